@@ -51,419 +51,325 @@ namespace AltAI
 
     namespace
     {
-        // update CityData with changes resulting from construction of supplied BuildingInfo nodes
-        class CityBuildingsUpdater : public boost::static_visitor<>
+        // update CityData with changes resulting from construction of supplied BuildingInfo's bonus node
+        void applyBonusNode(CityData& data, const PlayerPtr& pPlayer, const BuildingInfo::BonusNode& node)
         {
-        public:
-            CityBuildingsUpdater(CityData& data, BuildingTypes buildingType) : data_(data), buildingType_(buildingType)
-            {
-                pPlayer_ = gGlobals.getGame().getAltAI()->getPlayer(data.getOwner()); 
-            }
-
-            template <typename T>
-                result_type operator() (const T&) const
-            {
-            }
-
-            void operator() (const BuildingInfo::BaseNode& node) const
+            // check for increased health/happy from bonus
+            if (data.getBonusHelper()->getNumBonuses(node.bonusType) > 0)
             {
-                if (node.hurryCostModifier != 0)
-                {
-                    data_.getHurryHelper()->changeCostModifier(node.hurryCostModifier);
-                }
-                // add any base happy/health
                 if (node.happy > 0)
                 {
-                    data_.getHappyHelper()->changeBuildingGoodHappiness(node.happy);
+                    data.getHappyHelperForWrite()->changeBonusGoodHappiness(node.happy);
                 }
                 else if (node.happy < 0)
                 {
-                    data_.getHappyHelper()->changeBuildingBadHappiness(node.happy);
+                    data.getHappyHelperForWrite()->changeBonusBadHappiness(node.happy);
                 }
-                data_.changeWorkingPopulation();
+                data.changeWorkingPopulation();
 
                 if (node.health > 0)
                 {
-                    data_.getHealthHelper()->changeBuildingGoodHealthiness(node.health);
+                    data.getHealthHelperForWrite()->changeBonusGoodHealthiness(node.health);
                 }
                 else if (node.health < 0)
                 {
-                    data_.getHealthHelper()->changeBuildingBadHealthiness(node.health);
+                    data.getHealthHelperForWrite()->changeBonusBadHealthiness(node.health);
                 }
 
-                for (size_t i = 0, count = node.nodes.size(); i < count; ++i)
+                if (!isEmpty(node.yieldModifier))
                 {
-                    boost::apply_visitor(*this, node.nodes[i]);
-                }
-            }
-            
-            void operator() (const BuildingInfo::YieldNode& node) const
-            {
-                // TODO - check whether yield modifiers can be conditional on plots too (only store one in CityData)
-                if (!isEmpty(node.modifier))
-                {
-                    if (node.modifier[YIELD_COMMERCE] != 0)
+                    if (node.yieldModifier[YIELD_COMMERCE] != 0)
                     {
-                        data_.changeCommerceYieldModifier(node.modifier[YIELD_COMMERCE]);
+                        data.changeCommerceYieldModifier(node.yieldModifier[YIELD_COMMERCE]);
                     }
-                    data_.getModifiersHelper()->changeYieldModifier(node.modifier);
+                    data.getModifiersHelperForWrite()->changeBonusYieldModifier(node.yieldModifier);
                 }
 
-                if (!isEmpty(node.powerModifier))
+                // process new bonus
+                if (node.freeBonusCount > 0)
                 {
-                    if (node.powerModifier[YIELD_COMMERCE] != 0)
-                    {
-                        data_.changeCommerceYieldModifier(node.modifier[YIELD_COMMERCE]);
-                    }
-                    data_.getModifiersHelper()->changePowerYieldModifier(node.powerModifier);
+                    data.getBonusHelperForWrite()->changeNumBonuses(node.bonusType, node.freeBonusCount);
+                    updateRequestData(data, pPlayer->getAnalysis()->getResourceInfo(node.bonusType), true);
                 }
 
-                if (node.militaryProductionModifier != 0)
+                // remove access to bonus for this city
+                if (node.isRemoved)
                 {
-                    data_.getModifiersHelper()->changeMilitaryProductionModifier(node.militaryProductionModifier);
+                    data.getBonusHelperForWrite()->allowOrDenyBonus(node.bonusType, false);
+                    updateRequestData(data, pPlayer->getAnalysis()->getResourceInfo(node.bonusType), false);
                 }
+            }
+        }
 
-                if (!node.plotCond)  // applies to building itself
-                {
-                    data_.getCityPlotData().plotYield += node.yield;
-                }
-                else
+        // update CityData with changes resulting from construction of supplied BuildingInfo (using its compiled effects, rather than walking its nodes)
+        void applyCityEffects(CityData& data, const BuildingInfo& buildingInfo)
+        {
+            const BuildingInfo::CityEffects& cityEffects = buildingInfo.getCityEffects();
+            PlayerPtr pPlayer;
+
+            for (size_t i = 0, count = cityEffects.effects.size(); i < count; ++i)
+            {
+                const BuildingInfo::CityEffect& effect = cityEffects.effects[i];
+
+                switch (effect.type)
                 {
-                    int xCoord = data_.getCityPlotData().coords.iX, yCoord = data_.getCityPlotData().coords.iY;
-                    CvPlot* pPlot = gGlobals.getMap().plot(xCoord, yCoord);
+                case BuildingInfo::CityEffect::HurryCostModifier:
+                    data.getHurryHelperForWrite()->changeCostModifier(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::HurryAngerModifier:
+                    data.getHurryHelperForWrite()->changeModifier(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::BuildingGoodHappy:
+                    data.getHappyHelperForWrite()->changeBuildingGoodHappiness(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::BuildingBadHappy:
+                    data.getHappyHelperForWrite()->changeBuildingBadHappiness(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::BuildingGoodHealth:
+                    data.getHealthHelperForWrite()->changeBuildingGoodHealthiness(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::BuildingBadHealth:
+                    data.getHealthHelperForWrite()->changeBuildingBadHealthiness(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::ChangeWorkingPopulation:
+                    data.changeWorkingPopulation();
+                    break;
+
+                // TODO - check whether yield modifiers can be conditional on plots too (only store one in CityData)
+                case BuildingInfo::CityEffect::YieldModifier:
+                    if (effect.yield[YIELD_COMMERCE] != 0)
+                    {
+                        data.changeCommerceYieldModifier(effect.yield[YIELD_COMMERCE]);
+                    }
+                    data.getModifiersHelperForWrite()->changeYieldModifier(effect.yield);
+                    break;
 
-                    if ((pPlot->*(node.plotCond))())
+                case BuildingInfo::CityEffect::PowerYieldModifier:
+                    if (effect.value != 0)
                     {
-                        data_.getCityPlotData().plotYield += node.yield;
+                        data.changeCommerceYieldModifier(effect.value);
                     }
+                    data.getModifiersHelperForWrite()->changePowerYieldModifier(effect.yield);
+                    break;
+
+                case BuildingInfo::CityEffect::MilitaryProductionModifier:
+                    data.getModifiersHelperForWrite()->changeMilitaryProductionModifier(effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::CityPlotYield:
+                    data.getCityPlotData().plotYield += effect.yield;
+                    break;
 
-                    // update plot yields
-                    for (PlotDataListIter iter(data_.getPlotOutputs().begin()), endIter(data_.getPlotOutputs().end()); iter != endIter; ++iter)
+                case BuildingInfo::CityEffect::ConditionalPlotYield:
                     {
-                        if (iter->isActualPlot())
+                        const CvPlot* pPlot = gGlobals.getMap().plot(data.getCityPlotData().coords.iX, data.getCityPlotData().coords.iY);
+                        if ((pPlot->*(effect.plotCond))())
                         {
-                            xCoord = iter->coords.iX, yCoord = iter->coords.iY;
-                            pPlot = gGlobals.getMap().plot(xCoord, yCoord);
-                            if ((pPlot->*(node.plotCond))())
+                            data.getCityPlotData().plotYield += effect.yield;
+                        }
+
+                        // update plot yields
+                        for (PlotDataListIter iter(data.getPlotOutputs().begin()), endIter(data.getPlotOutputs().end()); iter != endIter; ++iter)
+                        {
+                            if (iter->isActualPlot())
                             {
-                                iter->plotYield += node.yield;
+                                pPlot = gGlobals.getMap().plot(iter->coords.iX, iter->coords.iY);
+                                if ((pPlot->*(effect.plotCond))())
+                                {
+                                    iter->plotYield += effect.yield;
+                                }
                             }
                         }
                     }
-                }
-            }
+                    break;
 
-            void operator() (const BuildingInfo::SpecialistNode& node) const
-            {
-                // find 'plots' which represent specialists and update their outputs
-                for (size_t i = 0, count = node.specialistTypesAndYields.size(); i < count; ++i)
-                {
-                    for (PlotDataListIter iter(data_.getPlotOutputs().begin()), endIter(data_.getPlotOutputs().end()); iter != endIter; ++iter)
+                case BuildingInfo::CityEffect::SpecialistYield:
+                    // find 'plots' which represent specialists and update their outputs
+                    for (PlotDataListIter iter(data.getPlotOutputs().begin()), endIter(data.getPlotOutputs().end()); iter != endIter; ++iter)
                     {
                         // TODO - double check everything is in correct units here
-                        if (!iter->isActualPlot() && (SpecialistTypes)iter->coords.iY == node.specialistTypesAndYields[i].first)
+                        if (!iter->isActualPlot() && iter->coords.iY == effect.id)
                         {
-                            iter->plotYield += node.specialistTypesAndYields[i].second;
-                            iter->commerce += node.extraCommerce;
+                            iter->plotYield += effect.yield;
+                            iter->commerce += effect.commerce;
 
-                            TotalOutput specialistOutput(makeOutput(iter->plotYield, iter->commerce, makeYield(100, 100, data_.getCommerceYieldModifier()), makeCommerce(100, 100, 100, 100), data_.getCommercePercent()));
+                            TotalOutput specialistOutput(makeOutput(iter->plotYield, iter->commerce, makeYield(100, 100, data.getCommerceYieldModifier()), makeCommerce(100, 100, 100, 100), data.getCommercePercent()));
                             iter->actualOutput = iter->output = specialistOutput;
                         }
                     }
-                }
+                    break;
 
-                // change city gpp rate
-                if (node.cityGPPRateModifier != 0)
-                {
-                    data_.getSpecialistHelper()->changeCityGPPModifier(node.cityGPPRateModifier);
-                }
+                case BuildingInfo::CityEffect::CityGPPModifier:
+                    data.getSpecialistHelperForWrite()->changeCityGPPModifier(effect.value);
+                    break;
 
-                // node.generatedGPP - data added in calcCityOutput_() for this building
-            }
+                case BuildingInfo::CityEffect::CityCommerce:
+                    data.getCityPlotData().commerce += effect.commerce;
+                    break;
 
-            void operator() (const BuildingInfo::CommerceNode& node) const
-            {
-                // update city commerce and/or commerce modifier
-                data_.getCityPlotData().commerce += 100 * node.commerce;
-                data_.getCityPlotData().commerce += 100 * node.obsoleteSafeCommerce;
+                case BuildingInfo::CityEffect::CommerceModifier:
+                    data.getModifiersHelperForWrite()->changeCommerceModifier(effect.commerce);
+                    break;
 
-                if (!isEmpty(node.modifier))
-                {
-                    data_.getModifiersHelper()->changeCommerceModifier(node.modifier);
-                }
+                case BuildingInfo::CityEffect::StateReligionCommerceModifier:
+                    data.getModifiersHelperForWrite()->changeStateReligionCommerceModifier(effect.commerce);
+                    break;
 
-                if (!isEmpty(node.stateReligionCommerce))
-                {
-                    data_.getModifiersHelper()->changeStateReligionCommerceModifier(node.stateReligionCommerce);
-                }
-            }
-
-            void operator() (const BuildingInfo::TradeNode& node) const
-            {
-                if (node.extraTradeRoutes != 0)
-                {
-                    data_.getTradeRouteHelper()->changeNumRoutes(node.extraTradeRoutes);
-                }
-
-                if (node.extraCoastalTradeRoutes != 0 && data_.getCity()->isCoastal(gGlobals.getMIN_WATER_SIZE_FOR_OCEAN()))
-                {
-                    data_.getTradeRouteHelper()->changeNumRoutes(node.extraCoastalTradeRoutes);
-                }
+                case BuildingInfo::CityEffect::TradeRoutes:
+                    data.getTradeRouteHelperForWrite()->changeNumRoutes(effect.value);
+                    break;
 
-                if (node.extraGlobalTradeRoutes != 0)
-                {
-                    data_.getTradeRouteHelper()->changeNumRoutes(node.extraGlobalTradeRoutes);
-                }
-
-                if (node.tradeRouteModifier != 0)
-                {
-                    data_.getTradeRouteHelper()->changeTradeRouteModifier(node.tradeRouteModifier);
-                }
-
-                if (node.foreignTradeRouteModifier != 0)
-                {
-                    data_.getTradeRouteHelper()->changeForeignTradeRouteModifier(node.foreignTradeRouteModifier);
-                }
-            }
-
-            void operator() (const BuildingInfo::PowerNode& node) const
-            {
-                data_.getBuildingsHelper()->updatePower(node.isDirty, true);
-                if (node.areaCleanPower)  // stored in building helper to save passing areaHelper - todo - redesign CityData so helpers keep back pointer to it
-                {
-                    data_.getAreaHelper()->changeCleanPowerCount(true);
-                    data_.getBuildingsHelper()->updateAreaCleanPower(data_.getAreaHelper()->getCleanPowerCount() > 0);
-                }
-
-                data_.getHealthHelper()->updatePowerHealth(data_);  // double use of CityData reinforces above comment!
-            }
-
-            void operator() (const BuildingInfo::UnitExpNode& node) const
-            {
-                if (node.freeExperience != 0)
-                {
-                    data_.getUnitHelper()->changeUnitFreeExperience(node.freeExperience);
-                }
-                if (node.globalFreeExperience != 0)
-                {
-                    data_.getUnitHelper()->changeUnitFreeExperience(node.globalFreeExperience);
-                }
-                for (int i = 0, count = node.domainFreeExperience.size(); i < count; ++i)
-                {
-                    if (node.domainFreeExperience[i].second != 0)
+                case BuildingInfo::CityEffect::CoastalTradeRoutes:
+                    if (data.getCity()->isCoastal(gGlobals.getMIN_WATER_SIZE_FOR_OCEAN()))
                     {
-                        data_.getUnitHelper()->changeDomainFreeExperience(node.domainFreeExperience[i].first, node.domainFreeExperience[i].second);
+                        data.getTradeRouteHelperForWrite()->changeNumRoutes(effect.value);
                     }
-                }
-                for (int i = 0, count = node.combatTypeFreeExperience.size(); i < count; ++i)
-                {
-                    if (node.combatTypeFreeExperience[i].second != 0)
-                    {
-                        data_.getUnitHelper()->changeUnitCombatTypeFreeExperience(node.combatTypeFreeExperience[i].first, node.combatTypeFreeExperience[i].second);
-                    }
-                }
-            }
+                    break;
 
-            void operator() (const BuildingInfo::SpecialistSlotNode& node) const
-            {
-                const CvPlayer& player = CvPlayerAI::getPlayer(data_.getOwner());
+                case BuildingInfo::CityEffect::TradeRouteModifier:
+                    data.getTradeRouteHelperForWrite()->changeTradeRouteModifier(effect.value);
+                    break;
 
-                // add any 'plots' for new specialist slots (if we aren't maxed out already for that type)
-                for (size_t i = 0, count = node.specialistTypes.size(); i < count; ++i)
-                {
-                    int specialistCount = data_.getNumPossibleSpecialists(node.specialistTypes[i].first);
+                case BuildingInfo::CityEffect::ForeignTradeRouteModifier:
+                    data.getTradeRouteHelperForWrite()->changeForeignTradeRouteModifier(effect.value);
+                    break;
 
-                    // todo - should this be total population?
-                    if (specialistCount < data_.getWorkingPopulation())  // if this is also changed by this building (e.g. HG)? - OK as long as add pop code updates specs
+                case BuildingInfo::CityEffect::Power:
+                    data.getBuildingsHelperForWrite()->updatePower(effect.value != 0, true);
+                    if (effect.id > 0)  // stored in building helper to save passing areaHelper - todo - redesign CityData so helpers keep back pointer to it
                     {
-                        data_.addSpecialistSlots(node.specialistTypes[i].first, std::min<int>(node.specialistTypes[i].second, data_.getWorkingPopulation() - specialistCount));
+                        data.getAreaHelper()->changeCleanPowerCount(true);
+                        data.getBuildingsHelperForWrite()->updateAreaCleanPower(data.getAreaHelper()->getCleanPowerCount() > 0);
                     }
-                }
+                    data.getHealthHelperForWrite()->updatePowerHealth(data);  // double use of CityData reinforces above comment!
+                    break;
 
-                // add free specialists
-                for (size_t i = 0, count = node.freeSpecialistTypes.size(); i < count; ++i)
-                {
-                    data_.getSpecialistHelper()->changeFreeSpecialistCount(node.freeSpecialistTypes[i].first, node.freeSpecialistTypes[i].second);
-                }
+                case BuildingInfo::CityEffect::FreeExperience:
+                    data.getUnitHelperForWrite()->changeUnitFreeExperience(effect.value);
+                    break;
 
-                // update city data to include any free specialists added for given improvement types (National Park + Forest Preserves)
-                for (size_t i = 0, count = node.improvementFreeSpecialists.size(); i < count; ++i)
-                {
-                    data_.changeFreeSpecialistCountPerImprovement(node.improvementFreeSpecialists[i].first, node.improvementFreeSpecialists[i].second);
-                }
-            }
+                case BuildingInfo::CityEffect::DomainFreeExperience:
+                    data.getUnitHelperForWrite()->changeDomainFreeExperience((DomainTypes)effect.id, effect.value);
+                    break;
 
-            void operator() (const BuildingInfo::BonusNode& node) const
-            {
-                // check for increased health/happy from bonus
-                if (data_.getBonusHelper()->getNumBonuses(node.bonusType) > 0)
-                {
-                    if (node.happy > 0)
-                    {
-                        data_.getHappyHelper()->changeBonusGoodHappiness(node.happy);
-                    }
-                    else if (node.happy < 0)
-                    {
-                        data_.getHappyHelper()->changeBonusBadHappiness(node.happy);
-                    }
-                    data_.changeWorkingPopulation();
+                case BuildingInfo::CityEffect::UnitCombatFreeExperience:
+                    data.getUnitHelperForWrite()->changeUnitCombatTypeFreeExperience((UnitCombatTypes)effect.id, effect.value);
+                    break;
 
-                    if (node.health > 0)
-                    {
-                        data_.getHealthHelper()->changeBonusGoodHealthiness(node.health);
-                    }
-                    else if (node.health < 0)
+                case BuildingInfo::CityEffect::SpecialistSlots:
                     {
-                        data_.getHealthHelper()->changeBonusBadHealthiness(node.health);
-                    }
+                        // add any 'plots' for new specialist slots (if we aren't maxed out already for that type)
+                        const int specialistCount = data.getNumPossibleSpecialists((SpecialistTypes)effect.id);
 
-                    if (!isEmpty(node.yieldModifier))
-                    {
-                        if (node.yieldModifier[YIELD_COMMERCE] != 0)
+                        // todo - should this be total population?
+                        if (specialistCount < data.getWorkingPopulation())  // if this is also changed by this building (e.g. HG)? - OK as long as add pop code updates specs
                         {
-                            data_.changeCommerceYieldModifier(node.yieldModifier[YIELD_COMMERCE]);
+                            data.addSpecialistSlots((SpecialistTypes)effect.id, std::min<int>(effect.value, data.getWorkingPopulation() - specialistCount));
                         }
-                        data_.getModifiersHelper()->changeBonusYieldModifier(node.yieldModifier);
                     }
+                    break;
+
+                case BuildingInfo::CityEffect::FreeSpecialists:
+                    data.getSpecialistHelperForWrite()->changeFreeSpecialistCount((SpecialistTypes)effect.id, effect.value);
+                    break;
 
-                    // process new bonus
-                    if (node.freeBonusCount > 0)
+                case BuildingInfo::CityEffect::ImprovementFreeSpecialists:
+                    // (National Park + Forest Preserves)
+                    data.changeFreeSpecialistCountPerImprovement((ImprovementTypes)effect.id, effect.value);
+                    break;
+
+                case BuildingInfo::CityEffect::Bonus:
+                    if (!pPlayer)
                     {
-                        data_.getBonusHelper()->changeNumBonuses(node.bonusType, node.freeBonusCount);
-                        updateRequestData(data_, pPlayer_->getAnalysis()->getResourceInfo(node.bonusType), true); 
+                        pPlayer = gGlobals.getGame().getAltAI()->getPlayer(data.getOwner());
                     }
+                    applyBonusNode(data, pPlayer, cityEffects.bonusNodes[effect.id]);
+                    break;
+
+                case BuildingInfo::CityEffect::BuildingDefence:
+                    data.getUnitHelperForWrite()->changeBuildingDefence(effect.value);
+                    break;
 
-                    // remove access to bonus for this city
-                    if (node.isRemoved)
+                case BuildingInfo::CityEffect::ReligiousBuilding:
                     {
-                        data_.getBonusHelper()->allowOrDenyBonus(node.bonusType, false);                
-                        updateRequestData(data_, pPlayer_->getAnalysis()->getResourceInfo(node.bonusType), false);
+                        PlotYield yieldChange = data.getVoteHelper()->getReligiousBuildingYieldChange((ReligionTypes)effect.id);
+                        Commerce commerceChange = data.getVoteHelper()->getReligiousBuildingCommerceChange((ReligionTypes)effect.id);
+
+                        if (!isEmpty(yieldChange))
+                        {
+                            data.getBuildingsHelperForWrite()->changeBuildingYieldChange(getBuildingClass(buildingInfo.getBuildingType()), yieldChange);
+                        }
+
+                        if (!isEmpty(commerceChange))
+                        {
+                            data.getBuildingsHelperForWrite()->changeBuildingCommerceChange(getBuildingClass(buildingInfo.getBuildingType()), commerceChange);
+                        }
                     }
-                }
-            }
+                    break;
 
-            void operator() (const BuildingInfo::CityDefenceNode& node) const
-            {
-                if (node.defenceBonus != 0)
-                {
-                    data_.getUnitHelper()->changeBuildingDefence(node.defenceBonus);
-                }
-                if (node.globalDefenceBonus != 0)
-                {
-                    data_.getUnitHelper()->changeBuildingDefence(node.globalDefenceBonus);
-                }
-            }
+                case BuildingInfo::CityEffect::AreaGoodHealth:
+                    data.getHealthHelperForWrite()->changeAreaBuildingGoodHealthiness(effect.value);
+                    break;
 
-            void operator() (const BuildingInfo::ReligionNode& node) const
-            {
-                if (node.religionType != NO_RELIGION)
-                {
-                    PlotYield yieldChange = data_.getVoteHelper()->getReligiousBuildingYieldChange(node.religionType);
-                    Commerce commerceChange = data_.getVoteHelper()->getReligiousBuildingCommerceChange(node.religionType);
+                case BuildingInfo::CityEffect::AreaBadHealth:
+                    data.getHealthHelperForWrite()->changeAreaBuildingBadHealthiness(effect.value);
+                    break;
 
-                    if (!isEmpty(yieldChange))
-                    {
-                        data_.getBuildingsHelper()->changeBuildingYieldChange(getBuildingClass(buildingType_), yieldChange);
-                    }
+                case BuildingInfo::CityEffect::PlayerGoodHealth:
+                    data.getHealthHelperForWrite()->changePlayerBuildingGoodHealthiness(effect.value);
+                    break;
 
-                    if (!isEmpty(commerceChange))
-                    {
-                        data_.getBuildingsHelper()->changeBuildingCommerceChange(getBuildingClass(buildingType_), commerceChange);
-                    }
-                }
-            }
+                case BuildingInfo::CityEffect::PlayerBadHealth:
+                    data.getHealthHelperForWrite()->changePlayerBuildingBadHealthiness(effect.value);
+                    break;
 
-            void operator() (const BuildingInfo::HurryNode& node) const
-            {
-                if (node.hurryAngerModifier != 0)
-                {
-                    data_.getHurryHelper()->changeModifier(node.hurryAngerModifier);
-                }
-                if (node.globalHurryCostModifier != 0)
-                {
-                    data_.getHurryHelper()->changeCostModifier(node.globalHurryCostModifier);
-                }
-            }
+                case BuildingInfo::CityEffect::AreaHappy:
+                    data.getHappyHelperForWrite()->changeAreaBuildingHappiness(effect.value);
+                    break;
 
-            void operator() (const BuildingInfo::AreaEffectNode& node) const
-            {
-                if (node.areaHealth > 0)
-                {
-                    data_.getHealthHelper()->changeAreaBuildingGoodHealthiness(node.areaHealth);
-                }
-                else if (node.areaHealth < 0)
-                {
-                    data_.getHealthHelper()->changeAreaBuildingBadHealthiness(node.areaHealth);
-                }
-                
-                if (node.globalHealth > 0)
-                {
-                    data_.getHealthHelper()->changePlayerBuildingGoodHealthiness(node.areaHealth);
-                }
-                else if (node.globalHealth < 0)
-                {
-                    data_.getHealthHelper()->changePlayerBuildingBadHealthiness(node.areaHealth);
-                }
-                
-                if (node.areaHappy != 0)
-                {
-                    data_.getHappyHelper()->changeAreaBuildingHappiness(node.areaHappy);
-                }
-                
-                if (node.globalHappy != 0)
-                {
-                    data_.getHappyHelper()->changePlayerBuildingHappiness(node.globalHappy);
-                }
-            }
+                case BuildingInfo::CityEffect::PlayerHappy:
+                    data.getHappyHelperForWrite()->changePlayerBuildingHappiness(effect.value);
+                    break;
 
-            void operator() (const BuildingInfo::MiscEffectNode& node) const
-            {
-                if (node.cityMaintenanceModifierChange != 0)
-                {
-                    data_.getMaintenanceHelper()->changeModifier(node.cityMaintenanceModifierChange);
-                }
+                case BuildingInfo::CityEffect::MaintenanceModifier:
+                    data.getMaintenanceHelperForWrite()->changeModifier(effect.value);
+                    break;
 
-                if (node.isGovernmentCenter)
-                {
-                    data_.getMaintenanceHelper()->addGovernmentCentre(data_.getCity()->getIDInfo());
-                }
+                case BuildingInfo::CityEffect::GovernmentCentre:
+                    data.getMaintenanceHelperForWrite()->addGovernmentCentre(data.getCity()->getIDInfo());
+                    break;
 
-                if (node.foodKeptPercent != 0)
-                {
-                    data_.changeFoodKeptPercent(node.foodKeptPercent);
-                }
+                case BuildingInfo::CityEffect::FoodKeptPercent:
+                    data.changeFoodKeptPercent(effect.value);
+                    break;
 
-                if (node.hurryAngerModifier != 0)
-                {
-                    data_.getHurryHelper()->changeModifier(node.hurryAngerModifier);
-                }
+                case BuildingInfo::CityEffect::PopulationChange:
+                    data.changePopulation(effect.value);
+                    break;
 
-                if (node.globalPopChange != 0)
-                {
-                    data_.changePopulation(node.globalPopChange);
-                }
+                case BuildingInfo::CityEffect::NoUnhealthinessFromBuildings:
+                    data.getHealthHelperForWrite()->setNoUnhealthinessFromBuildings();
+                    break;
 
-                if (node.noUnhealthinessFromBuildings)
-                {
-                    data_.getHealthHelper()->setNoUnhealthinessFromBuildings();
-                }
+                case BuildingInfo::CityEffect::NoUnhealthinessFromPopulation:
+                    data.getHealthHelperForWrite()->setNoUnhealthinessFromPopulation();
+                    break;
 
-                if (node.noUnhealthinessFromPopulation)
-                {
-                    data_.getHealthHelper()->setNoUnhealthinessFromPopulation();
-                }
+                case BuildingInfo::CityEffect::NoUnhappiness:
+                    data.getHappyHelperForWrite()->setNoUnhappiness(true);
+                    break;
 
-                if (node.noUnhappiness)
-                {
-                    data_.getHappyHelper()->setNoUnhappiness(true);
+                default:
+                    break;
                 }
             }
-
-        private:
-            PlayerPtr pPlayer_;
-            CityData& data_;
-            BuildingTypes buildingType_;
-        };
+        }
 
         // update CityData with changes resulting from construction of supplied BuildingInfo nodes from building constructed in another city
         class CityGlobalOutputUpdater : public boost::static_visitor<>
@@ -510,7 +416,7 @@ namespace AltAI
                 // change global gpp rate
                 if (node.playerGPPRateModifier != 0)
                 {
-                    pCityData_->getSpecialistHelper()->changePlayerGPPModifier(node.playerGPPRateModifier);
+                    pCityData_->getSpecialistHelperForWrite()->changePlayerGPPModifier(node.playerGPPRateModifier);
                 }
 
             }
@@ -525,7 +431,7 @@ namespace AltAI
                         {
                             pCityData_->changeCommerceYieldModifier(node.modifier[YIELD_COMMERCE]);
                         }
-                        pCityData_->getModifiersHelper()->changeYieldModifier(node.modifier);
+                        pCityData_->getModifiersHelperForWrite()->changeYieldModifier(node.modifier);
                     }
 
                     if (!isEmpty(node.powerModifier))
@@ -534,12 +440,12 @@ namespace AltAI
                         {
                             pCityData_->changeCommerceYieldModifier(node.modifier[YIELD_COMMERCE]);
                         }
-                        pCityData_->getModifiersHelper()->changePowerYieldModifier(node.powerModifier);
+                        pCityData_->getModifiersHelperForWrite()->changePowerYieldModifier(node.powerModifier);
                     }
 
                     if (node.militaryProductionModifier != 0)
                     {
-                        pCityData_->getModifiersHelper()->changeMilitaryProductionModifier(node.militaryProductionModifier);
+                        pCityData_->getModifiersHelperForWrite()->changeMilitaryProductionModifier(node.militaryProductionModifier);
                     }
 
                     if (node.plotCond)
@@ -575,12 +481,12 @@ namespace AltAI
                 {
                     if (!isEmpty(node.modifier))
                     {
-                        pCityData_->getModifiersHelper()->changeCommerceModifier(node.modifier);
+                        pCityData_->getModifiersHelperForWrite()->changeCommerceModifier(node.modifier);
                     }
 
                     if (!isEmpty(node.stateReligionCommerce))
                     {
-                        pCityData_->getModifiersHelper()->changeStateReligionCommerceModifier(node.stateReligionCommerce);
+                        pCityData_->getModifiersHelperForWrite()->changeStateReligionCommerceModifier(node.stateReligionCommerce);
                     }
                 }
             }
@@ -589,12 +495,12 @@ namespace AltAI
             {
                 if (node.extraCoastalTradeRoutes != 0 && pCityData_->getCity()->isCoastal(gGlobals.getMIN_WATER_SIZE_FOR_OCEAN()))
                 {
-                    pCityData_->getTradeRouteHelper()->changeNumRoutes(node.extraCoastalTradeRoutes);
+                    pCityData_->getTradeRouteHelperForWrite()->changeNumRoutes(node.extraCoastalTradeRoutes);
                 }
 
                 if (node.extraGlobalTradeRoutes != 0)
                 {
-                    pCityData_->getTradeRouteHelper()->changeNumRoutes(node.extraGlobalTradeRoutes);
+                    pCityData_->getTradeRouteHelperForWrite()->changeNumRoutes(node.extraGlobalTradeRoutes);
                 }
             }
 
@@ -602,7 +508,7 @@ namespace AltAI
             {
                 if (node.freeBonusCount > 0)
                 {
-                    pCityData_->getBonusHelper()->changeNumBonuses(node.bonusType, node.freeBonusCount);
+                    pCityData_->getBonusHelperForWrite()->changeNumBonuses(node.bonusType, node.freeBonusCount);
                     updateRequestData(*pCityData_, pPlayer_->getAnalysis()->getResourceInfo(node.bonusType), true); 
                 }
             }
@@ -612,8 +518,8 @@ namespace AltAI
                 if (node.areaCleanPower && pCityData_->getCity()->getArea() == pBuiltCity_->getArea())
                 {
                     pCityData_->getAreaHelper()->changeCleanPowerCount(true);
-                    pCityData_->getBuildingsHelper()->updateAreaCleanPower(pCityData_->getAreaHelper()->getCleanPowerCount() > 0);
-                    pCityData_->getHealthHelper()->updatePowerHealth(*pCityData_);
+                    pCityData_->getBuildingsHelperForWrite()->updateAreaCleanPower(pCityData_->getAreaHelper()->getCleanPowerCount() > 0);
+                    pCityData_->getHealthHelperForWrite()->updatePowerHealth(*pCityData_);
                 }                
             }
 
@@ -621,30 +527,30 @@ namespace AltAI
             {
                 if (node.areaHealth > 0)
                 {
-                    pCityData_->getHealthHelper()->changeAreaBuildingGoodHealthiness(node.areaHealth);
+                    pCityData_->getHealthHelperForWrite()->changeAreaBuildingGoodHealthiness(node.areaHealth);
                 }
                 else if (node.areaHealth < 0)
                 {
-                    pCityData_->getHealthHelper()->changeAreaBuildingBadHealthiness(node.areaHealth);
+                    pCityData_->getHealthHelperForWrite()->changeAreaBuildingBadHealthiness(node.areaHealth);
                 }
                 
                 if (node.globalHealth > 0)
                 {
-                    pCityData_->getHealthHelper()->changePlayerBuildingGoodHealthiness(node.areaHealth);
+                    pCityData_->getHealthHelperForWrite()->changePlayerBuildingGoodHealthiness(node.globalHealth);
                 }
                 else if (node.globalHealth < 0)
                 {
-                    pCityData_->getHealthHelper()->changePlayerBuildingBadHealthiness(node.areaHealth);
+                    pCityData_->getHealthHelperForWrite()->changePlayerBuildingBadHealthiness(node.globalHealth);
                 }
                 
                 if (node.areaHappy != 0)
                 {
-                    pCityData_->getHappyHelper()->changeAreaBuildingHappiness(node.areaHappy);
+                    pCityData_->getHappyHelperForWrite()->changeAreaBuildingHappiness(node.areaHappy);
                 }
                 
                 if (node.globalHappy != 0)
                 {
-                    pCityData_->getHappyHelper()->changePlayerBuildingHappiness(node.globalHappy);
+                    pCityData_->getHappyHelperForWrite()->changePlayerBuildingHappiness(node.globalHappy);
                 }
             }
 
@@ -657,7 +563,7 @@ namespace AltAI
             {
                 if (node.globalHurryCostModifier != 0)
                 {
-                    pCityData_->getHurryHelper()->changeCostModifier(node.globalHurryCostModifier);
+                    pCityData_->getHurryHelperForWrite()->changeCostModifier(node.globalHurryCostModifier);
                 }
             }
 
@@ -670,14 +576,14 @@ namespace AltAI
 
                 if (node.isGovernmentCenter)
                 {
-                    pCityData_->getMaintenanceHelper()->addGovernmentCentre(pBuiltCity_->getIDInfo());
+                    pCityData_->getMaintenanceHelperForWrite()->addGovernmentCentre(pBuiltCity_->getIDInfo());
                 }
 
                 if (node.freeBuildingType != NO_BUILDING)
                 {
                     if (pCityData_->getBuildingsHelper()->getNumBuildings(node.freeBuildingType) == 0)
                     {
-                        pCityData_->getBuildingsHelper()->changeNumFreeBuildings(node.freeBuildingType);
+                        pCityData_->getBuildingsHelperForWrite()->changeNumFreeBuildings(node.freeBuildingType);
                     }
                 }
             }
@@ -691,7 +597,7 @@ namespace AltAI
 
     void updateRequestData(CityData& data, const boost::shared_ptr<BuildingInfo>& pBuildingInfo)
     {
-        boost::apply_visitor(CityBuildingsUpdater(data, pBuildingInfo->getBuildingType()), pBuildingInfo->getInfo());
+        applyCityEffects(data, *pBuildingInfo);
         data.recalcOutputs();
     }
 
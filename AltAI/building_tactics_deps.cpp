@@ -87,13 +87,13 @@ namespace AltAI
 
     void CityBuildingDependency::apply(const CityDataPtr& pCityData)
     {
-        pCityData->getBuildingsHelper()->changeNumRealBuildings(buildingType_);
+        pCityData->getBuildingsHelperForWrite()->changeNumRealBuildings(buildingType_);
         pCityData->recalcOutputs();
     }
 
     void CityBuildingDependency::remove(const CityDataPtr& pCityData)
     {
-        pCityData->getBuildingsHelper()->changeNumRealBuildings(buildingType_, false);
+        pCityData->getBuildingsHelperForWrite()->changeNumRealBuildings(buildingType_, false);
         pCityData->recalcOutputs();
     }
 
@@ -250,13 +250,13 @@ namespace AltAI
 
     void ReligiousDependency::apply(const CityDataPtr& pCityData)
     {
-        pCityData->getReligionHelper()->setHasReligion(*pCityData, religionType_, true);
+        pCityData->getReligionHelperForWrite()->setHasReligion(*pCityData, religionType_, true);
         pCityData->recalcOutputs();
     }
 
     void ReligiousDependency::remove(const CityDataPtr& pCityData)
     {
-        pCityData->getReligionHelper()->setHasReligion(*pCityData, religionType_, false);
+        pCityData->getReligionHelperForWrite()->setHasReligion(*pCityData, religionType_, false);
         pCityData->recalcOutputs();
     }
 
@@ -316,7 +316,7 @@ namespace AltAI
         ReligionTypes stateReligion = pCityData->getReligionHelper()->getStateReligion();
         if (stateReligion != NO_RELIGION)
         {
-            pCityData->getReligionHelper()->setHasReligion(*pCityData, stateReligion, true);
+            pCityData->getReligionHelperForWrite()->setHasReligion(*pCityData, stateReligion, true);
             pCityData->recalcOutputs();
         }
     }
@@ -326,7 +326,7 @@ namespace AltAI
         ReligionTypes stateReligion = pCityData->getReligionHelper()->getStateReligion();
         if (stateReligion != NO_RELIGION)
         {
-            pCityData->getReligionHelper()->setHasReligion(*pCityData, stateReligion, false);
+            pCityData->getReligionHelperForWrite()->setHasReligion(*pCityData, stateReligion, false);
             pCityData->recalcOutputs();
         }
     }
@@ -408,12 +408,12 @@ namespace AltAI
 
         for (size_t i = 0, count = andBonusTypes_.size(); i < count; ++i)
         {
-            pCityData->getBonusHelper()->changeNumBonuses(andBonusTypes_[i], 1);            
+            pCityData->getBonusHelperForWrite()->changeNumBonuses(andBonusTypes_[i], 1);            
             updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(andBonusTypes_[i]), true);
         }
         for (size_t i = 0, count = orBonusTypes_.size(); i < count; ++i)
         {
-            pCityData->getBonusHelper()->changeNumBonuses(orBonusTypes_[i], 1);
+            pCityData->getBonusHelperForWrite()->changeNumBonuses(orBonusTypes_[i], 1);
             updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(orBonusTypes_[i]), true);
         }
 
@@ -425,12 +425,12 @@ namespace AltAI
 
         for (size_t i = 0, count = andBonusTypes_.size(); i < count; ++i)
         {
-            pCityData->getBonusHelper()->changeNumBonuses(andBonusTypes_[i], -1);
+            pCityData->getBonusHelperForWrite()->changeNumBonuses(andBonusTypes_[i], -1);
             updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(andBonusTypes_[i]), false);
         }
         for (size_t i = 0, count = orBonusTypes_.size(); i < count; ++i)
         {
-            pCityData->getBonusHelper()->changeNumBonuses(orBonusTypes_[i], -1);
+            pCityData->getBonusHelperForWrite()->changeNumBonuses(orBonusTypes_[i], -1);
             updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(orBonusTypes_[i]), false);
         }
     }
@@ -728,14 +728,14 @@ namespace AltAI
 
     void ResourceProductionBonusDependency::apply(const CityDataPtr& pCityData)
     {
-        pCityData->getBonusHelper()->changeNumBonuses(bonusType_, 1);
+        pCityData->getBonusHelperForWrite()->changeNumBonuses(bonusType_, 1);
         PlayerPtr pPlayer = gGlobals.getGame().getAltAI()->getPlayer(pCityData->getOwner());
         updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(bonusType_), true);
     }
 
     void ResourceProductionBonusDependency::remove(const CityDataPtr& pCityData)
     {
-        pCityData->getBonusHelper()->changeNumBonuses(bonusType_, -1);
+        pCityData->getBonusHelperForWrite()->changeNumBonuses(bonusType_, -1);
         PlayerPtr pPlayer = gGlobals.getGame().getAltAI()->getPlayer(pCityData->getOwner());
         updateRequestData(*pCityData,  pPlayer->getAnalysis()->getResourceInfo(bonusType_), false);
     }
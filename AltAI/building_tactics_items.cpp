@@ -184,12 +184,13 @@ namespace AltAI
         const CvCity* pCity = getCity(pCityBuildingTactics->getCity());
         City& city = gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner())->getCity(pCity);
         CityDataPtr pCityData = pCityBuildingTactics->getCityData();
+        const ModifiersHelperPtr& pModifiersHelper = pCityData->getModifiersHelper();
 
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(
             pCityBuildingTactics->getBuildingCost() - 
                 pCity->getBuildingProduction(pCityBuildingTactics->getBuildingType()), 
-            pCityData->getModifiersHelper()->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
-            pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
+            pModifiersHelper->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
+            pModifiersHelper->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
 
         const ProjectionLadder& ladder = pCityBuildingTactics->getProjection();
 
@@ -338,12 +339,13 @@ namespace AltAI
         const CvCity* pCity = getCity(pCityBuildingTactics->getCity());
         City& city = gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner())->getCity(pCity);
         CityDataPtr pCityData = pCityBuildingTactics->getCityData();
+        const ModifiersHelperPtr& pModifiersHelper = pCityData->getModifiersHelper();
         Player& player = *gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner());
 
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(pCityBuildingTactics->getBuildingCost() - 
                 pCity->getBuildingProduction(pCityBuildingTactics->getBuildingType()), 
-            pCityData->getModifiersHelper()->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
-            pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
+            pModifiersHelper->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
+            pModifiersHelper->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
 
         if (estimatedTurns >= 0)  // building built
         {
@@ -430,12 +432,13 @@ namespace AltAI
         const CvCity* pCity = getCity(pCityBuildingTactics->getCity());
         City& city = gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner())->getCity(pCity);
         CityDataPtr pCityData = pCityBuildingTactics->getCityData();
+        const ModifiersHelperPtr& pModifiersHelper = pCityData->getModifiersHelper();
         Player& player = *gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner());
 
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(pCityBuildingTactics->getBuildingCost() - 
                 pCity->getBuildingProduction(pCityBuildingTactics->getBuildingType()), 
-            pCityData->getModifiersHelper()->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
-            pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
+            pModifiersHelper->getBuildingProductionModifier(*pCityData, pCityBuildingTactics->getBuildingType()),
+            pModifiersHelper->getTotalYieldModifier(*pCityData)[YIELD_PRODUCTION]);
 
         if (estimatedTurns >= 0)
         {
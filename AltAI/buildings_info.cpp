@@ -2,6 +2,7 @@
 
 #include "./buildings_info.h"
 #include "./helper_fns.h"
+#include "./error_log.h"
 
 namespace AltAI
 {
@@ -613,6 +614,377 @@ namespace AltAI
         return areEqual;
     }
 
+    namespace
+    {
+        // flattens the node tree into the list of CityData changes updateRequestData() makes when the building is built
+        // effects are added in the order the tree is walked, and keep the walk's checks, so applying them in turn gives the same result
+        class CityEffectsCompiler : public boost::static_visitor<>
+        {
+        public:
+            explicit CityEffectsCompiler(BuildingInfo::CityEffects& cityEffects) : cityEffects_(cityEffects)
+            {
+            }
+
+            template <typename T>
+                result_type operator() (const T&) const
+            {
+            }
+
+            void operator() (const BuildingInfo::BaseNode& node) const
+            {
+                if (node.hurryCostModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::HurryCostModifier, node.hurryCostModifier);
+                }
+
+                if (node.happy > 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingGoodHappy, node.happy);
+                }
+                else if (node.happy < 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingBadHappy, node.happy);
+                }
+                add_(BuildingInfo::CityEffect::ChangeWorkingPopulation);
+
+                if (node.health > 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingGoodHealth, node.health);
+                }
+                else if (node.health < 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingBadHealth, node.health);
+                }
+
+                for (size_t i = 0, count = node.nodes.size(); i < count; ++i)
+                {
+                    boost::apply_visitor(*this, node.nodes[i]);
+                }
+            }
+
+            void operator() (const BuildingInfo::YieldNode& node) const
+            {
+                if (!isEmpty(node.modifier))
+                {
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::YieldModifier);
+                    effect.yield = node.modifier;
+                    add_(effect);
+                }
+
+                if (!isEmpty(node.powerModifier))
+                {
+                    // value is the commerce yield modifier change - taken from the non-power modifier, as the tree walk always did
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::PowerYieldModifier, node.powerModifier[YIELD_COMMERCE] != 0 ? node.modifier[YIELD_COMMERCE] : 0);
+                    effect.yield = node.powerModifier;
+                    add_(effect);
+                }
+
+                if (node.militaryProductionModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::MilitaryProductionModifier, node.militaryProductionModifier);
+                }
+
+                if (!isEmpty(node.yield))
+                {
+                    BuildingInfo::CityEffect effect(node.plotCond ? BuildingInfo::CityEffect::ConditionalPlotYield : BuildingInfo::CityEffect::CityPlotYield);
+                    effect.yield = node.yield;
+                    effect.plotCond = node.plotCond;
+                    add_(effect);
+                }
+            }
+
+            void operator() (const BuildingInfo::SpecialistNode& node) const
+            {
+                for (size_t i = 0, count = node.specialistTypesAndYields.size(); i < count; ++i)
+                {
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::SpecialistYield, 0, node.specialistTypesAndYields[i].first);
+                    effect.yield = node.specialistTypesAndYields[i].second;
+                    effect.commerce = node.extraCommerce;
+                    add_(effect);
+                }
+
+                if (node.cityGPPRateModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::CityGPPModifier, node.cityGPPRateModifier);
+                }
+            }
+
+            void operator() (const BuildingInfo::CommerceNode& node) const
+            {
+                Commerce commerce(100 * node.commerce);
+                commerce += 100 * node.obsoleteSafeCommerce;
+                if (!isEmpty(commerce))
+                {
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::CityCommerce);
+                    effect.commerce = commerce;
+                    add_(effect);
+                }
+
+                if (!isEmpty(node.modifier))
+                {
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::CommerceModifier);
+                    effect.commerce = node.modifier;
+                    add_(effect);
+                }
+
+                if (!isEmpty(node.stateReligionCommerce))
+                {
+                    BuildingInfo::CityEffect effect(BuildingInfo::CityEffect::StateReligionCommerceModifier);
+                    effect.commerce = node.stateReligionCommerce;
+                    add_(effect);
+                }
+            }
+
+            void operator() (const BuildingInfo::TradeNode& node) const
+            {
+                if (node.extraTradeRoutes != 0)
+                {
+                    add_(BuildingInfo::CityEffect::TradeRoutes, node.extraTradeRoutes);
+                }
+
+                if (node.extraCoastalTradeRoutes != 0)
+                {
+                    add_(BuildingInfo::CityEffect::CoastalTradeRoutes, node.extraCoastalTradeRoutes);
+                }
+
+                if (node.extraGlobalTradeRoutes != 0)
+                {
+                    add_(BuildingInfo::CityEffect::TradeRoutes, node.extraGlobalTradeRoutes);
+                }
+
+                if (node.tradeRouteModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::TradeRouteModifier, node.tradeRouteModifier);
+                }
+
+                if (node.foreignTradeRouteModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::ForeignTradeRouteModifier, node.foreignTradeRouteModifier);
+                }
+            }
+
+            void operator() (const BuildingInfo::PowerNode& node) const
+            {
+                // value = is dirty power, id = provides clean power to the area
+                add_(BuildingInfo::CityEffect::Power, node.isDirty, node.areaCleanPower);
+            }
+
+            void operator() (const BuildingInfo::UnitExpNode& node) const
+            {
+                if (node.freeExperience != 0)
+                {
+                    add_(BuildingInfo::CityEffect::FreeExperience, node.freeExperience);
+                }
+                if (node.globalFreeExperience != 0)
+                {
+                    add_(BuildingInfo::CityEffect::FreeExperience, node.globalFreeExperience);
+                }
+                for (size_t i = 0, count = node.domainFreeExperience.size(); i < count; ++i)
+                {
+                    if (node.domainFreeExperience[i].second != 0)
+                    {
+                        add_(BuildingInfo::CityEffect::DomainFreeExperience, node.domainFreeExperience[i].second, node.domainFreeExperience[i].first);
+                    }
+                }
+                for (size_t i = 0, count = node.combatTypeFreeExperience.size(); i < count; ++i)
+                {
+                    if (node.combatTypeFreeExperience[i].second != 0)
+                    {
+                        add_(BuildingInfo::CityEffect::UnitCombatFreeExperience, node.combatTypeFreeExperience[i].second, node.combatTypeFreeExperience[i].first);
+                    }
+                }
+            }
+
+            void operator() (const BuildingInfo::SpecialistSlotNode& node) const
+            {
+                for (size_t i = 0, count = node.specialistTypes.size(); i < count; ++i)
+                {
+                    add_(BuildingInfo::CityEffect::SpecialistSlots, node.specialistTypes[i].second, node.specialistTypes[i].first);
+                }
+
+                for (size_t i = 0, count = node.freeSpecialistTypes.size(); i < count; ++i)
+                {
+                    add_(BuildingInfo::CityEffect::FreeSpecialists, node.freeSpecialistTypes[i].second, node.freeSpecialistTypes[i].first);
+                }
+
+                for (size_t i = 0, count = node.improvementFreeSpecialists.size(); i < count; ++i)
+                {
+                    add_(BuildingInfo::CityEffect::ImprovementFreeSpecialists, node.improvementFreeSpecialists[i].second, node.improvementFreeSpecialists[i].first);
+                }
+            }
+
+            void operator() (const BuildingInfo::BonusNode& node) const
+            {
+                add_(BuildingInfo::CityEffect::Bonus, 0, (int)cityEffects_.bonusNodes.size());
+                cityEffects_.bonusNodes.push_back(node);
+            }
+
+            void operator() (const BuildingInfo::CityDefenceNode& node) const
+            {
+                if (node.defenceBonus != 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingDefence, node.defenceBonus);
+                }
+                if (node.globalDefenceBonus != 0)
+                {
+                    add_(BuildingInfo::CityEffect::BuildingDefence, node.globalDefenceBonus);
+                }
+            }
+
+            void operator() (const BuildingInfo::ReligionNode& node) const
+            {
+                if (node.religionType != NO_RELIGION)
+                {
+                    add_(BuildingInfo::CityEffect::ReligiousBuilding, 0, node.religionType);
+                }
+            }
+
+            void operator() (const BuildingInfo::HurryNode& node) const
+            {
+                if (node.hurryAngerModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::HurryAngerModifier, node.hurryAngerModifier);
+                }
+                if (node.globalHurryCostModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::HurryCostModifier, node.globalHurryCostModifier);
+                }
+            }
+
+            void operator() (const BuildingInfo::AreaEffectNode& node) const
+            {
+                if (node.areaHealth > 0)
+                {
+                    add_(BuildingInfo::CityEffect::AreaGoodHealth, node.areaHealth);
+                }
+                else if (node.areaHealth < 0)
+                {
+                    add_(BuildingInfo::CityEffect::AreaBadHealth, node.areaHealth);
+                }
+
+                if (node.globalHealth > 0)
+                {
+                    add_(BuildingInfo::CityEffect::PlayerGoodHealth, node.globalHealth);
+                }
+                else if (node.globalHealth < 0)
+                {
+                    add_(BuildingInfo::CityEffect::PlayerBadHealth, node.globalHealth);
+                }
+
+                if (node.areaHappy != 0)
+                {
+                    add_(BuildingInfo::CityEffect::AreaHappy, node.areaHappy);
+                }
+
+                if (node.globalHappy != 0)
+                {
+                    add_(BuildingInfo::CityEffect::PlayerHappy, node.globalHappy);
+                }
+            }
+
+            void operator() (const BuildingInfo::MiscEffectNode& node) const
+            {
+                if (node.cityMaintenanceModifierChange != 0)
+                {
+                    add_(BuildingInfo::CityEffect::MaintenanceModifier, node.cityMaintenanceModifierChange);
+                }
+
+                if (node.isGovernmentCenter)
+                {
+                    add_(BuildingInfo::CityEffect::GovernmentCentre);
+                }
+
+                if (node.foodKeptPercent != 0)
+                {
+                    add_(BuildingInfo::CityEffect::FoodKeptPercent, node.foodKeptPercent);
+                }
+
+                if (node.hurryAngerModifier != 0)
+                {
+                    add_(BuildingInfo::CityEffect::HurryAngerModifier, node.hurryAngerModifier);
+                }
+
+                if (node.globalPopChange != 0)
+                {
+                    add_(BuildingInfo::CityEffect::PopulationChange, node.globalPopChange);
+                }
+
+                if (node.noUnhealthinessFromBuildings)
+                {
+                    add_(BuildingInfo::CityEffect::NoUnhealthinessFromBuildings);
+                }
+
+                if (node.noUnhealthinessFromPopulation)
+                {
+                    add_(BuildingInfo::CityEffect::NoUnhealthinessFromPopulation);
+                }
+
+                if (node.noUnhappiness)
+                {
+                    add_(BuildingInfo::CityEffect::NoUnhappiness);
+                }
+            }
+
+        private:
+            void add_(BuildingInfo::CityEffect::Type type, int value = 0, int id = -1) const
+            {
+                cityEffects_.effects.push_back(BuildingInfo::CityEffect(type, value, id));
+            }
+
+            void add_(const BuildingInfo::CityEffect& effect) const
+            {
+                cityEffects_.effects.push_back(effect);
+            }
+
+            BuildingInfo::CityEffects& cityEffects_;
+        };
+
+#ifdef ALTAI_DEBUG
+        // the compiled area and player wide happy and health effects should total the building's xml values
+        void checkCityEffects(BuildingTypes buildingType, PlayerTypes playerType, const BuildingInfo::CityEffects& cityEffects)
+        {
+            int areaHealth = 0, globalHealth = 0, areaHappy = 0, globalHappy = 0;
+            for (size_t i = 0, count = cityEffects.effects.size(); i < count; ++i)
+            {
+                const BuildingInfo::CityEffect& effect = cityEffects.effects[i];
+                switch (effect.type)
+                {
+                case BuildingInfo::CityEffect::AreaGoodHealth:
+                case BuildingInfo::CityEffect::AreaBadHealth:
+                    areaHealth += effect.value;
+                    break;
+                case BuildingInfo::CityEffect::PlayerGoodHealth:
+                case BuildingInfo::CityEffect::PlayerBadHealth:
+                    globalHealth += effect.value;
+                    break;
+                case BuildingInfo::CityEffect::AreaHappy:
+                    areaHappy += effect.value;
+                    break;
+                case BuildingInfo::CityEffect::PlayerHappy:
+                    globalHappy += effect.value;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            const CvBuildingInfo& buildingInfo = gGlobals.getBuildingInfo(buildingType);
+            if (areaHealth != buildingInfo.getAreaHealth() || globalHealth != buildingInfo.getGlobalHealth() ||
+                areaHappy != buildingInfo.getAreaHappiness() || globalHappy != buildingInfo.getGlobalHappiness())
+            {
+                if (playerType != NO_PLAYER)
+                {
+                    std::ostream& os = ErrorLog::getLog(CvPlayerAI::getPlayer(playerType))->getStream();
+                    os << "\nCompiled area effects for building: " << buildingInfo.getType() << " differ from xml values: health = "
+                       << areaHealth << ", " << globalHealth << " (" << buildingInfo.getAreaHealth() << ", " << buildingInfo.getGlobalHealth()
+                       << "), happy = " << areaHappy << ", " << globalHappy << " (" << buildingInfo.getAreaHappiness() << ", " << buildingInfo.getGlobalHappiness() << ")";
+                }
+                FAssertMsg(false, "Compiled building area effects differ from xml values");
+            }
+        }
+#endif
+    }
+
     BuildingInfo::BuildingInfo(BuildingTypes buildingType) : buildingType_(buildingType), playerType_(NO_PLAYER)
     {
         init_();
@@ -630,10 +1002,19 @@ namespace AltAI
         requestData.playerType = playerType_;
 
         infoNode_ = getBaseNode(requestData);
+        boost::apply_visitor(CityEffectsCompiler(cityEffects_), infoNode_);
+#ifdef ALTAI_DEBUG
+        checkCityEffects(buildingType_, playerType_, cityEffects_);
+#endif
     }
 
     const BuildingInfo::BuildingInfoNode& BuildingInfo::getInfo() const
     {
         return infoNode_;
     }
+
+    const BuildingInfo::CityEffects& BuildingInfo::getCityEffects() const
+    {
+        return cityEffects_;
+    }
 }
\ No newline at end of file
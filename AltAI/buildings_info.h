@@ -213,12 +213,48 @@ namespace AltAI
 
         const BuildingInfoNode& getInfo() const;
 
+        // flattened form of the changes building this makes to its own city's CityData (see updateRequestData())
+        // compiled once from the node tree, in the same order the tree is walked
+        struct CityEffect
+        {
+            enum Type
+            {
+                None = 0, HurryCostModifier, HurryAngerModifier, BuildingGoodHappy, BuildingBadHappy, BuildingGoodHealth, BuildingBadHealth,
+                ChangeWorkingPopulation,
+                YieldModifier, PowerYieldModifier, MilitaryProductionModifier, CityPlotYield, ConditionalPlotYield,
+                SpecialistYield, CityGPPModifier, CityCommerce, CommerceModifier, StateReligionCommerceModifier,
+                TradeRoutes, CoastalTradeRoutes, TradeRouteModifier, ForeignTradeRouteModifier, Power,
+                FreeExperience, DomainFreeExperience, UnitCombatFreeExperience,
+                SpecialistSlots, FreeSpecialists, ImprovementFreeSpecialists, Bonus, BuildingDefence, ReligiousBuilding,
+                AreaGoodHealth, AreaBadHealth, PlayerGoodHealth, PlayerBadHealth, AreaHappy, PlayerHappy, MaintenanceModifier, GovernmentCentre, FoodKeptPercent,
+                PopulationChange, NoUnhealthinessFromBuildings, NoUnhealthinessFromPopulation, NoUnhappiness
+            };
+
+            explicit CityEffect(Type type_ = None, int value_ = 0, int id_ = -1) : type(type_), id(id_), value(value_), plotCond(NULL) {}
+
+            Type type;
+            int id;  // specialist, domain, unit combat, improvement or religion type, or index into bonusNodes
+            int value;
+            PlotYield yield;  // yield or yield modifier
+            Commerce commerce;  // commerce or commerce modifier
+            CvPlotFnPtr plotCond;
+        };
+
+        struct CityEffects
+        {
+            std::vector<CityEffect> effects;
+            std::vector<BonusNode> bonusNodes;  // depend on the city having the bonus when applied
+        };
+
+        const CityEffects& getCityEffects() const;
+
     private:
         void init_();
 
         BuildingTypes buildingType_;
         PlayerTypes playerType_;
         BuildingInfoNode infoNode_;
+        CityEffects cityEffects_;
     };
 
     // todo - generalise to multiple conditions?
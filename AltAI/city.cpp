@@ -91,6 +91,10 @@ namespace AltAI
     void City::setFlag(int flags)
     {
         flags_ |= flags;
+        if (flags & NeedsProjectionCalcs)
+        {
+            projectionCache_.clear();
+        }
     }
 
     int City::getFlags() const
@@ -340,7 +344,8 @@ namespace AltAI
                         }
 
                         TotalOutputWeights outputWeights = makeOutputW(1, 1, 1, 1, 1, 1);
-                        YieldModifier yieldModifier = pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData);
+                        const CityData& data = *pCityData;
+                        YieldModifier yieldModifier = data.getModifiersHelper()->getTotalYieldModifier(data);
                         CommerceModifier commerceModifier = makeCommerce(100, 100, 100, 100);
 
                         mixedSpecialistTypes = AltAI::getBestSpecialists(player_, yieldModifier, commerceModifier, 4, MixedWeightedOutputOrderFunctor<TotalOutput>(makeTotalOutputPriorities(outputTypes), outputWeights));
@@ -532,6 +537,9 @@ namespace AltAI
 
     void City::calcMaxOutputs_()
     {
+        // cached baselines depend on max outputs and weights via the plot optimiser
+        projectionCache_.clear();
+
         CityDataPtr pCityData = getCityData();
         CityOptimiser opt(pCityData);
         opt.optimise(NO_OUTPUT, CityOptimiser::Not_Set, true);
@@ -1630,6 +1638,11 @@ namespace AltAI
         return pBaseProjectionCityData_;
     }
 
+    ProjectionCache& City::getProjectionCache() const
+    {
+        return projectionCache_;
+    }
+
     void City::write(FDataStreamBase* pStream) const
     {
         constructItem_.write(pStream);
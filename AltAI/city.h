@@ -81,6 +81,7 @@ namespace AltAI
         const ProjectionLadder& getBaseOutputProjection();
         const CityDataPtr& getProjectionCityData();
         const CityDataPtr& getBaseProjectionCityData();
+        ProjectionCache& getProjectionCache() const;
 
         // save/load functions
         void write(FDataStreamBase* pStream) const;
@@ -106,6 +107,7 @@ namespace AltAI
         PlotAssignmentSettings plotAssignmentSettings_;
         ProjectionLadder currentOutputProjection_, baseOutputProjection_;
         CityDataPtr pProjectionCityData_, pBaseProjectionCityData_;
+        mutable ProjectionCache projectionCache_;
 
         int flags_;
         ConstructItem constructItem_;
@@ -503,7 +503,7 @@ namespace AltAI
                     std::vector<IProjectionEventPtr> events;
                     events.push_back(IProjectionEventPtr(new ProjectionGlobalBuildingEvent(pBuildingInfo, buildTime, city.getCvCity())));
 
-                    ProjectionLadder thisCityProjection = getProjectedOutput(*pPlayer, pCityData, numSimTurns, events, ConstructItem(), __FUNCTION__, true);
+                    ProjectionLadder thisCityProjection = getIncrementalProjectedOutput(*pPlayer, pCityData, numSimTurns, events, __FUNCTION__);
                     globalDelta += thisCityProjection.getOutput() - city.getBaseOutputProjection().getOutput();
 
                     /*if (!thisCityProjection.comparisons.empty())
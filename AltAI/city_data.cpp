@@ -37,6 +37,71 @@
 
 namespace AltAI
 {
+    namespace
+    {
+        // helpers are only copied when written to while shared with another city data
+        template <typename HelperPtr>
+            HelperPtr& copyOnWrite(HelperPtr& pHelper)
+        {
+            if (!pHelper.unique())
+            {
+                pHelper = pHelper->clone();
+            }
+            return pHelper;
+        }
+    }
+
+    PlotOutputTable::PlotOutputTable(PlotDataList& plots)
+    {
+        const size_t count = plots.size();
+        coords.reserve(count);
+        outputs.reserve(count);
+        actualOutputs.reserve(count);
+        isWorked.reserve(count);
+        plots_.reserve(count);
+
+        for (PlotDataListIter iter(plots.begin()), endIter(plots.end()); iter != endIter; ++iter)
+        {
+            coords.push_back(iter->coords);
+            outputs.push_back(iter->output);
+            actualOutputs.push_back(iter->actualOutput);
+            isWorked.push_back(iter->isWorked);
+            plots_.push_back(&*iter);
+        }
+    }
+
+    void PlotOutputTable::writeWorked() const
+    {
+        for (size_t i = 0, count = plots_.size(); i < count; ++i)
+        {
+            plots_[i]->isWorked = isWorked[i] != 0;
+        }
+    }
+
+    int PlotOutputTable::findFirstUnworked() const
+    {
+        for (int i = 0, count = size(); i < count; ++i)
+        {
+            if (!isWorked[i])
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    int PlotOutputTable::findLastWorked() const
+    {
+        for (int i = size() - 1; i >= 0; --i)
+        {
+            if (isWorked[i])
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
     CityData::~CityData()
     {
         //ErrorLog::getLog(CvPlayerAI::getPlayer(owner_))->getStream() << "\ndelete CityData at: " << this;
@@ -75,25 +140,95 @@ namespace AltAI
         areaHelper_ = other.areaHelper_;
         civHelper_ = other.civHelper_;
 
-        // copy state of unshared helpers
-        bonusHelper_ = other.bonusHelper_->clone();
-        buildingsHelper_ = other.buildingsHelper_->clone();
-        corporationHelper_ = other.corporationHelper_->clone();
-        cultureHelper_ = other.cultureHelper_->clone();
-        happyHelper_ = other.happyHelper_->clone();
-        healthHelper_ = other.healthHelper_->clone();
-        hurryHelper_ = other.hurryHelper_->clone();
-        maintenanceHelper_ = other.maintenanceHelper_->clone();
-        modifiersHelper_ = other.modifiersHelper_->clone();
-        religionHelper_ = other.religionHelper_->clone();
-        specialistHelper_ = other.specialistHelper_->clone();
-        tradeRouteHelper_ = other.tradeRouteHelper_->clone();
-        unitHelper_ = other.unitHelper_->clone();
-        voteHelper_ = other.voteHelper_->clone();
+        // other helpers are shared until either city data asks for write access (see the get...HelperForWrite() functions)
+        bonusHelper_ = other.bonusHelper_;
+        buildingsHelper_ = other.buildingsHelper_;
+        corporationHelper_ = other.corporationHelper_;
+        cultureHelper_ = other.cultureHelper_;
+        happyHelper_ = other.happyHelper_;
+        healthHelper_ = other.healthHelper_;
+        hurryHelper_ = other.hurryHelper_;
+        maintenanceHelper_ = other.maintenanceHelper_;
+        modifiersHelper_ = other.modifiersHelper_;
+        religionHelper_ = other.religionHelper_;
+        specialistHelper_ = other.specialistHelper_;
+        tradeRouteHelper_ = other.tradeRouteHelper_;
+        unitHelper_ = other.unitHelper_;
+        voteHelper_ = other.voteHelper_;
 
         bestMixedSpecialistTypes_ = other.bestMixedSpecialistTypes_;
     }
 
+    BonusHelperPtr& CityData::getBonusHelperForWrite()
+    {
+        return copyOnWrite(bonusHelper_);
+    }
+
+    BuildingsHelperPtr& CityData::getBuildingsHelperForWrite()
+    {
+        return copyOnWrite(buildingsHelper_);
+    }
+
+    CorporationHelperPtr& CityData::getCorporationHelperForWrite()
+    {
+        return copyOnWrite(corporationHelper_);
+    }
+
+    CultureHelperPtr& CityData::getCultureHelperForWrite()
+    {
+        return copyOnWrite(cultureHelper_);
+    }
+
+    ModifiersHelperPtr& CityData::getModifiersHelperForWrite()
+    {
+        return copyOnWrite(modifiersHelper_);
+    }
+
+    HappyHelperPtr& CityData::getHappyHelperForWrite()
+    {
+        return copyOnWrite(happyHelper_);
+    }
+
+    HealthHelperPtr& CityData::getHealthHelperForWrite()
+    {
+        return copyOnWrite(healthHelper_);
+    }
+
+    HurryHelperPtr& CityData::getHurryHelperForWrite()
+    {
+        return copyOnWrite(hurryHelper_);
+    }
+
+    MaintenanceHelperPtr& CityData::getMaintenanceHelperForWrite()
+    {
+        return copyOnWrite(maintenanceHelper_);
+    }
+
+    ReligionHelperPtr& CityData::getReligionHelperForWrite()
+    {
+        return copyOnWrite(religionHelper_);
+    }
+
+    SpecialistHelperPtr& CityData::getSpecialistHelperForWrite()
+    {
+        return copyOnWrite(specialistHelper_);
+    }
+
+    TradeRouteHelperPtr& CityData::getTradeRouteHelperForWrite()
+    {
+        return copyOnWrite(tradeRouteHelper_);
+    }
+
+    UnitHelperPtr& CityData::getUnitHelperForWrite()
+    {
+        return copyOnWrite(unitHelper_);
+    }
+
+    VoteHelperPtr& CityData::getVoteHelperForWrite()
+    {
+        return copyOnWrite(voteHelper_);
+    }
+
     CityData::CityData(const CvCity* pCity, bool includeUnclaimedPlots, int lookaheadDepth)
         : cityPopulation_(0), workingPopulation_(0), happyCap_(0), currentFood_(0), storedFood_(0),
           accumulatedProduction_(0), growthThreshold_(0), requiredProduction_(-1), foodKeptPercent_(0),
@@ -171,6 +306,14 @@ namespace AltAI
         return copy;
     }
 
+    CityDataPtr CityData::privateClone() const
+    {
+        CityDataPtr copy = clone();
+        copy->areaHelper_ = areaHelper_->clone();
+        copy->civHelper_ = civHelper_->clone();
+        return copy;
+    }
+
     void CityData::calcOutputsFromPlotData_(const CvCity* pCity, int lookaheadDepth)
     {
         boost::shared_ptr<MapAnalysis> pMapAnalysis = gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner())->getAnalysis()->getMapAnalysis();
@@ -366,7 +509,7 @@ namespace AltAI
 
     void CityData::recalcBestSpecialists_()
     {
-        if (!getSpecialistHelper()->getAvailableSpecialistTypes().empty())
+        if (!specialistHelper_->getAvailableSpecialistTypes().empty())
         {
             std::vector<OutputTypes> outputTypes;
             outputTypes.push_back(OUTPUT_PRODUCTION);
@@ -393,7 +536,7 @@ namespace AltAI
 
         if (tradeRouteHelper_->needsRecalc())
         {
-            tradeRouteHelper_->updateTradeRoutes();
+            getTradeRouteHelperForWrite()->updateTradeRoutes();
         }
 
         calcCityOutput_();
@@ -530,7 +673,7 @@ namespace AltAI
 
         updateProduction(1);
 
-        cultureHelper_->advanceTurns(*this, 1);
+        getCultureHelperForWrite()->advanceTurns(*this, 1);
 
         if (accumulatedProduction_ >= requiredProduction_ && !buildQueue_.empty())
         {
@@ -544,7 +687,7 @@ namespace AltAI
             case BuildingItem:
                 {
                     BuildingTypes completedBuilding = (BuildingTypes)buildItem.second;
-                    buildingsHelper_->changeNumRealBuildings(completedBuilding);
+                    getBuildingsHelperForWrite()->changeNumRealBuildings(completedBuilding);
                     events_.push(CitySimulationEventPtr(new TestBuildingBuilt(completedBuilding)));
                     buildQueue_.pop();
                 }
@@ -568,8 +711,8 @@ namespace AltAI
             requiredProduction_ = -1;
         }
 
-        happyHelper_->advanceTurn(*this);
-        healthHelper_->advanceTurn();
+        getHappyHelperForWrite()->advanceTurn(*this);
+        getHealthHelperForWrite()->advanceTurn();
         
         changeWorkingPopulation();
         checkHappyCap();
@@ -628,7 +771,7 @@ namespace AltAI
         if (hurryData.hurryPopulation > 0)
         {
             changePopulation(-hurryData.hurryPopulation);
-            hurryHelper_->updateAngryTimer();
+            getHurryHelperForWrite()->updateAngryTimer();
         }
         
         accumulatedProduction_ = requiredProduction_ + hurryData.extraProduction;
@@ -659,10 +802,10 @@ namespace AltAI
         cityPopulation_ += change;
         cityPopulation_ = std::max<int>(1, cityPopulation_);
 
-        maintenanceHelper_->setPopulation(cityPopulation_);
-        happyHelper_->setPopulation(*this, cityPopulation_);
-        healthHelper_->setPopulation(cityPopulation_);
-        tradeRouteHelper_->setPopulation(cityPopulation_);
+        getMaintenanceHelperForWrite()->setPopulation(cityPopulation_);
+        getHappyHelperForWrite()->setPopulation(*this, cityPopulation_);
+        getHealthHelperForWrite()->setPopulation(cityPopulation_);
+        getTradeRouteHelperForWrite()->setPopulation(cityPopulation_);
         checkHappyCap();
 
         events_.push(CitySimulationEventPtr(new PopChange(change)));
@@ -1180,13 +1323,13 @@ namespace AltAI
 
     void CityData::changePlayerFreeSpecialistSlotCount(int change)
     {
-        specialistHelper_->changePlayerFreeSpecialistSlotCount(change);
+        getSpecialistHelperForWrite()->changePlayerFreeSpecialistSlotCount(change);
         updateFreeSpecialistSlots_(change);
     }
 
     void CityData::changeImprovementFreeSpecialistSlotCount(int change)
     {
-        specialistHelper_->changeImprovementFreeSpecialistSlotCount(change);
+        getSpecialistHelperForWrite()->changeImprovementFreeSpecialistSlotCount(change);
         updateFreeSpecialistSlots_(change);
     }
 
@@ -1201,8 +1344,8 @@ namespace AltAI
                 ++improvementCount;
             }
         }
-        specialistHelper_->changeFreeSpecialistCountPerImprovement(improvementType, change);
-        specialistHelper_->changeImprovementFreeSpecialistSlotCount(change * improvementCount);
+        getSpecialistHelperForWrite()->changeFreeSpecialistCountPerImprovement(improvementType, change);
+        getSpecialistHelperForWrite()->changeImprovementFreeSpecialistSlotCount(change * improvementCount);
         updateFreeSpecialistSlots_(change);
     }
 
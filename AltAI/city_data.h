@@ -60,6 +60,38 @@ namespace AltAI
     typedef boost::shared_ptr<CityData> CityDataPtr;
     typedef boost::shared_ptr<const CityData> ConstCityDataPtr;
 
+    // contiguous copy of the plot fields read by the plot assignment swap loops, in the plot list's order
+    // the rest of each plot's data (plot info, upgrades, culture) is only reachable through getPlot()
+    // isWorked changes are made to the table and copied back to the plots by writeWorked()
+    class PlotOutputTable
+    {
+    public:
+        explicit PlotOutputTable(PlotDataList& plots);
+
+        void writeWorked() const;
+
+        int size() const
+        {
+            return (int)plots_.size();
+        }
+
+        PlotData& getPlot(int index) const
+        {
+            return *plots_[index];
+        }
+
+        // -1 if none
+        int findFirstUnworked() const;
+        int findLastWorked() const;
+
+        std::vector<XYCoords> coords;
+        std::vector<TotalOutput> outputs, actualOutputs;
+        std::vector<char> isWorked;
+
+    private:
+        std::vector<PlotData*> plots_;
+    };
+
     class CityData// : public boost::enable_shared_from_this<CityData>
     {
         friend class CultureHelper;
@@ -73,6 +105,8 @@ namespace AltAI
         void addPlot(const CvPlot* pPlot);
 
         CityDataPtr clone() const;
+        // also copies the area and civ helpers, which clone() shares with the player, so projections from it can run on a worker thread
+        CityDataPtr privateClone() const;
 
         const CvCity* getCity() const
         {
@@ -273,6 +307,10 @@ namespace AltAI
         CitySimulationEventPtr getEvent();
         void pushEvent(const CitySimulationEventPtr& event);
 
+        // helpers other than the area and civ helpers are shared between clones until first accessed through one of
+        // the ForWrite getters, which copy the helper if it is still shared - anything calling a helper's non-const
+        // methods must go through those, the plain getters never copy
+
         AreaHelperPtr& getAreaHelper()
         {
             return areaHelper_;
@@ -283,20 +321,14 @@ namespace AltAI
             return areaHelper_;
         }
 
-        BonusHelperPtr& getBonusHelper()
-        {
-            return bonusHelper_;
-        }
+        BonusHelperPtr& getBonusHelperForWrite();
 
         const BonusHelperPtr& getBonusHelper() const
         {
             return bonusHelper_;
         }
 
-        BuildingsHelperPtr& getBuildingsHelper()
-        {
-            return buildingsHelper_;
-        }
+        BuildingsHelperPtr& getBuildingsHelperForWrite();
 
         const BuildingsHelperPtr& getBuildingsHelper() const
         {
@@ -313,120 +345,84 @@ namespace AltAI
             return civHelper_;
         }
 
-        CorporationHelperPtr& getCorporationHelper()
-        {
-            return corporationHelper_;
-        }
+        CorporationHelperPtr& getCorporationHelperForWrite();
 
         const CorporationHelperPtr& getCorporationHelper() const
         {
             return corporationHelper_;
         }
 
-        CultureHelperPtr& getCultureHelper()
-        {
-            return cultureHelper_;
-        }
+        CultureHelperPtr& getCultureHelperForWrite();
 
         const CultureHelperPtr& getCultureHelper() const
         {
             return cultureHelper_;
         }
 
-        ModifiersHelperPtr& getModifiersHelper()
-        {
-            return modifiersHelper_;
-        }
+        ModifiersHelperPtr& getModifiersHelperForWrite();
 
         const ModifiersHelperPtr& getModifiersHelper() const
         {
             return modifiersHelper_;
         }
 
-        HappyHelperPtr& getHappyHelper()
-        {
-            return happyHelper_;
-        }
+        HappyHelperPtr& getHappyHelperForWrite();
 
         const HappyHelperPtr& getHappyHelper() const
         {
             return happyHelper_;
         }
 
-        HealthHelperPtr& getHealthHelper()
-        {
-            return healthHelper_;
-        }
+        HealthHelperPtr& getHealthHelperForWrite();
 
         const HealthHelperPtr& getHealthHelper() const
         {
             return healthHelper_;
         }
 
-        HurryHelperPtr& getHurryHelper()
-        {
-            return hurryHelper_;
-        }
+        HurryHelperPtr& getHurryHelperForWrite();
 
         const HurryHelperPtr& getHurryHelper() const
         {
             return hurryHelper_;
         }
 
-        MaintenanceHelperPtr& getMaintenanceHelper()
-        {
-            return maintenanceHelper_;
-        }
+        MaintenanceHelperPtr& getMaintenanceHelperForWrite();
 
         const MaintenanceHelperPtr& getMaintenanceHelper() const
         {
             return maintenanceHelper_;
         }
 
-        ReligionHelperPtr& getReligionHelper()
-        {
-            return religionHelper_;
-        }
+        ReligionHelperPtr& getReligionHelperForWrite();
 
         const ReligionHelperPtr& getReligionHelper() const
         {
             return religionHelper_;
         }
 
-        SpecialistHelperPtr& getSpecialistHelper()
-        {
-            return specialistHelper_;
-        }
+        SpecialistHelperPtr& getSpecialistHelperForWrite();
 
         const SpecialistHelperPtr& getSpecialistHelper() const
         {
             return specialistHelper_;
         }
 
-        TradeRouteHelperPtr& getTradeRouteHelper()
-        {
-            return tradeRouteHelper_;
-        }
+        TradeRouteHelperPtr& getTradeRouteHelperForWrite();
 
         const TradeRouteHelperPtr& getTradeRouteHelper() const
         {
             return tradeRouteHelper_;
         }
 
-        UnitHelperPtr& getUnitHelper()
-        {
-            return unitHelper_;
-        }
+        UnitHelperPtr& getUnitHelperForWrite();
 
         const UnitHelperPtr& getUnitHelper() const
         {
             return unitHelper_;
         }
 
-        VoteHelperPtr& getVoteHelper()
-        {
-            return voteHelper_;
-        }
+        VoteHelperPtr& getVoteHelperForWrite();
 
         const VoteHelperPtr& getVoteHelper() const
         {
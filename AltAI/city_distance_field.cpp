@@ -0,0 +1,196 @@
+#include "AltAI.h"
+
+#include "./city_distance_field.h"
+
+namespace AltAI
+{
+    void CityDistanceFieldPlots::init()
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        const int numPlots = theMap.numPlots();
+        if ((int)plotSubAreas_.size() == numPlots)
+        {
+            return;
+        }
+
+        neighbours_.assign(NUM_DIRECTION_TYPES * numPlots, -1);
+        plotSubAreas_.resize(numPlots);
+        subAreaIndices_.resize(numPlots);
+        subAreaPlots_.clear();
+
+        for (int i = 0; i < numPlots; ++i)
+        {
+            const CvPlot* pPlot = theMap.plotByIndex(i);
+            for (int j = 0; j < NUM_DIRECTION_TYPES; ++j)
+            {
+                const CvPlot* pLoopPlot = plotDirection(pPlot->getX(), pPlot->getY(), (DirectionTypes)j);
+                if (pLoopPlot)
+                {
+                    neighbours_[NUM_DIRECTION_TYPES * i + j] = theMap.plotNum(pLoopPlot->getX(), pLoopPlot->getY());
+                }
+            }
+
+            std::vector<int>& subAreaPlots = subAreaPlots_[pPlot->getSubArea()];
+            plotSubAreas_[i] = pPlot->getSubArea();
+            subAreaIndices_[i] = subAreaPlots.size();
+            subAreaPlots.push_back(i);
+        }
+    }
+
+    const std::vector<int>& CityDistanceFieldPlots::getSubAreaPlots(int subArea) const
+    {
+        static const std::vector<int> noPlots;
+        std::map<int, std::vector<int> >::const_iterator plotsIter = subAreaPlots_.find(subArea);
+        return plotsIter == subAreaPlots_.end() ? noPlots : plotsIter->second;
+    }
+
+    CityDistanceField::CityDistanceField(const CityDistanceFieldPlots& plots, int subArea) : pPlots_(&plots), subArea_(subArea)
+    {
+    }
+
+    void CityDistanceField::init(const std::vector<int>& sourceIndices)
+    {
+        const int numPlots = gGlobals.getMap().numPlots();
+        const std::vector<int>& subAreaPlots = pPlots_->getSubAreaPlots(subArea_);
+
+        distance_.assign(subAreaPlots.size(), MAX_INT);
+        closest_.assign(subAreaPlots.size(), -1);
+        sources_.clear();
+
+        // the search has to cross other sub areas (e.g. across a bay) to match step distances, so runs over the whole map,
+        // keeping just this sub area's results at the end
+        std::vector<int> distance(numPlots, MAX_INT), closest(numPlots, -1);
+        std::vector<std::vector<int> > buckets(1);
+        for (size_t i = 0, count = sourceIndices.size(); i < count; ++i)
+        {
+            if (sources_.insert(sourceIndices[i]).second)
+            {
+                distance[sourceIndices[i]] = 0;
+                closest[sourceIndices[i]] = sourceIndices[i];
+                buckets[0].push_back(sourceIndices[i]);
+            }
+        }
+
+        // buckets[d] holds plots reached at distance d
+        for (size_t d = 0; d < buckets.size(); ++d)
+        {
+            for (size_t i = 0; i < buckets[d].size(); ++i)
+            {
+                const int plotIndex = buckets[d][i];
+                for (int j = 0; j < NUM_DIRECTION_TYPES; ++j)
+                {
+                    const int neighbourIndex = pPlots_->getNeighbour(plotIndex, j);
+                    if (neighbourIndex != -1 && distance[neighbourIndex] == MAX_INT)
+                    {
+                        distance[neighbourIndex] = (int)d + 1;
+                        closest[neighbourIndex] = closest[plotIndex];
+
+                        if (d + 1 == buckets.size())
+                        {
+                            buckets.push_back(std::vector<int>());
+                        }
+                        buckets[d + 1].push_back(neighbourIndex);
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0, count = subAreaPlots.size(); i < count; ++i)
+        {
+            distance_[i] = distance[subAreaPlots[i]];
+            closest_[i] = closest[subAreaPlots[i]];
+        }
+    }
+
+    void CityDistanceField::addSource(int plotIndex)
+    {
+        if (!sources_.insert(plotIndex).second)
+        {
+            return;
+        }
+
+        // only plots closer to the new source than to their current closest source change
+        const CvMap& theMap = gGlobals.getMap();
+        const CvPlot* pSourcePlot = theMap.plotByIndex(plotIndex);
+        const std::vector<int>& subAreaPlots = pPlots_->getSubAreaPlots(subArea_);
+
+        for (size_t i = 0, count = subAreaPlots.size(); i < count; ++i)
+        {
+            const CvPlot* pPlot = theMap.plotByIndex(subAreaPlots[i]);
+            const int distance = stepDistance(pSourcePlot->getX(), pSourcePlot->getY(), pPlot->getX(), pPlot->getY());
+            if (distance < distance_[i])
+            {
+                distance_[i] = distance;
+                closest_[i] = plotIndex;
+            }
+        }
+    }
+
+    void CityDistanceField::removeSource(int plotIndex)
+    {
+        if (sources_.erase(plotIndex) == 0)
+        {
+            return;
+        }
+
+        // only the plots the removed source was closest to change - recalculate those from the remaining sources
+        const std::vector<int>& subAreaPlots = pPlots_->getSubAreaPlots(subArea_);
+        for (size_t i = 0, count = closest_.size(); i < count; ++i)
+        {
+            if (closest_[i] == plotIndex)
+            {
+                closest_[i] = findClosestSource_(subAreaPlots[i], distance_[i]);
+            }
+        }
+    }
+
+    bool CityDistanceField::hasSource(int plotIndex) const
+    {
+        return sources_.find(plotIndex) != sources_.end();
+    }
+
+    int CityDistanceField::getDistance(int plotIndex) const
+    {
+        const int index = pPlots_->getSubAreaIndex(plotIndex, subArea_);
+        if (index != -1)
+        {
+            return distance_.empty() ? MAX_INT : distance_[index];
+        }
+
+        int distance;
+        findClosestSource_(plotIndex, distance);
+        return distance;
+    }
+
+    int CityDistanceField::getClosestSource(int plotIndex) const
+    {
+        const int index = pPlots_->getSubAreaIndex(plotIndex, subArea_);
+        if (index != -1)
+        {
+            return closest_.empty() ? -1 : closest_[index];
+        }
+
+        int distance;
+        return findClosestSource_(plotIndex, distance);
+    }
+
+    int CityDistanceField::findClosestSource_(int plotIndex, int& distance) const
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        const CvPlot* pPlot = theMap.plotByIndex(plotIndex);
+
+        int closestSource = -1;
+        distance = MAX_INT;
+        for (std::set<int>::const_iterator si(sources_.begin()), siEnd(sources_.end()); si != siEnd; ++si)
+        {
+            const CvPlot* pSourcePlot = theMap.plotByIndex(*si);
+            const int sourceDistance = stepDistance(pSourcePlot->getX(), pSourcePlot->getY(), pPlot->getX(), pPlot->getY());
+            if (sourceDistance < distance)
+            {
+                distance = sourceDistance;
+                closestSource = *si;
+            }
+        }
+        return closestSource;
+    }
+}
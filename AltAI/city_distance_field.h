@@ -0,0 +1,60 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    // plot tables shared by all of a player's distance fields, built once per map:
+    // each plot's neighbours, and the plots of each sub area with each plot's index in its sub area's list
+    class CityDistanceFieldPlots
+    {
+    public:
+        void init();
+
+        // neighbouring plot number in the given direction, -1 if off the map
+        int getNeighbour(int plotIndex, int direction) const
+        {
+            return neighbours_[NUM_DIRECTION_TYPES * plotIndex + direction];
+        }
+
+        // plot's index in the given sub area's plots, -1 if the plot is in another sub area
+        int getSubAreaIndex(int plotIndex, int subArea) const
+        {
+            return plotSubAreas_[plotIndex] == subArea ? subAreaIndices_[plotIndex] : -1;
+        }
+
+        const std::vector<int>& getSubAreaPlots(int subArea) const;
+
+    private:
+        std::vector<int> neighbours_;  // NUM_DIRECTION_TYPES per plot
+        std::vector<int> plotSubAreas_, subAreaIndices_;  // by plot number
+        std::map<int, std::vector<int> > subAreaPlots_;
+    };
+
+    // step distance from every plot of one sub area to the closest of a set of source plots (e.g. a team's cities), which may lie outside the sub area
+    // built by a multi-source breadth first search over the whole map, so distances match stepDistance() to the closest source,
+    // but only the sub area's plots are kept - indexed through CityDistanceFieldPlots::getSubAreaIndex()
+    // sources can be added and removed without rebuilding the whole field
+    class CityDistanceField
+    {
+    public:
+        CityDistanceField(const CityDistanceFieldPlots& plots, int subArea);
+
+        void init(const std::vector<int>& sourceIndices);
+        void addSource(int plotIndex);
+        void removeSource(int plotIndex);
+
+        bool hasSource(int plotIndex) const;
+        // MAX_INT and -1 if there are no sources - plots outside the sub area are calculated directly from the sources
+        int getDistance(int plotIndex) const;
+        int getClosestSource(int plotIndex) const;
+
+    private:
+        int findClosestSource_(int plotIndex, int& distance) const;
+
+        const CityDistanceFieldPlots* pPlots_;
+        int subArea_;
+        std::vector<int> distance_, closest_;  // by index in the sub area's plots
+        std::set<int> sources_;
+    };
+}
@@ -93,6 +93,11 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionImprovementEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionImprovementEvent::updateCityData(int nTurns)
     {
         if (currentBuildIsComplete_)
@@ -250,6 +255,11 @@ namespace AltAI
         return false;
     }
 
+    bool WorkerBuildEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void WorkerBuildEvent::updateCityData(int nTurns)
     {
         std::vector<std::pair<UnitTypes, std::vector<Unit::WorkerMission> > > missions;
@@ -25,6 +25,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -69,6 +70,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
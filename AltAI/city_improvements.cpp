@@ -655,7 +655,7 @@ namespace AltAI
 
             ConstructItem constructItem;
             const int numSimTurns = player->getAnalysis()->getNumSimTurns();
-            ProjectionLadder base = getProjectedOutput(*gGlobals.getGame().getAltAI()->getPlayer(pCityData->getOwner()), pSimulationCityData, numSimTurns, events, constructItem, __FUNCTION__, false, false);
+            ProjectionLadder base = getIncrementalProjectedOutput(*gGlobals.getGame().getAltAI()->getPlayer(pCityData->getOwner()), pSimulationCityData, numSimTurns, events, __FUNCTION__);
 
             // add all imps
             {
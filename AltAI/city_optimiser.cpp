@@ -31,11 +31,11 @@ namespace AltAI
             return MixedOutputOrderFunctor<PlotYield>(yieldPriority, weights);
         }
 
-        bool PlotWasSwappedOut(const CityOptimiser::SwapData& swapData, const PlotData& plot)
+        bool PlotWasSwappedOut(const CityOptimiser::SwapData& swapData, XYCoords coords)
         {
             for (size_t i = 0, count = swapData.size(); i < count; ++i)
             {
-                if (swapData[i].second.coords == plot.coords)
+                if (swapData[i].second.coords == coords)
                 {
                     return true;
                 }
@@ -43,11 +43,11 @@ namespace AltAI
             return false;
         }
 
-        bool PlotWasSwappedIn(const CityOptimiser::SwapData& swapData, const PlotData& plot)
+        bool PlotWasSwappedIn(const CityOptimiser::SwapData& swapData, XYCoords coords)
         {
             for (size_t i = 0, count = swapData.size(); i < count; ++i)
             {
-                if (swapData[i].first.coords == plot.coords)
+                if (swapData[i].first.coords == coords)
                 {
                     return true;
                 }
@@ -55,6 +55,11 @@ namespace AltAI
             return false;
         }
 
+        CityOptimiser::SwapPlot makeSwapPlot(const PlotOutputTable& plotTable, int index)
+        {
+            return CityOptimiser::SwapPlot(plotTable.coords[index], plotTable.outputs[index]);
+        }
+
         template <typename P>
             struct SpecialFoodOutputOrderF
         {
@@ -67,15 +72,20 @@ namespace AltAI
 
             bool operator() (const PlotData& p1, const PlotData& p2) const
             {
-                if (!(p1.output[OUTPUT_FOOD] == p2.output[OUTPUT_FOOD] ||
-                    (ignoreDeficitFoodDiffs && p1.output[OUTPUT_FOOD] < foodPerPop && p2.output[OUTPUT_FOOD] < foodPerPop)))
+                return (*this)(p1.output, p2.output);
+            }
+
+            bool operator() (const TotalOutput& o1, const TotalOutput& o2) const
+            {
+                if (!(o1[OUTPUT_FOOD] == o2[OUTPUT_FOOD] ||
+                    (ignoreDeficitFoodDiffs && o1[OUTPUT_FOOD] < foodPerPop && o2[OUTPUT_FOOD] < foodPerPop)))
                 {
                     // if plots' food differs or ignore deficit food and both less than food per pop (2) 
-                    return p1.output[OUTPUT_FOOD] > p2.output[OUTPUT_FOOD];
+                    return o1[OUTPUT_FOOD] > o2[OUTPUT_FOOD];
                 }
 
                 // otherwise use predicate to compare whole output
-                return pred(p1.output, p2.output);
+                return pred(o1, o2);
             }
 
             P pred;
@@ -313,9 +323,10 @@ namespace AltAI
         PlayerPtr pPlayer = gGlobals.getGame().getAltAI()->getPlayer(pCity->getOwner());
         bool haveConstructItem = constructItem.buildingType != NO_BUILDING || constructItem.unitType != NO_UNIT || constructItem.processType != NO_PROCESS;
 
-        const int angryPop = pCityData->getHappyHelper()->angryPopulation(*pCityData);
-        const int happyCap = pCityData->getHappyCap();
-        const bool noUnhappiness = pCityData->getHappyHelper()->isNoUnhappiness();
+        const CityData& data = *pCityData;
+        const int angryPop = data.getHappyHelper()->angryPopulation(data);
+        const int happyCap = data.getHappyCap();
+        const bool noUnhappiness = data.getHappyHelper()->isNoUnhappiness();
         const bool canPopRush = pPlayer->getCvPlayer()->canPopRush();
         const int maxResearchRate = pPlayer->getMaxResearchPercent();
         const int cityCount = pPlayer->getCvPlayer()->getNumCities();
@@ -968,7 +979,8 @@ namespace AltAI
         // this is not that likely, as leads to runaway specialist count (if health and happy not issue)
         data_->getFreeSpecOutputs().sort(valueAdaptor);
         PlotDataListIter plotIter = data_->getFreeSpecOutputs().begin();
-        for (int i = 0; i < data_->getSpecialistHelper()->getTotalFreeSpecialistSlotCount(); ++i)
+        const int freeSpecCount = data_->getSpecialistHelper()->getTotalFreeSpecialistSlotCount();
+        for (int i = 0; i < freeSpecCount; ++i)
         {
             plotIter->isWorked = true;
             removeSpecialistSlot_((SpecialistTypes)plotIter->coords.iY);  // used a 'free' slot, so make sure we don't use it again in the main plots' slots
@@ -1122,41 +1134,40 @@ namespace AltAI
 //#endif
 
         SpecialFoodOutputOrderF<ValueAdaptor::Pred> foodP(valueAdaptor.pred);
+        PlotOutputTable plotTable(data_->getPlotOutputs());
 
         while (true)
         {
-            
-            PlotDataListIter endIter = data_->getPlotOutputs().end();
-            std::pair<PlotDataListIter, PlotDataListIter> worstPlots(endIter, endIter);
-            std::pair<PlotDataListIter, PlotDataListIter> bestUnworkedPlots(endIter, endIter);
+            std::pair<int, int> worstPlots(-1, -1);
+            std::pair<int, int> bestUnworkedPlots(-1, -1);
 
-            for (PlotDataListIter iter(data_->getPlotOutputs().begin()); iter != endIter; ++iter)
+            for (int i = 0, count = plotTable.size(); i < count; ++i)
             {
-                if (iter->isWorked)
+                if (plotTable.isWorked[i])
                 {
-                    if (!PlotWasSwappedIn(swapData, *iter))
+                    if (!PlotWasSwappedIn(swapData, plotTable.coords[i]))
                     {
-                        if (worstPlots.first != endIter)
+                        if (worstPlots.first != -1)
                         {
                             worstPlots.second = worstPlots.first;
                         }
-                        worstPlots.first = iter;
+                        worstPlots.first = i;
                     }
                 }
-                else if (bestUnworkedPlots.first == endIter)
+                else if (bestUnworkedPlots.first == -1)
                 {
-                    bestUnworkedPlots.first = iter;
+                    bestUnworkedPlots.first = i;
                 }
-                else if (bestUnworkedPlots.second == endIter || foodP(*iter, *bestUnworkedPlots.second))
+                else if (bestUnworkedPlots.second == -1 || foodP(plotTable.outputs[i], plotTable.outputs[bestUnworkedPlots.second]))
                 {
-                    bestUnworkedPlots.second = iter;
+                    bestUnworkedPlots.second = i;
                 }
             }
 
-            if (worstPlots.first != endIter && worstPlots.second != endIter && bestUnworkedPlots.first != endIter && bestUnworkedPlots.second != endIter)
+            if (worstPlots.first != -1 && worstPlots.second != -1 && bestUnworkedPlots.first != -1 && bestUnworkedPlots.second != -1)
             {
-                TotalOutput workedPlotOuputs[2] = {worstPlots.first->actualOutput, worstPlots.second->actualOutput},
-                            unworkedPlotOutputs[2] = {bestUnworkedPlots.first->actualOutput, bestUnworkedPlots.second->actualOutput};
+                TotalOutput workedPlotOuputs[2] = {plotTable.actualOutputs[worstPlots.first], plotTable.actualOutputs[worstPlots.second]},
+                            unworkedPlotOutputs[2] = {plotTable.actualOutputs[bestUnworkedPlots.first], plotTable.actualOutputs[bestUnworkedPlots.second]};
 
                 TotalOutput worstPlotsOutput = workedPlotOuputs[0] + workedPlotOuputs[1];
                 TotalOutput bestPlotsOutput = unworkedPlotOutputs[0] + unworkedPlotOutputs[1];
@@ -1169,16 +1180,16 @@ namespace AltAI
 //#endif
                     if (!isStrictlyGreater(workedPlotOuputs[0], unworkedPlotOutputs[0]))
                     {
-                        worstPlots.first->isWorked = false;
-                        bestUnworkedPlots.first->isWorked = true;
-                        juggledSwapData.push_back(std::make_pair(*bestUnworkedPlots.first, *worstPlots.first));
+                        plotTable.isWorked[worstPlots.first] = false;
+                        plotTable.isWorked[bestUnworkedPlots.first] = true;
+                        juggledSwapData.push_back(std::make_pair(makeSwapPlot(plotTable, bestUnworkedPlots.first), makeSwapPlot(plotTable, worstPlots.first)));
                     }
 
                     if (!isStrictlyGreater(workedPlotOuputs[1], unworkedPlotOutputs[1]))
                     {
-                        worstPlots.second->isWorked = false;
-                        bestUnworkedPlots.second->isWorked = true;
-                        juggledSwapData.push_back(std::make_pair(*bestUnworkedPlots.second, *worstPlots.second));
+                        plotTable.isWorked[worstPlots.second] = false;
+                        plotTable.isWorked[bestUnworkedPlots.second] = true;
+                        juggledSwapData.push_back(std::make_pair(makeSwapPlot(plotTable, bestUnworkedPlots.second), makeSwapPlot(plotTable, worstPlots.second)));
                     }
                 }
                 else
@@ -1192,6 +1203,8 @@ namespace AltAI
             }
         }
 
+        plotTable.writeWorked();
+
 #ifdef ALTAI_DEBUG
         if (debug)
         {
@@ -1208,8 +1221,6 @@ namespace AltAI
     template <class ValueAdaptor>
         std::pair<int, CityOptimiser::SwapData> CityOptimiser::optimiseOutputs_(ValueAdaptor valueAdaptor)
     {
-        typedef std::list<PlotData>::reverse_iterator PlotDataRIter;
-
         bool ignoreDeficitFoodDiffs = true;
 
         data_->getPlotOutputs().sort(SpecialFoodOutputOrderF<ValueAdaptor::Pred>(valueAdaptor.pred));
@@ -1225,28 +1236,31 @@ namespace AltAI
 
         SwapData swapData;
         int actualYield = data_->getFood();
-        const int plotCount = data_->getPlotOutputs().size();
-        const int maxSwapCount = data_->getPlotOutputs().size() - data_->getWorkingPopulation();
+        PlotOutputTable plotTable(data_->getPlotOutputs());
+        const int maxSwapCount = plotTable.size() - data_->getWorkingPopulation();
         int swapCount = 1;
 
         // try to get actual yield up into our target range by repeatedly swapping worst used value with best unused one
         while (targetYield_.valueBelow(actualYield) && swapCount < maxSwapCount)
         {
-            PlotDataRIter worstWorkedPlotIter = std::find_if(data_->getPlotOutputs().rbegin(), data_->getPlotOutputs().rend(), IsWorked());
-            PlotDataListIter bestUnworkedPlotIter = std::find_if(data_->getPlotOutputs().begin(), data_->getPlotOutputs().end(), Unworked());
-            if (worstWorkedPlotIter == data_->getPlotOutputs().rend() || bestUnworkedPlotIter == data_->getPlotOutputs().end())
+            const int worstWorkedPlotIndex = plotTable.findLastWorked();
+            const int bestUnworkedPlotIndex = plotTable.findFirstUnworked();
+            if (worstWorkedPlotIndex == -1 || bestUnworkedPlotIndex == -1)
             {
                 break;
             }
 
-            if (bestUnworkedPlotIter->actualOutput[OUTPUT_FOOD] > worstWorkedPlotIter->actualOutput[OUTPUT_FOOD])
+            const int worstWorkedFood = plotTable.actualOutputs[worstWorkedPlotIndex][OUTPUT_FOOD];
+            const int bestUnworkedFood = plotTable.actualOutputs[bestUnworkedPlotIndex][OUTPUT_FOOD];
+
+            if (bestUnworkedFood > worstWorkedFood)
             {
-                actualYield = actualYield - worstWorkedPlotIter->actualOutput[OUTPUT_FOOD] + bestUnworkedPlotIter->actualOutput[OUTPUT_FOOD];
+                actualYield = actualYield - worstWorkedFood + bestUnworkedFood;
                 
-                bestUnworkedPlotIter->isWorked = true;
-                worstWorkedPlotIter->isWorked = false;
+                plotTable.isWorked[bestUnworkedPlotIndex] = true;
+                plotTable.isWorked[worstWorkedPlotIndex] = false;
 
-                swapData.push_back(std::make_pair(*bestUnworkedPlotIter, *worstWorkedPlotIter));
+                swapData.push_back(std::make_pair(makeSwapPlot(plotTable, bestUnworkedPlotIndex), makeSwapPlot(plotTable, worstWorkedPlotIndex)));
                 ++swapCount;
             }
             else
@@ -1254,7 +1268,10 @@ namespace AltAI
                 if (ignoreDeficitFoodDiffs)
                 {
                     ignoreDeficitFoodDiffs = false;
+                    // plots' order changes, so rebuild the table from the re-sorted list
+                    plotTable.writeWorked();
                     data_->getPlotOutputs().sort(SpecialFoodOutputOrderF<ValueAdaptor::Pred>(valueAdaptor.pred, false));
+                    plotTable = PlotOutputTable(data_->getPlotOutputs());
                     swapCount = 0;
                 }
                 else
@@ -1264,14 +1281,14 @@ namespace AltAI
             }
         }
 
+        plotTable.writeWorked();
+
         return std::make_pair(actualYield, swapData);
     }
 
     template <class ValueAdaptor>
         std::pair<int, CityOptimiser::SwapData> CityOptimiser::optimiseExcessFood_(ValueAdaptor valueAdaptor)
     {
-        typedef std::list<PlotData>::reverse_iterator PlotDataRIter;
-
         bool ignoreDeficitFoodDiffs = true;
 
         data_->getPlotOutputs().sort(ReverseSpecialFoodOutputOrderF<ValueAdaptor::Pred>(valueAdaptor.pred));
@@ -1287,41 +1304,47 @@ namespace AltAI
 
         SwapData swapData;
         int actualYield = data_->getFood();
-        const int plotCount = data_->getPlotOutputs().size();
-        const int maxSwapCount = data_->getPlotOutputs().size() - data_->getWorkingPopulation();
+        PlotOutputTable plotTable(data_->getPlotOutputs());
+        const int maxSwapCount = plotTable.size() - data_->getWorkingPopulation();
         int swapCount = 1;
 
         // try to get actual yield down into our target range by repeatedly swapping worst (i.e. most food) used value with best unused one
         while (targetYield_.valueAbove(actualYield) && swapCount < maxSwapCount)
         {
-            PlotDataRIter worstWorkedPlotIter = std::find_if(data_->getPlotOutputs().rbegin(), data_->getPlotOutputs().rend(), IsWorked());
+            const int worstWorkedPlotIndex = plotTable.findLastWorked();
+            if (worstWorkedPlotIndex == -1)
+            {
+                break;
+            }
 
-            PlotDataListIter bestUnworkedPlotIter = data_->getPlotOutputs().begin(), endIter = data_->getPlotOutputs().end();
             // e.g. plot we are removing has food yield 6(00) and we are 4(00) over our target (targetYield_.upper), want min yield on replacement plot of 200
-            int minFoodToKeep = std::max<int>(0, worstWorkedPlotIter->output[YIELD_FOOD] - (actualYield - targetYield_.upper));
-            //while (!bestUnworkedPlotIter->isWorked && bestUnworkedPlotIter->output[YIELD_FOOD] < minFoodToKeep && ++bestUnworkedPlotIter != endIter);
-            while (bestUnworkedPlotIter != endIter)
+            const int minFoodToKeep = std::max<int>(0, plotTable.outputs[worstWorkedPlotIndex][YIELD_FOOD] - (actualYield - targetYield_.upper));
+            int bestUnworkedPlotIndex = -1;
+            for (int i = 0, count = plotTable.size(); i < count; ++i)
             {
-                if (!bestUnworkedPlotIter->isWorked && bestUnworkedPlotIter->output[YIELD_FOOD] >= minFoodToKeep)
+                if (!plotTable.isWorked[i] && plotTable.outputs[i][YIELD_FOOD] >= minFoodToKeep)
                 {
+                    bestUnworkedPlotIndex = i;
                     break;
                 }
-                ++bestUnworkedPlotIter;
             }
 
-            if (worstWorkedPlotIter == data_->getPlotOutputs().rend() || bestUnworkedPlotIter == endIter)
+            if (bestUnworkedPlotIndex == -1)
             {
                 break;
             }
 
-            if (bestUnworkedPlotIter->actualOutput[OUTPUT_FOOD] < worstWorkedPlotIter->actualOutput[OUTPUT_FOOD])
+            const int worstWorkedFood = plotTable.actualOutputs[worstWorkedPlotIndex][OUTPUT_FOOD];
+            const int bestUnworkedFood = plotTable.actualOutputs[bestUnworkedPlotIndex][OUTPUT_FOOD];
+
+            if (bestUnworkedFood < worstWorkedFood)
             {
-                actualYield = actualYield - worstWorkedPlotIter->actualOutput[OUTPUT_FOOD] + bestUnworkedPlotIter->actualOutput[OUTPUT_FOOD];
+                actualYield = actualYield - worstWorkedFood + bestUnworkedFood;
                 
-                bestUnworkedPlotIter->isWorked = true;
-                worstWorkedPlotIter->isWorked = false;
+                plotTable.isWorked[bestUnworkedPlotIndex] = true;
+                plotTable.isWorked[worstWorkedPlotIndex] = false;
 
-                swapData.push_back(std::make_pair(*bestUnworkedPlotIter, *worstWorkedPlotIter));
+                swapData.push_back(std::make_pair(makeSwapPlot(plotTable, bestUnworkedPlotIndex), makeSwapPlot(plotTable, worstWorkedPlotIndex)));
                 ++swapCount;
             }
             else
@@ -1330,6 +1353,8 @@ namespace AltAI
             }
         }
 
+        plotTable.writeWorked();
+
         return std::make_pair(actualYield, swapData);
     }
 
@@ -1406,7 +1431,7 @@ namespace AltAI
     {
         int requiredYield = 100 * data_->getPopulation() * foodPerPop_ + data_->getLostFood();
         const int maxFood = getMaxFood();
-        const int angryPop = data_->getHappyHelper()->angryPopulation(*data_);
+        const int angryPop = data_->angryPopulation();
 
         if (growthType == Not_Set)
         {
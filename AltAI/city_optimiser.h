@@ -48,7 +48,18 @@ namespace AltAI
         void debug(std::ostream& os, bool printAllPlots = true) const;
         static std::string getGrowthTypeString(GrowthType growthType);
 
-        typedef std::vector<std::pair<PlotData, PlotData> > SwapData;
+        // coords and output of a plot swapped in or out of the worked plots
+        struct SwapPlot
+        {
+            SwapPlot() {}
+            SwapPlot(XYCoords coords_, TotalOutput output_) : coords(coords_), output(output_) {}
+
+            XYCoords coords;
+            TotalOutput output;
+        };
+
+        // (plot swapped in, plot swapped out)
+        typedef std::vector<std::pair<SwapPlot, SwapPlot> > SwapData;
 
     private:
 
@@ -12,12 +12,16 @@
 #include "./culture_helper.h"
 #include "./modifiers_helper.h"
 #include "./happy_helper.h"
+#include "./health_helper.h"
 #include "./unit_helper.h"
 #include "./civ_helper.h"
+#include "./religion_helper.h"
+#include "./specialist_helper.h"
 #include "./buildings_info.h"
 #include "./civic_info.h"
 #include "./unit_info.h"
 #include "./civ_log.h"
+#include "./profiler.h"
 
 namespace AltAI
 {
@@ -31,8 +35,150 @@ namespace AltAI
             }
         };
 
-        void updateProjections(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events, 
-            const ConstructItem& constructItem, const bool doComparison, const bool debug, ProjectionLadder& ladder)
+        void addStandardEvents(std::vector<IProjectionEventPtr>& events)
+        {
+            events.push_back(IProjectionEventPtr(new ProjectionPopulationEvent()));
+            events.push_back(IProjectionEventPtr(new ProjectionCultureLevelEvent()));
+            events.push_back(IProjectionEventPtr(new ProjectionImprovementUpgradeEvent()));
+            events.push_back(IProjectionEventPtr(new ProjectionHappyTimerEvent()));
+        }
+
+        void addPlotsToKey(ProjectionCache::Key& key, const PlotDataList& plots)
+        {
+            key.push_back((int)plots.size());
+            for (PlotDataListConstIter iter(plots.begin()), endIter(plots.end()); iter != endIter; ++iter)
+            {
+                key.push_back(iter->coords.iX);
+                key.push_back(iter->coords.iY);
+                key.push_back(iter->improvementType);
+                key.push_back(iter->featureType);
+                key.push_back((iter->isWorked ? 1 : 0) | (iter->ableToWork ? 2 : 0) | (iter->controlled ? 4 : 0));
+                key.insert(key.end(), iter->plotYield.data.begin(), iter->plotYield.data.end());
+                key.insert(key.end(), iter->output.data.begin(), iter->output.data.end());
+                key.push_back(iter->greatPersonOutput.unitType);
+                key.push_back(iter->greatPersonOutput.output);
+                key.push_back(iter->upgradeData.upgrades.empty() ? -MAX_INT : iter->upgradeData.upgrades.begin()->remainingTurns);
+            }
+        }
+
+        // everything in the city data and player which feeds into a baseline projection:
+        // the simulated city state itself, plus the player level inputs to the plot assignment settings
+        ProjectionCache::Key makeProjectionKey(const Player& player, const CityDataPtr& pCityData, int nTurns)
+        {
+            const CityData& data = *pCityData;
+            ProjectionCache::Key key;
+            const CvCity* pCity = data.getCity();
+
+            CvPlayerAI& cvPlayer = CvPlayerAI::getPlayer(pCity->getOwner());
+
+            key.push_back(nTurns);
+            key.push_back(cvPlayer.getNumCities());
+            key.push_back(cvPlayer.canPopRush() ? 1 : 0);
+            key.push_back(player.getMaxResearchPercent());
+            key.push_back(CvTeamAI::getTeam(pCity->getTeam()).getAnyWarPlanCount(true));
+            key.push_back(CvTeamAI::getTeam(pCity->getTeam()).getAtWarCount(true));
+            key.push_back(cvPlayer.AI_getPlotDanger(pCity->plot(), 3) > 0 ? 1 : 0);
+
+            key.push_back(data.getPopulation());
+            key.push_back(data.getWorkingPopulation());
+            key.push_back(data.getHappyCap());
+            key.push_back(data.getCurrentFood());
+            key.push_back(data.getStoredFood());
+            key.push_back(data.getFoodKeptPercent());
+            key.push_back(data.getGrowthThreshold());
+            key.push_back(data.getRequiredProduction());
+            key.push_back(data.getAccumulatedProduction());
+            key.push_back(data.getCommerceYieldModifier());
+            key.push_back(data.getGoldenAgeTurns());
+            key.push_back((int)data.getBuildQueue().size());
+
+            const TotalOutput output = data.getOutput(), processOutput = data.getProcessOutput();
+            key.insert(key.end(), output.data.begin(), output.data.end());
+            key.insert(key.end(), processOutput.data.begin(), processOutput.data.end());
+            const CommerceModifier commercePercent = data.getCommercePercent();
+            key.insert(key.end(), commercePercent.data.begin(), commercePercent.data.end());
+
+            key.push_back(data.getLostFood());
+            key.push_back(data.getSpecialistSlotCount());
+            key.push_back(data.getHappyHelper()->happyPopulation(data));
+            key.push_back(data.getHappyHelper()->angryPopulation(data));
+            key.push_back(data.getHealthHelper()->goodHealth());
+            key.push_back(data.getHealthHelper()->badHealth());
+            key.push_back(data.getMaintenanceHelper()->getMaintenance());
+            key.push_back(data.getCultureHelper()->getCultureLevel());
+            key.push_back(data.getCultureHelper()->getTurnsToNextLevel(data));
+            key.push_back(data.getHurryHelper()->getAngryTimer());
+
+            // buildings (only those present, as type/count pairs)
+            const BuildingsHelperPtr& pBuildingsHelper = data.getBuildingsHelper();
+            for (int i = 0, count = gGlobals.getNumBuildingInfos(); i < count; ++i)
+            {
+                const int numBuildings = pBuildingsHelper->getNumBuildings((BuildingTypes)i);
+                if (numBuildings > 0)
+                {
+                    key.push_back(i);
+                    key.push_back(numBuildings);
+                    key.push_back(pBuildingsHelper->getNumActiveBuildings((BuildingTypes)i));
+                }
+            }
+            key.push_back(-1);
+
+            // specialists - assigned slots are in the plot outputs, so just the limits and gpp modifiers here
+            const SpecialistHelperPtr& pSpecialistHelper = data.getSpecialistHelper();
+            for (int i = 0, count = gGlobals.getNumSpecialistInfos(); i < count; ++i)
+            {
+                key.push_back(pSpecialistHelper->getMaxSpecialistCount((SpecialistTypes)i));
+                key.push_back(pSpecialistHelper->getFreeSpecialistCount((SpecialistTypes)i));
+            }
+            key.push_back(pSpecialistHelper->getTotalFreeSpecialistSlotCount());
+            key.push_back(pSpecialistHelper->getPlayerGPPModifier());
+            key.push_back(pSpecialistHelper->getCityGPPModifier());
+            key.push_back(pSpecialistHelper->getStateReligionGPPModifier());
+
+            // religions
+            const ReligionHelperPtr& pReligionHelper = data.getReligionHelper();
+            key.push_back(pReligionHelper->getStateReligion());
+            for (int i = 0, count = gGlobals.getNumReligionInfos(); i < count; ++i)
+            {
+                key.push_back(pReligionHelper->getReligionCount((ReligionTypes)i));
+                key.push_back(pReligionHelper->isHasReligion((ReligionTypes)i) ? 1 : 0);
+            }
+
+            const GreatPersonOutputMap gpp = data.getGPP();
+            for (GreatPersonOutputMap::const_iterator ci(gpp.begin()), ciEnd(gpp.end()); ci != ciEnd; ++ci)
+            {
+                key.push_back(ci->first);
+                key.push_back(ci->second);
+            }
+
+            // civ helper state is shared with the player and temporarily changed by some callers, so include it
+            const std::vector<CivicTypes>& civics = data.getCivHelper()->getCurrentCivics();
+            key.insert(key.end(), civics.begin(), civics.end());
+
+            int techBits = 0;
+            for (int i = 0, count = gGlobals.getNumTechInfos(); i < count; ++i)
+            {
+                if (data.getCivHelper()->hasTech((TechTypes)i))
+                {
+                    techBits |= 1 << (i % 31);
+                }
+                if (i % 31 == 30 || i == count - 1)
+                {
+                    key.push_back(techBits);
+                    techBits = 0;
+                }
+            }
+
+            addPlotsToKey(key, data.getPlotOutputs());
+            addPlotsToKey(key, data.getUnworkablePlots());
+            addPlotsToKey(key, data.getFreeSpecOutputs());
+
+            return key;
+        }
+
+        void updateProjections(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events,
+            const ConstructItem& constructItem, const bool doComparison, const bool debug, ProjectionLadder& ladder,
+            std::vector<ProjectionCache::Step>* pSteps = NULL)
         {
 #ifdef ALTAI_DEBUG
             std::ostream& os = CivLog::getLog(CvPlayerAI::getPlayer(pCityData->getOwner()))->getStream();
@@ -49,6 +195,11 @@ namespace AltAI
 
             while (nTurns > 0)
             {
+                if (pSteps)
+                {
+                    pSteps->push_back(ProjectionCache::Step(pCityData->clone()));
+                }
+
                 player.getCity(pCityData->getCity()->getID()).optimisePlots(pCityData, constructItem);
                 //outputPriorities = makeSimpleOutputPriorities(pCityData);
                 //cityOptimiser.optimise(outputPriorities);
@@ -58,9 +209,14 @@ namespace AltAI
                     //os << " target yield = " << cityOptimiser.getTargetYield();
                 //}
 #endif
-                std::sort(events.begin(), events.end(), EventTimeOrderF());
+                // stable sort so the relative order of the standard events doesn't depend on any additional events
+                std::stable_sort(events.begin(), events.end(), EventTimeOrderF());
 
                 int turnsToFirstEvent = (events.empty() ? MAX_INT : events[0]->getTurnsToEvent());
+                if (pSteps)
+                {
+                    pSteps->rbegin()->turnsToFirstEvent = turnsToFirstEvent;
+                }
 #ifdef ALTAI_DEBUG
                 std::ostringstream oss;
                 if (debug)
@@ -372,6 +528,11 @@ namespace AltAI
         return true;
     }
 
+    bool ProjectionBuildingEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionBuildingEvent::updateCityData(int nTurns)
     {
         // todo - handle overflow properly here, including from hurrying
@@ -382,7 +543,7 @@ namespace AltAI
 
         if (pCityData_->getRequiredProduction() - pCityData_->getAccumulatedProduction() <= 0)
         {
-            pCityData_->getBuildingsHelper()->changeNumRealBuildings(pBuildingInfo_->getBuildingType());
+            pCityData_->getBuildingsHelperForWrite()->changeNumRealBuildings(pBuildingInfo_->getBuildingType());
             updateRequestData(*pCityData_, pBuildingInfo_);
             pCityData_->clearBuildQueue();
         }
@@ -481,6 +642,11 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionUnitEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionUnitEvent::updateCityData(int nTurns)
     {
         pCityData_->updateProduction(nTurns);
@@ -555,6 +721,11 @@ namespace AltAI
         return true;
     }
 
+    bool ProjectionGlobalBuildingEvent::isFixedTurnEvent() const
+    {
+        return true;
+    }
+
     void ProjectionGlobalBuildingEvent::updateCityData(int nTurns)
     {
         if (complete_)
@@ -612,6 +783,11 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionPopulationEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionPopulationEvent::updateCityData(int nTurns)
     {
     }
@@ -654,13 +830,15 @@ namespace AltAI
 
     void ProjectionCultureLevelEvent::debug(std::ostream& os) const
     {
-        os << "\n\tProjectionCultureLevelEvent event - level = " << (int)pCityData_->getCultureHelper()->getCultureLevel()
-            << " turns left = " << pCityData_->getCultureHelper()->getTurnsToNextLevel(*pCityData_);
+        const CityData& data = *pCityData_;
+        os << "\n\tProjectionCultureLevelEvent event - level = " << (int)data.getCultureHelper()->getCultureLevel()
+            << " turns left = " << data.getCultureHelper()->getTurnsToNextLevel(data);
     }
 
     int ProjectionCultureLevelEvent::getTurnsToEvent() const
     {
-        return pCityData_->getCultureHelper()->getTurnsToNextLevel(*pCityData_);
+        const CityData& data = *pCityData_;
+        return data.getCultureHelper()->getTurnsToNextLevel(data);
     }
     
     bool ProjectionCultureLevelEvent::targetsCity(IDInfo city) const
@@ -673,9 +851,14 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionCultureLevelEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionCultureLevelEvent::updateCityData(int nTurns)
     {
-        pCityData_->getCultureHelper()->advanceTurns(*pCityData_, nTurns);
+        pCityData_->getCultureHelperForWrite()->advanceTurns(*pCityData_, nTurns);
     }
 
     IProjectionEventPtr ProjectionCultureLevelEvent::updateEvent(int nTurns, ProjectionLadder& ladder)
@@ -716,6 +899,11 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionImprovementUpgradeEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionImprovementUpgradeEvent::updateCityData(int nTurns)
     {
         pCityData_->doImprovementUpgrades(nTurns);
@@ -767,6 +955,11 @@ namespace AltAI
         return true;
     }
 
+    bool ProjectionChangeCivicEvent::isFixedTurnEvent() const
+    {
+        return true;
+    }
+
     void ProjectionChangeCivicEvent::updateCityData(int nTurns)
     {
         if (turnsToChange_ <= nTurns)
@@ -810,10 +1003,11 @@ namespace AltAI
 
     int ProjectionHappyTimerEvent::getTurnsToEvent() const
     {
-        const int hurryAngerTimer = pCityData_->getHurryHelper()->getAngryTimer();
+        const HurryHelperPtr& pHurryHelper = pCityData_->getHurryHelper();
+        const int hurryAngerTimer = pHurryHelper->getAngryTimer();
         if (hurryAngerTimer > 0)
         {
-            const int flatHurryAngerLength = pCityData_->getHurryHelper()->getFlatHurryAngryLength();
+            const int flatHurryAngerLength = pHurryHelper->getFlatHurryAngryLength();
             return hurryAngerTimer / flatHurryAngerLength + hurryAngerTimer % flatHurryAngerLength;
         }
         else
@@ -832,9 +1026,14 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionHappyTimerEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionHappyTimerEvent::updateCityData(int nTurns)
     {
-        pCityData_->getHurryHelper()->advanceTurns(nTurns);
+        pCityData_->getHurryHelperForWrite()->advanceTurns(nTurns);
         pCityData_->changeWorkingPopulation();
     }
 
@@ -871,8 +1070,9 @@ namespace AltAI
         {            
             if (!angryTimerExpired_())
             {
-                const int hurryAngerTimer = pCityData_->getHurryHelper()->getAngryTimer();
-                const int flatHurryAngerLength = pCityData_->getHurryHelper()->getFlatHurryAngryLength();
+                const HurryHelperPtr& pHurryHelper = pCityData_->getHurryHelper();
+                const int hurryAngerTimer = pHurryHelper->getAngryTimer();
+                const int flatHurryAngerLength = pHurryHelper->getFlatHurryAngryLength();
                 return hurryAngerTimer / flatHurryAngerLength + hurryAngerTimer % flatHurryAngerLength;
             }
             else
@@ -892,6 +1092,11 @@ namespace AltAI
         return false;
     }
 
+    bool ProjectionHurryEvent::isFixedTurnEvent() const
+    {
+        return false;
+    }
+
     void ProjectionHurryEvent::updateCityData(int nTurns)
     {
         if (havePopulation_() && angryTimerExpired_())
@@ -903,7 +1108,8 @@ namespace AltAI
                 pCityData_->setAccumulatedProduction(100);
 
                 bool canHurry;
-                boost::tie(canHurry, hurryData_) = pCityData_->getHurryHelper()->canHurry(*pCityData_, hurryData_.hurryType, true);
+                const CityData& data = *pCityData_;
+                boost::tie(canHurry, hurryData_) = data.getHurryHelper()->canHurry(data, hurryData_.hurryType, true);
                 if (canHurry)
                 {
                     pCityData_->hurry(hurryData_);
@@ -930,10 +1136,9 @@ namespace AltAI
     ProjectionLadder getProjectedOutput(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events, 
         const ConstructItem& constructItem, const std::string& sourceFunc, bool doComparison, bool debug)
     {
-        events.push_back(IProjectionEventPtr(new ProjectionPopulationEvent()));
-        events.push_back(IProjectionEventPtr(new ProjectionCultureLevelEvent()));
-        events.push_back(IProjectionEventPtr(new ProjectionImprovementUpgradeEvent()));
-        events.push_back(IProjectionEventPtr(new ProjectionHappyTimerEvent()));
+        ProfileScope profileScope("getProjectedOutput", player.getPlayerID());
+
+        addStandardEvents(events);
 
 #ifdef ALTAI_DEBUG
 //        if (debug)
@@ -981,4 +1186,132 @@ namespace AltAI
 #endif
         return ladder;
     }
+
+    ProjectionCache::ProjectionCache() : turn_(-1)
+    {
+    }
+
+    void ProjectionCache::clear()
+    {
+        CriticalSectionLock lock(cacheLock_);
+        baselines_.clear();
+    }
+
+    ProjectionCache::BaselinePtr ProjectionCache::getBaseline(const Key& key)
+    {
+        CriticalSectionLock lock(cacheLock_);
+        checkTurn_();
+        BaselineMap::const_iterator ci = baselines_.find(key);
+        return ci == baselines_.end() ? BaselinePtr() : ci->second;
+    }
+
+    void ProjectionCache::addBaseline(const Key& key, const BaselinePtr& pBaseline)
+    {
+        CriticalSectionLock lock(cacheLock_);
+        checkTurn_();
+        // each baseline holds a city data snapshot per step, so keep the number of them bounded
+        if (baselines_.size() >= MaxBaselines)
+        {
+            baselines_.clear();
+        }
+        baselines_[key] = pBaseline;
+    }
+
+    void ProjectionCache::checkTurn_()
+    {
+        const int currentTurn = gGlobals.getGame().getGameTurn();
+        if (currentTurn != turn_)
+        {
+            baselines_.clear();
+            turn_ = currentTurn;
+        }
+    }
+
+    ProjectionLadder getIncrementalProjectedOutput(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events,
+        const std::string& sourceFunc)
+    {
+        for (size_t i = 0, count = events.size(); i < count; ++i)
+        {
+            if (!events[i]->isFixedTurnEvent())
+            {
+                return getProjectedOutput(player, pCityData, nTurns, events, ConstructItem(), sourceFunc);
+            }
+        }
+
+        ProjectionCache& projectionCache = player.getCity(pCityData->getCity()->getID()).getProjectionCache();
+
+        const ProjectionCache::Key key = makeProjectionKey(player, pCityData, nTurns);
+        ProjectionCache::BaselinePtr pBaseline = projectionCache.getBaseline(key);
+
+        if (!pBaseline)
+        {
+            // two threads may both build the same baseline, in which case the second to finish replaces the first
+            boost::shared_ptr<ProjectionCache::Baseline> pNewBaseline(new ProjectionCache::Baseline());
+            ProjectionCache::Baseline& baseline = *pNewBaseline;
+            CityDataPtr pBaselineCityData = pCityData->clone();
+            std::vector<IProjectionEventPtr> baselineEvents;
+            addStandardEvents(baselineEvents);
+            for (size_t i = 0, count = baselineEvents.size(); i < count; ++i)
+            {
+                baselineEvents[i]->init(pBaselineCityData);
+            }
+
+            updateProjections(player, pBaselineCityData, nTurns, baselineEvents, ConstructItem(), false, false, baseline.ladder, &baseline.steps);
+            projectionCache.addBaseline(key, pNewBaseline);
+            pBaseline = pNewBaseline;
+        }
+
+        for (size_t i = 0, count = events.size(); i < count; ++i)
+        {
+            events[i]->init(pCityData);
+        }
+
+        // find the first step in which one of the events fires - up to then the projection matches the baseline
+        // (the events only count down their turns whilst they are waiting to fire)
+        const std::vector<ProjectionCache::Step>& steps = pBaseline->steps;
+        ProjectionLadder scratchLadder;
+        int remainingTurns = nTurns;
+        size_t stepIndex = 0;
+
+        for (size_t stepCount = steps.size(); stepIndex < stepCount; ++stepIndex)
+        {
+            const int stepTurns = std::min<int>(remainingTurns, steps[stepIndex].turnsToFirstEvent);
+
+            int turnsToFirstEvent = MAX_INT;
+            for (size_t i = 0, count = events.size(); i < count; ++i)
+            {
+                turnsToFirstEvent = std::min<int>(turnsToFirstEvent, events[i]->getTurnsToEvent());
+            }
+
+            if (turnsToFirstEvent <= stepTurns)
+            {
+                break;
+            }
+
+            for (size_t i = 0, count = events.size(); i < count; ++i)
+            {
+                events[i] = events[i]->updateEvent(stepTurns, scratchLadder);
+            }
+            remainingTurns -= steps[stepIndex].turnsToFirstEvent;
+        }
+
+        if (stepIndex == steps.size())
+        {
+            return pBaseline->ladder;
+        }
+
+        ProjectionLadder ladder;
+        ladder.entries.assign(pBaseline->ladder.entries.begin(), pBaseline->ladder.entries.begin() + stepIndex);
+
+        CityDataPtr pResumeCityData = steps[stepIndex].pCityData->clone();
+        addStandardEvents(events);
+        for (size_t i = 0, count = events.size(); i < count; ++i)
+        {
+            events[i]->init(pResumeCityData);
+        }
+
+        updateProjections(player, pResumeCityData, remainingTurns, events, ConstructItem(), false, false, ladder);
+
+        return ladder;
+    }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "./utils.h"
 #include "./tactic_actions.h"
 #include "./city_projections_ladder.h"
+#include "./worker_pool.h"
 
 namespace AltAI
 {
@@ -26,6 +27,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -42,6 +44,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -58,6 +61,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -77,6 +81,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -100,6 +105,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -124,6 +130,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -146,6 +153,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -165,6 +173,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -182,6 +191,7 @@ namespace AltAI
         virtual int getTurnsToEvent() const;
         virtual bool targetsCity(IDInfo city) const;
         virtual bool generateComparison() const;
+        virtual bool isFixedTurnEvent() const;
         virtual void updateCityData(int nTurns);
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder);
 
@@ -195,6 +205,57 @@ namespace AltAI
 	struct IProjectionEvent;
     typedef boost::shared_ptr<IProjectionEvent> IProjectionEventPtr;
 
-    ProjectionLadder getProjectedOutput(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events, 
+    ProjectionLadder getProjectedOutput(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events,
         const ConstructItem& constructItem, const std::string& sourceFunc, bool doComparison = false, bool debug = false);
+
+    // per city store of baseline projections (no construct item and only the standard events), valid for the current turn
+    // keyed by the CityData state (and player state used by the plot optimiser) which determines the ladder
+    // each baseline keeps a snapshot of the city data at the start of each ladder step, so projections which only add
+    // fixed turn events can be re-simulated from the step in which the first of those events fires
+    // cities' caches are filled from other cities' tactics (e.g. global building deltas), which may run on worker
+    // threads - so access is locked and baselines are handed out as shared ptrs which outlive any later clear
+    class ProjectionCache
+    {
+    public:
+        typedef std::vector<int> Key;
+
+        struct Step
+        {
+            Step() : turnsToFirstEvent(MAX_INT) {}
+            explicit Step(const CityDataPtr& pCityData_) : pCityData(pCityData_), turnsToFirstEvent(MAX_INT) {}
+
+            CityDataPtr pCityData;
+            int turnsToFirstEvent;
+        };
+
+        struct Baseline
+        {
+            ProjectionLadder ladder;
+            std::vector<Step> steps;
+        };
+        typedef boost::shared_ptr<const Baseline> BaselinePtr;
+
+        ProjectionCache();
+
+        void clear();
+
+        BaselinePtr getBaseline(const Key& key);
+        void addBaseline(const Key& key, const BaselinePtr& pBaseline);
+
+    private:
+        void checkTurn_();
+
+        static const size_t MaxBaselines = 8;
+
+        typedef std::map<Key, BaselinePtr> BaselineMap;
+        BaselineMap baselines_;
+        int turn_;
+        CriticalSection cacheLock_;
+    };
+
+    // as getProjectedOutput with an empty construct item, but reuses the city's cached baseline ladder for the steps
+    // before any of the passed events fires - falls back to a full projection if any event is not a fixed turn event
+    // unlike getProjectedOutput, pCityData is not guaranteed to be advanced to the end of the projection
+    ProjectionLadder getIncrementalProjectedOutput(const Player& player, const CityDataPtr& pCityData, int nTurns, std::vector<IProjectionEventPtr>& events,
+        const std::string& sourceFunc);
 }
\ No newline at end of file
@@ -119,6 +119,8 @@ namespace AltAI
         virtual int getTurnsToEvent() const = 0;
         virtual bool targetsCity(IDInfo city) const = 0;
         virtual bool generateComparison() const = 0;
+        // true if the event fires after a fixed number of turns and leaves the city data untouched until then
+        virtual bool isFixedTurnEvent() const = 0;
         virtual void updateCityData(int nTurns) = 0;
         virtual IProjectionEventPtr updateEvent(int nTurns, ProjectionLadder& ladder) = 0;
     };    
@@ -34,7 +34,7 @@ namespace AltAI
             {
                 if (node.health != 0)
                 {
-                    data_.getHealthHelper()->changePlayerHealthiness(isAdding_ ? node.health : -node.health);
+                    data_.getHealthHelperForWrite()->changePlayerHealthiness(isAdding_ ? node.health : -node.health);
                 }
 
                 for (size_t i = 0, count = node.nodes.size(); i < count; ++i)
@@ -52,20 +52,20 @@ namespace AltAI
                     {
                         if (node.happy > 0)
                         {
-                            data_.getHappyHelper()->changeExtraBuildingGoodHappiness(isAdding_ ? numBuildings * node.happy : -numBuildings * node.happy);
+                            data_.getHappyHelperForWrite()->changeExtraBuildingGoodHappiness(isAdding_ ? numBuildings * node.happy : -numBuildings * node.happy);
                         }
                         else if (node.happy < 0)
                         {
-                            data_.getHappyHelper()->changeExtraBuildingBadHappiness(isAdding_ ? numBuildings * node.happy : -numBuildings * node.happy);
+                            data_.getHappyHelperForWrite()->changeExtraBuildingBadHappiness(isAdding_ ? numBuildings * node.happy : -numBuildings * node.happy);
                         }
 
                         if (node.health > 0)
                         {
-                            data_.getHealthHelper()->changeExtraBuildingGoodHealthiness(isAdding_ ? numBuildings * node.health : -numBuildings * node.health);
+                            data_.getHealthHelperForWrite()->changeExtraBuildingGoodHealthiness(isAdding_ ? numBuildings * node.health : -numBuildings * node.health);
                         }
                         else if (node.health < 0)
                         {
-                            data_.getHealthHelper()->changeExtraBuildingBadHealthiness(isAdding_ ? numBuildings * node.health : -numBuildings * node.health);
+                            data_.getHealthHelperForWrite()->changeExtraBuildingBadHealthiness(isAdding_ ? numBuildings * node.health : -numBuildings * node.health);
                         }
                     }
                 }
@@ -100,11 +100,11 @@ namespace AltAI
                         {
                             if (node.featureTypeAndHappyChanges[i].second > 0)
                             {
-                                data_.getHappyHelper()->changeFeatureGoodHappiness(isAdding_ ? node.featureTypeAndHappyChanges[i].second : -node.featureTypeAndHappyChanges[i].second);
+                                data_.getHappyHelperForWrite()->changeFeatureGoodHappiness(isAdding_ ? node.featureTypeAndHappyChanges[i].second : -node.featureTypeAndHappyChanges[i].second);
                             }
                             else if (node.featureTypeAndHappyChanges[i].second < 0)
                             {
-                                data_.getHappyHelper()->changeFeatureBadHappiness(isAdding_ ? node.featureTypeAndHappyChanges[i].second : -node.featureTypeAndHappyChanges[i].second);
+                                data_.getHappyHelperForWrite()->changeFeatureBadHappiness(isAdding_ ? node.featureTypeAndHappyChanges[i].second : -node.featureTypeAndHappyChanges[i].second);
                             }
                         }
                     }
@@ -133,7 +133,7 @@ namespace AltAI
                     {
                         data_.changeCommerceYieldModifier(isAdding_ ? node.yieldModifier[YIELD_COMMERCE] : -node.yieldModifier[YIELD_COMMERCE]);
                     }
-                    data_.getModifiersHelper()->changePlayerYieldModifier(isAdding_ ? node.yieldModifier : -node.yieldModifier);
+                    data_.getModifiersHelperForWrite()->changePlayerYieldModifier(isAdding_ ? node.yieldModifier : -node.yieldModifier);
                 }
 
                 if (!isEmpty(node.capitalYieldModifier) && data_.getCity()->isCapital())
@@ -143,7 +143,7 @@ namespace AltAI
                     {
                         data_.changeCommerceYieldModifier(isAdding_ ? node.capitalYieldModifier[YIELD_COMMERCE] : -node.capitalYieldModifier[YIELD_COMMERCE]);
                     }
-                    data_.getModifiersHelper()->changeCapitalYieldModifier(isAdding_ ? node.capitalYieldModifier : -node.capitalYieldModifier);
+                    data_.getModifiersHelperForWrite()->changeCapitalYieldModifier(isAdding_ ? node.capitalYieldModifier : -node.capitalYieldModifier);
                 }
 
                 if (!isEmpty(node.stateReligionBuildingProductionModifier))
@@ -151,7 +151,7 @@ namespace AltAI
                     ReligionTypes stateReligion = data_.getReligionHelper()->getStateReligion();
                     if (stateReligion != NO_RELIGION && data_.getReligionHelper()->isHasReligion(stateReligion))
                     {
-                        data_.getModifiersHelper()->changeStateReligionBuildingProductionModifier(
+                        data_.getModifiersHelperForWrite()->changeStateReligionBuildingProductionModifier(
                             isAdding_ ? node.stateReligionBuildingProductionModifier : -node.stateReligionBuildingProductionModifier);
                     }
                 }
@@ -169,7 +169,7 @@ namespace AltAI
                 if (!isEmpty(node.commerceModifier))
                 {
                     recalcAllOutputs = true;
-                    data_.getModifiersHelper()->changePlayerCommerceModifier(isAdding_ ? node.commerceModifier : -node.commerceModifier);
+                    data_.getModifiersHelperForWrite()->changePlayerCommerceModifier(isAdding_ ? node.commerceModifier : -node.commerceModifier);
                 }
 
                 if (!isEmpty(node.extraSpecialistCommerce))
@@ -236,12 +236,12 @@ namespace AltAI
             {
                 if (node.distanceModifier != 0)
                 {
-                    data_.getMaintenanceHelper()->changeDistanceModifier(isAdding_ ? node.distanceModifier : -node.distanceModifier);
+                    data_.getMaintenanceHelperForWrite()->changeDistanceModifier(isAdding_ ? node.distanceModifier : -node.distanceModifier);
                 }
                 
                 if (node.numCitiesModifier != 0)
                 {
-                    data_.getMaintenanceHelper()->changeNumCitiesModifier(isAdding_ ? node.numCitiesModifier : -node.numCitiesModifier);
+                    data_.getMaintenanceHelperForWrite()->changeNumCitiesModifier(isAdding_ ? node.numCitiesModifier : -node.numCitiesModifier);
                 }
                 
                 if (node.corporationModifier != 0)
@@ -264,20 +264,20 @@ namespace AltAI
             {
                 if (node.extraTradeRoutes > 0)
                 {
-                    data_.getTradeRouteHelper()->changeNumRoutes(isAdding_ ? node.extraTradeRoutes : -node.extraTradeRoutes);
+                    data_.getTradeRouteHelperForWrite()->changeNumRoutes(isAdding_ ? node.extraTradeRoutes : -node.extraTradeRoutes);
                 }
 
-                data_.getTradeRouteHelper()->setAllowForeignTradeRoutes(isAdding_ ? !node.noForeignTrade : node.noForeignTrade);
+                data_.getTradeRouteHelperForWrite()->setAllowForeignTradeRoutes(isAdding_ ? !node.noForeignTrade : node.noForeignTrade);
             }
 
             void operator() (const CivicInfo::HappyNode& node) const
             {
                 if (node.largestCityHappy != 0)
                 {
-                    data_.getHappyHelper()->changeLargestCityHappiness(isAdding_ ? node.largestCityHappy : -node.largestCityHappy);
+                    data_.getHappyHelperForWrite()->changeLargestCityHappiness(isAdding_ ? node.largestCityHappy : -node.largestCityHappy);
                 }
 
-                data_.getHappyHelper()->setMilitaryHappinessPerUnit(node.happyPerUnit);
+                data_.getHappyHelperForWrite()->setMilitaryHappinessPerUnit(node.happyPerUnit);
             }
 
             void operator() (const CivicInfo::MiscEffectNode& node) const
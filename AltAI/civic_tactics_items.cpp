@@ -317,7 +317,7 @@ namespace AltAI
 
             if (pCityData->getHappyCap() <= 0)
             {
-                pCityData->getHappyHelper()->changeMilitaryHappinessUnits(1);
+                pCityData->getHappyHelperForWrite()->changeMilitaryHappinessUnits(1);
             }
 
             ProjectionLadder delta = getProjectedOutput(player, pCityData, player.getAnalysis()->getNumSimTurns(), events, ConstructItem(), __FUNCTION__, true, false);
@@ -128,7 +128,7 @@ namespace AltAI
         }
     }
 
-    int CultureHelper::getTurnsToNextLevel(CityData& data) const
+    int CultureHelper::getTurnsToNextLevel(const CityData& data) const
     {
         const int cultureRate = data.getOutput()[OUTPUT_CULTURE];
         if (cultureRate == 0 || cultureLevel_ == gGlobals.getNumCultureLevelInfos())
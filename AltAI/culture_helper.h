@@ -18,7 +18,7 @@ namespace AltAI
 
         void advanceTurns(CityData& data, int nTurns);
         CultureLevelTypes getCultureLevel() const;
-        int getTurnsToNextLevel(CityData& data) const;
+        int getTurnsToNextLevel(const CityData& data) const;
 
         void setCultureLevel(CultureLevelTypes cultureLevel);
 
@@ -143,7 +143,7 @@ namespace AltAI
     }
 
     DotMapItem::DotMapItem(XYCoords coords_, PlotYield cityPlotYield_, bool isFreshWater_, BonusTypes bonusType)
-        : coords(coords_), cityPlotYield(cityPlotYield_), isFreshWater(isFreshWater_), numDeadLockedBonuses(0), 
+        : coords(coords_), cityPlotYield(cityPlotYield_), cityPlotBestImprovement(NO_IMPROVEMENT), isFreshWater(isFreshWater_), numDeadLockedBonuses(0), 
           areaID(-1), subAreaID(-1), selectedPlots(makePlotSet()), positiveFoodTotal(0), projectedTurns(-1)
     {
         if (bonusType != NO_BONUS)
@@ -169,10 +169,9 @@ namespace AltAI
         YieldValueFunctor valueF(makeYieldW(6, 4, 3));
         int value = valueF(projectedYield);
 
-        PlotYield maxYield;
-        ImprovementTypes bestImprovement;
+        const PlotYield& maxYield = cityPlotMaxYield;
+        const ImprovementTypes bestImprovement = cityPlotBestImprovement;
         const CvPlot* pCityPlot = gGlobals.getMap().plot(coords.iX, coords.iY);
-        boost::tie(maxYield, bestImprovement) = getMaxYield(player.getAnalysis()->getMapAnalysis()->getPlotInfoNode(pCityPlot), player.getPlayerID(), 3);
 
         BonusTypes cityPlotBonusType = pCityPlot->getBonusType(player.getTeamID());
         bool onFoodSpecial = cityPlotBonusType != NO_BONUS && maxYield[YIELD_FOOD] > 3 && bestImprovement != NO_IMPROVEMENT;
@@ -264,7 +263,7 @@ namespace AltAI
     std::vector<int> DotMapItem::getGrowthRates(const CvPlayer& player, size_t maxPop, int baseHealthyPop, int cultureLevel) const
     {
         std::vector<int> growthTurns(1, 1);
-        static const int foodPerPop = gGlobals.getFOOD_CONSUMPTION_PER_POPULATION();
+        const int foodPerPop = gGlobals.getFOOD_CONSUMPTION_PER_POPULATION();
 
         BuildTimesData buildTimesData;
         getBuildTimesData(buildTimesData, player.getID(), cultureLevel, baseHealthyPop);
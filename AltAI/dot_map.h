@@ -61,6 +61,8 @@ namespace AltAI
 
         XYCoords coords;
         PlotYield cityPlotYield, conditionalYield;
+        PlotYield cityPlotMaxYield;  // best yield the city plot could have, and the improvement which gives it (used by getFoundValue())
+        ImprovementTypes cityPlotBestImprovement;
         bool isFreshWater;
         std::set<BonusTypes> bonusTypes;
         std::map<BonusTypes, int> bonusTypesMap;
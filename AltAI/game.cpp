@@ -12,6 +12,7 @@
 #include "./error_log.h"
 #include "./civ_log.h"
 #include "./iters.h"
+#include "./profiler.h"
 
 #include "../CvGameCoreDLL/CvPlayerAI.h"
 
@@ -20,6 +21,7 @@ namespace AltAI
     Game::Game(CvGame* pGame) : pGame_(pGame), init_(false)
     {
         GameDataAnalysis::getInstance()->analyse();
+        Profiler::getInstance()->startGame();
     }
 
     void Game::addPlayer(CvPlayer* player)
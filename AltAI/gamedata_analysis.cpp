@@ -7,6 +7,11 @@
 #include "./tech_info_streams.h"
 #include "./buildings_info.h"
 #include "./building_info_construct_visitors.h"
+#include "./building_info_visitors.h"
+#include "./unit_info_visitors.h"
+#include "./project_info_visitors.h"
+#include "./tech_info_visitors.h"
+#include "./civic_info_visitors.h"
 #include "./helper_fns.h"
 #include "./civ_log.h"
 
@@ -29,10 +34,29 @@ namespace AltAI
             }
             return impBuildTypes;
         }
+
+        template <typename InfoType, typename InfoEnum>
+            boost::shared_ptr<InfoType> getSharedInfo(std::map<GameDataAnalysis::StaticInfoKey, boost::shared_ptr<InfoType> >& infoMap,
+                InfoEnum infoType, PlayerTypes playerType, int playerValue, boost::shared_ptr<InfoType> (*makeInfo)(InfoEnum, PlayerTypes))
+        {
+            const GameDataAnalysis::StaticInfoKey key(playerType, infoType, playerValue);
+            typename std::map<GameDataAnalysis::StaticInfoKey, boost::shared_ptr<InfoType> >::const_iterator ci = infoMap.find(key);
+            if (ci != infoMap.end())
+            {
+                return ci->second;
+            }
+
+            boost::shared_ptr<InfoType> pInfo = makeInfo(infoType, playerType);
+            infoMap.insert(std::make_pair(key, pInfo));
+            return pInfo;
+        }
     }
 
     boost::shared_ptr<GameDataAnalysis> GameDataAnalysis::instance_;
 
+    int GameDataAnalysis::combatDieSides_ = 0, GameDataAnalysis::combatDamage_ = 0, GameDataAnalysis::collateralCombatDamage_ = 0;
+    bool GameDataAnalysis::landUnitsCanAttackWaterCities_ = false;
+
     boost::shared_ptr<GameDataAnalysis> GameDataAnalysis::getInstance()
     {
         if (instance_ == NULL)
@@ -44,6 +68,10 @@ namespace AltAI
 
     void GameDataAnalysis::analyse()
     {
+        combatDieSides_ = gGlobals.getDefineINT("COMBAT_DIE_SIDES");  // 1000
+        combatDamage_ = gGlobals.getDefineINT("COMBAT_DAMAGE");  // 20
+        collateralCombatDamage_ = gGlobals.getDefineINT("COLLATERAL_COMBAT_DAMAGE");
+        landUnitsCanAttackWaterCities_ = gGlobals.getDefineINT("LAND_UNITS_CAN_ATTACK_WATER_CITIES") != 0;
     }
 
     void GameDataAnalysis::analyseForPlayer(const Player& player)
@@ -402,4 +430,63 @@ namespace AltAI
             return std::vector<ConditionalPlotYieldEnchancingBuilding>();
         }
     }
-}
\ No newline at end of file
+
+    GameDataAnalysis::StaticInfoKey::StaticInfoKey(PlayerTypes playerType, int infoType_, int playerValue_)
+        : civType(CvPlayerAI::getPlayer(playerType).getCivilizationType()), infoType(infoType_), playerValue(playerValue_)
+    {
+        const CvPlayer& player = CvPlayerAI::getPlayer(playerType);
+        for (int i = 0, count = gGlobals.getNumTraitInfos(); i < count; ++i)
+        {
+            if (player.hasTrait((TraitTypes)i))
+            {
+                traits.push_back((TraitTypes)i);
+            }
+        }
+    }
+
+    bool GameDataAnalysis::StaticInfoKey::operator < (const GameDataAnalysis::StaticInfoKey& other) const
+    {
+        if (infoType != other.infoType)
+        {
+            return infoType < other.infoType;
+        }
+        if (civType != other.civType)
+        {
+            return civType < other.civType;
+        }
+        if (playerValue != other.playerValue)
+        {
+            return playerValue < other.playerValue;
+        }
+        return traits < other.traits;
+    }
+
+    boost::shared_ptr<UnitInfo> GameDataAnalysis::getUnitInfo(UnitTypes unitType, PlayerTypes playerType)
+    {
+        // the unit's cost is read from the player (includes handicap, era and instance cost adjustments) - see UnitInfo's getBaseNode
+        const int cost = gGlobals.getUnitInfo(unitType).getProductionCost() > -1 ? CvPlayerAI::getPlayer(playerType).getProductionNeeded(unitType) : 0;
+        return getSharedInfo(unitsInfo_, unitType, playerType, cost, makeUnitInfo);
+    }
+
+    boost::shared_ptr<BuildingInfo> GameDataAnalysis::getBuildingInfo(BuildingTypes buildingType, PlayerTypes playerType)
+    {
+        // includes the player's wonder production modifiers as well as the trait based ones
+        const int productionModifier = CvPlayerAI::getPlayer(playerType).getProductionModifier(buildingType);
+        return getSharedInfo(buildingsInfo_, buildingType, playerType, productionModifier, makeBuildingInfo);
+    }
+
+    boost::shared_ptr<ProjectInfo> GameDataAnalysis::getProjectInfo(ProjectTypes projectType, PlayerTypes playerType)
+    {
+        return getSharedInfo(projectsInfo_, projectType, playerType, 0, makeProjectInfo);
+    }
+
+    boost::shared_ptr<TechInfo> GameDataAnalysis::getTechInfo(TechTypes techType, PlayerTypes playerType)
+    {
+        return getSharedInfo(techsInfo_, techType, playerType, 0, makeTechInfo);
+    }
+
+    boost::shared_ptr<CivicInfo> GameDataAnalysis::getCivicInfo(CivicTypes civicType, PlayerTypes playerType)
+    {
+        return getSharedInfo(civicsInfo_, civicType, playerType, 0, makeCivicInfo);
+    }
+}
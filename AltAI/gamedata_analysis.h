@@ -9,6 +9,10 @@
 namespace AltAI
 {
     class Player;
+    class UnitInfo;
+    class BuildingInfo;
+    class ProjectInfo;
+    class CivicInfo;
     struct ConditionalPlotYieldEnchancingBuilding;
     // data derived from static game data
     // and functions which use that analysis
@@ -40,8 +44,33 @@ namespace AltAI
 
         static GreatPersonOutput getSpecialistUnitTypeAndOutput(SpecialistTypes specialistType, PlayerTypes playerType);
 
+        // defines read by the combat and movement calculations, which can run on the worker pool
+        // set by analyse() on the main thread when the game starts - function local statics aren't initialised thread safely by VC7.1
+        static int getCombatDieSides() { return combatDieSides_; }
+        static int getCombatDamage() { return combatDamage_; }
+        static int getCollateralCombatDamage() { return collateralCombatDamage_; }
+        static bool getLandUnitsCanAttackWaterCities() { return landUnitsCanAttackWaterCities_; }
+
         std::vector<ConditionalPlotYieldEnchancingBuilding> getConditionalPlotYieldEnhancingBuildings(PlayerTypes playerType, const CvCity* pCity = NULL) const;
 
+        // info trees are built once per distinct set of player attributes they depend on and shared between players (and across loads)
+        boost::shared_ptr<UnitInfo> getUnitInfo(UnitTypes unitType, PlayerTypes playerType);
+        boost::shared_ptr<BuildingInfo> getBuildingInfo(BuildingTypes buildingType, PlayerTypes playerType);
+        boost::shared_ptr<ProjectInfo> getProjectInfo(ProjectTypes projectType, PlayerTypes playerType);
+        boost::shared_ptr<TechInfo> getTechInfo(TechTypes techType, PlayerTypes playerType);
+        boost::shared_ptr<CivicInfo> getCivicInfo(CivicTypes civicType, PlayerTypes playerType);
+
+        // civ and leader traits, plus any other player dependent value the particular info type reads when it's built
+        struct StaticInfoKey
+        {
+            StaticInfoKey(PlayerTypes playerType, int infoType_, int playerValue_);
+            bool operator < (const StaticInfoKey& other) const;
+
+            CivilizationTypes civType;
+            std::vector<TraitTypes> traits;
+            int infoType, playerValue;
+        };
+
     private:
         void analysePlots_(PlayerTypes playerID);
 
@@ -49,6 +78,9 @@ namespace AltAI
 
         static boost::shared_ptr<GameDataAnalysis> instance_;
 
+        static int combatDieSides_, combatDamage_, collateralCombatDamage_;
+        static bool landUnitsCanAttackWaterCities_;
+
         static TechTypes getCanWorkWaterTech_();
         static std::vector<TechTypes> getIgnoreIrrigationTechs_();
         static std::vector<TechTypes> getCarriesIrrigationTechs_();
@@ -68,5 +100,11 @@ namespace AltAI
         };
 
         std::map<PlayerTypes, PlayerData> playerData_;
+
+        std::map<StaticInfoKey, boost::shared_ptr<UnitInfo> > unitsInfo_;
+        std::map<StaticInfoKey, boost::shared_ptr<BuildingInfo> > buildingsInfo_;
+        std::map<StaticInfoKey, boost::shared_ptr<ProjectInfo> > projectsInfo_;
+        std::map<StaticInfoKey, boost::shared_ptr<TechInfo> > techsInfo_;
+        std::map<StaticInfoKey, boost::shared_ptr<CivicInfo> > civicsInfo_;
     };
 }
\ No newline at end of file
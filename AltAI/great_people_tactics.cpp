@@ -18,17 +18,17 @@ namespace AltAI
         {
             explicit CityGPPData(City& city)
             {
-                CityDataPtr pCityData = city.getCityData();
-                cityGPPModifier = pCityData->getSpecialistHelper()->getPlayerGPPModifier()
-                    + pCityData->getSpecialistHelper()->getCityGPPModifier();
-                if (pCityData->getReligionHelper()->hasStateReligion())
+                const CityData& data = *city.getCityData();
+                cityGPPModifier = data.getSpecialistHelper()->getPlayerGPPModifier()
+                    + data.getSpecialistHelper()->getCityGPPModifier();
+                if (data.getReligionHelper()->hasStateReligion())
                 {
-                    cityGPPModifier += pCityData->getSpecialistHelper()->getStateReligionGPPModifier();
+                    cityGPPModifier += data.getSpecialistHelper()->getStateReligionGPPModifier();
                 }
 
                 for (int specialistType = 0, count = gGlobals.getNumSpecialistInfos(); specialistType < count; ++specialistType)
                 {
-                    slotsMap[(SpecialistTypes)specialistType] = pCityData->getNumPossibleSpecialists((SpecialistTypes)specialistType);
+                    slotsMap[(SpecialistTypes)specialistType] = data.getNumPossibleSpecialists((SpecialistTypes)specialistType);
                 }
 
                 // todo - wire through city data as we should be simulating it anyway
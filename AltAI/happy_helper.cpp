@@ -147,7 +147,7 @@ namespace AltAI
 
     void HappyHelper::advanceTurn(CityData& data)
     {
-        data.getHurryHelper()->advanceTurns(1);
+        data.getHurryHelperForWrite()->advanceTurns(1);
         if (--tempHappyTimer_ < 0)
         {
             tempHappyTimer_ = 0;
@@ -158,7 +158,7 @@ namespace AltAI
     {
         population_ = population;
         setOvercrowdingPercentAnger_();
-        data.getHurryHelper()->setPopulation(population);
+        data.getHurryHelperForWrite()->setPopulation(population);
     }
 
     void HappyHelper::setOvercrowdingPercentAnger_()
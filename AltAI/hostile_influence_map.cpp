@@ -0,0 +1,129 @@
+#include "AltAI.h"
+
+#include "./hostile_influence_map.h"
+#include "./unit_tactics.h"
+#include "./player.h"
+#include "./profiler.h"
+
+namespace AltAI
+{
+    const std::vector<int> HostileInfluenceMap::noStacks_;
+    const std::vector<IDInfo> HostileInfluenceMap::noUnits_;
+
+    HostileInfluenceMap::HostileInfluenceMap(const Player& player) : player_(player)
+    {
+    }
+
+    void HostileInfluenceMap::updateStack(const CvPlot* pStackPlot, const std::vector<const CvUnit*>& stackUnits)
+    {
+        ProfileScope profileScope("HostileInfluenceMap::updateStack", player_.getPlayerID());
+
+        const int stackIndex = gGlobals.getMap().plotNum(pStackPlot->getX(), pStackPlot->getY());
+
+        std::map<int, StackInfluence>::iterator stackIter = stacksMap_.find(stackIndex);
+        if (stackIter != stacksMap_.end())
+        {
+            removeInfluence_(stackIndex, stackIter->second);
+            stacksMap_.erase(stackIter);
+        }
+
+        StackInfluence stackInfluence;
+        std::vector<const CvUnit*> attackUnits;
+        for (size_t i = 0, count = stackUnits.size(); i < count; ++i)
+        {
+            if (stackUnits[i]->canAttack())
+            {
+                attackUnits.push_back(stackUnits[i]);
+                stackInfluence.units.push_back(stackUnits[i]->getIDInfo());
+                stackInfluence.attackStrength += stackUnits[i]->currCombatStr(NULL, NULL);
+            }
+        }
+
+        if (attackUnits.empty())
+        {
+            return;
+        }
+
+        // where the stack could get to next turn, with full moves
+        ReachablePlotsData reachablePlotsData;
+        getReachablePlotsData(reachablePlotsData, player_, attackUnits, true, true);
+        stackInfluence.reachablePlots.assign(reachablePlotsData.allReachablePlots.begin(), reachablePlotsData.allReachablePlots.end());
+
+        stackIter = stacksMap_.insert(std::make_pair(stackIndex, stackInfluence)).first;
+        addInfluence_(stackIndex, stackIter->second);
+    }
+
+    void HostileInfluenceMap::clear()
+    {
+        attackStrength_.clear();
+        stacks_.clear();
+        stacksMap_.clear();
+    }
+
+    bool HostileInfluenceMap::isThreatened(const CvPlot* pPlot) const
+    {
+        return !getStacks(pPlot).empty();
+    }
+
+    int HostileInfluenceMap::getAttackStrength(const CvPlot* pPlot) const
+    {
+        return attackStrength_.empty() ? 0 : attackStrength_[gGlobals.getMap().plotNum(pPlot->getX(), pPlot->getY())];
+    }
+
+    const std::vector<int>& HostileInfluenceMap::getStacks(const CvPlot* pPlot) const
+    {
+        return stacks_.empty() ? noStacks_ : stacks_[gGlobals.getMap().plotNum(pPlot->getX(), pPlot->getY())];
+    }
+
+    const std::vector<IDInfo>& HostileInfluenceMap::getStackUnits(int stackIndex) const
+    {
+        std::map<int, StackInfluence>::const_iterator stackIter = stacksMap_.find(stackIndex);
+        return stackIter != stacksMap_.end() ? stackIter->second.units : noUnits_;
+    }
+
+    PlotSet HostileInfluenceMap::getThreatenedPlots() const
+    {
+        PlotSet plots;
+        for (std::map<int, StackInfluence>::const_iterator stackIter(stacksMap_.begin()), stackEndIter(stacksMap_.end()); stackIter != stackEndIter; ++stackIter)
+        {
+            plots.insert(stackIter->second.reachablePlots.begin(), stackIter->second.reachablePlots.end());
+        }
+        return plots;
+    }
+
+    void HostileInfluenceMap::addInfluence_(int stackIndex, const StackInfluence& stackInfluence)
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        if (stacks_.empty())
+        {
+            attackStrength_.assign(theMap.numPlots(), 0);
+            stacks_.resize(theMap.numPlots());
+        }
+
+        for (size_t i = 0, count = stackInfluence.reachablePlots.size(); i < count; ++i)
+        {
+            const CvPlot* pPlot = stackInfluence.reachablePlots[i];
+            const int plotIndex = theMap.plotNum(pPlot->getX(), pPlot->getY());
+            attackStrength_[plotIndex] += stackInfluence.attackStrength;
+            stacks_[plotIndex].push_back(stackIndex);
+        }
+    }
+
+    void HostileInfluenceMap::removeInfluence_(int stackIndex, const StackInfluence& stackInfluence)
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        for (size_t i = 0, count = stackInfluence.reachablePlots.size(); i < count; ++i)
+        {
+            const CvPlot* pPlot = stackInfluence.reachablePlots[i];
+            const int plotIndex = theMap.plotNum(pPlot->getX(), pPlot->getY());
+            attackStrength_[plotIndex] -= stackInfluence.attackStrength;
+
+            std::vector<int>& stacks = stacks_[plotIndex];
+            std::vector<int>::iterator stacksIter = std::find(stacks.begin(), stacks.end(), stackIndex);
+            if (stacksIter != stacks.end())
+            {
+                stacks.erase(stacksIter);
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    class Player;
+
+    // which visible hostile stacks can reach each plot next turn, and their combined attack strength (sum of currCombatStr() of units which can attack)
+    // kept in arrays indexed by plot number - stacks are updated individually as hostile units are seen to move, so danger queries are lookups
+    class HostileInfluenceMap
+    {
+    public:
+        explicit HostileInfluenceMap(const Player& player);
+
+        // replaces any influence from a stack at this plot with that of the given units (which may be empty, to remove the stack)
+        void updateStack(const CvPlot* pStackPlot, const std::vector<const CvUnit*>& stackUnits);
+        void clear();
+
+        bool isThreatened(const CvPlot* pPlot) const;
+        int getAttackStrength(const CvPlot* pPlot) const;
+        // plot numbers of the stacks which can reach this plot
+        const std::vector<int>& getStacks(const CvPlot* pPlot) const;
+        const std::vector<IDInfo>& getStackUnits(int stackIndex) const;
+
+        PlotSet getThreatenedPlots() const;
+
+    private:
+        struct StackInfluence
+        {
+            StackInfluence() : attackStrength(0) {}
+
+            int attackStrength;
+            std::vector<IDInfo> units;
+            std::vector<const CvPlot*> reachablePlots;
+        };
+
+        void addInfluence_(int stackIndex, const StackInfluence& stackInfluence);
+        void removeInfluence_(int stackIndex, const StackInfluence& stackInfluence);
+
+        const Player& player_;
+        // indexed by plot number, empty until a stack is added
+        std::vector<int> attackStrength_;
+        std::vector<std::vector<int> > stacks_;
+        std::map<int, StackInfluence> stacksMap_;  // keyed by stack's plot number
+
+        static const std::vector<int> noStacks_;
+        static const std::vector<IDInfo> noUnits_;
+    };
+}
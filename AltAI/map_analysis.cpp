@@ -282,7 +282,7 @@ namespace AltAI
         }
     }
 
-    MapAnalysis::MapAnalysis(Player& player) : init_(false), player_(player)
+    MapAnalysis::MapAnalysis(Player& player) : init_(false), player_(player), cityDistanceFieldsCityCount_(-1)
     {
     }
 
@@ -300,34 +300,208 @@ namespace AltAI
     }
 
     // getters
+    const MovementCostField& MapAnalysis::getMovementCostField(TeamTypes teamType)
+    {
+        std::map<TeamTypes, MovementCostField>::iterator fieldIter = movementCostFields_.find(teamType);
+        if (fieldIter == movementCostFields_.end())
+        {
+            fieldIter = movementCostFields_.insert(std::make_pair(teamType, MovementCostField(teamType))).first;
+        }
+        fieldIter->second.update();
+        return fieldIter->second;
+    }
+
+    const CityDistanceField& MapAnalysis::getCityDistanceField_(int subArea, bool includeActsAsCity) const
+    {
+        // fields are updated as cities are added and deleted, but rebuild them if that missed any of the team's cities
+        const int teamCityCount = CvTeamAI::getTeam(player_.getTeamID()).getNumCities();
+        if (teamCityCount != cityDistanceFieldsCityCount_)
+        {
+            cityDistanceFields_.clear();
+            cityDistanceFieldsCityCount_ = teamCityCount;
+        }
+
+        const std::pair<int, bool> key(subArea, includeActsAsCity);
+        CityDistanceFieldMap::iterator fieldIter = cityDistanceFields_.find(key);
+        if (fieldIter == cityDistanceFields_.end())
+        {
+            cityDistanceFieldPlots_.init();
+            fieldIter = cityDistanceFields_.insert(std::make_pair(key, CityDistanceField(cityDistanceFieldPlots_, subArea))).first;
+            fieldIter->second.init(getCityDistanceSources_(subArea, includeActsAsCity));
+        }
+        return fieldIter->second;
+    }
+
+    std::vector<int> MapAnalysis::getCityDistanceSources_(int subArea, bool includeActsAsCity) const
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        const TeamTypes teamType = player_.getTeamID();
+        std::vector<int> sources;
+
+        TeamCityIter cityIter(teamType);
+        while (CvCity* pCity = cityIter())
+        {
+            if (isCityDistanceSource_(pCity->plot(), subArea))
+            {
+                sources.push_back(theMap.plotNum(pCity->getX(), pCity->getY()));
+            }
+        }
+
+        if (includeActsAsCity)
+        {
+            const boost::shared_ptr<SubArea> pSubArea = theMap.getSubArea(subArea);
+            std::set<int> subAreasToSearch;
+            if (pSubArea->isWater())
+            {   
+                std::vector<int> borderingAreas = getAreasBorderingArea(pSubArea->getAreaID());
+                for (size_t i = 0; i < borderingAreas.size(); ++i)
+                {
+                    std::vector<int> subAreas = getSubAreasInArea(borderingAreas[i]);
+                    for (size_t j = 0; j < subAreas.size(); ++j)
+                    {
+                        boost::shared_ptr<SubArea> pBorderSubArea = theMap.getSubArea(subAreas[j]);
+                        if (!pBorderSubArea->isImpassable() && !pBorderSubArea->isWater())
+                        {
+                            subAreasToSearch.insert(subAreas[j]);
+                        }
+                    }                        
+                }
+            }
+            else
+            {
+                subAreasToSearch.insert(subArea);
+            }
+
+            for (std::set<int>::const_iterator searchIter(subAreasToSearch.begin()), searchEndIter(subAreasToSearch.end()); searchIter != searchEndIter; ++searchIter)
+            {
+                SubAreaPlotSet::const_iterator fortIter = impAsCityMap_.find(*searchIter);
+                if (fortIter != impAsCityMap_.end())
+                {
+                    for (SubAreaPlotSet::Plots::const_iterator ci(fortIter->second.begin()), ciEnd(fortIter->second.end()); ci != ciEnd; ++ci)
+                    {
+                        const CvPlot* pLoopPlot = theMap.plot(ci->iX, ci->iY);
+                        TeamTypes plotTeam = pLoopPlot->getRevealedTeam(teamType, false);
+
+                        // only consider friendly forts
+                        if ((plotTeam == NO_TEAM || plotTeam == teamType) && isCityDistanceSource_(pLoopPlot, subArea))
+                        {
+                            sources.push_back(theMap.plotNum(ci->iX, ci->iY));
+                        }
+                    }
+                }
+            }
+        }
+
+        return sources;
+    }
+
+    bool MapAnalysis::isCityDistanceSource_(const CvPlot* pPlot, int subArea) const
+    {
+        if (gGlobals.getMap().getSubArea(subArea)->isWater())
+        {
+            // try and account for coastal cities
+            // this won't always work for units in impassable areas, as the unit may be in an impassable sub area (e.g. sub under ice)
+            // which doesn't border the city (a city could border an impassable sub area directly though)
+            std::vector<int> borderingSubAreas = getBorderingSubAreas(player_.getTeamID(), pPlot);
+            return std::find(borderingSubAreas.begin(), borderingSubAreas.end(), subArea) != borderingSubAreas.end();
+        }
+        else
+        {
+            return pPlot->getSubArea() == subArea;
+        }
+    }
+
+    void MapAnalysis::updateCityDistanceFields_(const CvCity* pCity, bool isAdding)
+    {
+        if (pCity->getTeam() != player_.getTeamID())
+        {
+            return;
+        }
+
+        const int plotIndex = gGlobals.getMap().plotNum(pCity->getX(), pCity->getY());
+        for (CityDistanceFieldMap::iterator fieldIter(cityDistanceFields_.begin()), fieldEndIter(cityDistanceFields_.end()); fieldIter != fieldEndIter; ++fieldIter)
+        {
+            if (isAdding)
+            {
+                if (isCityDistanceSource_(pCity->plot(), fieldIter->first.first))
+                {
+                    fieldIter->second.addSource(plotIndex);
+                }
+            }
+            else
+            {
+                fieldIter->second.removeSource(plotIndex);
+            }
+        }
+
+        if (isAdding)
+        {
+            // the core counts a new city before calling addCity, so a distance query in between will already have rebuilt
+            // the fields with it and synced the count - only step the count if that didn't happen
+            // (deleteCity is called before the core drops the city from its count, so there is no such gap for deletes)
+            if (cityDistanceFieldsCityCount_ != CvTeamAI::getTeam(player_.getTeamID()).getNumCities())
+            {
+                ++cityDistanceFieldsCityCount_;
+            }
+        }
+        else
+        {
+            --cityDistanceFieldsCityCount_;
+        }
+    }
+
+    void MapAnalysis::clearActsAsCityDistanceFields_()
+    {
+        for (CityDistanceFieldMap::iterator fieldIter(cityDistanceFields_.begin()); fieldIter != cityDistanceFields_.end();)
+        {
+            if (fieldIter->first.second)
+            {
+                cityDistanceFields_.erase(fieldIter++);
+            }
+            else
+            {
+                ++fieldIter;
+            }
+        }
+    }
+
+    void MapAnalysis::updateMovementCosts_(const CvPlot* pPlot)
+    {
+        for (std::map<TeamTypes, MovementCostField>::iterator fieldIter(movementCostFields_.begin()), fieldEndIter(movementCostFields_.end());
+            fieldIter != fieldEndIter; ++fieldIter)
+        {
+            fieldIter->second.markDirty(pPlot);
+        }
+    }
+
     const PlotInfo::PlotInfoNode& MapAnalysis::getPlotInfoNode(const CvPlot* pPlot)
     {
 #ifdef ALTAI_DEBUG
         std::ostream& os = ErrorLog::getLog(*player_.getCvPlayer())->getStream();
 #endif
         XYCoords coords(pPlot->getCoords());
-        KeyInfoMap::const_iterator keyIter = keyInfoMap_.find(coords);
+        const int* pPlotKey = findPlotKey_(coords);
 
-        if (keyIter != keyInfoMap_.end())
+        if (pPlotKey)
         {
-            PlotInfoMap::iterator iter = plotInfoMap_.find(keyIter->second);
+            PlotInfoMap::iterator iter = plotInfoMap_.find(*pPlotKey);
             if (iter != plotInfoMap_.end())
             {
 #ifdef ALTAI_DEBUG
                 PlotInfo plotInfo(pPlot, player_.getPlayerID());
                 int key = plotInfo.getKey();
-                if (key != keyIter->second)
+                if (key != *pPlotKey)
                 {
-                    os << "\n(getPlotInfoNode): Inconsistent plot keys for coords: " << coords << " keys: stored = " << keyIter->second << ", calculated = " << key
-                       << "\n" << iter->second << "\n" << plotInfo.getInfo();
+                    os << "\n(getPlotInfoNode): Inconsistent plot keys for coords: " << coords << " keys: stored = " << *pPlotKey << ", calculated = " << key
+                       << "\n" << *iter->second << "\n" << plotInfo.getInfo();
                 }
-                else if (!(iter->second == plotInfo.getInfo()))
+                else if (iter->second != PlotInfoNodeStore::getInstance()->intern(plotInfo.getInfo()))
                 {
-                    os << "\n(getPlotInfoNode): Inconsistent plot info for coords: " << coords << " keys: stored = " << keyIter->second << ", calculated = " << key
-                       << "\n" << iter->second << "\n" << plotInfo.getInfo();
+                    os << "\n(getPlotInfoNode): Inconsistent plot info for coords: " << coords << " keys: stored = " << *pPlotKey << ", calculated = " << key
+                       << "\n" << *iter->second << "\n" << plotInfo.getInfo();
                 }
 #endif
-                return iter->second;
+                return *iter->second;
             }
         }
 
@@ -335,7 +509,7 @@ namespace AltAI
 #ifdef ALTAI_DEBUG
         os << "\nPlotInfo missing for coords: " << coords;
 #endif
-        return updatePlotInfo_(pPlot, false).second->second;
+        return *updatePlotInfo_(pPlot, false).second->second;
     }
 
     const MapAnalysis::PlotValues& MapAnalysis::getPlotValues()
@@ -348,7 +522,19 @@ namespace AltAI
 
     bool MapAnalysis::plotValuesDirty() const
     {
-        return !updatedPlots_.empty();
+        return !updatedPlots_.empty() || !plotValueChanges_.empty();
+    }
+
+    const MapAnalysis::PlotValueChanges& MapAnalysis::getPlotValueChanges()
+    {
+        processUpdatedPlots_();
+
+        return plotValueChanges_;
+    }
+
+    void MapAnalysis::clearPlotValueChanges()
+    {
+        plotValueChanges_ = PlotValueChanges();
     }
 
     bool MapAnalysis::isSharedPlot(XYCoords coords) const
@@ -586,107 +772,31 @@ namespace AltAI
     const CvPlot* MapAnalysis::getClosestCity(const CvPlot* pPlot, int subArea, bool includeActsAsCity, IDInfo& closestCity) const
     {
         const CvMap& theMap = gGlobals.getMap();
-        const bool isWaterSubArea = theMap.getSubArea(subArea)->isWater();
-        const TeamTypes teamType = player_.getTeamID();
+        const int plotIndex = theMap.plotNum(pPlot->getX(), pPlot->getY());
 
-        int bestStepDistance = MAX_INT;
         const CvPlot* pClosestCityPlot = (const CvPlot*)0;
+        int bestStepDistance = MAX_INT;
 
-        TeamCityIter cityIter(teamType);
-        while (CvCity* pCity = cityIter())
+        const CityDistanceField& cityField = getCityDistanceField_(subArea, false);
+        const int cityIndex = cityField.getClosestSource(plotIndex);
+        if (cityIndex != -1)
         {
-            bool mayBeReachable = false;
-            if (isWaterSubArea)
-            {
-                // try and account for coastal cities
-                // this won't always work for units in impassable areas, as the unit may be in an impassable sub area (e.g. sub under ice)
-                // which doesn't border the city (a city could border an impassable sub area directly though)
-                std::vector<int> borderingSubAreas = getBorderingSubAreas(teamType, pCity->plot());
-                if (std::find(borderingSubAreas.begin(), borderingSubAreas.end(), subArea) != borderingSubAreas.end())
-                {
-                    mayBeReachable = true;
-                }
-            }
-            else
+            bestStepDistance = cityField.getDistance(plotIndex);
+            pClosestCityPlot = theMap.plotByIndex(cityIndex);
+            if (pClosestCityPlot->isCity())
             {
-                mayBeReachable = pCity->plot()->getSubArea() == subArea;
-            }
-
-            if (mayBeReachable)
-            {
-                int thisStepDistance = stepDistance(pPlot->getX(), pPlot->getY(), pCity->getX(), pCity->getY());
-                if (thisStepDistance < bestStepDistance)
-                {
-                    bestStepDistance = thisStepDistance;
-                    pClosestCityPlot = pCity->plot();
-                    closestCity = pCity->getIDInfo();
-                }
+                closestCity = pClosestCityPlot->getPlotCity()->getIDInfo();
             }
         }
 
+        // closestCity stays as the closest actual city, even if an acts as city plot is closer
         if (includeActsAsCity)
         {
-            std::set<int> subAreasToSearch;
-            if (isWaterSubArea)
-            {   
-                std::vector<int> borderingAreas = getAreasBorderingArea(pPlot->getArea());
-                for (size_t i = 0; i < borderingAreas.size(); ++i)
-                {
-                    std::vector<int> subAreas = getSubAreasInArea(borderingAreas[i]);
-                    for (size_t j = 0; j < subAreas.size(); ++j)
-                    {
-                        boost::shared_ptr<SubArea> pBorderSubArea = theMap.getSubArea(subAreas[j]);
-                        if (!pBorderSubArea->isImpassable() && !pBorderSubArea->isWater())
-                        {
-                            subAreasToSearch.insert(subAreas[j]);
-                        }
-                    }                        
-                }
-            }
-            else
+            const CityDistanceField& actsAsCityField = getCityDistanceField_(subArea, true);
+            const int sourceIndex = actsAsCityField.getClosestSource(plotIndex);
+            if (sourceIndex != -1 && actsAsCityField.getDistance(plotIndex) < bestStepDistance)
             {
-                subAreasToSearch.insert(subArea);
-            }
-
-            for (std::set<int>::const_iterator searchIter(subAreasToSearch.begin()), searchEndIter(subAreasToSearch.end()); searchIter != searchEndIter; ++searchIter)
-            {
-                std::map<int /* sub area id */, std::set<XYCoords> >::const_iterator fortIter = impAsCityMap_.find(*searchIter);
-                if (fortIter != impAsCityMap_.end())
-                {
-                    for (std::set<XYCoords>::const_iterator ci(fortIter->second.begin()), ciEnd(fortIter->second.end()); ci != ciEnd; ++ci)
-                    {
-                        const CvPlot* pLoopPlot = theMap.plot(ci->iX, ci->iY);
-                        TeamTypes plotTeam = pLoopPlot->getRevealedTeam(teamType, false);
-
-                        if (plotTeam != NO_TEAM && plotTeam != teamType)
-                        {
-                            continue;  // only consider friendly forts
-                        }
-
-                        bool mayBeReachable = true;
-                        if (isWaterSubArea)
-                        {
-                            // try and account for coastal cities
-                            // this won't always work for units in impassable areas, as the unit may be in an impassable sub area (e.g. sub under ice)
-                            // which doesn't border the city (a city could border an impassable sub area directly though)
-                            std::vector<int> borderingSubAreas = getBorderingSubAreas(teamType, pLoopPlot);
-                            if (std::find(borderingSubAreas.begin(), borderingSubAreas.end(), subArea) == borderingSubAreas.end())
-                            {
-                                mayBeReachable = false;
-                            }
-                        }
-
-                        if (mayBeReachable)
-                        {
-                            int thisStepDistance = stepDistance(pPlot->getX(), pPlot->getY(), ci->iX, ci->iY);
-                            if (thisStepDistance < bestStepDistance)
-                            {
-                                bestStepDistance = thisStepDistance;
-                                pClosestCityPlot = pLoopPlot;
-                            }
-                        }
-                    }
-                }
+                pClosestCityPlot = theMap.plotByIndex(sourceIndex);
             }
         }
 
@@ -739,31 +849,24 @@ namespace AltAI
         return huts;
     }
 
-    const std::map<int /* sub area id */, std::set<XYCoords> >& MapAnalysis::getBorderMap() const
+    const SubAreaPlotSet& MapAnalysis::getBorderMap() const
     {
         return ourBorderMap_;
     }
 
-    const std::map<int /* sub area id */, std::set<XYCoords> >& MapAnalysis::getUnrevealedBorderMap() const
+    const SubAreaPlotSet& MapAnalysis::getUnrevealedBorderMap() const
     {
         return unrevealedBorderMap_;
     }
 
     int MapAnalysis::getUnrevealedBorderCount(int subAreaId) const
     {
-        std::map<int /* sub area id */, std::set<XYCoords> >::const_iterator ci = unrevealedBorderMap_.find(subAreaId);
-        return ci == unrevealedBorderMap_.end() ? 0 : ci->second.size();
+        return unrevealedBorderMap_.size(subAreaId);
     }
 
     bool MapAnalysis::isOurBorderPlot(int subAreaId, XYCoords coords) const
     {
-        bool isOurBorderPlot = false;
-        std::map<int /* sub area id */, std::set<XYCoords> >::const_iterator borderSubAreaIter = ourBorderMap_.find(subAreaId);
-        if (borderSubAreaIter != ourBorderMap_.end())
-        {
-             isOurBorderPlot = borderSubAreaIter->second.find(coords) != borderSubAreaIter->second.end();
-        }
-        return isOurBorderPlot;
+        return ourBorderMap_.contains(subAreaId, coords);
     }
 
     std::vector<int /* area id */> MapAnalysis::getAreasBorderingArea(int areaId) const
@@ -830,7 +933,7 @@ namespace AltAI
                 }
                 else if (pPlot->isCity(true, teamType))
                 {
-                    impAsCityMap_[pPlot->getSubArea()].insert(pPlot->getCoords());
+                    impAsCityMap_.insert(pPlot->getSubArea(), pPlot->getCoords());
                 }
                 // will update plots we know - don't want to retrigger discovery of new sub areas as those are saved/restored
                 // todo - maybe revisit saving of MapAnalysis data?
@@ -902,6 +1005,7 @@ namespace AltAI
 
         // need to update dot map once we've processed the complete set of plot updates
         processUpdatedPlots_();
+        plotValueChanges_.all = true;
 
         previousPlotValues_ = plotValues_;
         plotValues_.plotValueMap.clear();
@@ -919,7 +1023,7 @@ namespace AltAI
 
                 if (owner == NO_PLAYER || owner == player_.getPlayerID())
                 {
-                    addDotMapPlot_(pPlot, keyAndIter.second->second);
+                    addDotMapPlot_(pPlot, *keyAndIter.second->second);
                 }
             }
         }
@@ -935,7 +1039,7 @@ namespace AltAI
 
     void MapAnalysis::reinitPlotKeys()
     {
-        keyInfoMap_.clear();
+        plotKeys_.clear();
         keyCoordsMap_.clear();
 
         const CvMap& theMap = gGlobals.getMap();
@@ -1005,7 +1109,8 @@ namespace AltAI
         }
         else if (pPlot->isCity(true, player_.getTeamID()))  // improvement which acts as city
         {
-            impAsCityMap_[pPlot->getSubArea()].insert(pPlot->getCoords());
+            impAsCityMap_.insert(pPlot->getSubArea(), pPlot->getCoords());
+            clearActsAsCityDistanceFields_();
         }
     }
 
@@ -1086,12 +1191,14 @@ namespace AltAI
 //           << " new feature = " << (pPlot->getFeatureType() == NO_FEATURE ? "NO_FEATURE" : gGlobals.getFeatureInfo(pPlot->getFeatureType()).getType());
 //#endif
         updatePlotInfo_(pPlot, false);
+        updateMovementCosts_(pPlot);
     }
 
     void MapAnalysis::updatePlotImprovement(const CvPlot* pPlot, ImprovementTypes oldImprovementType)
     {
         ImprovementTypes newImprovementType = pPlot->getImprovementType();
         XYCoords plotCoords(pPlot->getCoords());
+        updateMovementCosts_(pPlot);
 
 #ifdef ALTAI_DEBUG
         std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
@@ -1104,7 +1211,8 @@ namespace AltAI
             if (gGlobals.getImprovementInfo(oldImprovementType).isActsAsCity())
             {
                 // might not exist if we never controlled the plot and it was never neutral either
-                impAsCityMap_[pPlot->getSubArea()].erase(pPlot->getCoords());
+                impAsCityMap_.erase(pPlot->getCoords());
+                clearActsAsCityDistanceFields_();
             }
             if (gGlobals.getImprovementInfo(oldImprovementType).isGoody())
             {
@@ -1171,6 +1279,11 @@ namespace AltAI
         //}
     }
 
+    void MapAnalysis::updatePlotMovementCosts(const CvPlot* pPlot)
+    {
+        updateMovementCosts_(pPlot);
+    }
+
     void MapAnalysis::updatePlotBonus(const CvPlot* pPlot, BonusTypes bonusType)
     {
 #ifdef ALTAI_DEBUG
@@ -1183,17 +1296,25 @@ namespace AltAI
 
     void MapAnalysis::updatePlotCulture(const CvPlot* pPlot, PlayerTypes previousRevealedOwner, PlayerTypes newRevealedOwner)
     {
+        // plot's owner decides whether its route is usable by units at war with them
+        updateMovementCosts_(pPlot);
+        // ...and whether an acts as city improvement on it counts as one of our cities
+        if (pPlot->getImprovementType() != NO_IMPROVEMENT && gGlobals.getImprovementInfo(pPlot->getImprovementType()).isActsAsCity())
+        {
+            clearActsAsCityDistanceFields_();
+        }
+
         XYCoords coords(pPlot->getCoords());
         std::vector<XYCoords> hostilePlotsWithUnknownCity;
 
-        KeyInfoMap::const_iterator keyIter = keyInfoMap_.find(coords);
+        const int* pPlotKey = findPlotKey_(coords);
 
-        if (keyIter == keyInfoMap_.end())
+        if (!pPlotKey)
         {
             return;
         }
 
-        const int key = keyIter->second;
+        const int key = *pPlotKey;
         const int subAreaID = pPlot->getSubArea();
 
 #ifdef ALTAI_DEBUG
@@ -1363,6 +1484,7 @@ namespace AltAI
         for (PlotSet::iterator iter(updatedPlots_.begin()); iter != updatedPlots_.end();)
         {
             PlayerTypes owner = (*iter)->getRevealedOwner(player_.getTeamID(), false);
+            plotValueChanges_.coords.insert((*iter)->getCoords());
             // consider plots we or nobody owns
             if (owner == NO_PLAYER || owner == player_.getPlayerID())
             {
@@ -1379,12 +1501,12 @@ namespace AltAI
     void MapAnalysis::removePlotValuePlot_(const CvPlot* pPlot)
     {
         const XYCoords coords(pPlot->getCoords());
-        KeyInfoMap::const_iterator keyIter = keyInfoMap_.find(coords);
-        if (keyIter == keyInfoMap_.end())
+        const int* pPlotKey = findPlotKey_(coords);
+        if (!pPlotKey)
         {
             return;
         }
-        const int key = keyIter->second;
+        const int key = *pPlotKey;
 
 //#ifdef ALTAI_DEBUG
 //        std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
@@ -1456,6 +1578,32 @@ namespace AltAI
     }
 
     // plot update helper functions
+    int* MapAnalysis::findPlotKey_(XYCoords coords)
+    {
+        if (plotKeys_.empty())
+        {
+            return NULL;
+        }
+        int& plotKey = plotKeys_[gGlobals.getMap().plotNum(coords.iX, coords.iY)];
+        return plotKey == NoPlotKey ? NULL : &plotKey;
+    }
+
+    int* MapAnalysis::setPlotKey_(XYCoords coords, int key)
+    {
+        if (plotKeys_.empty())
+        {
+            plotKeys_.assign(gGlobals.getMap().numPlots(), NoPlotKey);
+        }
+        int& plotKey = plotKeys_[gGlobals.getMap().plotNum(coords.iX, coords.iY)];
+        plotKey = key;
+        return &plotKey;
+    }
+
+    int MapAnalysis::getPlotKey_(XYCoords coords) const
+    {
+        return plotKeys_.empty() ? NoPlotKey : plotKeys_[gGlobals.getMap().plotNum(coords.iX, coords.iY)];
+    }
+
     std::pair<int, MapAnalysis::PlotInfoMap::iterator> MapAnalysis::updatePlotInfo_(const CvPlot* pPlot, bool isNew, bool forceKeyUpdate)
     {
         const XYCoords coords(pPlot->getCoords());
@@ -1472,20 +1620,20 @@ namespace AltAI
 
         if (isNew)
         {
-            KeyInfoMap::iterator keyIter = keyInfoMap_.find(coords);
-            if (keyIter != keyInfoMap_.end())
+            int* pPlotKey = findPlotKey_(coords);
+            if (pPlotKey)
             {
-                oldKey = keyIter->second;
+                oldKey = *pPlotKey;
 //#ifdef ALTAI_DEBUG
 //                os << "\n(updatePlotInfo_): key already exists for coords: " << coords << " - existing key = " << oldKey << ", new key = " << newKey;
 //#endif
                 if (oldKey != newKey)
                 {
-                    keyIter->second = newKey;
+                    *pPlotKey = newKey;
                     keyCoordsMap_[oldKey].erase(coords);
                     keyCoordsMap_[newKey].insert(coords);
                     plotInfoMap_.erase(oldKey);
-                    plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, plotInfo.getInfo())).first;
+                    plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, PlotInfoNodeStore::getInstance()->intern(plotInfo.getInfo()))).first;
                 }
                 else
                 {
@@ -1497,19 +1645,19 @@ namespace AltAI
 //#ifdef ALTAI_DEBUG
 //                os << "\n(updatePlotInfo_): adding key: " << newKey << " for coords: " << coords;
 //#endif
-                keyInfoMap_[coords] = newKey;
+                setPlotKey_(coords, newKey);
                 keyCoordsMap_[newKey].insert(coords);
-                plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, plotInfo.getInfo())).first;
+                plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, PlotInfoNodeStore::getInstance()->intern(plotInfo.getInfo()))).first;
             }
         }
         else  // updating existing plot
         {
-            KeyInfoMap::iterator keyIter = keyInfoMap_.find(coords);
-            if (keyIter == keyInfoMap_.end())  // plot info missing altogether
+            int* pPlotKey = findPlotKey_(coords);
+            if (!pPlotKey)  // plot info missing altogether
             {
-                keyIter = keyInfoMap_.insert(std::make_pair(coords, newKey)).first;
+                pPlotKey = setPlotKey_(coords, newKey);
                 keyCoordsMap_[newKey].insert(coords);
-                plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, plotInfo.getInfo())).first;
+                plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, PlotInfoNodeStore::getInstance()->intern(plotInfo.getInfo()))).first;
 
 //#ifdef ALTAI_DEBUG
 //                os << "\n(updatePlotInfo_): Missing plot info?: key = " << newKey << ", coords = " << pPlot->getCoords()
@@ -1518,7 +1666,7 @@ namespace AltAI
             }
             else  // found existing key for these coords
             {
-                oldKey = keyIter->second;
+                oldKey = *pPlotKey;
                 if (oldKey != newKey)
                 {
                     KeyCoordsMap::iterator keyCoordsIter = keyCoordsMap_.find(oldKey);
@@ -1532,9 +1680,9 @@ namespace AltAI
                         }
                     }
                     
-                    keyIter->second = newKey;
+                    *pPlotKey = newKey;
                     keyCoordsMap_[newKey].insert(coords);
-                    plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, plotInfo.getInfo())).first;
+                    plotInfoIter = plotInfoMap_.insert(std::make_pair(newKey, PlotInfoNodeStore::getInstance()->intern(plotInfo.getInfo()))).first;
 //#ifdef ALTAI_DEBUG
 //                    os << "\n(updatePlotInfo_): Updating plot info: key = " << newKey << ", old key = " << oldKey << ", coords = " << pPlot->getCoords();
 //#endif
@@ -1565,7 +1713,7 @@ namespace AltAI
     void MapAnalysis::addDotMapPlot_(const CvPlot* pPlot, const PlotInfo::PlotInfoNode& plotInfo)
     {
         const XYCoords coords(pPlot->getCoords());
-        const int key = keyInfoMap_[coords];
+        const int key = getPlotKey_(coords);
         const TeamTypes teamType = player_.getTeamID();
 
 //#ifdef ALTAI_DEBUG
@@ -1621,7 +1769,7 @@ namespace AltAI
                         if (playerType == NO_PLAYER || playerType == player_.getPlayerID())
                         {
                             const PlotInfo::PlotInfoNode& thisNode = getPlotInfoNode(pLoopPlot);
-                            const int thisKey = keyInfoMap_[pLoopPlot->getCoords()];
+                            const int thisKey = getPlotKey_(pLoopPlot->getCoords());
 
                             if (hasPossibleYield(thisNode, player_.getPlayerID()))
                             {
@@ -1650,6 +1798,7 @@ namespace AltAI
         const TeamTypes teamType = player_.getTeamID();
         const PlayerTypes playerType = player_.getPlayerID();
         const XYCoords coords(pPlot->getCoords());
+        plotValueChanges_.coords.insert(coords);
 
         // update plot keys
         for (int i = 1; i <= CITY_PLOTS_RADIUS; ++i)
@@ -1751,6 +1900,7 @@ namespace AltAI
 
         plotValues_.keysValueMap[key] = getYields(plotInfo, player_.getPlayerID(), false,
             player_.getCvPlayer()->isBarbarian() ? BarbDotMapTechDepth : DotMapTechDepth);
+        plotValueChanges_.keys.insert(key);
     }
 
     void MapAnalysis::updateKeysValueYields_()
@@ -1761,7 +1911,7 @@ namespace AltAI
             PlotInfoMap::const_iterator plotInfoIter = plotInfoMap_.find(keyIter->first);
             if (plotInfoIter != plotInfoMap_.end())
             {
-                keyIter->second = getYields(plotInfoIter->second, player_.getPlayerID(), false,
+                keyIter->second = getYields(*plotInfoIter->second, player_.getPlayerID(), false,
                     player_.getCvPlayer()->isBarbarian() ? BarbDotMapTechDepth : DotMapTechDepth);
             }
         }
@@ -1822,7 +1972,7 @@ namespace AltAI
                     }
 
                     // does this plot have any remaining unrevealed neighbours, if we're adding a new border plot?
-                    if (unrevealedBorderMap_[pLoopPlot->getSubArea()].find(pLoopPlot->getCoords()) != unrevealedBorderMap_[pLoopPlot->getSubArea()].end())
+                    if (unrevealedBorderMap_.contains(pLoopPlot->getSubArea(), pLoopPlot->getCoords()))
                     {
                         possiblePlotsToRemoveFromBorder.push_back(pLoopPlot);
                     }
@@ -1836,7 +1986,7 @@ namespace AltAI
 
         if (hasUnrevealedNeighbours)
         {
-            unrevealedBorderMap_[pPlot->getSubArea()].insert(pPlot->getCoords());
+            unrevealedBorderMap_.insert(pPlot->getSubArea(), pPlot->getCoords());
         }
         
         // check this even if we didn't add a new border plot - could be filling in an interior region of border...
@@ -1855,7 +2005,7 @@ namespace AltAI
 
             if (!hasUnrevealedNeighbours)
             {
-                unrevealedBorderMap_[possiblePlotsToRemoveFromBorder[i]->getSubArea()].erase(possiblePlotsToRemoveFromBorder[i]->getCoords());
+                unrevealedBorderMap_.erase(possiblePlotsToRemoveFromBorder[i]->getCoords());
             }
         }
     }
@@ -1882,7 +2032,7 @@ namespace AltAI
                     else
                     {
                         // is this plot a border plot?
-                        if (ourBorderMap_[pLoopPlot->getSubArea()].find(pLoopPlot->getCoords()) != ourBorderMap_[pLoopPlot->getSubArea()].end())
+                        if (ourBorderMap_.contains(pLoopPlot->getSubArea(), pLoopPlot->getCoords()))
                         {
                             possiblePlotsToRemoveFromBorder.push_back(pLoopPlot);
                         }
@@ -1892,7 +2042,7 @@ namespace AltAI
 
             if (plotIsBorder)
             {
-                ourBorderMap_[pPlot->getSubArea()].insert(pPlot->getCoords());
+                ourBorderMap_.insert(pPlot->getSubArea(), pPlot->getCoords());
             }
 
             for (size_t i = 0, count = possiblePlotsToRemoveFromBorder.size(); i < count; ++i)
@@ -1910,14 +2060,14 @@ namespace AltAI
 
                 if (!plotIsBorder)
                 {
-                    ourBorderMap_[possiblePlotsToRemoveFromBorder[i]->getSubArea()].erase(possiblePlotsToRemoveFromBorder[i]->getCoords());
+                    ourBorderMap_.erase(possiblePlotsToRemoveFromBorder[i]->getCoords());
                 }
             }
         }
         else
         {
             // possibly erase ourself from the border
-            ourBorderMap_[pPlot->getSubArea()].erase(pPlot->getCoords());
+            ourBorderMap_.erase(pPlot->getCoords());
 
             NeighbourPlotIter iter(pPlot);
             while (IterPlot pLoopPlot = iter())
@@ -2329,6 +2479,7 @@ namespace AltAI
         IDInfo thisCity = pCity->getIDInfo();
 
         seenCities_[thisCity] = coords;
+        updateCityDistanceFields_(pCity, true);
 
         if (pCity->getOwner() == player_.getPlayerID())
         {
@@ -2421,6 +2572,7 @@ namespace AltAI
         os << "\nRemoving plot: " << pPlot->getCoords() << " from plot values map for sub area: (new city) " << pPlot->getSubArea();
 #endif
         plotValues_.plotValueMap[pPlot->getSubArea()].erase(pPlot->getCoords());
+        plotValueChanges_.coords.insert(pPlot->getCoords());
         // neightbouring plots which are now invalid (must be same area)
         NeighbourPlotIter plotIter(pPlot, 2, 2);
         while (IterPlot pLoopPlot = plotIter())
@@ -2501,6 +2653,8 @@ namespace AltAI
 
         citySharedPlots_.erase(city);
         updatePlotInfo_(pPlot, false);
+        updateCityDistanceFields_(pCity, false);
+        plotValueChanges_.coords.insert(pPlot->getCoords());
     }
    
     // debug functions
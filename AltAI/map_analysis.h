@@ -2,9 +2,13 @@
 
 #include "./utils.h"
 #include "./plot_info.h"
+#include "./plot_info_store.h"
 #include "./dot_map.h"
 #include "./shared_plot.h"
 #include "./city_improvements.h"
+#include "./movement_cost_field.h"
+#include "./city_distance_field.h"
+#include "./plot_tables.h"
 
 #include "boost/enable_shared_from_this.hpp"
 
@@ -72,6 +76,8 @@ namespace AltAI
         void updatePlotFeature(const CvPlot* pPlot, FeatureTypes oldFeatureType);
         void updatePlotImprovement(const CvPlot* pPlot, ImprovementTypes oldImprovementType);
         void updatePlotCulture(const CvPlot* pPlot, PlayerTypes previousRevealedOwner, PlayerTypes newRevealedOwner);
+        // route or actual owner change
+        void updatePlotMovementCosts(const CvPlot* pPlot);
         void updateResourceData(const std::vector<BonusTypes>& revealedBonusTypes);
         void updatePlotBonus(const CvPlot* pPlot, BonusTypes bonusType);
 
@@ -86,8 +92,8 @@ namespace AltAI
         bool getTurnsToOwnership(const CvPlot* pPlot, bool includeOtherPlayers, IDInfo& owningCity, int& turns) const;
         std::vector<XYCoords> getGoodyHuts(int subArea) const;
 
-        const std::map<int /* sub area id */, std::set<XYCoords> >& getBorderMap() const;
-        const std::map<int /* sub area id */, std::set<XYCoords> >& getUnrevealedBorderMap() const;
+        const SubAreaPlotSet& getBorderMap() const;
+        const SubAreaPlotSet& getUnrevealedBorderMap() const;
         int getUnrevealedBorderCount(int subAreaId) const;
         bool isOurBorderPlot(int subAreaId, XYCoords coords) const;
         std::vector<int /* area id */> getAreasBorderingArea(int areaId) const;
@@ -95,10 +101,27 @@ namespace AltAI
         std::map<int /* sub area id */, std::vector<IDInfo> > getSubAreaCityMap() const;
 
         const PlotInfo::PlotInfoNode& getPlotInfoNode(const CvPlot* pPlot);
+        // movement costs for units of the given team (brought up to date for the current turn)
+        const MovementCostField& getMovementCostField(TeamTypes teamType);
         const Player& getPlayer() const { return player_; }
 
+        // plots and plot keys whose plot values have changed since the last call to clearPlotValueChanges()
+        // all is set when every plot key's yields have been recalculated (e.g. on acquiring a tech)
+        struct PlotValueChanges
+        {
+            PlotValueChanges() : all(false) {}
+            bool empty() const { return !all && coords.empty() && keys.empty(); }
+
+            std::set<XYCoords> coords;
+            std::set<int> keys;
+            bool all;
+        };
+
         const PlotValues& getPlotValues();
         bool plotValuesDirty() const;
+        // processes any pending plot updates first, as getPlotValues()
+        const PlotValueChanges& getPlotValueChanges();
+        void clearPlotValueChanges();
 
         void analyseSharedPlots(const std::set<IDInfo>& cities);
         void addCity(const CvCity* pCity);
@@ -148,6 +171,15 @@ namespace AltAI
         void removePlotValuePlot_(const CvPlot* pPlot);
 
         void updateBorderPlots_(const CvPlot* pPlot, bool isAdding);
+        void updateMovementCosts_(const CvPlot* pPlot);
+
+        // fields for getClosestCity(), keyed by sub area and whether acts as city plots are included
+        typedef std::map<std::pair<int, bool>, CityDistanceField> CityDistanceFieldMap;
+        const CityDistanceField& getCityDistanceField_(int subArea, bool includeActsAsCity) const;
+        std::vector<int> getCityDistanceSources_(int subArea, bool includeActsAsCity) const;
+        bool isCityDistanceSource_(const CvPlot* pPlot, int subArea) const;
+        void updateCityDistanceFields_(const CvCity* pCity, bool isAdding);
+        void clearActsAsCityDistanceFields_();
 
         void setWorkingCity_(XYCoords coords, IDInfo assignedCity);
 
@@ -158,30 +190,35 @@ namespace AltAI
         SubAreaMap revealedSubAreaDataMap_;
         std::map<int /* area id */, std::set<int /* sub area id */> > areaSubAreaMap_;
 
-        std::map<int /* sub area id */, std::set<XYCoords> > impAsCityMap_;
+        SubAreaPlotSet impAsCityMap_;
 
-        std::map<int /* sub area id */, std::set<XYCoords> > unrevealedBorderMap_, ourBorderMap_;
+        SubAreaPlotSet unrevealedBorderMap_, ourBorderMap_;
         // key = sub area id
         typedef std::map<int, ResourceData> ResourcesMap;
         typedef ResourcesMap::iterator ResourcesMapIter;
         typedef ResourcesMap::const_iterator ResourcesMapConstIter;
         ResourcesMap resourcesMap_;
 
-        // value is plot key
-        typedef std::map<XYCoords, int> KeyInfoMap;
-        KeyInfoMap keyInfoMap_;
+        // plot key by plot number (NoPlotKey if the plot's info hasn't been added)
+        static const int NoPlotKey = -1;
+        std::vector<int> plotKeys_;
+
+        int* findPlotKey_(XYCoords coords);
+        int* setPlotKey_(XYCoords coords, int key);
+        int getPlotKey_(XYCoords coords) const;
 
         // key is plot key
         typedef std::map<int, std::set<XYCoords> > KeyCoordsMap;
         KeyCoordsMap keyCoordsMap_;
 
-        // key is plot key
-        typedef std::map<int, PlotInfo::PlotInfoNode> PlotInfoMap;
+        // key is plot key - nodes are shared between players through the PlotInfoNodeStore
+        typedef std::map<int, PlotInfoNodeHandle> PlotInfoMap;
         PlotInfoMap plotInfoMap_;
 
         std::pair<int, PlotInfoMap::iterator> updatePlotInfo_(const CvPlot* pPlot, bool isNew, bool forceKeyUpdate = false);
 
         PlotValues plotValues_, previousPlotValues_;
+        PlotValueChanges plotValueChanges_;
         
         typedef std::set<DotMapItem> DotMap;
         std::map<int, XYCoords, std::greater<int> > bestSites_;
@@ -193,7 +230,7 @@ namespace AltAI
         CitySharedPlotsMap::iterator getCitySharedPlots_(IDInfo city);
 
         // set of all shared plots
-        typedef std::map<XYCoords, SharedPlot> SharedPlots;
+        typedef SharedPlotTable SharedPlots;
         SharedPlots sharedPlots_;
 
         SharedPlots::iterator getSharedPlot_(XYCoords coords);
@@ -202,6 +239,12 @@ namespace AltAI
         std::set<XYCoords> goodyHuts_;
         PlotSet updatedPlots_;
 
+        std::map<TeamTypes, MovementCostField> movementCostFields_;
+
+        mutable CityDistanceFieldPlots cityDistanceFieldPlots_;  // neighbour and sub area plot tables shared by all the fields
+        mutable CityDistanceFieldMap cityDistanceFields_;
+        mutable int cityDistanceFieldsCityCount_;  // team's city count the fields were built or last updated for
+
         void analyseSharedPlot_(const std::set<XYCoords>& sharedCoords);
     };
 }
\ No newline at end of file
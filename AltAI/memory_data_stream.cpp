@@ -0,0 +1,513 @@
+#include "AltAI.h"
+
+#include "./memory_data_stream.h"
+
+#include <fstream>
+
+namespace AltAI
+{
+    MemoryDataStream::MemoryDataStream() : position_(0), isValid_(true)
+    {
+    }
+
+    MemoryDataStream::Hash MemoryDataStream::getHash() const
+    {
+        return getHash(0);
+    }
+
+    MemoryDataStream::Hash MemoryDataStream::getHash(unsigned int position) const
+    {
+        Hash hash = 14695981039346656037ui64;
+        for (size_t i = position, count = buffer_.size(); i < count; ++i)
+        {
+            hash ^= (unsigned char)buffer_[i];
+            hash *= 1099511628211ui64;
+        }
+        return hash;
+    }
+
+    bool MemoryDataStream::isValid() const
+    {
+        return isValid_;
+    }
+
+    bool MemoryDataStream::saveToFile(const std::string& fileName) const
+    {
+        std::ofstream ofs(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs)
+        {
+            return false;
+        }
+
+        if (!buffer_.empty())
+        {
+            ofs.write(&buffer_[0], (std::streamsize)buffer_.size());
+        }
+        return !ofs.fail();
+    }
+
+    bool MemoryDataStream::loadFromFile(const std::string& fileName)
+    {
+        buffer_.clear();
+        position_ = 0;
+        isValid_ = true;
+
+        std::ifstream ifs(fileName.c_str(), std::ios::in | std::ios::binary);
+        if (!ifs)
+        {
+            return false;
+        }
+
+        ifs.seekg(0, std::ios::end);
+        const std::streamoff size = ifs.tellg();
+        ifs.seekg(0, std::ios::beg);
+
+        if (size <= 0)
+        {
+            return false;
+        }
+
+        buffer_.resize((size_t)size);
+        ifs.read(&buffer_[0], (std::streamsize)size);
+
+        if (ifs.fail())
+        {
+            buffer_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    void MemoryDataStream::write_(const void* data, size_t size)
+    {
+        if (position_ + size > buffer_.size())
+        {
+            buffer_.resize(position_ + size);
+        }
+        if (size > 0)
+        {
+            memcpy(&buffer_[position_], data, size);
+            position_ += size;
+        }
+    }
+
+    void MemoryDataStream::read_(void* data, size_t size)
+    {
+        if (position_ + size > buffer_.size())
+        {
+            // leave the caller with zeros rather than garbage
+            memset(data, 0, size);
+            position_ = buffer_.size();
+            isValid_ = false;
+            return;
+        }
+        if (size > 0)
+        {
+            memcpy(data, &buffer_[position_], size);
+            position_ += size;
+        }
+    }
+
+    void MemoryDataStream::Rewind()
+    {
+        position_ = 0;
+    }
+
+    bool MemoryDataStream::AtEnd()
+    {
+        return position_ >= buffer_.size();
+    }
+
+    void MemoryDataStream::FastFwd()
+    {
+        position_ = buffer_.size();
+    }
+
+    unsigned int MemoryDataStream::GetPosition() const
+    {
+        return position_;
+    }
+
+    void MemoryDataStream::SetPosition(unsigned int position)
+    {
+        position_ = std::min<size_t>(position, buffer_.size());
+    }
+
+    void MemoryDataStream::Truncate()
+    {
+        buffer_.resize(position_);
+    }
+
+    void MemoryDataStream::Flush()
+    {
+    }
+
+    unsigned int MemoryDataStream::GetEOF() const
+    {
+        return buffer_.size();
+    }
+
+    unsigned int MemoryDataStream::GetSizeLeft() const
+    {
+        return buffer_.size() - position_;
+    }
+
+    void MemoryDataStream::CopyToMem(void* mem)
+    {
+        if (!buffer_.empty())
+        {
+            memcpy(mem, &buffer_[0], buffer_.size());
+        }
+    }
+
+    // strings are stored as their length followed by their characters (no terminator)
+    unsigned int MemoryDataStream::WriteString(const wchar* szName)
+    {
+        const int length = szName ? (int)wcslen(szName) : 0;
+        Write(length);
+        write_(szName, length * sizeof(wchar));
+        return sizeof(int) + length * sizeof(wchar);
+    }
+
+    unsigned int MemoryDataStream::WriteString(const char* szName)
+    {
+        const int length = szName ? (int)strlen(szName) : 0;
+        Write(length);
+        write_(szName, length);
+        return sizeof(int) + length;
+    }
+
+    unsigned int MemoryDataStream::WriteString(const std::string& szName)
+    {
+        return WriteString(szName.c_str());
+    }
+
+    unsigned int MemoryDataStream::WriteString(const std::wstring& szName)
+    {
+        return WriteString(szName.c_str());
+    }
+
+    unsigned int MemoryDataStream::WriteString(int count, std::string values[])
+    {
+        unsigned int size = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            size += WriteString(values[i]);
+        }
+        return size;
+    }
+
+    unsigned int MemoryDataStream::WriteString(int count, std::wstring values[])
+    {
+        unsigned int size = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            size += WriteString(values[i]);
+        }
+        return size;
+    }
+
+    unsigned int MemoryDataStream::ReadString(char* szName)
+    {
+        int length = 0;
+        Read(&length);
+        length = std::max<int>(0, std::min<int>(length, GetSizeLeft()));
+        read_(szName, length);
+        szName[length] = '\0';
+        return sizeof(int) + length;
+    }
+
+    unsigned int MemoryDataStream::ReadString(wchar* szName)
+    {
+        int length = 0;
+        Read(&length);
+        length = std::max<int>(0, std::min<int>(length, GetSizeLeft() / sizeof(wchar)));
+        read_(szName, length * sizeof(wchar));
+        szName[length] = L'\0';
+        return sizeof(int) + length * sizeof(wchar);
+    }
+
+    unsigned int MemoryDataStream::ReadString(std::string& szName)
+    {
+        int length = 0;
+        Read(&length);
+        length = std::max<int>(0, std::min<int>(length, GetSizeLeft()));
+        szName.resize(length);
+        if (length > 0)
+        {
+            read_(&szName[0], length);
+        }
+        return sizeof(int) + length;
+    }
+
+    unsigned int MemoryDataStream::ReadString(std::wstring& szName)
+    {
+        int length = 0;
+        Read(&length);
+        length = std::max<int>(0, std::min<int>(length, GetSizeLeft() / sizeof(wchar)));
+        szName.resize(length);
+        if (length > 0)
+        {
+            read_(&szName[0], length * sizeof(wchar));
+        }
+        return sizeof(int) + length * sizeof(wchar);
+    }
+
+    unsigned int MemoryDataStream::ReadString(int count, std::string values[])
+    {
+        unsigned int size = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            size += ReadString(values[i]);
+        }
+        return size;
+    }
+
+    unsigned int MemoryDataStream::ReadString(int count, std::wstring values[])
+    {
+        unsigned int size = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            size += ReadString(values[i]);
+        }
+        return size;
+    }
+
+    char* MemoryDataStream::ReadString()
+    {
+        std::string value;
+        ReadString(value);
+        char* szValue = new char[value.size() + 1];
+        strcpy(szValue, value.c_str());
+        return szValue;
+    }
+
+    wchar* MemoryDataStream::ReadWideString()
+    {
+        std::wstring value;
+        ReadString(value);
+        wchar* szValue = new wchar[value.size() + 1];
+        wcscpy(szValue, value.c_str());
+        return szValue;
+    }
+
+    void MemoryDataStream::Read(char* value)
+    {
+        read_(value, sizeof(char));
+    }
+
+    void MemoryDataStream::Read(byte* value)
+    {
+        read_(value, sizeof(byte));
+    }
+
+    void MemoryDataStream::Read(int count, char values[])
+    {
+        read_(values, count * sizeof(char));
+    }
+
+    void MemoryDataStream::Read(int count, byte values[])
+    {
+        read_(values, count * sizeof(byte));
+    }
+
+    void MemoryDataStream::Read(bool* value)
+    {
+        read_(value, sizeof(bool));
+    }
+
+    void MemoryDataStream::Read(int count, bool values[])
+    {
+        read_(values, count * sizeof(bool));
+    }
+
+    void MemoryDataStream::Read(short* value)
+    {
+        read_(value, sizeof(short));
+    }
+
+    void MemoryDataStream::Read(unsigned short* value)
+    {
+        read_(value, sizeof(unsigned short));
+    }
+
+    void MemoryDataStream::Read(int count, short values[])
+    {
+        read_(values, count * sizeof(short));
+    }
+
+    void MemoryDataStream::Read(int count, unsigned short values[])
+    {
+        read_(values, count * sizeof(unsigned short));
+    }
+
+    void MemoryDataStream::Read(int* value)
+    {
+        read_(value, sizeof(int));
+    }
+
+    void MemoryDataStream::Read(unsigned int* value)
+    {
+        read_(value, sizeof(unsigned int));
+    }
+
+    void MemoryDataStream::Read(int count, int values[])
+    {
+        read_(values, count * sizeof(int));
+    }
+
+    void MemoryDataStream::Read(int count, unsigned int values[])
+    {
+        read_(values, count * sizeof(unsigned int));
+    }
+
+    void MemoryDataStream::Read(long* value)
+    {
+        read_(value, sizeof(long));
+    }
+
+    void MemoryDataStream::Read(unsigned long* value)
+    {
+        read_(value, sizeof(unsigned long));
+    }
+
+    void MemoryDataStream::Read(int count, long values[])
+    {
+        read_(values, count * sizeof(long));
+    }
+
+    void MemoryDataStream::Read(int count, unsigned long values[])
+    {
+        read_(values, count * sizeof(unsigned long));
+    }
+
+    void MemoryDataStream::Read(float* value)
+    {
+        read_(value, sizeof(float));
+    }
+
+    void MemoryDataStream::Read(int count, float values[])
+    {
+        read_(values, count * sizeof(float));
+    }
+
+    void MemoryDataStream::Read(double* value)
+    {
+        read_(value, sizeof(double));
+    }
+
+    void MemoryDataStream::Read(int count, double values[])
+    {
+        read_(values, count * sizeof(double));
+    }
+
+    void MemoryDataStream::Write(char value)
+    {
+        write_(&value, sizeof(char));
+    }
+
+    void MemoryDataStream::Write(byte value)
+    {
+        write_(&value, sizeof(byte));
+    }
+
+    void MemoryDataStream::Write(int count, const char values[])
+    {
+        write_(values, count * sizeof(char));
+    }
+
+    void MemoryDataStream::Write(int count, const byte values[])
+    {
+        write_(values, count * sizeof(byte));
+    }
+
+    void MemoryDataStream::Write(bool value)
+    {
+        write_(&value, sizeof(bool));
+    }
+
+    void MemoryDataStream::Write(int count, const bool values[])
+    {
+        write_(values, count * sizeof(bool));
+    }
+
+    void MemoryDataStream::Write(short value)
+    {
+        write_(&value, sizeof(short));
+    }
+
+    void MemoryDataStream::Write(unsigned short value)
+    {
+        write_(&value, sizeof(unsigned short));
+    }
+
+    void MemoryDataStream::Write(int count, const short values[])
+    {
+        write_(values, count * sizeof(short));
+    }
+
+    void MemoryDataStream::Write(int count, const unsigned short values[])
+    {
+        write_(values, count * sizeof(unsigned short));
+    }
+
+    void MemoryDataStream::Write(int value)
+    {
+        write_(&value, sizeof(int));
+    }
+
+    void MemoryDataStream::Write(unsigned int value)
+    {
+        write_(&value, sizeof(unsigned int));
+    }
+
+    void MemoryDataStream::Write(int count, const int values[])
+    {
+        write_(values, count * sizeof(int));
+    }
+
+    void MemoryDataStream::Write(int count, const unsigned int values[])
+    {
+        write_(values, count * sizeof(unsigned int));
+    }
+
+    void MemoryDataStream::Write(long value)
+    {
+        write_(&value, sizeof(long));
+    }
+
+    void MemoryDataStream::Write(unsigned long value)
+    {
+        write_(&value, sizeof(unsigned long));
+    }
+
+    void MemoryDataStream::Write(int count, const long values[])
+    {
+        write_(values, count * sizeof(long));
+    }
+
+    void MemoryDataStream::Write(int count, const unsigned long values[])
+    {
+        write_(values, count * sizeof(unsigned long));
+    }
+
+    void MemoryDataStream::Write(float value)
+    {
+        write_(&value, sizeof(float));
+    }
+
+    void MemoryDataStream::Write(int count, const float values[])
+    {
+        write_(values, count * sizeof(float));
+    }
+
+    void MemoryDataStream::Write(double value)
+    {
+        write_(&value, sizeof(double));
+    }
+
+    void MemoryDataStream::Write(int count, const double values[])
+    {
+        write_(values, count * sizeof(double));
+    }
+}
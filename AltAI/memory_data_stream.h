@@ -0,0 +1,109 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    // FDataStreamBase over an in memory buffer - allows the save game style write()/read() functions
+    // (and the CvInfo classes' xml cache ones) to be used for data which is kept outside of the save game
+    class MemoryDataStream : public FDataStreamBase
+    {
+    public:
+        typedef unsigned __int64 Hash;
+
+        MemoryDataStream();
+
+        // 64 bit FNV-1a hash of everything written so far
+        Hash getHash() const;
+        // same, but only of the bytes from the given position on (e.g. to skip a header)
+        Hash getHash(unsigned int position) const;
+
+        // false if any read has gone past the end of the buffer
+        bool isValid() const;
+
+        bool saveToFile(const std::string& fileName) const;
+        bool loadFromFile(const std::string& fileName);
+
+        virtual void Rewind();
+        virtual bool AtEnd();
+        virtual void FastFwd();
+        virtual unsigned int GetPosition() const;
+        virtual void SetPosition(unsigned int position);
+        virtual void Truncate();
+        virtual void Flush();
+        virtual unsigned int GetEOF() const;
+        virtual unsigned int GetSizeLeft() const;
+        virtual void CopyToMem(void* mem);
+
+        virtual unsigned int WriteString(const wchar* szName);
+        virtual unsigned int WriteString(const char* szName);
+        virtual unsigned int WriteString(const std::string& szName);
+        virtual unsigned int WriteString(const std::wstring& szName);
+        virtual unsigned int WriteString(int count, std::string values[]);
+        virtual unsigned int WriteString(int count, std::wstring values[]);
+
+        virtual unsigned int ReadString(char* szName);
+        virtual unsigned int ReadString(wchar* szName);
+        virtual unsigned int ReadString(std::string& szName);
+        virtual unsigned int ReadString(std::wstring& szName);
+        virtual unsigned int ReadString(int count, std::string values[]);
+        virtual unsigned int ReadString(int count, std::wstring values[]);
+
+        virtual char* ReadString();
+        virtual wchar* ReadWideString();
+
+        virtual void Read(char* value);
+        virtual void Read(byte* value);
+        virtual void Read(int count, char values[]);
+        virtual void Read(int count, byte values[]);
+        virtual void Read(bool* value);
+        virtual void Read(int count, bool values[]);
+        virtual void Read(short* value);
+        virtual void Read(unsigned short* value);
+        virtual void Read(int count, short values[]);
+        virtual void Read(int count, unsigned short values[]);
+        virtual void Read(int* value);
+        virtual void Read(unsigned int* value);
+        virtual void Read(int count, int values[]);
+        virtual void Read(int count, unsigned int values[]);
+        virtual void Read(long* value);
+        virtual void Read(unsigned long* value);
+        virtual void Read(int count, long values[]);
+        virtual void Read(int count, unsigned long values[]);
+        virtual void Read(float* value);
+        virtual void Read(int count, float values[]);
+        virtual void Read(double* value);
+        virtual void Read(int count, double values[]);
+
+        virtual void Write(char value);
+        virtual void Write(byte value);
+        virtual void Write(int count, const char values[]);
+        virtual void Write(int count, const byte values[]);
+        virtual void Write(bool value);
+        virtual void Write(int count, const bool values[]);
+        virtual void Write(short value);
+        virtual void Write(unsigned short value);
+        virtual void Write(int count, const short values[]);
+        virtual void Write(int count, const unsigned short values[]);
+        virtual void Write(int value);
+        virtual void Write(unsigned int value);
+        virtual void Write(int count, const int values[]);
+        virtual void Write(int count, const unsigned int values[]);
+        virtual void Write(long value);
+        virtual void Write(unsigned long value);
+        virtual void Write(int count, const long values[]);
+        virtual void Write(int count, const unsigned long values[]);
+        virtual void Write(float value);
+        virtual void Write(int count, const float values[]);
+        virtual void Write(double value);
+        virtual void Write(int count, const double values[]);
+
+    private:
+        void write_(const void* data, size_t size);
+        void read_(void* data, size_t size);
+
+        std::vector<char> buffer_;
+        size_t position_;
+        bool isValid_;
+    };
+}
@@ -27,6 +27,9 @@
 #include "./civ_log.h"
 #include "./unit_log.h"
 #include "./helper_fns.h"
+#include "./hostile_influence_map.h"
+#include "./profiler.h"
+#include "./worker_pool.h"
 
 namespace AltAI
 {
@@ -164,6 +167,42 @@ namespace AltAI
 
             XYCoords newUnitCoords;
         };
+
+        struct CombatMapEvaluationTask : IWorkerTask
+        {
+            CombatMapEvaluationTask(const Player* pPlayer_, const CombatData* pCombatData_, CombatGraph* pCombatGraph_)
+                : pPlayer(pPlayer_), pCombatData(pCombatData_), pCombatGraph(pCombatGraph_)
+            {
+            }
+
+            virtual void run()
+            {
+                *pCombatGraph = getCombatGraph(*pPlayer, pCombatData->combatDetails, pCombatData->attackers, pCombatData->defenders);
+                pCombatGraph->analyseEndStates();
+            }
+
+            const Player* pPlayer;
+            const CombatData* pCombatData;
+            CombatGraph* pCombatGraph;
+        };
+
+        // evaluates each plot's combat - only reads the combat map snapshot and the player's unit analysis (whose odds caches are locked),
+        // so each plot's evaluation is independent of the others (and of the mission state the results are applied to afterwards)
+        // and can run on the worker pool - results are in the same order as the map's entries
+        void evaluateCombatMap(const Player& player, const std::map<XYCoords, CombatData>& combatMap, std::vector<CombatGraph>& combatGraphs)
+        {
+            combatGraphs.clear();
+            combatGraphs.resize(combatMap.size());
+
+            std::vector<CombatMapEvaluationTask> tasks;
+            tasks.reserve(combatMap.size());
+            for (std::map<XYCoords, CombatData>::const_iterator ci(combatMap.begin()), ciEnd(combatMap.end()); ci != ciEnd; ++ci)
+            {
+                tasks.push_back(CombatMapEvaluationTask(&player, &ci->second, &combatGraphs[tasks.size()]));
+            }
+
+            WorkerPool::getInstance()->runTasks(tasks);
+        }
     }
 
     class MilitaryAnalysisImpl
@@ -176,7 +215,7 @@ namespace AltAI
         static const size_t CategoryCount = 9;
 
         explicit MilitaryAnalysisImpl(Player& player)
-            : player_(player), pCityDefenceAnalysis_(new CityDefenceAnalysis(player))
+            : player_(player), hostileInfluenceMap_(player), pCityDefenceAnalysis_(new CityDefenceAnalysis(player))
         {   
         }
 
@@ -397,10 +436,9 @@ namespace AltAI
                         std::map<XYCoords, CombatData>::iterator defCombatIter = defenceCombatMap_.find(pPlot->getCoords());
                         if (defCombatIter != defenceCombatMap_.end())
                         {
-                            CombatGraph combatGraph = getCombatGraph(player_, defCombatIter->second.combatDetails, defCombatIter->second.attackers, defCombatIter->second.defenders);
-                            combatGraph.analyseEndStates();
-                            missionIter->second->hostileAttackOdds = combatGraph.endStatesData;
-                            defenceCombatData_[pPlot->getCoords()] = combatGraph.endStatesData;
+                            markCombatDataDirty_(pPlot->getCoords(), false);
+                            updateDirtyCombatData_();
+                            missionIter->second->hostileAttackOdds = defenceCombatData_[pPlot->getCoords()];
                         }
                     }
 
@@ -429,9 +467,7 @@ namespace AltAI
                                 if (attCombatIter != attackCombatMap_.end())
                                 {
                                     updateUnitData(attCombatIter->second.defenders);
-                                    CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                                    combatGraph.analyseEndStates();
-                                    attackCombatData_[*attackCoordsIter] = combatGraph.endStatesData;
+                                    markCombatDataDirty_(*attackCoordsIter, true);
                                 }
                             }
                         }
@@ -495,9 +531,7 @@ namespace AltAI
                     if (attCombatIter != attackCombatMap_.end())
                     {
                         updateUnitData(attCombatIter->second.defenders);
-                        CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                        combatGraph.analyseEndStates();
-                        attackCombatData_[pAttackPlot->getCoords()] = combatGraph.endStatesData;
+                        markCombatDataDirty_(pAttackPlot->getCoords(), true);
                     }
                 }
                 // need to update our defenceCombatMap, but not erase the withdrawing unit...
@@ -528,6 +562,7 @@ namespace AltAI
             if (CvTeamAI::getTeam(player_.getTeamID()).isAtWar(pUnit->getTeam()))
             {
                 addHostileUnitMission_(pPlot->getSubArea(), pPlot->getCoords(), pUnit->getIDInfo());
+                markHostileInfluenceDirty_(pPlot);
             }
         }
 
@@ -548,9 +583,7 @@ namespace AltAI
                         // todo - store last attacker/defender (although have to deal with units that create collateral damage)
                         // also - did we kill this unit? - if so - we need to remove the attacking unit unless it's blitz capable
                         updateUnitData(attCombatIter->second.attackers);
-                        CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                        combatGraph.analyseEndStates();
-                        attackCombatData_[pPlot->getCoords()] = combatGraph.endStatesData;
+                        markCombatDataDirty_(pPlot->getCoords(), true);
                     }
                 }
 
@@ -572,9 +605,7 @@ namespace AltAI
                             if (defCombatIter != defenceCombatMap_.end())
                             {                        
                                 updateUnitData(defCombatIter->second.defenders);
-                                CombatGraph combatGraph = getCombatGraph(player_, defCombatIter->second.combatDetails, defCombatIter->second.attackers, defCombatIter->second.defenders);
-                                combatGraph.analyseEndStates();
-                                defenceCombatData_[(*reachableHostilePlotsIter)->getCoords()] = combatGraph.endStatesData;
+                                markCombatDataDirty_((*reachableHostilePlotsIter)->getCoords(), false);
                             }
                         }
                     }
@@ -590,9 +621,7 @@ namespace AltAI
                             std::map<XYCoords, CombatData>::iterator attCombatIter(attackCombatMap_.find(pPlot->getCoords()));
                             if (attCombatIter != attackCombatMap_.end())
                             {
-                                CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                                combatGraph.analyseEndStates();
-                                attackCombatData_[pPlot->getCoords()] = combatGraph.endStatesData;
+                                markCombatDataDirty_(pPlot->getCoords(), true);
                             }
                         }
 
@@ -616,9 +645,7 @@ namespace AltAI
                                 if (attCombatIter != attackCombatMap_.end())
                                 {
                                     updateUnitData(attCombatIter->second.defenders);
-                                    CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                                    combatGraph.analyseEndStates();
-                                    attackCombatData_[*attackCoordsIter] = combatGraph.endStatesData;
+                                    markCombatDataDirty_(*attackCoordsIter, true);
                                 }
                             }
                         }                        
@@ -657,6 +684,11 @@ namespace AltAI
             // removes unit from unitsMap_ and unitStacks_
             eraseUnit_(unit, pPlot);
             unitHistories_.erase(unit);
+
+            if (CvTeamAI::getTeam(player_.getTeamID()).isAtWar(PlayerIDToTeamID(unit.eOwner)))
+            {
+                markHostileInfluenceDirty_(pPlot);
+            }
         }
 
         void withdrawPlayerUnit(CvUnitAI* pUnit, const CvPlot* pAttackPlot)
@@ -678,6 +710,13 @@ namespace AltAI
                 {
                     addHostileUnitMission_(pToPlot->getSubArea(), pToPlot->getCoords(), pUnit->getIDInfo());
                 }
+
+                if (pFromPlot)
+                {
+                    markHostileInfluenceDirty_(pFromPlot);
+                }
+                markHostileInfluenceDirty_(pToPlot);
+
                 // update attackCombatMap_ - hostile unit can no longer be attacked at the 'from' plot
                 if (pFromPlot)
                 {
@@ -687,9 +726,7 @@ namespace AltAI
                         if (attCombatIter != attackCombatMap_.end())
                         {
                             updateUnitData(attCombatIter->second.defenders);
-                            CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                            combatGraph.analyseEndStates();
-                            attackCombatData_[pFromPlot->getCoords()] = combatGraph.endStatesData;
+                            markCombatDataDirty_(pFromPlot->getCoords(), true);
                         }
                     }
                 }
@@ -712,9 +749,7 @@ namespace AltAI
                             if (defCombatIter != defenceCombatMap_.end())
                             {
                                 // no need to update defender's hp as it's not at this plot anymore
-                                CombatGraph combatGraph = getCombatGraph(player_, defCombatIter->second.combatDetails, defCombatIter->second.attackers, defCombatIter->second.defenders);
-                                combatGraph.analyseEndStates();
-                                defenceCombatData_[pFromPlot->getCoords()] = combatGraph.endStatesData;
+                                markCombatDataDirty_(pFromPlot->getCoords(), false);
                             }
                         }
 
@@ -723,9 +758,7 @@ namespace AltAI
                         if (defCombatIter != defenceCombatMap_.end())
                         {
                             defCombatIter->second.defenders.push_back(UnitData(pUnit));
-                            CombatGraph combatGraph = getCombatGraph(player_, defCombatIter->second.combatDetails, defCombatIter->second.attackers, defCombatIter->second.defenders);
-                            combatGraph.analyseEndStates();
-                            defenceCombatData_[pToPlot->getCoords()] = combatGraph.endStatesData;
+                            markCombatDataDirty_(pToPlot->getCoords(), false);
                         }
                         else
                         {
@@ -738,9 +771,7 @@ namespace AltAI
                             if (attCombatIter != attackCombatMap_.end())
                             {
                                 // no need to update attacker's hp as it's not at this plot anymore
-                                CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                                combatGraph.analyseEndStates();
-                                attackCombatData_[pFromPlot->getCoords()] = combatGraph.endStatesData;
+                                markCombatDataDirty_(pFromPlot->getCoords(), true);
                             }
                         }
 
@@ -752,9 +783,7 @@ namespace AltAI
                             {
                                 attCombatIter->second.attackers.push_back(UnitData(pUnit));
 
-                                CombatGraph combatGraph = getCombatGraph(player_, attCombatIter->second.combatDetails, attCombatIter->second.attackers, attCombatIter->second.defenders);
-                                combatGraph.analyseEndStates();
-                                attackCombatData_[pToPlot->getCoords()] = combatGraph.endStatesData;
+                                markCombatDataDirty_(pToPlot->getCoords(), true);
                             }
                             else
                             {
@@ -771,6 +800,11 @@ namespace AltAI
             // todo - treat differently from unit deletion? - add to list of untracked units?
             eraseUnit_(pUnit->getIDInfo(), pOldPlot);
             hideUnit_(pUnit->getIDInfo(), pOldPlot);
+
+            if (CvTeamAI::getTeam(player_.getTeamID()).isAtWar(pUnit->getTeam()))
+            {
+                markHostileInfluenceDirty_(pOldPlot);
+            }
         }
 
         void addOurCity(const CvCity* pCity)
@@ -1383,7 +1417,7 @@ namespace AltAI
                                     }
 
                                     UnitPathData unitPathData;
-                                    unitPathData.calculate(pathfinderUnitData, pLoopCity->plot(), pOurTargetCity->plot(), MOVE_MAX_MOVES | MOVE_IGNORE_DANGER, player_.getPlayerID(), player_.getTeamID());
+                                    unitPathData.calculate(pathfinderUnitData, pLoopCity->plot(), pOurTargetCity->plot(), player_.getPlayerID(), player_.getTeamID());
                                     if (unitPathData.valid)
                                     {
                                         cityRoutingMap.push_back(std::make_pair(pLoopCity->getIDInfo(), unitPathData.pathTurns));
@@ -1404,7 +1438,7 @@ namespace AltAI
 #endif
 
                             UnitPathData hostileUnitPathData;
-                            hostileUnitPathData.calculate(hostileUnitData, pHostileUnitsPlot, pOurTargetCity->plot(), MOVE_MAX_MOVES | MOVE_IGNORE_DANGER | MOVE_THROUGH_ENEMY, player_.getPlayerID(), player_.getTeamID());
+                            hostileUnitPathData.calculate(hostileUnitData, pHostileUnitsPlot, pOurTargetCity->plot(), player_.getPlayerID(), player_.getTeamID());
                             if (hostileUnitPathData.valid)
                             {
                                 std::map<IDInfo, int>::iterator tIter = timesToTargetMap.find((*missionsIter)->closestCity);
@@ -1616,24 +1650,30 @@ namespace AltAI
             return requestData;
         }
 
-        PlotUnitsMap getNearbyHostileStacks(const CvPlot* pPlot, int range)
+        // hostile stacks within range of the plot which can reach it next turn
+        PlotUnitsMap getNearbyHostileStacks(const CvPlot* pPlot, int range) const
         {
+            updateDirtyHostileInfluence_();
             PlotUnitsMap stacks;
+            const CvMap& theMap = gGlobals.getMap();
 
-            for (std::map<XYCoords, std::list<IDInfo> >::const_iterator si(enemyStacks_.begin()), siEnd(enemyStacks_.end()); si != siEnd; ++si)
+            const std::vector<int>& stackIndices = hostileInfluenceMap_.getStacks(pPlot);
+            for (size_t i = 0, count = stackIndices.size(); i < count; ++i)
             {
-                const CvPlot* pHostilePlot = gGlobals.getMap().plot(si->first.iX, si->first.iY);
+                const CvPlot* pHostilePlot = theMap.plotByIndex(stackIndices[i]);
                 // only looks at water-water or land-land combinations
-                if (pHostilePlot->isWater() == pPlot->isWater() && stepDistance(pPlot->getX(), pPlot->getY(), si->first.iX, si->first.iY) <= range)
+                if (pHostilePlot->isWater() == pPlot->isWater() && stepDistance(pPlot->getX(), pPlot->getY(), pHostilePlot->getX(), pHostilePlot->getY()) <= range)
                 {
-                    std::vector<const CvUnit*> stackUnits;
-                    for (std::list<IDInfo>::const_iterator unitStackIter(si->second.begin()), unitStackEndIter(si->second.end());
-                                        unitStackIter != unitStackEndIter; ++unitStackIter)
+                    std::vector<const CvUnit*>& stackUnits = stacks[pHostilePlot];
+                    const std::vector<IDInfo>& units = hostileInfluenceMap_.getStackUnits(stackIndices[i]);
+                    for (size_t j = 0, unitCount = units.size(); j < unitCount; ++j)
                     {
-                        const CvUnit* pStackUnit = ::getUnit(*unitStackIter);
-                        stackUnits.push_back(pStackUnit);
+                        const CvUnit* pStackUnit = ::getUnit(units[j]);
+                        if (pStackUnit)
+                        {
+                            stackUnits.push_back(pStackUnit);
+                        }
                     }
-                    stacks.insert(std::make_pair(pHostilePlot, stackUnits));
                 }
             }
 
@@ -1642,28 +1682,34 @@ namespace AltAI
 
         PlotSet getThreatenedPlots() const
         {
-            PlotSet plots;
-            for (std::list<MilitaryMissionDataPtr>::const_iterator missionsIter(missionList_.begin()); missionsIter != missionList_.end(); ++missionsIter)
-            {
-                plots.insert((*missionsIter)->hostilesReachablePlots.begin(), (*missionsIter)->hostilesReachablePlots.end());
-            }
+            updateDirtyHostileInfluence_();
+            return hostileInfluenceMap_.getThreatenedPlots();
+        }
 
-            return plots;
+        bool isPlotThreatened(const CvPlot* pPlot) const
+        {
+            updateDirtyHostileInfluence_();
+            return hostileInfluenceMap_.isThreatened(pPlot);
+        }
+
+        int getHostileAttackStrength(const CvPlot* pPlot) const
+        {
+            updateDirtyHostileInfluence_();
+            return hostileInfluenceMap_.getAttackStrength(pPlot);
         }
 
         std::set<IDInfo> getUnitsThreateningPlots(const PlotSet& plots) const
         {
+            updateDirtyHostileInfluence_();
             std::set<IDInfo> units;
 
-            for (std::list<MilitaryMissionDataPtr>::const_iterator missionsIter(missionList_.begin()); missionsIter != missionList_.end(); ++missionsIter)
+            for (PlotSet::const_iterator pi(plots.begin()), piEnd(plots.end()); pi != piEnd; ++pi)
             {
-                for (PlotSet::const_iterator pi(plots.begin()), piEnd(plots.end()); pi != piEnd; ++pi)
+                const std::vector<int>& stackIndices = hostileInfluenceMap_.getStacks(*pi);
+                for (size_t i = 0, count = stackIndices.size(); i < count; ++i)
                 {
-                    if ((*missionsIter)->hostilesReachablePlots.find(*pi) != (*missionsIter)->hostilesReachablePlots.end())
-                    {
-                        units.insert((*missionsIter)->targetUnits.begin(), (*missionsIter)->targetUnits.end());
-                        break;
-                    }
+                    const std::vector<IDInfo>& stackUnits = hostileInfluenceMap_.getStackUnits(stackIndices[i]);
+                    units.insert(stackUnits.begin(), stackUnits.end());
                 }
             }
 
@@ -1700,25 +1746,22 @@ namespace AltAI
 
         PlotUnitsMap getPlotsThreatenedByUnits(const PlotSet& plots) const
         {
+            updateDirtyHostileInfluence_();
             PlotUnitsMap targetsMap;
-            // for each mission...
-            for (std::list<MilitaryMissionDataPtr>::const_iterator missionsIter(missionList_.begin()); missionsIter != missionList_.end(); ++missionsIter)
+            // for each plot we can reach...
+            for (PlotSet::const_iterator pi(plots.begin()), piEnd(plots.end()); pi != piEnd; ++pi)
             {
-                // for each plot we can reach...
-                for (PlotSet::const_iterator pi(plots.begin()), piEnd(plots.end()); pi != piEnd; ++pi)
+                // copy each unit of the hostile stacks which can reach that plot into the targetUnits map
+                const std::vector<int>& stackIndices = hostileInfluenceMap_.getStacks(*pi);
+                for (size_t i = 0, count = stackIndices.size(); i < count; ++i)
                 {
-                    // see if this mission has targets which can reach that plot...
-                    if ((*missionsIter)->hostilesReachablePlots.find(*pi) != (*missionsIter)->hostilesReachablePlots.end())
+                    const std::vector<IDInfo>& stackUnits = hostileInfluenceMap_.getStackUnits(stackIndices[i]);
+                    for (size_t j = 0, unitCount = stackUnits.size(); j < unitCount; ++j)
                     {
-                        // copy each target unit into the targetUnits map
-                        for (std::set<IDInfo>::const_iterator ti((*missionsIter)->targetUnits.begin()), tiEnd((*missionsIter)->targetUnits.end());
-                            ti != tiEnd; ++ti)
+                        const CvUnit* pTargetUnit = ::getUnit(stackUnits[j]);
+                        if (pTargetUnit)
                         {
-                            const CvUnit* pTargetUnit = ::getUnit(*ti);
-                            if (pTargetUnit)
-                            {
-                                targetsMap[*pi].push_back(pTargetUnit);
-                            }
+                            targetsMap[*pi].push_back(pTargetUnit);
                         }
                     }
                 }
@@ -1770,16 +1813,20 @@ namespace AltAI
 
         const std::map<XYCoords, CombatGraph::Data>& getAttackCombatData() const
         {
+            updateDirtyCombatData_();
             return attackCombatData_;
         }
 
         const std::map<XYCoords, CombatGraph::Data>& getDefenceCombatData() const
         {
+            updateDirtyCombatData_();
             return defenceCombatData_;
         }
 
         CvUnit* getNextAttackUnit()
         {
+            updateDirtyCombatData_();
+
             CvUnit* pAttackUnit = NULL;  // fine to return no unit
             if (enemyStacks_.empty())
             {
@@ -2250,6 +2297,7 @@ namespace AltAI
             writeMissionIndexMap_(pStream, missionPointersMap, cityGuardMissionsMap_, "city guard units");
 
             // save intra-turn data (needed as autosave is called after update)
+            updateDirtyCombatData_();
             writeComplexMap(pStream, attackCombatMap_);
             writeComplexMap(pStream, defenceCombatMap_);
 
@@ -2364,6 +2412,10 @@ namespace AltAI
 
             readComplexMap(pStream, attackCombatData_);
             readComplexMap(pStream, defenceCombatData_);
+            dirtyAttackPlots_.clear();
+            dirtyDefencePlots_.clear();
+
+            rebuildHostileInfluence_();
         }
 
     private:
@@ -2708,6 +2760,7 @@ namespace AltAI
                 }
             }
 #endif
+            rebuildHostileInfluence_();
         }
 
         void updateMissionRequirements_()
@@ -3077,12 +3130,17 @@ namespace AltAI
             std::ostream& os = UnitLog::getLog(*player_.getCvPlayer())->getStream();
 #endif
             attackCombatData_.clear();
+            dirtyAttackPlots_.clear();
             attackCombatMap_ = getAttackableUnitsMap_();
 
-            for (std::map<XYCoords, CombatData>::const_iterator attIter(attackCombatMap_.begin()), attEndIter(attackCombatMap_.end()); attIter != attEndIter; ++attIter)
+            std::vector<CombatGraph> combatGraphs;
+            evaluateCombatMap(player_, attackCombatMap_, combatGraphs);
+
+            // apply results to missions
+            size_t graphIndex = 0;
+            for (std::map<XYCoords, CombatData>::const_iterator attIter(attackCombatMap_.begin()), attEndIter(attackCombatMap_.end()); attIter != attEndIter; ++attIter, ++graphIndex)
             {
-                CombatGraph combatGraph = getCombatGraph(player_, attIter->second.combatDetails, attIter->second.attackers, attIter->second.defenders);
-                combatGraph.analyseEndStates();
+                const CombatGraph& combatGraph = combatGraphs[graphIndex];
 
                 std::set<MilitaryMissionDataPtr> updatedMissions;
                 for (size_t i = 0, count = attIter->second.defenders.size(); i < count; ++i)
@@ -3156,13 +3214,18 @@ namespace AltAI
             std::ostream& os = UnitLog::getLog(*player_.getCvPlayer())->getStream();
 #endif
             defenceCombatData_.clear();
+            dirtyDefencePlots_.clear();
             defenceCombatMap_ = getAttackingUnitsMap_();
 
+            std::vector<CombatGraph> combatGraphs;
+            evaluateCombatMap(player_, defenceCombatMap_, combatGraphs);
+
+            // apply results to missions
             std::list<std::pair<XYCoords, double> > plotSurvivalOdds;
-            for (std::map<XYCoords, CombatData>::const_iterator defIter(defenceCombatMap_.begin()), defEndIter(defenceCombatMap_.end()); defIter != defEndIter; ++defIter)
+            size_t graphIndex = 0;
+            for (std::map<XYCoords, CombatData>::const_iterator defIter(defenceCombatMap_.begin()), defEndIter(defenceCombatMap_.end()); defIter != defEndIter; ++defIter, ++graphIndex)
             {
-                CombatGraph combatGraph = getCombatGraph(player_, defIter->second.combatDetails, defIter->second.attackers, defIter->second.defenders);
-                combatGraph.analyseEndStates();
+                const CombatGraph& combatGraph = combatGraphs[graphIndex];
                 plotSurvivalOdds.push_back(std::make_pair(defIter->first, combatGraph.endStatesData.pLoss));  // we are the defenders; odds are wrt attackers
 
                 std::set<MilitaryMissionDataPtr> updatedHostilesMissions, ourUpdatedMissions;
@@ -3236,6 +3299,66 @@ namespace AltAI
             return addHistory_(info, pPlot);
         }
 
+        // hostile unit events only note the plots whose stacks changed - the influence (which needs the stacks' reachable plots) is refreshed on first access
+        void markHostileInfluenceDirty_(const CvPlot* pPlot)
+        {
+            dirtyHostilePlots_.insert(pPlot->getCoords());
+        }
+
+        void updateDirtyHostileInfluence_() const
+        {
+            if (dirtyHostilePlots_.empty())
+            {
+                return;
+            }
+
+            ProfileScope profileScope("MilitaryAnalysis::updateDirtyHostileInfluence", player_.getPlayerID());
+            Profiler::getInstance()->addCount("dirtyHostilePlots", (int)dirtyHostilePlots_.size());
+
+            const CvMap& theMap = gGlobals.getMap();
+            for (std::set<XYCoords>::const_iterator ci(dirtyHostilePlots_.begin()), ciEnd(dirtyHostilePlots_.end()); ci != ciEnd; ++ci)
+            {
+                updateHostileInfluence_(theMap.plot(ci->iX, ci->iY));
+            }
+            dirtyHostilePlots_.clear();
+        }
+
+        // refreshes the influence of whatever hostile units are now known to be at this plot
+        void updateHostileInfluence_(const CvPlot* pPlot) const
+        {
+            std::vector<const CvUnit*> hostileUnits;
+            CvTeamAI& ourTeam = CvTeamAI::getTeam(player_.getTeamID());
+
+            std::map<int, std::map<XYCoords, std::set<IDInfo> > >::const_iterator stackIter = unitStacks_.find(pPlot->getSubArea());
+            if (stackIter != unitStacks_.end())
+            {
+                std::map<XYCoords, std::set<IDInfo> >::const_iterator subAreaStackIter = stackIter->second.find(pPlot->getCoords());
+                if (subAreaStackIter != stackIter->second.end())
+                {
+                    for (std::set<IDInfo>::const_iterator ui(subAreaStackIter->second.begin()), uiEnd(subAreaStackIter->second.end()); ui != uiEnd; ++ui)
+                    {
+                        const CvUnit* pUnit = ::getUnit(*ui);
+                        if (pUnit && ourTeam.isAtWar(pUnit->getTeam()))
+                        {
+                            hostileUnits.push_back(pUnit);
+                        }
+                    }
+                }
+            }
+
+            hostileInfluenceMap_.updateStack(pPlot, hostileUnits);
+        }
+
+        void rebuildHostileInfluence_()
+        {
+            hostileInfluenceMap_.clear();
+            dirtyHostilePlots_.clear();
+            for (std::map<XYCoords, std::list<IDInfo> >::const_iterator si(enemyStacks_.begin()), siEnd(enemyStacks_.end()); si != siEnd; ++si)
+            {
+                dirtyHostilePlots_.insert(si->first);
+            }
+        }
+
         void hideUnit_(const IDInfo& info, const CvPlot* pPlot)
         {
             hiddenUnitsMap_[pPlot->getSubArea()][info] = pPlot->getCoords();
@@ -4152,6 +4275,41 @@ namespace AltAI
             return possibleCombatMap;
         }
 
+        // unit events only mark the plots whose combat results are out of date - the graphs are rebuilt once per plot when the data is next read
+        void markCombatDataDirty_(XYCoords coords, bool isAttackCombatMap)
+        {
+            (isAttackCombatMap ? dirtyAttackPlots_ : dirtyDefencePlots_).insert(coords);
+        }
+
+        void updateDirtyCombatData_() const
+        {
+            if (dirtyAttackPlots_.empty() && dirtyDefencePlots_.empty())
+            {
+                return;
+            }
+
+            ProfileScope profileScope("MilitaryAnalysis::updateDirtyCombatData", player_.getPlayerID());
+            Profiler::getInstance()->addCount("dirtyCombatPlots", (int)(dirtyAttackPlots_.size() + dirtyDefencePlots_.size()));
+
+            updateDirtyCombatData_(attackCombatMap_, attackCombatData_, dirtyAttackPlots_);
+            updateDirtyCombatData_(defenceCombatMap_, defenceCombatData_, dirtyDefencePlots_);
+        }
+
+        void updateDirtyCombatData_(const std::map<XYCoords, CombatData>& combatMap, std::map<XYCoords, CombatGraph::Data>& combatDataMap, std::set<XYCoords>& dirtyPlots) const
+        {
+            for (std::set<XYCoords>::const_iterator ci(dirtyPlots.begin()), ciEnd(dirtyPlots.end()); ci != ciEnd; ++ci)
+            {
+                std::map<XYCoords, CombatData>::const_iterator combatMapIter = combatMap.find(*ci);
+                if (combatMapIter != combatMap.end())  // entry may have been erased since the plot was marked
+                {
+                    CombatGraph combatGraph = getCombatGraph(player_, combatMapIter->second.combatDetails, combatMapIter->second.attackers, combatMapIter->second.defenders);
+                    combatGraph.analyseEndStates();
+                    combatDataMap[*ci] = combatGraph.endStatesData;
+                }
+            }
+            dirtyPlots.clear();
+        }
+
         bool eraseAttackCombatMapEntry_(XYCoords coords, IDInfo unit, bool isAttacker)
         {
             return eraseCombatMapEntry_(coords, unit, true, isAttacker);
@@ -4299,9 +4457,14 @@ namespace AltAI
         std::map<int, std::map<XYCoords, std::set<IDInfo> > > unitStacks_;
 
         std::map<XYCoords, std::list<IDInfo> > enemyStacks_;
+        // mutable as plots marked dirty by hostile unit events are recalculated lazily on access
+        mutable HostileInfluenceMap hostileInfluenceMap_;
+        mutable std::set<XYCoords> dirtyHostilePlots_;
 
         std::map<XYCoords, CombatData> attackCombatMap_, defenceCombatMap_;
-        std::map<XYCoords, CombatGraph::Data> attackCombatData_, defenceCombatData_;
+        // mutable as plots marked dirty by unit events are recalculated lazily on access
+        mutable std::map<XYCoords, CombatGraph::Data> attackCombatData_, defenceCombatData_;
+        mutable std::set<XYCoords> dirtyAttackPlots_, dirtyDefencePlots_;
 
         std::map<IDInfo, UnitHistory> unitHistories_;
 
@@ -4498,6 +4661,16 @@ namespace AltAI
         return pImpl_->getThreatenedPlots();
     }
 
+    bool MilitaryAnalysis::isPlotThreatened(const CvPlot* pPlot) const
+    {
+        return pImpl_->isPlotThreatened(pPlot);
+    }
+
+    int MilitaryAnalysis::getHostileAttackStrength(const CvPlot* pPlot) const
+    {
+        return pImpl_->getHostileAttackStrength(pPlot);
+    }
+
     std::set<IDInfo> MilitaryAnalysis::getUnitsThreateningPlots(const PlotSet& plots) const
     {
         return pImpl_->getUnitsThreateningPlots(plots);
@@ -61,6 +61,8 @@ namespace AltAI
         boost::shared_ptr<MilitaryAnalysisImpl> getImpl() const;
 
         PlotSet getThreatenedPlots() const;
+        bool isPlotThreatened(const CvPlot* pPlot) const;
+        int getHostileAttackStrength(const CvPlot* pPlot) const;
         std::set<IDInfo> getUnitsThreateningPlots(const PlotSet& plots) const;
         PlotUnitsMap getPlotsThreatenedByUnits(const PlotSet& plots) const;
         CvUnit* getNextAttackUnit();
@@ -0,0 +1,214 @@
+#include "AltAI.h"
+
+#include "./movement_cost_field.h"
+#include "./unit_tactics.h"
+#include "./iters.h"
+
+namespace AltAI
+{
+    namespace
+    {
+        bool isValidRoute(const CvPlot* pPlot, const CvTeamAI& unitsTeam, bool canUseEnemyRoute)
+        {
+            const TeamTypes plotTeam = pPlot->getTeam();
+            return pPlot->getRouteType() != NO_ROUTE && (plotTeam == NO_TEAM || !unitsTeam.isAtWar(plotTeam) || canUseEnemyRoute);
+        }
+    }
+
+    MovementCostField::PlotCosts::PlotCosts() : regularCost(0), doubleMoveFeature(NO_FEATURE), doubleMoveTerrain(NO_TERRAIN), isHills(false)
+    {
+        neighbours.assign(-1);
+        routeCost.assign(MAX_INT);
+        routeFlatCost.assign(MAX_INT);
+        enemyRouteCost.assign(MAX_INT);
+        enemyRouteFlatCost.assign(MAX_INT);
+    }
+
+    MovementCostField::MovementCostField(TeamTypes teamType) : teamType_(teamType), turn_(-1), version_(0)
+    {
+    }
+
+    void MovementCostField::update()
+    {
+        const int numPlots = gGlobals.getMap().numPlots();
+        const int currentTurn = gGlobals.getGame().getGameTurn();
+        std::vector<int> currentTeamState = getTeamState_();
+
+        if ((int)plotCosts_.size() != numPlots)
+        {
+            plotCosts_.assign(numPlots, PlotCosts());
+            isDirty_.assign(numPlots, 1);
+            ++version_;
+        }
+        else if (turn_ != currentTurn || teamState_ != currentTeamState)
+        {
+            // plot events mark route and owner changes dirty - resetting each turn covers any changes made without them
+            isDirty_.assign(numPlots, 1);
+            ++version_;
+        }
+
+        turn_ = currentTurn;
+        teamState_.swap(currentTeamState);
+    }
+
+    void MovementCostField::markDirty(const CvPlot* pPlot)
+    {
+        if (isDirty_.empty())
+        {
+            return;  // not yet used
+        }
+
+        const CvMap& theMap = gGlobals.getMap();
+        isDirty_[theMap.plotNum(pPlot->getX(), pPlot->getY())] = 1;
+        ++version_;
+
+        NeighbourPlotIter plotIter(pPlot);
+        while (IterPlot pLoopPlot = plotIter())
+        {
+            if (pLoopPlot.valid())
+            {
+                isDirty_[theMap.plotNum(pLoopPlot->getX(), pLoopPlot->getY())] = 1;
+            }
+        }
+    }
+
+    int MovementCostField::getLandMovementCost(const UnitMovementData& unit, int fromIndex, DirectionTypes direction) const
+    {
+        const PlotCosts& fromCosts = getPlotCosts_(fromIndex);
+        const int iRegularCost = getRegularCost_(unit, fromCosts, getPlotCosts_(fromCosts.neighbours[direction]));
+
+        const int iRouteCost = unit.isEnemyRoute ? fromCosts.enemyRouteCost[direction] : fromCosts.routeCost[direction];
+        int iRouteFlatCost = unit.isEnemyRoute ? fromCosts.enemyRouteFlatCost[direction] : fromCosts.routeFlatCost[direction];
+        if (iRouteFlatCost != MAX_INT)
+        {
+            iRouteFlatCost *= unit.moves;
+        }
+
+        return std::max<int>(1, std::min<int>(iRegularCost, std::min<int>(iRouteCost, iRouteFlatCost)));
+    }
+
+    int MovementCostField::getSeaMovementCost(const UnitMovementData& unit, int fromIndex, DirectionTypes direction) const
+    {
+        const PlotCosts& fromCosts = getPlotCosts_(fromIndex);
+        return std::max<int>(1, getRegularCost_(unit, fromCosts, getPlotCosts_(fromCosts.neighbours[direction])));
+    }
+
+    int MovementCostField::getRegularCost_(const UnitMovementData& unit, const PlotCosts& fromCosts, const PlotCosts& toCosts) const
+    {
+        const int MOVE_DENOMINATOR = gGlobals.getMOVE_DENOMINATOR();
+
+        int iRegularCost;
+        if (unit.ignoresTerrainCost)
+        {
+            iRegularCost = 1;
+        }
+        else
+        {
+            iRegularCost = toCosts.regularCost;
+            if (iRegularCost > 0)
+            {
+                iRegularCost = std::max<int>(1, (iRegularCost - unit.extraMovesDiscount));
+            }
+        }
+
+        const bool bHasTerrainCost = iRegularCost > 1;
+
+        iRegularCost = std::min<int>(iRegularCost, unit.moves);
+        iRegularCost *= MOVE_DENOMINATOR;
+
+        if (bHasTerrainCost)
+        {
+            if ((fromCosts.doubleMoveFeature == NO_FEATURE ? unit.terrainDoubleMoves[fromCosts.doubleMoveTerrain] : unit.featureDoubleMoves[fromCosts.doubleMoveFeature]) ||
+                (fromCosts.isHills && unit.isHillsDoubleMoves))
+            {
+                iRegularCost /= 2;
+            }
+        }
+
+        return iRegularCost;
+    }
+
+    const MovementCostField::PlotCosts& MovementCostField::getPlotCosts_(int index) const
+    {
+        if (isDirty_[index])
+        {
+            calculatePlotCosts_(index);
+            isDirty_[index] = 0;
+        }
+        return plotCosts_[index];
+    }
+
+    void MovementCostField::calculatePlotCosts_(int index) const
+    {
+        const int HILLS_EXTRA_MOVEMENT = gGlobals.getHILLS_EXTRA_MOVEMENT();
+
+        const CvMap& theMap = gGlobals.getMap();
+        const CvTeamAI& unitsTeam = CvTeamAI::getTeam(teamType_);
+        const CvPlot* pPlot = theMap.plotByIndex(index);
+        PlotCosts& plotCosts = plotCosts_[index];
+
+        const FeatureTypes featureType = pPlot->getFeatureType();
+        const TerrainTypes terrainType = pPlot->getTerrainType();
+
+        plotCosts.doubleMoveFeature = featureType;
+        plotCosts.doubleMoveTerrain = terrainType;
+        plotCosts.isHills = pPlot->isHills();
+        plotCosts.regularCost = featureType == NO_FEATURE ? gGlobals.getTerrainInfo(terrainType).getMovementCost() : gGlobals.getFeatureInfo(featureType).getMovementCost();
+        if (plotCosts.isHills)
+        {
+            plotCosts.regularCost += HILLS_EXTRA_MOVEMENT;
+        }
+
+        const RouteTypes fromRouteType = pPlot->getRouteType();
+        const bool fromPlotIsValidRoute = isValidRoute(pPlot, unitsTeam, false), fromPlotIsValidEnemyRoute = isValidRoute(pPlot, unitsTeam, true);
+
+        for (int i = 0; i < NUM_DIRECTION_TYPES; ++i)
+        {
+            const CvPlot* pToPlot = plotDirection(pPlot->getX(), pPlot->getY(), (DirectionTypes)i);
+
+            plotCosts.neighbours[i] = pToPlot ? theMap.plotNum(pToPlot->getX(), pToPlot->getY()) : -1;
+            plotCosts.routeCost[i] = plotCosts.routeFlatCost[i] = plotCosts.enemyRouteCost[i] = plotCosts.enemyRouteFlatCost[i] = MAX_INT;
+
+            if (!pToPlot || !fromPlotIsValidEnemyRoute || (!unitsTeam.isBridgeBuilding() && pPlot->isRiverCrossing((DirectionTypes)i)))
+            {
+                continue;
+            }
+
+            const RouteTypes toRouteType = pToPlot->getRouteType();
+            if (toRouteType == NO_ROUTE)
+            {
+                continue;
+            }
+
+            const int routeCost = std::max<int>((gGlobals.getRouteInfo(fromRouteType).getMovementCost() + unitsTeam.getRouteChange(fromRouteType)),
+                (gGlobals.getRouteInfo(toRouteType).getMovementCost() + unitsTeam.getRouteChange(toRouteType)));
+            const int routeFlatCost = std::max<int>(gGlobals.getRouteInfo(fromRouteType).getFlatMovementCost(), gGlobals.getRouteInfo(toRouteType).getFlatMovementCost());
+
+            plotCosts.enemyRouteCost[i] = routeCost;
+            plotCosts.enemyRouteFlatCost[i] = routeFlatCost;
+
+            if (fromPlotIsValidRoute && isValidRoute(pToPlot, unitsTeam, false))
+            {
+                plotCosts.routeCost[i] = routeCost;
+                plotCosts.routeFlatCost[i] = routeFlatCost;
+            }
+        }
+    }
+
+    std::vector<int> MovementCostField::getTeamState_() const
+    {
+        const CvTeamAI& unitsTeam = CvTeamAI::getTeam(teamType_);
+
+        std::vector<int> teamState;
+        teamState.push_back(unitsTeam.isBridgeBuilding() ? 1 : 0);
+        for (int i = 0; i < MAX_TEAMS; ++i)
+        {
+            teamState.push_back(unitsTeam.isAtWar((TeamTypes)i) ? 1 : 0);
+        }
+        for (int i = 0, count = gGlobals.getNumRouteInfos(); i < count; ++i)
+        {
+            teamState.push_back(unitsTeam.getRouteChange((RouteTypes)i));
+        }
+        return teamState;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    struct UnitMovementData;
+
+    // cache of the plot data landMovementCost() and seaMovementCost() use, indexed by plot number, for units of one team
+    // route costs are held per edge (plot and direction) with the team's war state, route changes and bridge building already applied
+    // dirty plots are recalculated when next used - plots are marked dirty by feature, improvement, route and owner events,
+    // and the whole field each turn and if the team's state changes
+    class MovementCostField
+    {
+    public:
+        explicit MovementCostField(TeamTypes teamType);
+
+        // call before a set of queries
+        void update();
+        // plot's own costs and those of edges into it from its neighbours
+        void markDirty(const CvPlot* pPlot);
+
+        // changes whenever any costs may have changed - lets users cache results derived from the field
+        int getVersion() const
+        {
+            return version_;
+        }
+
+        // same results as landMovementCost()/seaMovementCost() for the plot with index fromIndex and its neighbour in the given direction
+        int getLandMovementCost(const UnitMovementData& unit, int fromIndex, DirectionTypes direction) const;
+        int getSeaMovementCost(const UnitMovementData& unit, int fromIndex, DirectionTypes direction) const;
+
+    private:
+        struct PlotCosts
+        {
+            PlotCosts();
+
+            int regularCost;  // feature (or terrain if no feature) movement cost, plus hills extra movement
+            int doubleMoveFeature, doubleMoveTerrain;  // feature (NO_FEATURE if none) and terrain, for double move checks
+            bool isHills;
+            // per direction: neighbouring plot's index (-1 if off map), route costs (MAX_INT if no valid route along that edge)
+            // route flat costs are multiplied by the unit's moves - enemy route values are for units which can use enemy routes
+            boost::array<int, NUM_DIRECTION_TYPES> neighbours, routeCost, routeFlatCost, enemyRouteCost, enemyRouteFlatCost;
+        };
+
+        const PlotCosts& getPlotCosts_(int index) const;
+        void calculatePlotCosts_(int index) const;
+        std::vector<int> getTeamState_() const;
+        int getRegularCost_(const UnitMovementData& unit, const PlotCosts& fromCosts, const PlotCosts& toCosts) const;
+
+        TeamTypes teamType_;
+        int turn_, version_;
+        std::vector<int> teamState_;
+
+        mutable std::vector<PlotCosts> plotCosts_;
+        mutable std::vector<char> isDirty_;
+    };
+}
@@ -34,6 +34,7 @@
 #include "./tictacs.h"
 #include "./save_utils.h"
 #include "./unit_explore.h"
+#include "./profiler.h"
 
 namespace AltAI
 {
@@ -127,6 +128,8 @@ namespace AltAI
 
     void Player::doTurn()
     {
+        ProfileScope profileScope("Player::doTurn", getPlayerID());
+
         if (pPlayer_->isAlive())
         {
             initCities();
@@ -452,11 +455,13 @@ namespace AltAI
 
     void Player::updateMilitaryAnalysis()
     {
+        ProfileScope profileScope("updateMilitaryAnalysis", getPlayerID());
         AltAI::updateMilitaryAnalysis(*this);
     }
 
     void Player::updateWorkerAnalysis()
     {
+        ProfileScope profileScope("updateWorkerAnalysis", getPlayerID());
         AltAI::updateWorkerAnalysis(*this);
     }
 
@@ -728,6 +733,8 @@ namespace AltAI
         os << "\nTurn: " << gGlobals.getGame().getGameTurn() << " Player: " << pUnit->getOwner() << " - unit added: " << pUnit->getID() << " "
             << pUnit->getUnitInfo().getType() << " at: " << pPlot->getCoords();
 #endif
+        // visible defenders change path costs
+        invalidateUnitPaths(getPlayerID());
         pPlayerAnalysis_->getMilitaryAnalysis()->addPlayerUnit(pUnit, pPlot);
     }
 
@@ -738,6 +745,7 @@ namespace AltAI
         os << "\nPlayer: " << pUnit->getOwner() << " - unit deleted: " << pUnit->getID() << " " 
             << pUnit->getUnitInfo().getType() << " at: " << pPlot->getCoords();
 #endif
+        invalidateUnitPaths(getPlayerID());
         pPlayerAnalysis_->getMilitaryAnalysis()->deletePlayerUnit(pUnit, pPlot);
     }
 
@@ -757,6 +765,7 @@ namespace AltAI
         }
         os << " to: " << pToPlot->getCoords();
 #endif
+        invalidateUnitPaths(getPlayerID());
         pPlayerAnalysis_->getMilitaryAnalysis()->movePlayerUnit(pUnit, pFromPlot, pToPlot);
     }
 
@@ -775,12 +784,14 @@ namespace AltAI
 #endif
         if (pUnit->getTeam() != getTeamID())
         {
+            invalidateUnitPaths(getPlayerID());
             pPlayerAnalysis_->getMilitaryAnalysis()->hidePlayerUnit(pUnit, pOldPlot, moved);
         }
     }
 
     void Player::withdrawPlayerUnit(CvUnitAI* pUnit, const CvPlot* pAttackPlot)
     {
+        invalidateUnitPaths(getPlayerID());
         pPlayerAnalysis_->getMilitaryAnalysis()->withdrawPlayerUnit(pUnit, pAttackPlot);
     }
 
@@ -1669,6 +1680,11 @@ namespace AltAI
         getAnalysis()->getMapDelta()->updatePlotOwner(pPlot, previousRevealedOwner, newRevealedOwner);
     }
 
+    void Player::updatePlotMovementCosts(const CvPlot* pPlot)
+    {
+        getAnalysis()->getMapAnalysis()->updatePlotMovementCosts(pPlot);
+    }
+
     void Player::updateCityBonusCount(const CvCity* pCity, BonusTypes bonusType, int delta)
     {
         getAnalysis()->getWorkerAnalysis()->updateCityBonusCount(pCity, bonusType, delta);
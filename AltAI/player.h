@@ -149,6 +149,7 @@ namespace AltAI
         void updatePlotFeature(const CvPlot* pPlot, FeatureTypes oldFeatureType);
         void updatePlotCulture(const CvPlot* pPlot, PlayerTypes previousRevealedOwner, PlayerTypes newRevealedOwner);
         void updatePlotImprovement(const CvPlot* pPlot, ImprovementTypes oldImprovementType);
+        void updatePlotMovementCosts(const CvPlot* pPlot);
         void updateCityBonusCount(const CvCity* pCity, BonusTypes bonusType, int delta);
 
         void updateCityGreatPeople(IDInfo city);
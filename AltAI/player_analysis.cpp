@@ -105,7 +105,7 @@ namespace AltAI
                 boost::shared_ptr<UnitInfo> pUnitInfo;
                 if (!unitInfo.isAnimal())
                 {
-                    pUnitInfo = makeUnitInfo(unitType, playerType);
+                    pUnitInfo = GameDataAnalysis::getInstance()->getUnitInfo(unitType, playerType);
                     unitsInfo_.insert(std::make_pair(unitType, pUnitInfo));
                 }
                 else
@@ -172,12 +172,12 @@ namespace AltAI
                 const CvBuildingInfo& buildingInfo = gGlobals.getBuildingInfo(buildingType);
                 if (buildingInfo.getProductionCost() > 0)
                 {
-                    buildingsInfo_.insert(std::make_pair(buildingType, makeBuildingInfo(buildingType, playerType)));
+                    buildingsInfo_.insert(std::make_pair(buildingType, GameDataAnalysis::getInstance()->getBuildingInfo(buildingType, playerType)));
                 }
                 else
                 {
                     // buildings which we can't build directly (e.g. need great people to build)
-                    specialBuildingsInfo_.insert(std::make_pair(buildingType, makeBuildingInfo(buildingType, playerType)));
+                    specialBuildingsInfo_.insert(std::make_pair(buildingType, GameDataAnalysis::getInstance()->getBuildingInfo(buildingType, playerType)));
                 }
 
                 int productionMultiplier = 0;
@@ -238,7 +238,7 @@ namespace AltAI
         for (int i = 0, count = gGlobals.getNumProjectInfos(); i < count; ++i)
         {
             PlayerTypes playerType = player_.getPlayerID();
-            projectsInfo_.insert(std::make_pair((ProjectTypes)i, makeProjectInfo((ProjectTypes)i, playerType)));
+            projectsInfo_.insert(std::make_pair((ProjectTypes)i, GameDataAnalysis::getInstance()->getProjectInfo((ProjectTypes)i, playerType)));
         }
 
 #ifdef ALTAI_DEBUG
@@ -260,7 +260,7 @@ namespace AltAI
         for (int i = 0, count = gGlobals.getNumTechInfos(); i < count; ++i)
         {
             PlayerTypes playerType = player_.getPlayerID();
-            techsInfo_.insert(std::make_pair((TechTypes)i, makeTechInfo((TechTypes)i, playerType)));
+            techsInfo_.insert(std::make_pair((TechTypes)i, GameDataAnalysis::getInstance()->getTechInfo((TechTypes)i, playerType)));
         }
 
 //#ifdef ALTAI_DEBUG
@@ -281,7 +281,7 @@ namespace AltAI
     {        for (int i = 0, count = gGlobals.getNumCivicInfos(); i < count; ++i)
         {
             PlayerTypes playerType = player_.getPlayerID();
-            civicsInfo_.insert(std::make_pair((CivicTypes)i, makeCivicInfo((CivicTypes)i, playerType)));
+            civicsInfo_.insert(std::make_pair((CivicTypes)i, GameDataAnalysis::getInstance()->getCivicInfo((CivicTypes)i, playerType)));
         }
 
 //#ifdef ALTAI_DEBUG
@@ -348,9 +348,9 @@ namespace AltAI
 
             if (pCity)
             {
-                const CityDataPtr& pCityData = player_.getCity(pCity).getCityData();
+                const CityData& data = *player_.getCity(pCity).getCityData();
 
-                YieldModifier yieldModifier = pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData);
+                YieldModifier yieldModifier = data.getModifiersHelper()->getTotalYieldModifier(data);
                 CommerceModifier commerceModifier = makeCommerce(100, 100, 100, 100);
                 bestSpecialistTypesMap_[(OutputTypes)i] = AltAI::getBestSpecialist(player_, yieldModifier, commerceModifier, valueF);
             }
@@ -396,9 +396,9 @@ namespace AltAI
 
         if (pCity)
         {
-            const CityDataPtr& pCityData = player_.getCity(pCity).getCityData();
+            const CityData& data = *player_.getCity(pCity).getCityData();
 
-            YieldModifier yieldModifier = pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData);
+            YieldModifier yieldModifier = data.getModifiersHelper()->getTotalYieldModifier(data);
             CommerceModifier commerceModifier = makeCommerce(100, 100, 100, 100);
             bestSpecialistType = AltAI::getBestSpecialist(player_, yieldModifier, commerceModifier, valueF);
         }
@@ -416,9 +416,9 @@ namespace AltAI
         const CvCity* pCity = player_.getCvPlayer()->getCapitalCity();
         TotalOutputPriority outputPriorities = makeTotalOutputPriorities(outputTypes);
         MixedWeightedOutputOrderFunctor<TotalOutput> valueF(outputPriorities, outputWeights);
-        const CityDataPtr& pCityData = player_.getCity(pCity).getCityData();
+        const CityData& data = *player_.getCity(pCity).getCityData();
 
-        YieldModifier yieldModifier = pCityData->getModifiersHelper()->getTotalYieldModifier(*pCityData);
+        YieldModifier yieldModifier = data.getModifiersHelper()->getTotalYieldModifier(data);
         CommerceModifier commerceModifier = makeCommerce(100, 100, 100, 100);
 
         return AltAI::getBestSpecialists(player_, yieldModifier, commerceModifier, count, valueF);
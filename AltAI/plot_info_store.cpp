@@ -0,0 +1,223 @@
+#include "AltAI.h"
+
+#include "./plot_info_store.h"
+
+namespace AltAI
+{
+    namespace
+    {
+        // flattens a node tree into a sequence of ints which identifies its structure - used for both hashing and equality
+        // (PlotInfo's node operator==s deliberately skip some fields, so can't be used to decide if two nodes can share an instance)
+        class NodeWriter : public boost::static_visitor<>
+        {
+        public:
+            explicit NodeWriter(std::vector<int>& values) : values_(values) {}
+
+            void operator() (const PlotInfo::NullNode&) const
+            {
+                values_.push_back(-1);
+            }
+
+            void operator() (const PlotInfo::HasTech& node) const
+            {
+                values_.push_back(node.techType);
+            }
+
+            void operator() (const PlotInfo::HasAvailableRiverSide&) const
+            {
+                values_.push_back(-1);
+            }
+
+            void operator() (const PlotInfo::BuildOrCondition& node) const
+            {
+                writeConditions_(node.conditions);
+            }
+
+            void operator() (const PlotInfo::BaseNode& node) const
+            {
+                values_.push_back(node.isImpassable);
+                values_.push_back(node.isFreshWater);
+                values_.push_back(node.hasPotentialFreshWaterAccess);
+                writeYield_(node.yield);
+                writeYield_(node.bonusYield);
+                values_.push_back(node.tech);
+                values_.push_back(node.featureRemoveTech);
+                values_.push_back(node.plotType);
+                values_.push_back(node.terrainType);
+                values_.push_back(node.bonusType);
+                values_.push_back(node.featureType);
+                write_(node.featureRemovedNode);
+                writeNodes_(node.improvementNodes);
+            }
+
+            void operator() (const PlotInfo::FeatureRemovedNode& node) const
+            {
+                writeYield_(node.yield);
+                writeYield_(node.bonusYield);
+                writeNodes_(node.improvementNodes);
+            }
+
+            void operator() (const PlotInfo::ImprovementNode& node) const
+            {
+                writeImprovementNode_(node);
+            }
+
+            void operator() (const PlotInfo::UpgradeNode& node) const
+            {
+                writeImprovementNode_(node);
+            }
+
+            void write_(const PlotInfo::PlotInfoNode& node) const
+            {
+                values_.push_back(node.which());
+                boost::apply_visitor(*this, node);
+            }
+
+        private:
+            template <typename NodeType> void writeImprovementNode_(const NodeType& node) const
+            {
+                writeYield_(node.yield);
+                writeYield_(node.bonusYield);
+                values_.push_back(node.improvementType);
+                writeConditions_(node.buildConditions);
+
+                values_.push_back(node.techYields.size());
+                for (size_t i = 0, count = node.techYields.size(); i < count; ++i)
+                {
+                    values_.push_back(node.techYields[i].first);
+                    writeYield_(node.techYields[i].second);
+                }
+
+                values_.push_back(node.civicYields.size());
+                for (size_t i = 0, count = node.civicYields.size(); i < count; ++i)
+                {
+                    values_.push_back(node.civicYields[i].first);
+                    writeYield_(node.civicYields[i].second);
+                }
+
+                values_.push_back(node.routeYields.size());
+                for (size_t i = 0, count = node.routeYields.size(); i < count; ++i)
+                {
+                    values_.push_back(node.routeYields[i].first);
+                    values_.push_back(node.routeYields[i].second.first);
+                    writeYield_(node.routeYields[i].second.second);
+                }
+
+                writeNodes_(node.upgradeNode);
+            }
+
+            template <typename NodeType> void writeNodes_(const std::vector<NodeType>& nodes) const
+            {
+                values_.push_back(nodes.size());
+                for (size_t i = 0, count = nodes.size(); i < count; ++i)
+                {
+                    (*this)(nodes[i]);
+                }
+            }
+
+            void writeConditions_(const std::vector<PlotInfo::BuildCondition>& conditions) const
+            {
+                values_.push_back(conditions.size());
+                for (size_t i = 0, count = conditions.size(); i < count; ++i)
+                {
+                    values_.push_back(conditions[i].which());
+                    boost::apply_visitor(*this, conditions[i]);
+                }
+            }
+
+            void writeYield_(const PlotYield& yield) const
+            {
+                for (size_t i = 0; i < PlotYield::numTypes; ++i)
+                {
+                    values_.push_back(yield[i]);
+                }
+            }
+
+            std::vector<int>& values_;
+        };
+
+        std::vector<int> getNodeValues(const PlotInfo::PlotInfoNode& node)
+        {
+            std::vector<int> values;
+            NodeWriter(values).write_(node);
+            return values;
+        }
+
+        // 64 bit FNV-1a over the node's flattened values
+        PlotInfoNodeStore::NodeHash hashValues(const std::vector<int>& values)
+        {
+            PlotInfoNodeStore::NodeHash hash = 14695981039346656037ui64;
+            for (size_t i = 0, count = values.size(); i < count; ++i)
+            {
+                unsigned int value = (unsigned int)values[i];
+                for (int j = 0; j < 4; ++j)
+                {
+                    hash ^= (value >> (8 * j)) & 0xff;
+                    hash *= 1099511628211ui64;
+                }
+            }
+            return hash;
+        }
+    }
+
+    boost::shared_ptr<PlotInfoNodeStore> PlotInfoNodeStore::instance_;
+
+    boost::shared_ptr<PlotInfoNodeStore> PlotInfoNodeStore::getInstance()
+    {
+        if (instance_ == NULL)
+        {
+            instance_ = boost::shared_ptr<PlotInfoNodeStore>(new PlotInfoNodeStore());
+        }
+        return instance_;
+    }
+
+    PlotInfoNodeHandle PlotInfoNodeStore::intern(const PlotInfo::PlotInfoNode& node)
+    {
+        const std::vector<int> values(getNodeValues(node));
+        NodeList& nodeList = nodes_[hashValues(values)];
+
+        NodeList::iterator iter(nodeList.begin());
+        while (iter != nodeList.end())
+        {
+            PlotInfoNodeHandle pNode = iter->lock();
+            if (!pNode)
+            {
+                // no player refers to this node any more
+                nodeList.erase(iter++);
+            }
+            else if (getNodeValues(*pNode) == values)
+            {
+                return pNode;
+            }
+            else  // hash collision
+            {
+                ++iter;
+            }
+        }
+
+        PlotInfoNodeHandle pNode(new PlotInfo::PlotInfoNode(node));
+        nodeList.push_back(boost::weak_ptr<const PlotInfo::PlotInfoNode>(pNode));
+        return pNode;
+    }
+
+    PlotInfoNodeStore::NodeHash PlotInfoNodeStore::getHash(const PlotInfo::PlotInfoNode& node)
+    {
+        return hashValues(getNodeValues(node));
+    }
+
+    size_t PlotInfoNodeStore::size() const
+    {
+        size_t count = 0;
+        for (NodeMap::const_iterator ci(nodes_.begin()), ciEnd(nodes_.end()); ci != ciEnd; ++ci)
+        {
+            for (NodeList::const_iterator nodeIter(ci->second.begin()), nodeEndIter(ci->second.end()); nodeIter != nodeEndIter; ++nodeIter)
+            {
+                if (!nodeIter->expired())
+                {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
+}
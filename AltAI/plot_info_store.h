@@ -0,0 +1,35 @@
+#pragma once
+
+#include "./utils.h"
+#include "./plot_info.h"
+
+namespace AltAI
+{
+    typedef boost::shared_ptr<const PlotInfo::PlotInfoNode> PlotInfoNodeHandle;
+
+    // game wide store of immutable plot info nodes, shared between all players' MapAnalysis instances
+    // structurally identical nodes are interned to a single instance, so handles can be compared by pointer
+    // the store only holds weak references - nodes are released when no player refers to them any more
+    class PlotInfoNodeStore
+    {
+    public:
+        typedef unsigned __int64 NodeHash;
+
+        static boost::shared_ptr<PlotInfoNodeStore> getInstance();
+
+        PlotInfoNodeHandle intern(const PlotInfo::PlotInfoNode& node);
+
+        static NodeHash getHash(const PlotInfo::PlotInfoNode& node);
+
+        size_t size() const;
+
+    private:
+        PlotInfoNodeStore() {}
+
+        typedef std::list<boost::weak_ptr<const PlotInfo::PlotInfoNode> > NodeList;
+        typedef std::map<NodeHash, NodeList> NodeMap;
+        NodeMap nodes_;
+
+        static boost::shared_ptr<PlotInfoNodeStore> instance_;
+    };
+}
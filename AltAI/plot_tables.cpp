@@ -0,0 +1,134 @@
+#include "AltAI.h"
+
+#include "./plot_tables.h"
+
+namespace AltAI
+{
+    bool SubAreaPlotSet::contains(XYCoords coords) const
+    {
+        return !positions_.empty() && positions_[gGlobals.getMap().plotNum(coords.iX, coords.iY)] != -1;
+    }
+
+    bool SubAreaPlotSet::contains(int subAreaId, XYCoords coords) const
+    {
+        if (positions_.empty())
+        {
+            return false;
+        }
+        const int plotIndex = gGlobals.getMap().plotNum(coords.iX, coords.iY);
+        return positions_[plotIndex] != -1 && subAreas_[plotIndex] == subAreaId;
+    }
+
+    size_t SubAreaPlotSet::size(int subAreaId) const
+    {
+        SubAreaPlotsMap::const_iterator ci = subAreaPlots_.find(subAreaId);
+        return ci == subAreaPlots_.end() ? 0 : ci->second.size();
+    }
+
+    bool SubAreaPlotSet::insert(int subAreaId, XYCoords coords)
+    {
+        init_();
+
+        Plots& plots = subAreaPlots_[subAreaId];
+        const int plotIndex = gGlobals.getMap().plotNum(coords.iX, coords.iY);
+        if (positions_[plotIndex] != -1)
+        {
+            return false;
+        }
+
+        positions_[plotIndex] = plots.size();
+        subAreas_[plotIndex] = subAreaId;
+        plots.push_back(coords);
+        return true;
+    }
+
+    bool SubAreaPlotSet::erase(XYCoords coords)
+    {
+        if (positions_.empty())
+        {
+            return false;
+        }
+
+        const CvMap& theMap = gGlobals.getMap();
+        const int plotIndex = theMap.plotNum(coords.iX, coords.iY);
+        const int position = positions_[plotIndex];
+        if (position == -1)
+        {
+            return false;
+        }
+
+        // move the sub area's last plot into the erased plot's position
+        Plots& plots = subAreaPlots_[subAreas_[plotIndex]];
+        const XYCoords lastCoords = plots.back();
+        plots[position] = lastCoords;
+        positions_[theMap.plotNum(lastCoords.iX, lastCoords.iY)] = position;
+        plots.pop_back();
+
+        positions_[plotIndex] = -1;
+        return true;
+    }
+
+    void SubAreaPlotSet::init_()
+    {
+        if (positions_.empty())
+        {
+            const int numPlots = gGlobals.getMap().numPlots();
+            positions_.assign(numPlots, -1);
+            subAreas_.assign(numPlots, FFreeList::INVALID_INDEX);
+        }
+    }
+
+    SharedPlotTable::iterator SharedPlotTable::find(XYCoords coords)
+    {
+        const int index = getIndex_(coords);
+        return index == -1 ? sharedPlots_.end() : sharedPlots_.begin() + index;
+    }
+
+    SharedPlotTable::const_iterator SharedPlotTable::find(XYCoords coords) const
+    {
+        const int index = getIndex_(coords);
+        return index == -1 ? sharedPlots_.end() : sharedPlots_.begin() + index;
+    }
+
+    std::pair<SharedPlotTable::iterator, bool> SharedPlotTable::insert(const value_type& value)
+    {
+        if (indices_.empty())
+        {
+            indices_.assign(gGlobals.getMap().numPlots(), -1);
+        }
+
+        int& index = indices_[gGlobals.getMap().plotNum(value.first.iX, value.first.iY)];
+        if (index != -1)
+        {
+            return std::make_pair(sharedPlots_.begin() + index, false);
+        }
+
+        index = sharedPlots_.size();
+        sharedPlots_.push_back(value);
+        return std::make_pair(sharedPlots_.begin() + index, true);
+    }
+
+    void SharedPlotTable::erase(XYCoords coords)
+    {
+        const int index = getIndex_(coords);
+        if (index == -1)
+        {
+            return;
+        }
+
+        const CvMap& theMap = gGlobals.getMap();
+        const XYCoords lastCoords = sharedPlots_.back().first;
+        if (index != (int)sharedPlots_.size() - 1)
+        {
+            sharedPlots_[index] = sharedPlots_.back();
+            indices_[theMap.plotNum(lastCoords.iX, lastCoords.iY)] = index;
+        }
+        sharedPlots_.pop_back();
+        indices_[theMap.plotNum(coords.iX, coords.iY)] = -1;
+    }
+
+    int SharedPlotTable::getIndex_(XYCoords coords) const
+    {
+        return indices_.empty() ? -1 : indices_[gGlobals.getMap().plotNum(coords.iX, coords.iY)];
+    }
+}
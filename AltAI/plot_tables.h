@@ -0,0 +1,64 @@
+#pragma once
+
+#include "./utils.h"
+#include "./shared_plot.h"
+
+namespace AltAI
+{
+    // set of plots grouped by sub area, stored in map sized tables indexed by plot number rather than as ordered sets of coords
+    // membership tests, insertion and removal are constant time - plots within a sub area are not kept in any particular order
+    class SubAreaPlotSet
+    {
+    public:
+        typedef std::vector<XYCoords> Plots;
+        typedef std::map<int /* sub area id */, Plots> SubAreaPlotsMap;
+        typedef SubAreaPlotsMap::const_iterator const_iterator;
+
+        // sub areas are not removed once they have had a plot added, as with the std::map<int, std::set<XYCoords> > this replaces
+        const_iterator begin() const { return subAreaPlots_.begin(); }
+        const_iterator end() const { return subAreaPlots_.end(); }
+        const_iterator find(int subAreaId) const { return subAreaPlots_.find(subAreaId); }
+
+        bool contains(XYCoords coords) const;
+        bool contains(int subAreaId, XYCoords coords) const;
+        size_t size(int subAreaId) const;
+
+        // return true if the plot was added/removed
+        bool insert(int subAreaId, XYCoords coords);
+        bool erase(XYCoords coords);
+
+    private:
+        void init_();
+
+        SubAreaPlotsMap subAreaPlots_;
+        // per plot: position in its sub area's list (-1 if not in the set) and that sub area
+        std::vector<int> positions_, subAreas_;
+    };
+
+    // shared plot records in one contiguous table, with an index from plot number to the plot's record
+    // looked up and iterated as the std::map<XYCoords, SharedPlot> this replaces, but erasing moves the last record into the erased slot
+    // so iterators are invalidated by insert and erase
+    class SharedPlotTable
+    {
+    public:
+        typedef std::pair<XYCoords, SharedPlot> value_type;
+        typedef std::vector<value_type>::iterator iterator;
+        typedef std::vector<value_type>::const_iterator const_iterator;
+
+        iterator begin() { return sharedPlots_.begin(); }
+        iterator end() { return sharedPlots_.end(); }
+        const_iterator begin() const { return sharedPlots_.begin(); }
+        const_iterator end() const { return sharedPlots_.end(); }
+
+        iterator find(XYCoords coords);
+        const_iterator find(XYCoords coords) const;
+        std::pair<iterator, bool> insert(const value_type& value);
+        void erase(XYCoords coords);
+
+    private:
+        int getIndex_(XYCoords coords) const;
+
+        std::vector<value_type> sharedPlots_;
+        std::vector<int> indices_;  // per plot: index into sharedPlots_, -1 if not a shared plot
+    };
+}
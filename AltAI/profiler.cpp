@@ -0,0 +1,239 @@
+#include "AltAI.h"
+
+#include "./profiler.h"
+#include "./helper_fns.h"
+#include "./worker_pool.h"
+
+#include <ctime>
+#include <fstream>
+
+namespace AltAI
+{
+    namespace
+    {
+        __int64 getTicks()
+        {
+            LARGE_INTEGER ticks;
+            ::QueryPerformanceCounter(&ticks);
+            return ticks.QuadPart;
+        }
+    }
+
+    Profiler Profiler::instance_;
+
+    Profiler* Profiler::getInstance()
+    {
+        return &instance_;
+    }
+
+    // no game data is available yet when this runs (as the dll loads)
+    Profiler::Profiler() : isEnabled_(false), ticksPerMs_(1.0), headerWritten_(false), currentFrameKey_(-1, NO_PLAYER), workerScopes_(0)
+    {
+    }
+
+    Profiler::~Profiler()
+    {
+        writeAll_();
+    }
+
+    void Profiler::startGame()
+    {
+        writeAll_();
+
+        frames_.clear();
+        stack_.clear();
+        currentFrameKey_ = FrameKey(-1, NO_PLAYER);
+        workerScopes_ = 0;
+        headerWritten_ = false;
+        fileName_.clear();
+
+        isEnabled_ = gGlobals.getDefineINT("ALTAI_PROFILE") != 0;
+
+        if (isEnabled_)
+        {
+            LARGE_INTEGER frequency;
+            ::QueryPerformanceFrequency(&frequency);
+            ticksPerMs_ = std::max<double>(1.0, (double)frequency.QuadPart / 1000.0);
+
+            std::ostringstream oss;
+            oss << getLogDirectory() << "AltAI_Profile_" << (unsigned long)::time(NULL) << ".csv";
+            fileName_ = oss.str();
+        }
+    }
+
+    void Profiler::writeAll_()
+    {
+        if (isEnabled_ && !frames_.empty())
+        {
+            std::ofstream ofs(fileName_.c_str(), std::ios::out | std::ios::app);
+            for (std::map<FrameKey, Frame>::const_iterator ci(frames_.begin()), ciEnd(frames_.end()); ci != ciEnd; ++ci)
+            {
+                write_(ofs, ci->first.first, ci->first.second, ci->second);
+            }
+        }
+    }
+
+    void Profiler::enter(const char* name, PlayerTypes playerType)
+    {
+        if (stack_.empty())
+        {
+            const int turn = gGlobals.getGame().getGameTurn();
+            if (!frames_.empty() && frames_.begin()->first.first < turn)
+            {
+                flush();
+            }
+            currentFrameKey_ = FrameKey(turn, playerType);
+        }
+
+        // nested scopes stay in their root's frame, whichever player they are for
+        std::vector<Node>& nodes = frames_[currentFrameKey_].nodes;
+        const size_t parent = stack_.empty() ? 0 : stack_.back().first;
+        if (!stack_.empty())
+        {
+            takeWorkerScopes_(parent);
+        }
+
+        size_t index;
+        std::map<const char*, size_t, StrLess>::const_iterator childIter = nodes[parent].children.find(name);
+        if (childIter == nodes[parent].children.end())
+        {
+            index = nodes.size();
+            nodes[parent].children.insert(std::make_pair(name, index));
+            nodes.push_back(Node(name, parent));
+        }
+        else
+        {
+            index = childIter->second;
+        }
+
+        ++nodes[index].calls;
+        stack_.push_back(std::make_pair(index, getTicks()));
+    }
+
+    void Profiler::leave()
+    {
+        if (!stack_.empty())
+        {
+            frames_[currentFrameKey_].nodes[stack_.back().first].ticks += getTicks() - stack_.back().second;
+            takeWorkerScopes_(stack_.back().first);
+            stack_.pop_back();
+        }
+    }
+
+    // worker threads only run while the main thread waits on their batch, so any skipped scopes belong to the innermost scope
+    void Profiler::takeWorkerScopes_(size_t nodeIndex)
+    {
+        const LONG workerScopes = ::InterlockedExchange(&workerScopes_, 0);
+        if (workerScopes > 0)
+        {
+            frames_[currentFrameKey_].nodes[nodeIndex].counters["worker_scopes"] += workerScopes;
+        }
+    }
+
+    void Profiler::addWorkerScope()
+    {
+        if (isEnabled_)
+        {
+            ::InterlockedIncrement(&workerScopes_);
+        }
+    }
+
+    void Profiler::addCount(const char* name, int count)
+    {
+        if (isEnabled_ && !stack_.empty() && !WorkerPool::isWorkerThread())
+        {
+            frames_[currentFrameKey_].nodes[stack_.back().first].counters[name] += count;
+        }
+    }
+
+    void Profiler::flush()
+    {
+        if (!isEnabled_)
+        {
+            return;
+        }
+
+        const int turn = gGlobals.getGame().getGameTurn();
+        std::ofstream ofs(fileName_.c_str(), std::ios::out | std::ios::app);
+
+        std::map<FrameKey, Frame>::iterator iter(frames_.begin());
+        while (iter != frames_.end() && iter->first.first < turn)
+        {
+            if (stack_.empty() || !(iter->first == currentFrameKey_))
+            {
+                write_(ofs, iter->first.first, iter->first.second, iter->second);
+                frames_.erase(iter++);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    // one row per scope and counter: turn, player, type, path, count (calls or counter total), total ms, self ms (excluding child scopes)
+    void Profiler::write_(std::ostream& os, int turn, PlayerTypes playerType, const Frame& frame)
+    {
+        if (!headerWritten_)
+        {
+            os << "turn,player,type,path,count,total_ms,self_ms\n";
+            headerWritten_ = true;
+        }
+
+        for (size_t i = 1, count = frame.nodes.size(); i < count; ++i)
+        {
+            const Node& node = frame.nodes[i];
+            const std::string path = getPath_(frame, i);
+
+            __int64 childTicks = 0;
+            for (std::map<const char*, size_t, StrLess>::const_iterator ci(node.children.begin()), ciEnd(node.children.end()); ci != ciEnd; ++ci)
+            {
+                childTicks += frame.nodes[ci->second].ticks;
+            }
+
+            os << turn << ',' << playerType << ",scope," << path << ',' << node.calls << ','
+               << (double)node.ticks / ticksPerMs_ << ',' << (double)(node.ticks - childTicks) / ticksPerMs_ << '\n';
+
+            for (std::map<const char*, __int64, StrLess>::const_iterator ci(node.counters.begin()), ciEnd(node.counters.end()); ci != ciEnd; ++ci)
+            {
+                os << turn << ',' << playerType << ",counter," << path << '/' << ci->first << ',' << ci->second << ",,\n";
+            }
+        }
+    }
+
+    std::string Profiler::getPath_(const Frame& frame, size_t nodeIndex) const
+    {
+        std::string path = frame.nodes[nodeIndex].name;
+        for (size_t index = frame.nodes[nodeIndex].parent; index != 0; index = frame.nodes[index].parent)
+        {
+            path = std::string(frame.nodes[index].name) + "/" + path;
+        }
+        return path;
+    }
+
+    ProfileScope::ProfileScope(const char* name, PlayerTypes playerType) : pProfiler_(NULL)
+    {
+        Profiler* pProfiler = Profiler::getInstance();
+
+        // time spent on worker threads is counted in the scope which started the batch
+        if (WorkerPool::isWorkerThread())
+        {
+            pProfiler->addWorkerScope();
+            return;
+        }
+
+        if (pProfiler->isEnabled())
+        {
+            pProfiler_ = pProfiler;
+            pProfiler_->enter(name, playerType);
+        }
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        if (pProfiler_)
+        {
+            pProfiler_->leave();
+        }
+    }
+}
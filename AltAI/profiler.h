@@ -0,0 +1,102 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    // per turn, per player hierarchy of timed scopes and counters - written to a csv file in the log directory (one file per game)
+    // always compiled in, but only records anything if ALTAI_PROFILE is defined (as non-zero) in the global defines
+    // only records from the main thread - scopes and counts on WorkerPool threads are not timed, their time is in the scope which ran the batch
+    // the number of scopes skipped on worker threads is written as a worker_scopes counter of that scope, so the gap shows in the output
+    class Profiler
+    {
+    public:
+        // a static object, so there is no lazy creation to race on - it records nothing until startGame()
+        static Profiler* getInstance();
+
+        ~Profiler();
+
+        // call from the main thread when a game is started or loaded - writes out anything recorded for the previous game and starts a new file
+        void startGame();
+
+        bool isEnabled() const
+        {
+            return isEnabled_;
+        }
+
+        void enter(const char* name, PlayerTypes playerType);
+        void leave();
+
+        // adds to the named counter under the current scope (ignored if no scope is active)
+        void addCount(const char* name, int count);
+
+        // writes out all completed turns' data
+        void flush();
+
+        // safe to call from any thread
+        void addWorkerScope();
+
+    private:
+        Profiler();
+
+        struct StrLess
+        {
+            bool operator() (const char* first, const char* second) const
+            {
+                return strcmp(first, second) < 0;
+            }
+        };
+
+        struct Node
+        {
+            Node(const char* name_ = "", size_t parent_ = 0) : name(name_), parent(parent_), calls(0), ticks(0) {}
+
+            const char* name;
+            size_t parent;
+            int calls;
+            __int64 ticks;
+            std::map<const char*, size_t, StrLess> children;
+            std::map<const char*, __int64, StrLess> counters;
+        };
+
+        struct Frame
+        {
+            Frame() : nodes(1, Node()) {}  // node 0 is the root
+            std::vector<Node> nodes;
+        };
+
+        typedef std::pair<int, PlayerTypes> FrameKey;  // turn, player
+
+        void takeWorkerScopes_(size_t nodeIndex);
+        void writeAll_();
+        void write_(std::ostream& os, int turn, PlayerTypes playerType, const Frame& frame);
+        std::string getPath_(const Frame& frame, size_t nodeIndex) const;
+
+        bool isEnabled_;
+        double ticksPerMs_;
+        std::string fileName_;
+        bool headerWritten_;
+
+        std::map<FrameKey, Frame> frames_;
+        FrameKey currentFrameKey_;
+        std::vector<std::pair<size_t, __int64> > stack_;  // node index, start ticks
+        volatile LONG workerScopes_;  // skipped on worker threads since the main thread last entered or left a scope
+
+        static Profiler instance_;
+    };
+
+    // times its lifetime as a scope of the given name - the name must be a string which outlives the profiler (e.g. a literal)
+    // player is used to pick the turn's hierarchy when there is no enclosing scope
+    class ProfileScope
+    {
+    public:
+        ProfileScope(const char* name, PlayerTypes playerType);
+        ~ProfileScope();
+
+    private:
+        ProfileScope(const ProfileScope&);
+        ProfileScope& operator = (const ProfileScope&);
+
+        Profiler* pProfiler_;
+    };
+}
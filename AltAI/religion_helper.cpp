@@ -110,8 +110,10 @@ namespace AltAI
 #ifdef ALTAI_DEBUG
         std::ostream& os = CivLog::getLog(CvPlayerAI::getPlayer(data.getOwner()))->getStream();
 #endif
-        int stateReligionHappiness = data.getHappyHelper()->getStateReligionHappiness();
-        int nonStateReligionHappiness = data.getHappyHelper()->getNonStateReligionHappiness();        
+        // only take write access to the happy helper if the religion happiness actually changes
+        const HappyHelperPtr& pHappyHelper = data.getHappyHelper();
+        int stateReligionHappiness = pHappyHelper->getStateReligionHappiness();
+        int nonStateReligionHappiness = pHappyHelper->getNonStateReligionHappiness();        
 
         int totalGoodHappy = 0, totalBadHappy = 0;
         for (int religionType = 0; religionType < gGlobals.getNumReligionInfos(); ++religionType)
@@ -147,13 +149,13 @@ namespace AltAI
            << stateReligionHappiness << ", nsrh: " << nonStateReligionHappiness;
 #endif
 
-        if (totalGoodHappy != data.getHappyHelper()->getReligionGoodHappiness())
+        if (totalGoodHappy != pHappyHelper->getReligionGoodHappiness())
         {
-            data.getHappyHelper()->setReligionGoodHappiness(totalGoodHappy);
+            data.getHappyHelperForWrite()->setReligionGoodHappiness(totalGoodHappy);
         }
-        if (totalBadHappy != data.getHappyHelper()->getReligionBadHappiness())
+        if (totalBadHappy != pHappyHelper->getReligionBadHappiness())
         {
-            data.getHappyHelper()->setReligionBadHappiness(totalBadHappy);
+            data.getHappyHelperForWrite()->setReligionBadHappiness(totalBadHappy);
         }
     }
 }
\ No newline at end of file
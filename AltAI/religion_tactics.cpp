@@ -863,7 +863,7 @@ namespace AltAI
 
         std::vector<IProjectionEventPtr> events;
         CityDataPtr pCityData = city.getCityData()->clone();
-        pCityData->getReligionHelper()->setHasReligion(*pCityData, pReligionTactics->getReligionType(), true);
+        pCityData->getReligionHelperForWrite()->setHasReligion(*pCityData, pReligionTactics->getReligionType(), true);
         pCityData->recalcOutputs();
 
         ProjectionLadder delta = getProjectedOutput(*pPlayer, pCityData, pPlayer->getAnalysis()->getNumSimTurns(), events, ConstructItem(), __FUNCTION__, false, false);
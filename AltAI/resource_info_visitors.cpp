@@ -32,20 +32,20 @@ namespace AltAI
             {
                 if (node.baseHealth > 0)
                 {
-                    data_.getHealthHelper()->changeBonusGoodHealthiness(multiplier_ * node.baseHealth);
+                    data_.getHealthHelperForWrite()->changeBonusGoodHealthiness(multiplier_ * node.baseHealth);
                 }
                 else if (node.baseHealth < 0)
                 {
-                    data_.getHealthHelper()->changeBonusBadHealthiness(multiplier_ * node.baseHealth);
+                    data_.getHealthHelperForWrite()->changeBonusBadHealthiness(multiplier_ * node.baseHealth);
                 }
 
                 if (node.baseHappy > 0)
                 {
-                    data_.getHappyHelper()->changeBonusGoodHappiness(multiplier_ * node.baseHappy);
+                    data_.getHappyHelperForWrite()->changeBonusGoodHappiness(multiplier_ * node.baseHappy);
                 }
                 else if (node.baseHappy < 0)
                 {
-                    data_.getHappyHelper()->changeBonusBadHappiness(multiplier_ * node.baseHappy);
+                    data_.getHappyHelperForWrite()->changeBonusBadHappiness(multiplier_ * node.baseHappy);
                 }
 
                 for (size_t i = 0, count = node.buildingNodes.size(); i < count; ++i)
@@ -61,20 +61,20 @@ namespace AltAI
             {
                 if (node.bonusHealth > 0)
                 {
-                    data_.getHealthHelper()->changeBonusGoodHealthiness(multiplier_ * node.bonusHealth);
+                    data_.getHealthHelperForWrite()->changeBonusGoodHealthiness(multiplier_ * node.bonusHealth);
                 }
                 else if (node.bonusHealth < 0)
                 {
-                    data_.getHealthHelper()->changeBonusBadHealthiness(multiplier_ * node.bonusHealth);
+                    data_.getHealthHelperForWrite()->changeBonusBadHealthiness(multiplier_ * node.bonusHealth);
                 }
 
                 if (node.bonusHappy > 0)
                 {
-                    data_.getHappyHelper()->changeBonusGoodHappiness(multiplier_ * node.bonusHappy);
+                    data_.getHappyHelperForWrite()->changeBonusGoodHappiness(multiplier_ * node.bonusHappy);
                 }
                 else if (node.bonusHappy < 0)
                 {
-                    data_.getHappyHelper()->changeBonusBadHappiness(multiplier_ * node.bonusHappy);
+                    data_.getHappyHelperForWrite()->changeBonusBadHappiness(multiplier_ * node.bonusHappy);
                 }
             }
 
@@ -190,7 +190,7 @@ namespace AltAI
 
         std::vector<IProjectionEventPtr> events;
         CityDataPtr pCityData = city.getCityData()->clone();
-        pCityData->getBonusHelper()->changeNumBonuses(pResourceTactics->getBonusType(), 1);
+        pCityData->getBonusHelperForWrite()->changeNumBonuses(pResourceTactics->getBonusType(), 1);
         updateRequestData(*pCityData, pPlayer->getAnalysis()->getResourceInfo(pResourceTactics->getBonusType()), true);
             
         ProjectionLadder delta = getProjectedOutput(*pPlayer, pCityData, pPlayer->getAnalysis()->getNumSimTurns(), events, ConstructItem(), __FUNCTION__, false, false);
@@ -104,7 +104,8 @@ namespace AltAI
         {
             initialPop_ = pCityData_->getPopulation();
             happyCap_ = pCityData_->happyPopulation() - pCityData_->angryPopulation();
-            healthCap_ = pCityData_->getHealthHelper()->goodHealth() - pCityData_->getHealthHelper()->badHealth();
+            const HealthHelperPtr& pHealthHelper = pCityData_->getHealthHelper();
+            healthCap_ = pHealthHelper->goodHealth() - pHealthHelper->badHealth();
         }
 
         template <typename T>
@@ -18,6 +18,8 @@
 #include "./civ_log.h"
 #include "./map_log.h"
 #include "./error_log.h"
+#include "./profiler.h"
+#include "./worker_pool.h"
 
 #include <numeric>
 
@@ -46,6 +48,18 @@ namespace AltAI
             PlayerTypes playerType;
             int minFoundValue;
         };
+
+        bool hasChangedKey(const MapAnalysis::PlotValues::PlotKeyCoordsMap& plotKeys, const std::set<int>& changedKeys)
+        {
+            for (std::set<int>::const_iterator ci(changedKeys.begin()), ciEnd(changedKeys.end()); ci != ciEnd; ++ci)
+            {
+                if (plotKeys.find(*ci) != plotKeys.end())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
     }
     
     SettlerManager::SettlerManager(Player& player) : player_(player), pMapAnalysis_(player.getAnalysis()->getMapAnalysis()), maxFoundValue_(0), currentMaintenance_(0), turnLastCalculated_(-1)
@@ -113,8 +127,29 @@ namespace AltAI
         return foundCount;
     }
 
+    // evaluates one site of analysePlotValues()'s snapshot - writes only to its own dot map item and found value
+    struct SettlerManager::SiteEvaluationTask : IWorkerTask
+    {
+        SiteEvaluationTask(SettlerManager* pSettlerManager_, DotMap::iterator siteIter_, int lookAheadTurns_)
+            : pSettlerManager(pSettlerManager_), siteIter(siteIter_), lookAheadTurns(lookAheadTurns_), foundValue(0)
+        {
+        }
+
+        virtual void run()
+        {
+            foundValue = pSettlerManager->evaluateSite_(siteIter, lookAheadTurns);
+        }
+
+        SettlerManager* pSettlerManager;
+        DotMap::iterator siteIter;
+        int lookAheadTurns;
+        int foundValue;
+    };
+
     void SettlerManager::analysePlotValues()
     {
+        ProfileScope profileScope("SettlerManager::analysePlotValues", playerType_);
+
         const int thisGameTurn = gGlobals.getGame().getGameTurn();
         if (thisGameTurn == turnLastCalculated_ && !pMapAnalysis_->plotValuesDirty())
         {
@@ -123,61 +158,52 @@ namespace AltAI
 
         turnLastCalculated_ = thisGameTurn;
 
-        clearFoundValues_();
-        populateDotMap_();
-        populateBonusMap_();
-
-        const int foodPerPop = gGlobals.getFOOD_CONSUMPTION_PER_POPULATION();
-        const CvPlayerAI& player = CvPlayerAI::getPlayer(playerType_);
-        const Player& player_ = *gGlobals.getGame().getAltAI()->getPlayer(playerType_);
-        const CvCity* pCapitalCity = player.getCapitalCity();        
-
-        std::set<BonusTypes> existingBonuses;
-        int baseHappy = 0, baseHealthy = 0;
-        if (pCapitalCity)
+        // only re-evaluate sites whose plots (or their plots' keys) have changed since the last evaluation
+        // unless all the plot keys' yields have been recalculated, or we have no dot map yet
+        std::vector<DotMap::iterator> sites;
+        const MapAnalysis::PlotValueChanges& plotValueChanges = pMapAnalysis_->getPlotValueChanges();
+        if (plotValueChanges.all || dotMap_.empty())
         {
-            for (int bonusType = 0, count = gGlobals.getNumBonusInfos(); bonusType < count; ++bonusType)
+            clearFoundValues_();
+            populateDotMap_();
+
+            sites.reserve(dotMap_.size());
+            for (DotMap::iterator iter(dotMap_.begin()), endIter(dotMap_.end()); iter != endIter; ++iter)
             {
-                if (pCapitalCity->getNumBonuses((BonusTypes)bonusType) > 0)
-                {
-                    existingBonuses.insert((BonusTypes)bonusType);
-                    baseHappy += gGlobals.getBonusInfo((BonusTypes)bonusType).getHappiness();
-                    baseHealthy += gGlobals.getBonusInfo((BonusTypes)bonusType).getHealth();
-                }
+                sites.push_back(iter);
             }
         }
         else
         {
-            baseHappy = 1;  // to allow for palace
+            updateDotMap_(plotValueChanges, sites);
         }
+        pMapAnalysis_->clearPlotValueChanges();
+
+        populateBonusMap_();
 
-        // todo - factor in expected free buildings happy in case of no cities (hence the additional one to level happiness in lieu of palace +1)
-        const int baseHappyPopulation = baseHappy + gGlobals.getHandicapInfo(player.getHandicapType()).getHappyBonus();
-        const int baseHealthPopulation = baseHealthy + gGlobals.getHandicapInfo(player.getHandicapType()).getHealthBonus();
         const int timeHorizon = player_.getAnalysis()->getTimeHorizon();
 
 #ifdef ALTAI_DEBUG
-        std::ostream& os = CivLog::getLog(player)->getStream();
-        os << "\nanalysePlotValues - using baseHappyPopulation: " << baseHappyPopulation << ", baseHealthPopulation: " << baseHealthPopulation;
+        std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
+        os << "\nanalysePlotValues - evaluating " << sites.size() << " of " << dotMap_.size() << " sites";
 #endif  
-        CvMap& theMap = gGlobals.getMap(); 
-        for (DotMap::iterator iter(dotMap_.begin()), endIter(dotMap_.end()); iter != endIter; ++iter)
+        // each site's evaluation only reads shared state and writes to its own dot map item, so sites are evaluated
+        // from the snapshot of sites to update (on the worker pool if it has threads) and their found values set on the map afterwards, in order
+        // anything the evaluation reads from the map analysis (e.g. the city plot's max yield) is stored on the dot map item by analysePlotValue_(),
+        // as the map analysis fills its plot info lazily and isn't safe to call from the workers
+        std::vector<SiteEvaluationTask> tasks;
+        tasks.reserve(sites.size());
+        for (size_t i = 0, count = sites.size(); i < count; ++i)
         {
-            std::vector<BonusTypes> newBonuses = iter->getNewBonuses(existingBonuses);
-            int extraHappy = 0, extraHealth = 0;
-            for (int bonusType = 0, count = newBonuses.size(); bonusType < count; ++bonusType)
-            {
-                extraHappy += gGlobals.getBonusInfo((BonusTypes)bonusType).getHappiness();
-                extraHealth += gGlobals.getBonusInfo((BonusTypes)bonusType).getHealth();
-            }
-            extraHealth += iter->getBaseFeatureHealth();
+            tasks.push_back(SiteEvaluationTask(this, sites[i], 2 * timeHorizon));
+        }
+
+        WorkerPool::getInstance()->runTasks(tasks);
 
-            DotMapOptimiser opt(*iter, playerType_);
-            std::vector<YieldTypes> yieldTypes(boost::assign::list_of(YIELD_FOOD)(YIELD_PRODUCTION)(YIELD_COMMERCE));
-            //opt.optimise(yieldTypes, std::min<int>(1 + baseHappyPopulation + extraHappy, iter->plotDataSet.size()));
-            opt.optimise(std::vector<YieldWeights>());
-            iter->calcOutput(player_, 2 * player_.getAnalysis()->getTimeHorizon(), iter->plotDataSet.size());
-            theMap.plot(iter->coords.iX, iter->coords.iY)->setFoundValue(playerType_, iter->getFoundValue(player_));
+        CvMap& theMap = gGlobals.getMap(); 
+        for (size_t i = 0, count = tasks.size(); i < count; ++i)
+        {
+            theMap.plot(tasks[i].siteIter->coords.iX, tasks[i].siteIter->coords.iY)->setFoundValue(playerType_, tasks[i].foundValue);
         }
 
         findBestCitySites_();
@@ -190,6 +216,14 @@ namespace AltAI
 #endif
     }
 
+    int SettlerManager::evaluateSite_(DotMap::iterator siteIter, int lookAheadTurns)
+    {
+        DotMapOptimiser opt(*siteIter, playerType_);
+        opt.optimise(std::vector<YieldWeights>());
+        siteIter->calcOutput(player_, lookAheadTurns, siteIter->plotDataSet.size());
+        return siteIter->getFoundValue(player_);
+    }
+
     void SettlerManager::debugDotMap() const
     {
 #ifdef ALTAI_DEBUG
@@ -495,6 +529,7 @@ namespace AltAI
 
         BonusTypes cityPlotBonusType = pPlot->getBonusType(player.getTeam());
         DotMapItem dotMapItem(ci->first, getPlotCityYield(plotInfoNode, playerType_), pPlot->isFreshWater(), pPlot->getBonusType(player.getTeam()));
+        boost::tie(dotMapItem.cityPlotMaxYield, dotMapItem.cityPlotBestImprovement) = getMaxYield(plotInfoNode, playerType_, 3);
         if (cityPlotBonusType != NO_BONUS)
         {
             ++dotMapItem.bonusTypesMap[cityPlotBonusType];
@@ -863,6 +898,93 @@ namespace AltAI
         }
     }
 
+    void SettlerManager::updateDotMap_(const MapAnalysis::PlotValueChanges& plotValueChanges, std::vector<DotMap::iterator>& updatedSites)
+    {
+        CvMap& theMap = gGlobals.getMap();
+        const CvPlayerAI& player = CvPlayerAI::getPlayer(playerType_);
+        const MapAnalysis::PlotValues& plotValues = pMapAnalysis_->getPlotValues();
+
+        // any site whose 21 plot footprint includes a changed plot
+        std::set<XYCoords> dirtySites;
+        for (std::set<XYCoords>::const_iterator ci(plotValueChanges.coords.begin()), ciEnd(plotValueChanges.coords.end()); ci != ciEnd; ++ci)
+        {
+            const CvPlot* pPlot = theMap.plot(ci->iX, ci->iY);
+            dirtySites.insert(*ci);
+
+            for (int i = 1; i <= CITY_PLOTS_RADIUS; ++i)
+            {
+                CultureRangePlotIter plotIter(pPlot, (CultureLevelTypes)i);
+                while (IterPlot pLoopPlot = plotIter())
+                {
+                    if (pLoopPlot.valid())
+                    {
+                        dirtySites.insert(pLoopPlot->getCoords());
+                    }
+                }
+            }
+        }
+
+        // clean sites only need their deadlocked bonuses recounting if a changed plot is within the range AI_countDeadlockedBonuses
+        // depends on: bonuses up to twice the min city range away, each checked for a foundable site within its city radius
+        const int deadlockRange = 2 * gGlobals.getMIN_CITY_RANGE() + CITY_PLOTS_RADIUS;
+        std::vector<char> deadlockDirtyPlots(theMap.numPlots(), 0);
+        for (std::set<XYCoords>::const_iterator ci(plotValueChanges.coords.begin()), ciEnd(plotValueChanges.coords.end()); ci != ciEnd; ++ci)
+        {
+            for (int iDX = -deadlockRange; iDX <= deadlockRange; ++iDX)
+            {
+                for (int iDY = -deadlockRange; iDY <= deadlockRange; ++iDY)
+                {
+                    const CvPlot* pLoopPlot = plotXY(ci->iX, ci->iY, iDX, iDY);
+                    if (pLoopPlot)
+                    {
+                        deadlockDirtyPlots[theMap.plotNum(pLoopPlot->getX(), pLoopPlot->getY())] = 1;
+                    }
+                }
+            }
+        }
+
+        std::set<XYCoords> currentSites;
+        for (MapAnalysis::PlotValues::PlotValueMap::const_iterator ci(plotValues.plotValueMap.begin()), ciEnd(plotValues.plotValueMap.end()); ci != ciEnd; ++ci)
+        {
+            for (MapAnalysis::PlotValues::SubAreaPlotValueMap::const_iterator ci2(ci->second.begin()), ci2End(ci->second.end()); ci2 != ci2End; ++ci2)
+            {
+                currentSites.insert(ci2->first);
+
+                DotMap::iterator dotMapIter = dotMap_.find(DotMapItem(ci2->first, PlotYield()));
+                if (dotMapIter != dotMap_.end())
+                {
+                    if (dirtySites.find(ci2->first) == dirtySites.end() && !hasChangedKey(ci2->second, plotValueChanges.keys))
+                    {
+                        // deadlocked bonuses depend on where any player can found cities well outside the site's footprint,
+                        // so recount them for clean sites near a change and re-evaluate the site if the count has changed
+                        if (!deadlockDirtyPlots[theMap.plotNum(ci2->first.iX, ci2->first.iY)] ||
+                            dotMapIter->numDeadLockedBonuses == player.AI_countDeadlockedBonuses(theMap.plot(ci2->first.iX, ci2->first.iY)))
+                        {
+                            continue;
+                        }
+                    }
+                    dotMap_.erase(dotMapIter);
+                }
+
+                updatedSites.push_back(dotMap_.insert(analysePlotValue_(plotValues, ci2)).first);
+            }
+        }
+
+        // sites which are no longer valid (e.g. now owned by another player, or too close to a new city)
+        for (DotMap::iterator iter(dotMap_.begin()); iter != dotMap_.end();)
+        {
+            if (currentSites.find(iter->coords) == currentSites.end())
+            {
+                theMap.plot(iter->coords.iX, iter->coords.iY)->setFoundValue(playerType_, 0);
+                dotMap_.erase(iter++);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
     void SettlerManager::populateMaxFoundValues_()
     {
         const PlayerPtr& pPlayer = gGlobals.getGame().getAltAI()->getPlayer(playerType_);
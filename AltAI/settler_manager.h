@@ -69,6 +69,12 @@ namespace AltAI
         typedef std::set<DotMapItem> DotMap;
         DotMap dotMap_;
 
+        // optimises the site's plots and calculates its output - returns its found value
+        int evaluateSite_(DotMap::iterator siteIter, int lookAheadTurns);
+        struct SiteEvaluationTask;
+        // re-analyses dot map items whose plots have changed, adds new sites and removes invalid ones
+        void updateDotMap_(const MapAnalysis::PlotValueChanges& plotValueChanges, std::vector<DotMap::iterator>& updatedSites);
+
         typedef std::multimap<int, XYCoords, std::greater<int> > BestSitesMap;
         BestSitesMap bestSites_, bestBonusSites_;
 
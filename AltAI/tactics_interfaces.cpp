@@ -165,6 +165,11 @@ namespace AltAI
         }
     }
 
+    void debugDepItemSet(const DependencyItemSetKey& depItemSetKey, std::ostream& os)
+    {
+        debugDepItemSet(depItemSetKey.getItems(), os);
+    }
+
     void debugDepItem(const DependencyItem& depItem, std::ostream& os)
     {
         switch (depItem.first)
@@ -294,6 +299,126 @@ namespace AltAI
         }
     }
 
+    namespace
+    {
+        // 64 bit FNV-1a over the set's items
+        unsigned __int64 hashDepItemSet(const DependencyItemSet& depItemSet)
+        {
+            unsigned __int64 hash = 14695981039346656037ui64;
+            for (DependencyItemSet::const_iterator ci(depItemSet.begin()), ciEnd(depItemSet.end()); ci != ciEnd; ++ci)
+            {
+                const unsigned int values[2] = {(unsigned int)ci->first, (unsigned int)ci->second};
+                for (int i = 0; i < 2; ++i)
+                {
+                    for (int j = 0; j < 4; ++j)
+                    {
+                        hash ^= (values[i] >> (8 * j)) & 0xff;
+                        hash *= 1099511628211ui64;
+                    }
+                }
+            }
+            return hash;
+        }
+    }
+
+    boost::shared_ptr<DependencyItemSetStore> DependencyItemSetStore::instance_;
+
+    boost::shared_ptr<DependencyItemSetStore> DependencyItemSetStore::getInstance()
+    {
+        if (instance_ == NULL)
+        {
+            instance_ = boost::shared_ptr<DependencyItemSetStore>(new DependencyItemSetStore());
+        }
+        return instance_;
+    }
+
+    DependencyItemSetStore::DependencyItemSetStore()
+    {
+        // so the empty set is always NoDependenciesID
+        intern(DependencyItemSet());
+    }
+
+    int DependencyItemSetStore::intern(const DependencyItemSet& depItemSet)
+    {
+        std::vector<int>& ids = hashedIDs_[hashDepItemSet(depItemSet)];
+        for (size_t i = 0, count = ids.size(); i < count; ++i)
+        {
+            if (entries_[ids[i]].items == depItemSet)
+            {
+                return ids[i];
+            }
+        }
+
+        const int id = entries_.size();
+        ids.push_back(id);
+
+        entries_.push_back(Entry());
+        Entry& entry = entries_.back();
+        entry.items = depItemSet;
+
+        for (DependencyItemSet::const_iterator ci(depItemSet.begin()), ciEnd(depItemSet.end()); ci != ciEnd; ++ci)
+        {
+            FAssertMsg(ci->first >= 0 && ci->first < 32, "Unexpected dependency type id");
+            entry.typeBits |= 1 << ci->first;
+        }
+
+        return id;
+    }
+
+    const DependencyItemSet& DependencyItemSetStore::getItems(int id) const
+    {
+        return entries_[id].items;
+    }
+
+    bool DependencyItemSetStore::hasDependencyType(int id, int dependencyTypeID) const
+    {
+        return (entries_[id].typeBits & (1 << dependencyTypeID)) != 0;
+    }
+
+    size_t DependencyItemSetStore::size() const
+    {
+        return entries_.size();
+    }
+
+    DependencyItemSetKey::DependencyItemSetKey() : id_(DependencyItemSetStore::NoDependenciesID)
+    {
+    }
+
+    DependencyItemSetKey::DependencyItemSetKey(const DependencyItemSet& depItemSet)
+        : id_(depItemSet.empty() ? DependencyItemSetStore::NoDependenciesID : DependencyItemSetStore::getInstance()->intern(depItemSet))
+    {
+    }
+
+    const DependencyItemSet& DependencyItemSetKey::getItems() const
+    {
+        return DependencyItemSetStore::getInstance()->getItems(id_);
+    }
+
+    DependencyItemSetKey::const_iterator DependencyItemSetKey::begin() const
+    {
+        return getItems().begin();
+    }
+
+    DependencyItemSetKey::const_iterator DependencyItemSetKey::end() const
+    {
+        return getItems().end();
+    }
+
+    size_t DependencyItemSetKey::size() const
+    {
+        return getItems().size();
+    }
+
+    bool DependencyItemSetKey::empty() const
+    {
+        return id_ == DependencyItemSetStore::NoDependenciesID;
+    }
+
+    bool DependencyItemSetKey::hasDependencyType(int dependencyTypeID) const
+    {
+        return DependencyItemSetStore::getInstance()->hasDependencyType(id_, dependencyTypeID);
+    }
+
     bool IsNotRequired::operator() (const IDependentTacticPtr& pDependentTactic) const
     {
         return pDependentTactic->removeable() && (pCity ? !pDependentTactic->required(pCity, depTacticFlags) : !pDependentTactic->required(player, depTacticFlags));
@@ -3,6 +3,8 @@
 #include "./utils.h"
 #include "./city_projections.h"
 
+#include <deque>
+
 namespace AltAI
 {
     class Player;
@@ -40,7 +42,87 @@ namespace AltAI
         bool operator() (const DependencyItemSet& first, const DependencyItemSet& second) const;
     };
 
-    typedef std::map<DependencyItemSet, TacticSelectionData, DependencyItemsComp> TacticSelectionDataMap;
+    // game wide store of distinct dependency item sets - each set is given a small id when first seen (the empty set is always NoDependenciesID)
+    // along with a bitset of its dependency types - so sets can be compared by id and dependency type tests are bit operations
+    class DependencyItemSetStore
+    {
+    public:
+        enum { NoDependenciesID = 0 };
+
+        static boost::shared_ptr<DependencyItemSetStore> getInstance();
+
+        int intern(const DependencyItemSet& depItemSet);
+
+        const DependencyItemSet& getItems(int id) const;
+
+        bool hasDependencyType(int id, int dependencyTypeID) const;
+
+        size_t size() const;
+
+    private:
+        DependencyItemSetStore();
+
+        struct Entry
+        {
+            Entry() : typeBits(0) {}
+            DependencyItemSet items;
+            unsigned int typeBits;  // indexed by DependencyItem::first
+        };
+
+        typedef unsigned __int64 SetHash;
+
+        std::deque<Entry> entries_;  // deque so getItems() references stay valid as sets are added
+        std::map<SetHash, std::vector<int> > hashedIDs_;
+
+        static boost::shared_ptr<DependencyItemSetStore> instance_;
+    };
+
+    // key for maps indexed by dependency item sets - holds the set's interned id
+    // constructible from a DependencyItemSet, so such maps can still be indexed by sets directly
+    class DependencyItemSetKey
+    {
+    public:
+        typedef DependencyItemSet::const_iterator const_iterator;
+
+        DependencyItemSetKey();
+        DependencyItemSetKey(const DependencyItemSet& depItemSet);
+
+        int getID() const
+        {
+            return id_;
+        }
+
+        const DependencyItemSet& getItems() const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        size_t size() const;
+        bool empty() const;
+
+        bool hasDependencyType(int dependencyTypeID) const;
+
+        bool operator < (const DependencyItemSetKey& other) const
+        {
+            return id_ < other.id_;
+        }
+
+        bool operator == (const DependencyItemSetKey& other) const
+        {
+            return id_ == other.id_;
+        }
+
+        bool operator != (const DependencyItemSetKey& other) const
+        {
+            return id_ != other.id_;
+        }
+
+    private:
+        int id_;
+    };
+
+    void debugDepItemSet(const DependencyItemSetKey& depItemSetKey, std::ostream& os);
+
+    typedef std::map<DependencyItemSetKey, TacticSelectionData> TacticSelectionDataMap;
 
     typedef boost::shared_ptr<CityData> CityDataPtr;
 
@@ -38,13 +38,13 @@ namespace AltAI
                 // add any base happy/health
                 if (node.happy != 0)
                 {
-                    data_.getHappyHelper()->changePlayerHappiness(node.happy);
+                    data_.getHappyHelperForWrite()->changePlayerHappiness(node.happy);
                     data_.changeWorkingPopulation();
                 }
 
                 if (node.health != 0)
                 {
-                    data_.getHealthHelper()->changePlayerHealthiness(node.health);
+                    data_.getHealthHelperForWrite()->changePlayerHealthiness(node.health);
                 }
 
                 for (size_t i = 0, count = node.nodes.size(); i < count; ++i)
@@ -71,7 +71,7 @@ namespace AltAI
             {
                 if (node.extraTradeRoutes != 0)
                 {
-                    data_.getTradeRouteHelper()->changeNumRoutes(node.extraTradeRoutes);
+                    data_.getTradeRouteHelperForWrite()->changeNumRoutes(node.extraTradeRoutes);
                 }
             }
 
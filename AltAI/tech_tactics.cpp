@@ -69,7 +69,7 @@ namespace AltAI
             {
                 const CvTeam& team = CvTeamAI::getTeam(player.getTeamID());
                 int leastTurns = MAX_INT;
-                std::map<DependencyItemSet, int> possiblyTooExpensiveTechs;
+                std::map<DependencyItemSetKey, int> possiblyTooExpensiveTechs;
 
                 for (TacticSelectionDataMap::const_iterator ci(tacticSelectionDataMap.begin()), ciEnd(tacticSelectionDataMap.end());
                     ci != ciEnd; ++ci)
@@ -112,7 +112,7 @@ namespace AltAI
                     }
                 }
 
-                for (std::map<DependencyItemSet, int>::const_iterator ci(possiblyTooExpensiveTechs.begin()),
+                for (std::map<DependencyItemSetKey, int>::const_iterator ci(possiblyTooExpensiveTechs.begin()),
                     ciEnd(possiblyTooExpensiveTechs.end()); ci != ciEnd; ++ci)
                 {
                     if (ci->second > 3 * leastTurns)
@@ -131,16 +131,7 @@ namespace AltAI
                 for (TacticSelectionDataMap::iterator iter(tacticSelectionDataMap.begin()), endIter(tacticSelectionDataMap.end());
                     iter != endIter;)
                 {
-                    bool entryHasTechDep = false;
-                    for (DependencyItemSet::const_iterator depIter(iter->first.begin()), depEndIter(iter->first.end()); depIter != depEndIter; ++depIter)
-                    {
-                        if (depIter->first == ResearchTechDependency::ID)
-                        {
-                            entryHasTechDep = true;
-                            break;
-                        }
-                    }
-                    if (entryHasTechDep)
+                    if (iter->first.hasDependencyType(ResearchTechDependency::ID))
                     {
 #ifdef ALTAI_DEBUG
                         civLog << "\nRemoving tech selection data: ";
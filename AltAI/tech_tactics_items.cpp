@@ -72,7 +72,7 @@ namespace AltAI
 
         std::vector<IProjectionEventPtr> events;
         const int numSimTurns = player.getAnalysis()->getNumSimTurns();
-        base_ = getProjectedOutput(player, pBaseCityData, numSimTurns, events, constructItem, __FUNCTION__);
+        base_ = getIncrementalProjectedOutput(player, pBaseCityData, numSimTurns, events, __FUNCTION__);
 
         events.clear();
         projection_ = getProjectedOutput(player, pSimulationCityData, numSimTurns, events, constructItem, __FUNCTION__);
@@ -544,7 +544,7 @@ namespace AltAI
                 {
                     CityDataPtr pCityData = city.getCityData()->clone();
                     std::vector<IProjectionEventPtr> events;
-                    base = getProjectedOutput(*pPlayer, pCityData, numSimTurns, events, ConstructItem(), __FUNCTION__, false);
+                    base = getIncrementalProjectedOutput(*pPlayer, pCityData, numSimTurns, events, __FUNCTION__);
                 }
 
                 {
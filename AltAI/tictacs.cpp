@@ -40,6 +40,7 @@
 #include "./helper_fns.h"
 #include "./civ_log.h"
 #include "./save_utils.h"
+#include "./profiler.h"
 
 namespace AltAI
 {
@@ -157,6 +158,8 @@ namespace AltAI
         }      
 
         const int lookAheadDepth = 2;
+        // general (not wonder) buildings, in the order they are found - their city tactics are evaluated per city below
+        std::vector<boost::shared_ptr<BuildingInfo> > generalBuildings;
 
         for (size_t i = 0, count = gGlobals.getNumTechInfos(); i < count; ++i)
         {
@@ -220,30 +223,7 @@ namespace AltAI
                             availableGeneralBuildingsList_.insert(possibleBuildings[i]);
                         }
 
-                        CityIter iter(*player.getCvPlayer());
-                        while (CvCity* pCity = iter())
-                        {       
-                            CityBuildingTacticsList::iterator buildingsIter = cityBuildingTacticsMap_[pCity->getIDInfo()].find(possibleBuildings[i]);
-                            if (buildingsIter == cityBuildingTacticsMap_[pCity->getIDInfo()].end())
-                            {
-                                if (couldConstructBuilding(player, player.getCity(pCity), lookAheadDepth, pBuildingInfo, true))
-                                {
-#ifdef ALTAI_DEBUG
-                                    CivLog::getLog(*player.getCvPlayer())->getStream() << "\n" << __FUNCTION__
-                                        << " Adding tactic for building: " << gGlobals.getBuildingInfo(possibleBuildings[i]).getType() << " for city: " << safeGetCityName(pCity);
-#endif
-                                    cityBuildingTacticsMap_[pCity->getIDInfo()][possibleBuildings[i]] = makeCityBuildingTactics(player, player.getCity(pCity), pBuildingInfo);
-                                }
-                            }
-                            else
-                            {
-#ifdef ALTAI_DEBUG
-                                CivLog::getLog(*player.getCvPlayer())->getStream() << "\n" << __FUNCTION__
-                                    << " Updating (new tech) tactic for building: " << gGlobals.getBuildingInfo(possibleBuildings[i]).getType();
-#endif
-                                buildingsIter->second->updateDependencies(player, pCity);
-                            }
-                        }
+                        generalBuildings.push_back(pBuildingInfo);
                     }
                 }
 
@@ -255,6 +235,93 @@ namespace AltAI
                 }
             }
         }
+
+        if (generalBuildings.empty())
+        {
+            return;
+        }
+
+        // each city's tactics are evaluated independently of the other cities' and only added to the map once all cities are done,
+        // in city order, so the result doesn't depend on the order the evaluations run in
+        // this stays on the main thread: projections fill the city's base projection and projection cache lazily,
+        // and limited building tactics write to other cities' caches too
+        std::vector<std::pair<IDInfo, CityBuildingTacticsList> > cityResults;
+        CityIter iter(*player.getCvPlayer());
+        while (CvCity* pCity = iter())
+        {
+            cityResults.push_back(std::make_pair(pCity->getIDInfo(), CityBuildingTacticsList()));
+        }
+
+        for (size_t i = 0, count = cityResults.size(); i < count; ++i)
+        {
+            City& city = player.getCity(cityResults[i].first.iID);
+            evaluateCityBuildingTactics_(city, generalBuildings, cityResults[i].second);
+
+            const CityDataPtr pCityData = city.getCityData();
+            for (CityBuildingTacticsList::iterator tacticIter(cityResults[i].second.begin()), tacticEndIter(cityResults[i].second.end()); tacticIter != tacticEndIter; ++tacticIter)
+            {
+                tacticIter->second->update(player, pCityData->privateClone());
+            }
+        }
+
+        for (size_t i = 0, count = cityResults.size(); i < count; ++i)
+        {
+            CityBuildingTacticsList& cityBuildingTactics = cityBuildingTacticsMap_[cityResults[i].first];
+            cityBuildingTactics.insert(cityResults[i].second.begin(), cityResults[i].second.end());
+        }
+    }
+
+    // reads this city's existing tactics (and updates their dependencies) - new tactics are returned in newTactics
+    void PlayerTactics::evaluateCityBuildingTactics_(const City& city, const std::vector<boost::shared_ptr<BuildingInfo> >& buildings, CityBuildingTacticsList& newTactics)
+    {
+        const int lookAheadDepth = 2;
+        const CvCity* pCity = city.getCvCity();
+
+        CityBuildingTacticsMap::const_iterator cityIter = cityBuildingTacticsMap_.find(pCity->getIDInfo());
+
+        for (size_t i = 0, count = buildings.size(); i < count; ++i)
+        {
+            const BuildingTypes buildingType = buildings[i]->getBuildingType();
+
+            // the same building can be enabled by more than one tech
+            ICityBuildingTacticsPtr pExistingTactic;
+            if (cityIter != cityBuildingTacticsMap_.end())
+            {
+                CityBuildingTacticsList::const_iterator buildingsIter = cityIter->second.find(buildingType);
+                if (buildingsIter != cityIter->second.end())
+                {
+                    pExistingTactic = buildingsIter->second;
+                }
+            }
+            if (!pExistingTactic)
+            {
+                CityBuildingTacticsList::const_iterator buildingsIter = newTactics.find(buildingType);
+                if (buildingsIter != newTactics.end())
+                {
+                    pExistingTactic = buildingsIter->second;
+                }
+            }
+
+            if (!pExistingTactic)
+            {
+                if (couldConstructBuilding(player, city, lookAheadDepth, buildings[i], true))
+                {
+#ifdef ALTAI_DEBUG
+                    CivLog::getLog(*player.getCvPlayer())->getStream() << "\n" << __FUNCTION__
+                        << " Adding tactic for building: " << gGlobals.getBuildingInfo(buildingType).getType() << " for city: " << safeGetCityName(pCity);
+#endif
+                    newTactics[buildingType] = makeCityBuildingTactics(player, city, buildings[i]);
+                }
+            }
+            else
+            {
+#ifdef ALTAI_DEBUG
+                CivLog::getLog(*player.getCvPlayer())->getStream() << "\n" << __FUNCTION__
+                    << " Updating (new tech) tactic for building: " << gGlobals.getBuildingInfo(buildingType).getType();
+#endif
+                pExistingTactic->updateDependencies(player, pCity);
+            }
+        }
     }
 
     void PlayerTactics::updateCityBuildingTactics(IDInfo city, BuildingTypes buildingType, int buildingChangeCount)
@@ -312,12 +379,15 @@ namespace AltAI
 
     void PlayerTactics::updateCityBuildingTactics(IDInfo city)
     {
+        // each tactic projects from its own private clone of this
+        const CityDataPtr pCityData = player.getCity(city.iID).getCityData();
+
         CityBuildingTacticsMap::iterator iter = cityBuildingTacticsMap_.find(city);
         if (iter != cityBuildingTacticsMap_.end())
         {
             for (CityBuildingTacticsList::iterator buildingTacticsIter(iter->second.begin()), endIter(iter->second.end()); buildingTacticsIter != endIter; ++buildingTacticsIter)
             {
-                buildingTacticsIter->second->update(player, player.getCity(city.iID).getCityData());
+                buildingTacticsIter->second->update(player, pCityData->privateClone());
             }
         }
 
@@ -325,7 +395,7 @@ namespace AltAI
         {
             if (iter->second->getCityTactics(city))
             {
-                iter->second->getCityTactics(city)->update(player, player.getCity(city.iID).getCityData());
+                iter->second->getCityTactics(city)->update(player, pCityData->privateClone());
             }
         }
 
@@ -333,7 +403,7 @@ namespace AltAI
         {
             if (iter->second->getCityTactics(city))
             {
-                iter->second->getCityTactics(city)->update(player, player.getCity(city.iID).getCityData());
+                iter->second->getCityTactics(city)->update(player, pCityData->privateClone());
             }
         }
     }
@@ -637,8 +707,7 @@ namespace AltAI
 
     TacticSelectionData& PlayerTactics::getBaseTacticSelectionData()
     {
-        DependencyItemSet di;
-        return tacticSelectionDataMap[di];
+        return tacticSelectionDataMap[DependencyItemSetKey()];
     }
     
     TacticSelectionDataMap& PlayerTactics::getCityTacticSelectionDataMap(IDInfo city)
@@ -648,8 +717,7 @@ namespace AltAI
 
     TacticSelectionData& PlayerTactics::getCityTacticSelectionData(IDInfo city)
     {
-        DependencyItemSet di;
-        return cityTacticSelectionDataMap[city][di];
+        return cityTacticSelectionDataMap[city][DependencyItemSetKey()];
     }
 
     std::map<int, ICityBuildingTacticsPtr> PlayerTactics::getCityBuildingTactics(BuildingTypes buildingType) const
@@ -727,6 +795,8 @@ namespace AltAI
 
     ConstructItem PlayerTactics::getBuildItem(City& city)
     {
+        ProfileScope profileScope("PlayerTactics::getBuildItem", player.getPlayerID());
+
         //debugTactics();
         return AltAI::getConstructItem(*this, city);
     }
@@ -1434,7 +1504,7 @@ namespace AltAI
                                 events.push_back(IProjectionEventPtr(new ProjectionGlobalBuildingEvent(pBuildingInfo, firstBuiltTurn, pBuiltCity)));
 
                                 ConstructItem constructItem;
-                                ProjectionLadder otherCityProjection = getProjectedOutput(player, pCityData, player.getAnalysis()->getNumSimTurns(), events, constructItem, __FUNCTION__, true);
+                                ProjectionLadder otherCityProjection = getIncrementalProjectedOutput(player, pCityData, player.getAnalysis()->getNumSimTurns(), events, __FUNCTION__);
 
                                 //if (!otherCityProjection.comparisons.empty())
                                 {
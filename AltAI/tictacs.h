@@ -144,6 +144,7 @@ namespace AltAI
         void addBuildingTactics_(const boost::shared_ptr<BuildingInfo>& pBuildingInfo, CvCity* pCity);
         void addSpecialBuildingTactics_(const boost::shared_ptr<BuildingInfo>& pBuildingInfo, CvCity* pCity);
         void addUnitTactics_(const boost::shared_ptr<UnitInfo>& pUnitInfo, CvCity* pCity);
+        void evaluateCityBuildingTactics_(const City& city, const std::vector<boost::shared_ptr<BuildingInfo> >& buildings, CityBuildingTacticsList& newTactics);
 
         bool initialised_;
     };
@@ -4,36 +4,77 @@
 #include "./player_analysis.h"
 #include "./unit_info_visitors.h"
 #include "./player.h"
+#include "./gamedata_analysis.h"
 #include "./helper_fns.h"
 #include "./save_utils.h"
 #include "./civ_log.h"
+#include "./error_log.h"
 #include "./unit_info.h"
 #include "./iters.h"
+#include "./memory_data_stream.h"
 
 namespace AltAI
 {
     namespace
     {
-        int getCombatOdds(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails = UnitData::CombatDetails())
-        {
-            const int attHP = attacker.hp;
-            const int defHP = defender.hp;
-            const int attMaxHP = attacker.maxhp;
-            const int defMaxHP = defender.maxhp;
-
-            const int maxAttackerStrength = attacker.calculateStrength();
-            const int maxDefenderStrength = defender.calculateStrength(attacker, combatDetails);
+        // everything the odds calculations depend on - the units' max strengths already include the effects of promotions and the combat details
+        struct CombatOddsInputs
+        {
+            CombatOddsInputs(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails)
+                : attHP(attacker.hp), attMaxHP(attacker.maxhp), maxAttackerStrength(attacker.calculateStrength()),
+                  attFirstStrikes(attacker.firstStrikes), attChanceFirstStrikes(attacker.chanceFirstStrikes),
+                  attCombatLimit(attacker.combatLimit), attWithdrawalProb(attacker.withdrawalProb),
+                  defHP(defender.hp), defMaxHP(defender.maxhp), maxDefenderStrength(defender.calculateStrength(attacker, combatDetails)),
+                  defFirstStrikes(defender.firstStrikes), defChanceFirstStrikes(defender.chanceFirstStrikes),
+                  attImmuneToFirstStrikes(attacker.immuneToFirstStrikes), defImmuneToFirstStrikes(defender.immuneToFirstStrikes)
+            {
+            }
+
+            explicit CombatOddsInputs(const UnitAnalysis::CombatOddsKey& key)
+                : attHP(key[0]), attMaxHP(key[1]), maxAttackerStrength(key[2]), attFirstStrikes(key[3]), attChanceFirstStrikes(key[4]),
+                  attCombatLimit(key[5]), attWithdrawalProb(key[6]),
+                  defHP(key[8]), defMaxHP(key[9]), maxDefenderStrength(key[10]), defFirstStrikes(key[11]), defChanceFirstStrikes(key[12]),
+                  attImmuneToFirstStrikes(key[7] != 0), defImmuneToFirstStrikes(key[13] != 0)
+            {
+            }
+
+            UnitAnalysis::CombatOddsKey getKey() const
+            {
+                UnitAnalysis::CombatOddsKey key;
+                key[0] = attHP;
+                key[1] = attMaxHP;
+                key[2] = maxAttackerStrength;
+                key[3] = attFirstStrikes;
+                key[4] = attChanceFirstStrikes;
+                key[5] = attCombatLimit;
+                key[6] = attWithdrawalProb;
+                key[7] = attImmuneToFirstStrikes ? 1 : 0;
+                key[8] = defHP;
+                key[9] = defMaxHP;
+                key[10] = maxDefenderStrength;
+                key[11] = defFirstStrikes;
+                key[12] = defChanceFirstStrikes;
+                key[13] = defImmuneToFirstStrikes ? 1 : 0;
+                return key;
+            }
+
+            int attHP, attMaxHP, maxAttackerStrength, attFirstStrikes, attChanceFirstStrikes, attCombatLimit, attWithdrawalProb;
+            int defHP, defMaxHP, maxDefenderStrength, defFirstStrikes, defChanceFirstStrikes;
+            bool attImmuneToFirstStrikes, defImmuneToFirstStrikes;
+        };
 
-            const int attackerStrength = maxAttackerStrength * attHP / attMaxHP;
-            const int defenderStrength = maxDefenderStrength * defHP / defMaxHP;
+        int calculateCombatOdds(const CombatOddsInputs& inputs)
+        {
+            const int attackerStrength = inputs.maxAttackerStrength * inputs.attHP / inputs.attMaxHP;
+            const int defenderStrength = inputs.maxDefenderStrength * inputs.defHP / inputs.defMaxHP;
 
-            const int attackerFirepower = (1 + maxAttackerStrength + attackerStrength) / 2;
-            const int defenderFirepower = (1 + maxDefenderStrength + defenderStrength) / 2;
+            const int attackerFirepower = (1 + inputs.maxAttackerStrength + attackerStrength) / 2;
+            const int defenderFirepower = (1 + inputs.maxDefenderStrength + defenderStrength) / 2;
 
-            return ::getCombatOdds(attackerStrength, attacker.firstStrikes, attacker.chanceFirstStrikes, 
-                attacker.immuneToFirstStrikes, attackerFirepower, attHP, attMaxHP, attacker.combatLimit,
-                defenderStrength, defender.firstStrikes, defender.chanceFirstStrikes, 
-                defender.immuneToFirstStrikes, defenderFirepower, defHP, defMaxHP);
+            return ::getCombatOdds(attackerStrength, inputs.attFirstStrikes, inputs.attChanceFirstStrikes, 
+                inputs.attImmuneToFirstStrikes, attackerFirepower, inputs.attHP, inputs.attMaxHP, inputs.attCombatLimit,
+                defenderStrength, inputs.defFirstStrikes, inputs.defChanceFirstStrikes, 
+                inputs.defImmuneToFirstStrikes, defenderFirepower, inputs.defHP, inputs.defMaxHP);
         }
 
         struct OddsForwarder
@@ -80,39 +121,271 @@ namespace AltAI
             return true;
         }
 
-        UnitOddsData getCombatOddsDetail_(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails = UnitData::CombatDetails())
+        // structure of arrays form of the odds inputs for a whole attacker x defender matrix
+        // attacker strengths are calculated once per attacker rather than once per pairing, pair values are stored row major (one row per attacker)
+        struct CombatOddsMatrixInputs
         {
-            static const int COMBAT_DIE_SIDES = gGlobals.getDefineINT("COMBAT_DIE_SIDES");  // 1000
-            static const int COMBAT_DAMAGE = gGlobals.getDefineINT("COMBAT_DAMAGE");  // 20
+            CombatOddsMatrixInputs(const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders, const UnitData::CombatDetails& combatDetails)
+                : attackerCount(attackers.size()), defenderCount(defenders.size()),
+                  attHP(attackerCount), attMaxHP(attackerCount), maxAttackerStrength(attackerCount), attFirstStrikes(attackerCount), attChanceFirstStrikes(attackerCount),
+                  attCombatLimit(attackerCount), attWithdrawalProb(attackerCount), attImmuneToFirstStrikes(attackerCount),
+                  defHP(defenderCount), defMaxHP(defenderCount), defFirstStrikes(defenderCount), defChanceFirstStrikes(defenderCount), defImmuneToFirstStrikes(defenderCount),
+                  maxDefenderStrength(attackerCount * defenderCount), canFight(attackerCount * defenderCount)
+            {
+                for (size_t i = 0; i < attackerCount; ++i)
+                {
+                    const UnitData& attacker = attackers[i];
+                    attHP[i] = attacker.hp;
+                    attMaxHP[i] = attacker.maxhp;
+                    maxAttackerStrength[i] = attacker.calculateStrength();
+                    attFirstStrikes[i] = attacker.firstStrikes;
+                    attChanceFirstStrikes[i] = attacker.chanceFirstStrikes;
+                    attCombatLimit[i] = attacker.combatLimit;
+                    attWithdrawalProb[i] = attacker.withdrawalProb;
+                    attImmuneToFirstStrikes[i] = attacker.immuneToFirstStrikes;
+                }
 
-            UnitOddsData odds;
+                for (size_t j = 0; j < defenderCount; ++j)
+                {
+                    const UnitData& defender = defenders[j];
+                    defHP[j] = defender.hp;
+                    defMaxHP[j] = defender.maxhp;
+                    defFirstStrikes[j] = defender.firstStrikes;
+                    defChanceFirstStrikes[j] = defender.chanceFirstStrikes;
+                    defImmuneToFirstStrikes[j] = defender.immuneToFirstStrikes;
+                }
 
-            const int attHP = attacker.hp;
-            const int defHP = defender.hp;
-            const int attMaxHP = attacker.maxhp;
-            const int defMaxHP = defender.maxhp;
+                for (size_t i = 0; i < attackerCount; ++i)
+                {
+                    for (size_t j = 0; j < defenderCount; ++j)
+                    {
+                        const size_t index = i * defenderCount + j;
+                        // as UnitAnalysis::getOdds(attacker, defenders, combatDetails, true)
+                        canFight[index] = canAttack(attackers[i], defenders[j], combatDetails) && defenders[j].pUnitInfo->getCombat() > 0
+                            && attackers[i].pUnitInfo->getDomainType() == defenders[j].pUnitInfo->getDomainType();
+                        // defender's strength depends on who is attacking
+                        maxDefenderStrength[index] = canFight[index] ? defenders[j].calculateStrength(attackers[i], combatDetails) : 0;
+                    }
+                }
+            }
 
-            const int maxAttackerStrength = attacker.calculateStrength();
-            const int maxDefenderStrength = defender.calculateStrength(attacker, combatDetails);
+            UnitAnalysis::CombatOddsKey getKey(size_t attackerIndex, size_t defenderIndex) const
+            {
+                UnitAnalysis::CombatOddsKey key;
+                key[0] = attHP[attackerIndex];
+                key[1] = attMaxHP[attackerIndex];
+                key[2] = maxAttackerStrength[attackerIndex];
+                key[3] = attFirstStrikes[attackerIndex];
+                key[4] = attChanceFirstStrikes[attackerIndex];
+                key[5] = attCombatLimit[attackerIndex];
+                key[6] = attWithdrawalProb[attackerIndex];
+                key[7] = attImmuneToFirstStrikes[attackerIndex] ? 1 : 0;
+                key[8] = defHP[defenderIndex];
+                key[9] = defMaxHP[defenderIndex];
+                key[10] = maxDefenderStrength[attackerIndex * defenderCount + defenderIndex];
+                key[11] = defFirstStrikes[defenderIndex];
+                key[12] = defChanceFirstStrikes[defenderIndex];
+                key[13] = defImmuneToFirstStrikes[defenderIndex] ? 1 : 0;
+                return key;
+            }
+
+            size_t attackerCount, defenderCount;
+            std::vector<int> attHP, attMaxHP, maxAttackerStrength, attFirstStrikes, attChanceFirstStrikes, attCombatLimit, attWithdrawalProb;
+            std::vector<char> attImmuneToFirstStrikes;
+            std::vector<int> defHP, defMaxHP, defFirstStrikes, defChanceFirstStrikes;
+            std::vector<char> defImmuneToFirstStrikes;
+            std::vector<int> maxDefenderStrength;
+            std::vector<char> canFight;
+        };
 
-            const int attackerStrength = maxAttackerStrength * attHP / attMaxHP;
-            const int defenderStrength = maxDefenderStrength * defHP / defMaxHP;
+        // getBinomialCoefficient() results, calculated on first use - one table is shared by all the pairings of a matrix
+        class BinomialTable
+        {
+        public:
+            float operator() (const int n, const int k)
+            {
+                if (n < 0 || k < 0 || k > n)
+                {
+                    return (float)getBinomialCoefficient(n, k);
+                }
 
-            const int attackerFirepower = (1 + maxAttackerStrength + attackerStrength) / 2;
-            const int defenderFirepower = (1 + maxDefenderStrength + defenderStrength) / 2;
+                const size_t index = (size_t)n * (n + 1) / 2 + k;
+                if (index >= values_.size())
+                {
+                    values_.resize((size_t)(n + 1) * (n + 2) / 2, -1.0f);
+                }
+                if (values_[index] < 0.0f)
+                {
+                    values_[index] = (float)getBinomialCoefficient(n, k);
+                }
+                return values_[index];
+            }
 
-            const int iStrengthFactor = ((attackerFirepower + defenderFirepower + 1) / 2);
-            const int iDamageToAttacker = std::max<int>(1, (COMBAT_DAMAGE * (defenderFirepower + iStrengthFactor)) / (attackerFirepower + iStrengthFactor));
-            const int iDamageToDefender = std::max<int>(1, (COMBAT_DAMAGE * (attackerFirepower + iStrengthFactor)) / (defenderFirepower + iStrengthFactor));
-            const int iDefenderHitLimit = defMaxHP - attacker.combatLimit;
+        private:
+            std::vector<float> values_;
+        };
 
-            const int iNeededRoundsAttacker = (defHP - defMaxHP + attacker.combatLimit - (attacker.combatLimit == defMaxHP ? 1 : 0)) / iDamageToDefender + 1;
-            const int iNeededRoundsDefender = (attHP - 1) / iDamageToAttacker + 1;
+        // same odds for each (hits to attacker, hits to defender) outcome as the float ::getCombatOdds() overload,
+        // but with the per fight setup done once in reset() and the powers of the round odds tabulated
+        class CombatOutcomeOdds
+        {
+        public:
+            explicit CombatOutcomeOdds(BinomialTable& binomials) : binomials_(&binomials)
+            {
+            }
+
+            void reset(const int attStrength, const int defStrength, const int attHP, const int defHP, const int defMaxHP,
+                const int attCombatLimit, const int attWithdrawalProb, const int damageToAttacker, const int damageToDefender, const int neededRoundsAttacker,
+                const int attFirstStrikes, const int attChanceFirstStrikes, const bool attImmuneToFirstStrikes,
+                const int defFirstStrikes, const int defChanceFirstStrikes, const bool defImmuneToFirstStrikes)
+            {
+                const int COMBAT_DIE_SIDES = GameDataAnalysis::getCombatDieSides();  // 1000
+                const int MAX_HIT_POINTS = gGlobals.getMAX_HIT_POINTS();  // 100
+
+                const int defenderOdds = (COMBAT_DIE_SIDES * defStrength) / (attStrength + defStrength);
+                P_A_ = (float)(COMBAT_DIE_SIDES - defenderOdds) / COMBAT_DIE_SIDES;
+                P_D_ = (float)defenderOdds / COMBAT_DIE_SIDES;
+
+                neededRoundsAttacker_ = neededRoundsAttacker;
+                N_D_ = (std::max<int>(0, defHP - (defMaxHP - attCombatLimit)) + damageToDefender - (attCombatLimit == MAX_HIT_POINTS ? 1 : 0)) / damageToDefender;
+                N_A_ = (attHP - 1) / damageToAttacker + 1;
+
+                retreatOdds_ = std::min<int>(attWithdrawalProb, 100) * 0.01f;
+
+                attFSnet_ = (defImmuneToFirstStrikes ? 0 : attFirstStrikes) - (attImmuneToFirstStrikes ? 0 : defFirstStrikes);
+                attFSC_ = defImmuneToFirstStrikes ? 0 : attChanceFirstStrikes;
+                defFSC_ = attImmuneToFirstStrikes ? 0 : defChanceFirstStrikes;
+
+                // largest exponent any outcome uses - anything outside the tables falls back to pow()
+                const int maxPower = N_A_ + std::max<int>(N_D_, neededRoundsAttacker_) + std::abs(attFSnet_) + attFSC_ + defFSC_;
+                powersA_.resize(std::max<int>(0, maxPower) + 1);
+                powersD_.resize(powersA_.size());
+                for (size_t k = 0, count = powersA_.size(); k < count; ++k)
+                {
+                    powersA_[k] = pow(P_A_, (float)k);
+                    powersD_[k] = pow(P_D_, (float)k);
+                }
+            }
+
+            float operator() (const int nHitsToAttacker, const int nHitsToDefender) const
+            {
+                float answer = 0.0f;
+
+                if (nHitsToAttacker < N_A_ && nHitsToDefender == neededRoundsAttacker_)  // (1) defender dies or is taken to combat limit
+                {
+                    float sum1 = 0.0f;
+                    for (int i = (-attFSnet_ - attFSC_ < 1 ? 1 : -attFSnet_ - attFSC_); i <= defFSC_ - attFSnet_; i++)
+                    {
+                        for (int j = 0; j <= i; j++)
+                        {
+                            if (nHitsToAttacker >= j)
+                            {
+                                sum1 += binomial_(i, j) * powA_(i - j) * binomial_(neededRoundsAttacker_ - 1 + nHitsToAttacker - j, neededRoundsAttacker_ - 1);
+                            }
+                        }
+                    }
+
+                    sum1 *= powD_(nHitsToAttacker) * powA_(neededRoundsAttacker_);
+                    answer += sum1;
+
+                    float sum2 = 0.0f;
+                    for (int i = (0 < attFSnet_ - defFSC_ ? attFSnet_ - defFSC_ : 0); i <= attFSnet_ + attFSC_; i++)
+                    {
+                        for (int j = 0; j <= i; j++)
+                        {
+                            if (N_D_ > j)
+                            {
+                                sum2 += binomial_(nHitsToAttacker + neededRoundsAttacker_ - j - 1, nHitsToAttacker) *
+                                    binomial_(i, j) * powA_(neededRoundsAttacker_) * powD_(nHitsToAttacker + i - j);
+                            }
+                            else if (nHitsToAttacker == 0)
+                            {
+                                sum2 += binomial_(i, j) * powA_(j) * powD_(i - j);
+                            }
+                        }
+                    }
+                    answer += sum2;
+                }
+                else if (nHitsToDefender < N_D_ && nHitsToAttacker == N_A_)  // (2) attacker dies
+                {
+                    answer += attackerLosesOdds_((-attFSnet_ - attFSC_ < 1 ? 1 : -attFSnet_ - attFSC_), nHitsToDefender);
+                    answer = answer * (1.0f - retreatOdds_);
+                }
+                else if (nHitsToAttacker == (N_A_ - 1) && nHitsToDefender < N_D_)  // (3) attacker retreats
+                {
+                    answer += attackerLosesOdds_((attFSnet_ + attFSC_ > -1 ? 1 : -attFSnet_ - attFSC_), nHitsToDefender);
+                    answer = answer * retreatOdds_;
+                }
+
+                answer /= (float)(attFSC_ + defFSC_ + 1);
+                return answer;
+            }
+
+        private:
+            // common sums for the attacker dying and retreating cases, which only differ in the first strike count the first sum starts from
+            float attackerLosesOdds_(const int firstI, const int nHitsToDefender) const
+            {
+                float sum1 = 0.0f;
+                for (int i = firstI; i <= defFSC_ - attFSnet_; i++)
+                {
+                    for (int j = 0; j <= i; j++)
+                    {
+                        if (N_A_ > j)
+                        {
+                            sum1 += binomial_(nHitsToDefender + N_A_ - j - 1, nHitsToDefender) * binomial_(i, j) * powD_(N_A_) * powA_(nHitsToDefender + i - j);
+                        }
+                        else if (nHitsToDefender == 0)
+                        {
+                            sum1 += binomial_(i, j) * powD_(j) * powA_(i - j);
+                        }
+                    }
+                }
+
+                float sum2 = 0.0f;
+                for (int i = (0 < attFSnet_ - defFSC_ ? attFSnet_ - defFSC_ : 0); i <= attFSnet_ + attFSC_; i++)
+                {
+                    for (int j = 0; j <= i; j++)
+                    {
+                        if (nHitsToDefender >= j)
+                        {
+                            sum2 += binomial_(i, j) * powD_(i - j) * binomial_(N_A_ - 1 + nHitsToDefender - j, N_A_ - 1);
+                        }
+                    }
+                }
+                sum2 *= powA_(nHitsToDefender) * powD_(N_A_);
+
+                return sum1 + sum2;
+            }
+
+            float binomial_(const int n, const int k) const
+            {
+                return (*binomials_)(n, k);
+            }
+
+            float powA_(const int k) const
+            {
+                return k >= 0 && k < (int)powersA_.size() ? powersA_[k] : pow(P_A_, (float)k);
+            }
+
+            float powD_(const int k) const
+            {
+                return k >= 0 && k < (int)powersD_.size() ? powersD_[k] : pow(P_D_, (float)k);
+            }
+
+            BinomialTable* binomials_;
+            float P_A_, P_D_, retreatOdds_;
+            int neededRoundsAttacker_, N_A_, N_D_, attFSnet_, attFSC_, defFSC_;
+            std::vector<float> powersA_, powersD_;
+        };
 
-            OddsForwarder oddsForwarder(attackerStrength, attacker.firstStrikes, attacker.chanceFirstStrikes,
-                        attackerFirepower, attHP, attMaxHP, attacker.combatLimit, attacker.withdrawalProb,
-                        defenderStrength, defender.firstStrikes, defender.chanceFirstStrikes,
-                        defenderFirepower, defHP, defMaxHP, attacker.immuneToFirstStrikes, defender.immuneToFirstStrikes);
+        // expected hps and outcome odds of one fight, given the odds of each (hits to attacker, hits to defender) outcome
+        template <typename OutcomeOdds>
+            UnitOddsData sumOddsDetail(const OutcomeOdds& oddsForwarder, const int attHP, const int defHP, const int defMaxHP,
+                const int attCombatLimit, const int attWithdrawalProb, const int iDamageToAttacker, const int iDamageToDefender,
+                const int iNeededRoundsAttacker, const int iNeededRoundsDefender)
+        {
+            UnitOddsData odds;
+            const int iDefenderHitLimit = defMaxHP - attCombatLimit;
 
             for (int n_A = 0; n_A < iNeededRoundsDefender; n_A++)
             {
@@ -121,7 +394,7 @@ namespace AltAI
 
             odds.E_HP_Att_Victory = odds.E_HP_Att;         
 
-            if (attacker.withdrawalProb > 0)
+            if (attWithdrawalProb > 0)
             {
                 odds.E_HP_Att_Withdraw = odds.E_HP_Att;
                 for (int n_D = 0; n_D < iNeededRoundsAttacker; n_D++)
@@ -130,7 +403,7 @@ namespace AltAI
                 }
             }
 
-            if (attacker.combatLimit < defMaxHP)
+            if (attCombatLimit < defMaxHP)
             {
                 odds.E_HP_Att_Retreat = (float)(attHP - (iNeededRoundsDefender - 1) * iDamageToAttacker);
             }
@@ -142,7 +415,7 @@ namespace AltAI
 
             odds.E_HP_Def_Defeat = odds.E_HP_Def;
 
-            if (attacker.combatLimit < defMaxHP) // if attacker has a combatLimit (eg. catapult)
+            if (attCombatLimit < defMaxHP) // if attacker has a combatLimit (eg. catapult)
             {
                 // code specific to case where the last successful hit by an attacker will do 0 damage, 
                 // and doing either iNeededRoundsAttacker or iNeededRoundsAttacker - 1 will cause the same damage
@@ -154,7 +427,7 @@ namespace AltAI
                 }
             }
 
-            if (attacker.combatLimit == defMaxHP) // ie. we can kill the defender...
+            if (attCombatLimit == defMaxHP) // ie. we can kill the defender...
             {
                 for (int n_A = 0; n_A < iNeededRoundsDefender; n_A++)
                 {
@@ -170,7 +443,7 @@ namespace AltAI
                 }
             }
 
-            if (attacker.withdrawalProb > 0)
+            if (attWithdrawalProb > 0)
             {
                 for (int n_D = 0; n_D < iNeededRoundsAttacker; n_D++)
                 {
@@ -186,6 +459,127 @@ namespace AltAI
             return odds;
         }
 
+        UnitOddsData calculateCombatOddsDetail(const CombatOddsInputs& inputs)
+        {
+            const int COMBAT_DAMAGE = GameDataAnalysis::getCombatDamage();  // 20
+
+            const int attHP = inputs.attHP;
+            const int defHP = inputs.defHP;
+            const int attMaxHP = inputs.attMaxHP;
+            const int defMaxHP = inputs.defMaxHP;
+            const int attCombatLimit = inputs.attCombatLimit;
+            const int attWithdrawalProb = inputs.attWithdrawalProb;
+
+            const int maxAttackerStrength = inputs.maxAttackerStrength;
+            const int maxDefenderStrength = inputs.maxDefenderStrength;
+
+            const int attackerStrength = maxAttackerStrength * attHP / attMaxHP;
+            const int defenderStrength = maxDefenderStrength * defHP / defMaxHP;
+
+            const int attackerFirepower = (1 + maxAttackerStrength + attackerStrength) / 2;
+            const int defenderFirepower = (1 + maxDefenderStrength + defenderStrength) / 2;
+
+            const int iStrengthFactor = ((attackerFirepower + defenderFirepower + 1) / 2);
+            const int iDamageToAttacker = std::max<int>(1, (COMBAT_DAMAGE * (defenderFirepower + iStrengthFactor)) / (attackerFirepower + iStrengthFactor));
+            const int iDamageToDefender = std::max<int>(1, (COMBAT_DAMAGE * (attackerFirepower + iStrengthFactor)) / (defenderFirepower + iStrengthFactor));
+
+            const int iNeededRoundsAttacker = (defHP - defMaxHP + attCombatLimit - (attCombatLimit == defMaxHP ? 1 : 0)) / iDamageToDefender + 1;
+            const int iNeededRoundsDefender = (attHP - 1) / iDamageToAttacker + 1;
+
+            OddsForwarder oddsForwarder(attackerStrength, inputs.attFirstStrikes, inputs.attChanceFirstStrikes,
+                        attackerFirepower, attHP, attMaxHP, attCombatLimit, attWithdrawalProb,
+                        defenderStrength, inputs.defFirstStrikes, inputs.defChanceFirstStrikes,
+                        defenderFirepower, defHP, defMaxHP, inputs.attImmuneToFirstStrikes, inputs.defImmuneToFirstStrikes);
+
+            return sumOddsDetail(oddsForwarder, attHP, defHP, defMaxHP, attCombatLimit, attWithdrawalProb,
+                iDamageToAttacker, iDamageToDefender, iNeededRoundsAttacker, iNeededRoundsDefender);
+        }
+
+        // calculates the odds detail for each pairing flagged in toCalculate - so callers can skip pairings they already have results for
+        // strengths, firepower, damage and the rounds each side needs are computed in separate passes over the flat arrays,
+        // then each pairing's outcomes are summed with the binomials shared across the matrix and the round odds' powers shared across the pairing
+        // same arithmetic as calculateCombatOddsDetail(), so results only differ from the scalar version by float rounding
+        void calculateCombatOddsDetailMatrix(const CombatOddsMatrixInputs& inputs, const std::vector<char>& toCalculate, std::vector<UnitOddsData>& odds)
+        {
+            const int COMBAT_DAMAGE = GameDataAnalysis::getCombatDamage();  // 20
+
+            const size_t attackerCount = inputs.attackerCount, defenderCount = inputs.defenderCount, pairCount = attackerCount * defenderCount;
+
+            std::vector<int> attackerStrength(attackerCount), attackerFirepower(attackerCount);
+            for (size_t i = 0; i < attackerCount; ++i)
+            {
+                attackerStrength[i] = inputs.maxAttackerStrength[i] * inputs.attHP[i] / inputs.attMaxHP[i];
+                attackerFirepower[i] = (1 + inputs.maxAttackerStrength[i] + attackerStrength[i]) / 2;
+            }
+
+            std::vector<int> defenderStrength(pairCount), defenderFirepower(pairCount);
+            for (size_t i = 0; i < attackerCount; ++i)
+            {
+                for (size_t j = 0, index = i * defenderCount; j < defenderCount; ++j, ++index)
+                {
+                    defenderStrength[index] = inputs.maxDefenderStrength[index] * inputs.defHP[j] / inputs.defMaxHP[j];
+                    defenderFirepower[index] = (1 + inputs.maxDefenderStrength[index] + defenderStrength[index]) / 2;
+                }
+            }
+
+            std::vector<int> damageToAttacker(pairCount), damageToDefender(pairCount), neededRoundsAttacker(pairCount), neededRoundsDefender(pairCount);
+            for (size_t i = 0; i < attackerCount; ++i)
+            {
+                for (size_t j = 0, index = i * defenderCount; j < defenderCount; ++j, ++index)
+                {
+                    if (toCalculate[index])
+                    {
+                        const int strengthFactor = (attackerFirepower[i] + defenderFirepower[index] + 1) / 2;
+                        damageToAttacker[index] = std::max<int>(1, (COMBAT_DAMAGE * (defenderFirepower[index] + strengthFactor)) / (attackerFirepower[i] + strengthFactor));
+                        damageToDefender[index] = std::max<int>(1, (COMBAT_DAMAGE * (attackerFirepower[i] + strengthFactor)) / (defenderFirepower[index] + strengthFactor));
+                        neededRoundsAttacker[index] = (inputs.defHP[j] - inputs.defMaxHP[j] + inputs.attCombatLimit[i] - (inputs.attCombatLimit[i] == inputs.defMaxHP[j] ? 1 : 0)) / damageToDefender[index] + 1;
+                        neededRoundsDefender[index] = (inputs.attHP[i] - 1) / damageToAttacker[index] + 1;
+                    }
+                }
+            }
+
+            odds.resize(pairCount);
+            BinomialTable binomials;
+            CombatOutcomeOdds outcomeOdds(binomials);
+            for (size_t i = 0; i < attackerCount; ++i)
+            {
+                for (size_t j = 0, index = i * defenderCount; j < defenderCount; ++j, ++index)
+                {
+                    if (toCalculate[index])
+                    {
+                        outcomeOdds.reset(attackerStrength[i], defenderStrength[index], inputs.attHP[i], inputs.defHP[j], inputs.defMaxHP[j],
+                            inputs.attCombatLimit[i], inputs.attWithdrawalProb[i], damageToAttacker[index], damageToDefender[index], neededRoundsAttacker[index],
+                            inputs.attFirstStrikes[i], inputs.attChanceFirstStrikes[i], inputs.attImmuneToFirstStrikes[i] != 0,
+                            inputs.defFirstStrikes[j], inputs.defChanceFirstStrikes[j], inputs.defImmuneToFirstStrikes[j] != 0);
+
+                        odds[index] = sumOddsDetail(outcomeOdds, inputs.attHP[i], inputs.defHP[j], inputs.defMaxHP[j], inputs.attCombatLimit[i], inputs.attWithdrawalProb[i],
+                            damageToAttacker[index], damageToDefender[index], neededRoundsAttacker[index], neededRoundsDefender[index]);
+                    }
+                }
+            }
+        }
+
+#ifdef ALTAI_DEBUG
+        // true if every field agrees to within tolerance (relative to the field's size, for the expected hps)
+        bool oddsDetailMatches(const UnitOddsData& first, const UnitOddsData& second, const float tolerance)
+        {
+            const float firstValues[] = {first.E_HP_Att, first.E_HP_Def, first.E_HP_Att_Withdraw, first.E_HP_Att_Victory, first.E_HP_Att_Retreat,
+                first.E_HP_Def_Withdraw, first.E_HP_Def_Defeat, first.AttackerKillOdds, first.PullOutOdds, first.RetreatOdds, first.DefenderKillOdds};
+            const float secondValues[] = {second.E_HP_Att, second.E_HP_Def, second.E_HP_Att_Withdraw, second.E_HP_Att_Victory, second.E_HP_Att_Retreat,
+                second.E_HP_Def_Withdraw, second.E_HP_Def_Defeat, second.AttackerKillOdds, second.PullOutOdds, second.RetreatOdds, second.DefenderKillOdds};
+
+            for (size_t i = 0; i < sizeof(firstValues) / sizeof(firstValues[0]); ++i)
+            {
+                const float scale = std::max<float>(1.0f, std::max<float>(fabs(firstValues[i]), fabs(secondValues[i])));
+                if (fabs(firstValues[i] - secondValues[i]) > tolerance * scale)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+#endif
+
         void debugPromotion(std::ostream& os, PromotionTypes promotionType, const Promotions& requiredPromotions, int level)
         {
 #ifdef ALTAI_DEBUG
@@ -385,6 +779,118 @@ namespace AltAI
         }
     }
 
+    namespace
+    {
+        // unit type and its sorted promotions - all the profile's tables are derived from these
+        typedef std::pair<UnitTypes, std::vector<PromotionTypes> > ModifierProfileKey;
+        typedef std::map<ModifierProfileKey, UnitData::ModifierProfilePtr> ModifierProfileMap;
+
+        // only grows - bounded by the number of distinct unit type and promotion combinations seen
+        ModifierProfileMap modifierProfiles;
+        // unit data can be made on the worker pool (e.g. applying collateral damage in combat graphs)
+        CriticalSection modifierProfilesLock;
+
+        // as CvUnit::setHasPromotion
+        void addPromotionModifiers(const CvPromotionInfo& promotion, UnitData::ModifierProfile& modifierProfile)
+        {
+            for (int i = 0, count = gGlobals.getNumTerrainInfos(); i < count; ++i)
+            {
+                modifierProfile.terrainAttackModifiers[i] += promotion.getTerrainAttackPercent(i);
+                modifierProfile.terrainDefenceModifiers[i] += promotion.getTerrainDefensePercent(i);
+                if (promotion.getTerrainDoubleMove(i))
+                {
+                    modifierProfile.terrainDoubleMoves[i] = 1;
+                }
+            }
+
+            for (int i = 0, count = gGlobals.getNumFeatureInfos(); i < count; ++i)
+            {
+                modifierProfile.featureAttackModifiers[i] += promotion.getFeatureAttackPercent(i);
+                modifierProfile.featureDefenceModifiers[i] += promotion.getFeatureDefensePercent(i);
+                if (promotion.getFeatureDoubleMove(i))
+                {
+                    modifierProfile.featureDoubleMoves[i] = 1;
+                }
+            }
+
+            for (int i = 0, count = gGlobals.getNumUnitCombatInfos(); i < count; ++i)
+            {
+                modifierProfile.unitCombatModifiers[i] += promotion.getUnitCombatModifierPercent(i);
+            }
+        }
+
+        // the save format keeps the modifiers as maps of the non-zero entries
+        template <typename T>
+            std::map<T, int> makeModifiersMap(const std::vector<int>& modifiers)
+        {
+            std::map<T, int> modifiersMap;
+            for (size_t i = 0, count = modifiers.size(); i < count; ++i)
+            {
+                if (modifiers[i] != 0)
+                {
+                    modifiersMap[(T)i] = modifiers[i];
+                }
+            }
+            return modifiersMap;
+        }
+    }
+
+    UnitData::ModifierProfile::ModifierProfile() :
+        featureAttackModifiers(gGlobals.getNumFeatureInfos(), 0), featureDefenceModifiers(gGlobals.getNumFeatureInfos(), 0),
+        terrainAttackModifiers(gGlobals.getNumTerrainInfos(), 0), terrainDefenceModifiers(gGlobals.getNumTerrainInfos(), 0),
+        unitCombatModifiers(gGlobals.getNumUnitCombatInfos(), 0),
+        featureDoubleMoves(gGlobals.getNumFeatureInfos(), 0), terrainDoubleMoves(gGlobals.getNumTerrainInfos(), 0)
+    {
+    }
+
+    // the profile is only built the first time a unit type and promotion combination is seen
+    UnitData::ModifierProfilePtr UnitData::getModifierProfile(UnitTypes unitType, const std::vector<PromotionTypes>& promotions)
+    {
+        ModifierProfileKey key(unitType, promotions);
+        std::sort(key.second.begin(), key.second.end());
+
+        CriticalSectionLock lock(modifierProfilesLock);
+
+        ModifierProfileMap::const_iterator profileIter = modifierProfiles.find(key);
+        if (profileIter != modifierProfiles.end())
+        {
+            return profileIter->second;
+        }
+
+        // as the CvUnit modifier functions - the unit type's values plus those of its promotions
+        boost::shared_ptr<ModifierProfile> pModifierProfile(new ModifierProfile());
+        if (unitType != NO_UNIT)
+        {
+            const CvUnitInfo& unitInfo = gGlobals.getUnitInfo(unitType);
+
+            for (int i = 0, count = gGlobals.getNumUnitCombatInfos(); i < count; ++i)
+            {
+                pModifierProfile->unitCombatModifiers[i] = unitInfo.getUnitCombatModifier(i);
+            }
+
+            for (int i = 0, count = gGlobals.getNumTerrainInfos(); i < count; ++i)
+            {
+                pModifierProfile->terrainAttackModifiers[i] = unitInfo.getTerrainAttackModifier(i);
+                pModifierProfile->terrainDefenceModifiers[i] = unitInfo.getTerrainDefenseModifier(i);
+            }
+
+            for (int i = 0, count = gGlobals.getNumFeatureInfos(); i < count; ++i)
+            {
+                pModifierProfile->featureAttackModifiers[i] = unitInfo.getFeatureAttackModifier(i);
+                pModifierProfile->featureDefenceModifiers[i] = unitInfo.getFeatureDefenseModifier(i);
+            }
+        }
+
+        for (size_t i = 0, count = key.second.size(); i < count; ++i)
+        {
+            addPromotionModifiers(gGlobals.getPromotionInfo(key.second[i]), *pModifierProfile);
+        }
+        pModifierProfile->promotions = key.second;
+
+        modifierProfiles.insert(std::make_pair(key, pModifierProfile));
+        return pModifierProfile;
+    }
+
     UnitData::UnitData() :
         pUnitInfo(NULL),
         unitType(NO_UNIT),
@@ -398,7 +904,7 @@ namespace AltAI
         hasAttacked(false),
         animalModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIAnimalCombatModifier()),
         barbModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIBarbarianCombatModifier()),
-        featureDoubleMoves(gGlobals.getNumFeatureInfos(), 0), terrainDoubleMoves(gGlobals.getNumTerrainInfos(), 0)
+        pModifierProfile(getModifierProfile(NO_UNIT, std::vector<PromotionTypes>()))
     {
     }
 
@@ -424,38 +930,8 @@ namespace AltAI
         animalModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIAnimalCombatModifier()),
         barbModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIBarbarianCombatModifier())
     {
-        for (int i = 0, count = gGlobals.getNumUnitCombatInfos(); i < count; ++i)
-        {
-            if (pUnit->unitCombatModifier((UnitCombatTypes)i) != 0)
-            {
-                unitCombatModifiers[(UnitCombatTypes)i] = pUnit->unitCombatModifier((UnitCombatTypes)i);
-            }
-        }
-
-        for (int i = 0, count = gGlobals.getNumTerrainInfos(); i < count; ++i)
-        {
-            if (pUnit->terrainAttackModifier((TerrainTypes)i) != 0)
-            {
-                unitTerrainAttackModifiers[(TerrainTypes)i] = pUnit->terrainAttackModifier((TerrainTypes)i);
-            }
-            if (pUnit->terrainDefenseModifier((TerrainTypes)i) != 0)
-            {
-                unitTerrainDefenceModifiers[(TerrainTypes)i] = pUnit->terrainDefenseModifier((TerrainTypes)i);
-            }
-        }
-
-        for (int i = 0, count = gGlobals.getNumFeatureInfos(); i < count; ++i)
-        {
-            if (pUnit->featureAttackModifier((FeatureTypes)i) != 0)
-            {
-                unitFeatureAttackModifiers[(FeatureTypes)i] = pUnit->featureAttackModifier((FeatureTypes)i);
-            }
-            if (pUnit->featureDefenseModifier((FeatureTypes)i) != 0)
-            {
-                unitFeatureDefenceModifiers[(FeatureTypes)i] = pUnit->featureDefenseModifier((FeatureTypes)i);
-            }
-        }
-
+        // the unit's terrain, feature and unit combat modifiers and double moves only come from its type and promotions
+        std::vector<PromotionTypes> promotions;
         for (int i = 0, count = gGlobals.getNumPromotionInfos(); i < count; ++i)
         {
             if (pUnit->isHasPromotion((PromotionTypes)i))
@@ -464,14 +940,7 @@ namespace AltAI
             }
         }
 
-        for (int i = 0, infoCount = gGlobals.getNumFeatureInfos(); i < infoCount; ++i)
-        {
-            featureDoubleMoves.push_back(pUnit->isFeatureDoubleMove((FeatureTypes)i));
-        }
-        for (int i = 0, infoCount = gGlobals.getNumTerrainInfos(); i < infoCount; ++i)
-        {
-            terrainDoubleMoves.push_back(pUnit->isTerrainDoubleMove((TerrainTypes)i));
-        }
+        pModifierProfile = getModifierProfile(unitType, promotions);
     }
 
     UnitData::UnitData(UnitTypes unitType_, const Promotions& promotions_) :
@@ -492,55 +961,38 @@ namespace AltAI
         immuneToFirstStrikes(pUnitInfo->isFirstStrikeImmune()), isBlitz(false), isBarbarian(false), isAnimal(pUnitInfo->isAnimal()),
         hasAttacked(false),
         animalModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIAnimalCombatModifier()),
-        barbModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIBarbarianCombatModifier()),
-        featureDoubleMoves(gGlobals.getNumFeatureInfos(), 0), terrainDoubleMoves(gGlobals.getNumTerrainInfos(), 0)
+        barbModifier(gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).getAIBarbarianCombatModifier())
     {
-        for (int i = 0, count = gGlobals.getNumUnitCombatInfos(); i < count; ++i)
+        std::vector<PromotionTypes> promotions;
+        for (Promotions::const_iterator ci(promotions_.begin()), ciEnd(promotions_.end()); ci != ciEnd; ++ci)
         {
-            if (pUnitInfo->getUnitCombatModifier(i) != 0)
+            if (applyPromotion_(*ci, promotions))
             {
-                unitCombatModifiers[(UnitCombatTypes)i] = pUnitInfo->getUnitCombatModifier(i);
+                promotions.push_back(*ci);
             }
         }
 
-        for (int i = 0, count = gGlobals.getNumTerrainInfos(); i < count; ++i)
+        pModifierProfile = getModifierProfile(unitType, promotions);
+    }
+
+    void UnitData::applyPromotion(PromotionTypes promotionType)
+    {
+        if (applyPromotion_(promotionType, pModifierProfile->promotions))
         {
-            if (pUnitInfo->getTerrainAttackModifier(i) != 0)
-            {
-                unitTerrainAttackModifiers[(TerrainTypes)i] = pUnitInfo->getTerrainAttackModifier(i);
-            }
-            if (pUnitInfo->getTerrainDefenseModifier(i) != 0)
-            {
-                unitTerrainDefenceModifiers[(TerrainTypes)i] = pUnitInfo->getTerrainDefenseModifier(i);
-            }
-        }
-
-        for (int i = 0, count = gGlobals.getNumFeatureInfos(); i < count; ++i)
-        {
-            if (pUnitInfo->getFeatureAttackModifier(i) != 0)
-            {
-                unitFeatureAttackModifiers[(FeatureTypes)i] = pUnitInfo->getFeatureAttackModifier(i);
-            }
-            if (pUnitInfo->getFeatureDefenseModifier(i) != 0)
-            {
-                unitFeatureDefenceModifiers[(FeatureTypes)i] = pUnitInfo->getFeatureDefenseModifier(i);
-            }
-        }
-
-        for (Promotions::const_iterator ci(promotions_.begin()), ciEnd(promotions_.end()); ci != ciEnd; ++ci)
-        {
-            applyPromotion(*ci);
+            std::vector<PromotionTypes> promotions(pModifierProfile->promotions);
+            promotions.push_back(promotionType);
+            pModifierProfile = getModifierProfile(unitType, promotions);
         }
     }
 
-    void UnitData::applyPromotion(PromotionTypes promotionType)
+    // the promotion's effects on the unit's own values - getModifierProfile() adds its modifier table changes
+    bool UnitData::applyPromotion_(PromotionTypes promotionType, const std::vector<PromotionTypes>& promotions)
     {
         if (std::find(promotions.begin(), promotions.end(), promotionType) != promotions.end())
         {
-            return;
+            return false;
         }
         const CvPromotionInfo& promotion = gGlobals.getPromotionInfo(promotionType);
-        promotions.push_back(promotionType);
 
         extraCombat += promotion.getCombatPercent();
         firstStrikes += promotion.getFirstStrikesChange();
@@ -573,35 +1025,17 @@ namespace AltAI
         hillsAttackPercent += promotion.getHillsAttackPercent();
         hillsDefencePercent += promotion.getHillsDefensePercent();
 
-        for (int i = 0, count = gGlobals.getNumFeatureInfos(); i < count; ++i)
-        {
-            if (promotion.getFeatureAttackPercent(i) != 0)
-            {
-                unitFeatureAttackModifiers[(FeatureTypes)i] += promotion.getFeatureAttackPercent(i);
-            }
-            if (promotion.getFeatureDefensePercent(i) != 0)
-            {
-                unitFeatureDefenceModifiers[(FeatureTypes)i] += promotion.getFeatureDefensePercent(i);
-            }
-        }
-
-        for (int i = 0, count = gGlobals.getNumUnitCombatInfos(); i < count; ++i)
-        {
-            if (promotion.getUnitCombatModifierPercent(i) != 0)
-            {
-                unitCombatModifiers[(UnitCombatTypes)i] += promotion.getUnitCombatModifierPercent(i);
-            }
-        }
-
         if (hp < maxhp)
         {
             hp += (maxhp - hp) / 2;
         }
+        return true;
     }
 
     void UnitData::debugPromotions(std::ostream& os) const
     {
 #ifdef ALTAI_DEBUG
+        const std::vector<PromotionTypes>& promotions = pModifierProfile->promotions;
         for (size_t i = 0, count = promotions.size(); i < count; ++i)
         {
             if (i == 0) os << " {";
@@ -652,16 +1086,16 @@ namespace AltAI
         }
 
         // unit type modifiers - add defence, subtract other's attack bonus
-        std::map<UnitCombatTypes, int>::const_iterator ci = unitCombatModifiers.find((UnitCombatTypes)other.pUnitInfo->getUnitCombatType());
-        if (ci != unitCombatModifiers.end())
+        const UnitCombatTypes otherUnitCombatType = (UnitCombatTypes)other.pUnitInfo->getUnitCombatType();
+        if (otherUnitCombatType != NO_UNITCOMBAT)
         {
-            modifier += ci->second;
+            modifier += pModifierProfile->unitCombatModifiers[otherUnitCombatType];
         }
 
-        ci = other.unitCombatModifiers.find((UnitCombatTypes)pUnitInfo->getUnitCombatType());
-        if (ci != other.unitCombatModifiers.end())
+        const UnitCombatTypes unitCombatType = (UnitCombatTypes)pUnitInfo->getUnitCombatType();
+        if (unitCombatType != NO_UNITCOMBAT)
         {
-            modifier -= ci->second;
+            modifier -= other.pModifierProfile->unitCombatModifiers[unitCombatType];
         }
 
         if (combatDetails.plotIsHills)
@@ -688,34 +1122,17 @@ namespace AltAI
             }
         }
 
-        if (combatDetails.plotTerrain != NO_TERRAIN)
+        // as CvUnit::maxCombatStr - feature modifiers if the plot has a feature, otherwise terrain ones
+        // add our defence bonus, subtract the attacker's attack bonus
+        if (combatDetails.plotFeature != NO_FEATURE)
         {
-            std::map<TerrainTypes, int>::const_iterator fi = unitTerrainDefenceModifiers.find(combatDetails.plotTerrain);
-            if (fi != unitTerrainDefenceModifiers.end())
-            {
-                modifier += fi->second;
-            }
-
-            fi = unitTerrainAttackModifiers.find(combatDetails.plotTerrain);
-            if (fi != unitTerrainAttackModifiers.end())
-            {
-                modifier -= fi->second;
-            }
+            modifier += pModifierProfile->featureDefenceModifiers[combatDetails.plotFeature];
+            modifier -= other.pModifierProfile->featureAttackModifiers[combatDetails.plotFeature];
         }
-
-        if (combatDetails.plotFeature != NO_FEATURE)
+        else if (combatDetails.plotTerrain != NO_TERRAIN)
         {
-            std::map<FeatureTypes, int>::const_iterator fi = unitFeatureDefenceModifiers.find(combatDetails.plotFeature);
-            if (fi != unitFeatureDefenceModifiers.end())
-            {
-                modifier += fi->second;
-            }
-
-            fi = unitFeatureAttackModifiers.find(combatDetails.plotFeature);
-            if (fi != unitFeatureAttackModifiers.end())
-            {
-                modifier -= fi->second;
-            }
+            modifier += pModifierProfile->terrainDefenceModifiers[combatDetails.plotTerrain];
+            modifier -= other.pModifierProfile->terrainAttackModifiers[combatDetails.plotTerrain];
         }
 
         // if attacker is attacking a city (so we are the defender)
@@ -795,13 +1212,13 @@ namespace AltAI
         pStream->Write(isAnimal);
         pStream->Write(extraCollateralDamage);
         pStream->Write(collateralDamageProtection);
-        writeMap(pStream, unitFeatureAttackModifiers);
-        writeMap(pStream, unitFeatureDefenceModifiers);
-        writeMap(pStream, unitTerrainAttackModifiers);
-        writeMap(pStream, unitTerrainDefenceModifiers);
-        writeMap(pStream, unitCombatModifiers);
+        writeMap(pStream, makeModifiersMap<FeatureTypes>(pModifierProfile->featureAttackModifiers));
+        writeMap(pStream, makeModifiersMap<FeatureTypes>(pModifierProfile->featureDefenceModifiers));
+        writeMap(pStream, makeModifiersMap<TerrainTypes>(pModifierProfile->terrainAttackModifiers));
+        writeMap(pStream, makeModifiersMap<TerrainTypes>(pModifierProfile->terrainDefenceModifiers));
+        writeMap(pStream, makeModifiersMap<UnitCombatTypes>(pModifierProfile->unitCombatModifiers));
         pStream->Write(hasAttacked);
-        writeVector(pStream, promotions);
+        writeVector(pStream, pModifierProfile->promotions);
         pStream->Write(animalModifier);
         pStream->Write(barbModifier);
     }
@@ -837,13 +1254,22 @@ namespace AltAI
         pStream->Read(&isAnimal);
         pStream->Read(&extraCollateralDamage);
         pStream->Read(&collateralDamageProtection);
-        readMap<FeatureTypes, int, int, int>(pStream, unitFeatureAttackModifiers);
-        readMap<FeatureTypes, int, int, int>(pStream, unitFeatureDefenceModifiers);
-        readMap<TerrainTypes, int, int, int>(pStream, unitTerrainAttackModifiers);
-        readMap<TerrainTypes, int, int, int>(pStream, unitTerrainDefenceModifiers);
+        // the saved modifier tables are derived from the unit type and promotions, so are rebuilt from them
+        std::map<FeatureTypes, int> featureModifiers;
+        readMap<FeatureTypes, int, int, int>(pStream, featureModifiers);
+        readMap<FeatureTypes, int, int, int>(pStream, featureModifiers);
+
+        std::map<TerrainTypes, int> terrainModifiers;
+        readMap<TerrainTypes, int, int, int>(pStream, terrainModifiers);
+        readMap<TerrainTypes, int, int, int>(pStream, terrainModifiers);
+
+        std::map<UnitCombatTypes, int> unitCombatModifiers;
         readMap<UnitCombatTypes, int, int, int>(pStream, unitCombatModifiers);
+
         pStream->Read(&hasAttacked);
+        std::vector<PromotionTypes> promotions;
         readVector<PromotionTypes, int>(pStream, promotions);
+        pModifierProfile = getModifierProfile(unitType, promotions);
         pStream->Read(&animalModifier);
         pStream->Read(&barbModifier);
     }
@@ -954,11 +1380,286 @@ namespace AltAI
         return availablePromotions;
     }
 
+    namespace
+    {
+        // generic (de)serialisation of the nested containers which hold the analysis results - leaf values are ints or enums
+        template <typename T>
+            void writeValue(FDataStreamBase* pStream, const T& value)
+        {
+            pStream->Write((int)value);
+        }
+
+        // fewest bytes a value can take in the stream
+        template <typename T> struct MinStreamSize
+        {
+            enum { value = sizeof(int) };
+        };
+
+        template <typename T, typename U> struct MinStreamSize<std::pair<T, U> >
+        {
+            enum { value = MinStreamSize<T>::value + MinStreamSize<U>::value };
+        };
+
+        template <typename T, typename C> struct MinStreamSize<std::set<T, C> >
+        {
+            enum { value = sizeof(size_t) };
+        };
+
+        template <typename T> struct MinStreamSize<std::vector<T> >
+        {
+            enum { value = sizeof(size_t) };
+        };
+
+        template <typename K, typename T, typename C> struct MinStreamSize<std::map<K, T, C> >
+        {
+            enum { value = sizeof(size_t) };
+        };
+
+        template <typename K, typename T, typename C> struct MinStreamSize<std::multimap<K, T, C> >
+        {
+            enum { value = sizeof(size_t) };
+        };
+
+        // reads a container's element count - false if the rest of the stream couldn't hold that many elements,
+        // so a corrupt count can't cause a huge allocation or a long loop of reads past the end
+        template <typename T>
+            bool readCount(FDataStreamBase* pStream, size_t& count)
+        {
+            count = 0;
+            pStream->Read(&count);
+            return count <= pStream->GetSizeLeft() / MinStreamSize<T>::value;
+        }
+
+        // reads return false if the stream is found to be corrupt
+        template <typename T>
+            bool readValue(FDataStreamBase* pStream, T& value)
+        {
+            int i = 0;
+            pStream->Read(&i);
+            value = (T)i;
+            return true;
+        }
+
+        template <typename T, typename U>
+            void writeValue(FDataStreamBase* pStream, const std::pair<T, U>& value)
+        {
+            writeValue(pStream, value.first);
+            writeValue(pStream, value.second);
+        }
+
+        template <typename T, typename U>
+            bool readValue(FDataStreamBase* pStream, std::pair<T, U>& value)
+        {
+            return readValue(pStream, value.first) && readValue(pStream, value.second);
+        }
+
+        template <typename T, typename C>
+            void writeValue(FDataStreamBase* pStream, const std::set<T, C>& s)
+        {
+            pStream->Write(s.size());
+            for (typename std::set<T, C>::const_iterator ci(s.begin()), ciEnd(s.end()); ci != ciEnd; ++ci)
+            {
+                writeValue(pStream, *ci);
+            }
+        }
+
+        template <typename T, typename C>
+            bool readValue(FDataStreamBase* pStream, std::set<T, C>& s)
+        {
+            size_t size = 0;
+            s.clear();
+            if (!readCount<T>(pStream, size))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < size; ++i)
+            {
+                T value;
+                if (!readValue(pStream, value))
+                {
+                    return false;
+                }
+                s.insert(s.end(), value);
+            }
+            return true;
+        }
+
+        template <typename T>
+            void writeValue(FDataStreamBase* pStream, const std::vector<T>& v)
+        {
+            pStream->Write(v.size());
+            for (size_t i = 0, count = v.size(); i < count; ++i)
+            {
+                writeValue(pStream, v[i]);
+            }
+        }
+
+        template <typename T>
+            bool readValue(FDataStreamBase* pStream, std::vector<T>& v)
+        {
+            size_t size = 0;
+            v.clear();
+            if (!readCount<T>(pStream, size))
+            {
+                return false;
+            }
+            v.resize(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (!readValue(pStream, v[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename K, typename T, typename C>
+            void writeValue(FDataStreamBase* pStream, const std::map<K, T, C>& m)
+        {
+            pStream->Write(m.size());
+            for (typename std::map<K, T, C>::const_iterator ci(m.begin()), ciEnd(m.end()); ci != ciEnd; ++ci)
+            {
+                writeValue(pStream, ci->first);
+                writeValue(pStream, ci->second);
+            }
+        }
+
+        template <typename K, typename T, typename C>
+            bool readValue(FDataStreamBase* pStream, std::map<K, T, C>& m)
+        {
+            size_t size = 0;
+            m.clear();
+            if (!readCount<std::pair<K, T> >(pStream, size))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < size; ++i)
+            {
+                K key;
+                if (!readValue(pStream, key) || !readValue(pStream, m[key]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename K, typename T, typename C>
+            void writeValue(FDataStreamBase* pStream, const std::multimap<K, T, C>& m)
+        {
+            pStream->Write(m.size());
+            for (typename std::multimap<K, T, C>::const_iterator ci(m.begin()), ciEnd(m.end()); ci != ciEnd; ++ci)
+            {
+                writeValue(pStream, ci->first);
+                writeValue(pStream, ci->second);
+            }
+        }
+
+        template <typename K, typename T, typename C>
+            bool readValue(FDataStreamBase* pStream, std::multimap<K, T, C>& m)
+        {
+            size_t size = 0;
+            m.clear();
+            if (!readCount<std::pair<K, T> >(pStream, size))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < size; ++i)
+            {
+                std::pair<K, T> value;
+                if (!readValue(pStream, value))
+                {
+                    return false;
+                }
+                m.insert(m.end(), value);  // keep the order of equal keys
+            }
+            return true;
+        }
+
+        const int UnitAnalysisCacheMagic = 0x41415541;  // 'AAUA'
+
+        // hash of everything analyse_() reads from the xml data: promotions, units, the player's civ and traits, the handicap and the combat defines
+        MemoryDataStream::Hash getUnitAnalysisCacheKey(const Player& player, int version)
+        {
+            MemoryDataStream stream;
+            stream.Write(version);
+
+            for (int i = 0, count = gGlobals.getNumPromotionInfos(); i < count; ++i)
+            {
+                gGlobals.getPromotionInfo((PromotionTypes)i).write(&stream);
+            }
+
+            for (int i = 0, count = gGlobals.getNumUnitInfos(); i < count; ++i)
+            {
+                gGlobals.getUnitInfo((UnitTypes)i).write(&stream);
+            }
+
+            for (int i = 0, count = gGlobals.getNumUnitClassInfos(); i < count; ++i)
+            {
+                stream.Write(gGlobals.getUnitClassInfo((UnitClassTypes)i).getDefaultUnitIndex());
+            }
+            stream.Write(gGlobals.getNumUnitCombatInfos());
+
+            const CvPlayer* pPlayer = player.getCvPlayer();
+            if (pPlayer->getCivilizationType() != NO_CIVILIZATION)
+            {
+                gGlobals.getCivilizationInfo(pPlayer->getCivilizationType()).write(&stream);
+            }
+
+            // trait info classes have no write() - just the free promotion data the unit infos' promotions node uses
+            for (int i = 0, count = gGlobals.getNumTraitInfos(); i < count; ++i)
+            {
+                if (pPlayer->hasTrait((TraitTypes)i))
+                {
+                    const CvTraitInfo& traitInfo = gGlobals.getTraitInfo((TraitTypes)i);
+                    stream.Write(i);
+                    for (int j = 0, promotionCount = gGlobals.getNumPromotionInfos(); j < promotionCount; ++j)
+                    {
+                        stream.Write(traitInfo.isFreePromotion(j));
+                    }
+                    for (int j = 0, unitCombatCount = gGlobals.getNumUnitCombatInfos(); j < unitCombatCount; ++j)
+                    {
+                        stream.Write(traitInfo.isFreePromotionUnitCombat(j));
+                    }
+                }
+            }
+
+            gGlobals.getHandicapInfo(gGlobals.getGame().getHandicapType()).write(&stream);
+
+            stream.Write(gGlobals.getMAX_HIT_POINTS());
+            stream.Write(gGlobals.getFORTIFY_MODIFIER_PER_TURN());
+            stream.Write(gGlobals.getDefineINT("MAX_FORTIFY_TURNS"));
+            stream.Write(gGlobals.getDefineINT("COMBAT_DIE_SIDES"));
+            stream.Write(gGlobals.getDefineINT("COMBAT_DAMAGE"));
+            stream.Write(gGlobals.getDefineINT("COLLATERAL_COMBAT_DAMAGE"));
+
+            return stream.getHash();
+        }
+    }
+
     UnitAnalysis::UnitAnalysis(const Player& player) : player_(player)
     {
     }
 
     void UnitAnalysis::init()
+    {
+        if (gGlobals.getDefineINT("ALTAI_UNIT_ANALYSIS_CACHE") > 0)
+        {
+            const std::string fileName = getCacheFileName_();
+            if (!readCache_(fileName))
+            {
+                analyse_();
+                writeCache_(fileName);
+            }
+        }
+        else
+        {
+            analyse_();
+        }
+    }
+
+    void UnitAnalysis::analyse_()
     {
         calculatePromotionDepths_();
         analysePromotions_();
@@ -1076,6 +1777,235 @@ namespace AltAI
         
     }
     
+    std::string UnitAnalysis::getCacheFileName_() const
+    {
+        std::ostringstream oss;
+        oss << getLogDirectory() << "AltAI_UnitAnalysis_" << std::hex << getUnitAnalysisCacheKey(player_, cacheVersion_) << ".dat";
+        return oss.str();
+    }
+
+    bool UnitAnalysis::readCache_(const std::string& fileName)
+    {
+        MemoryDataStream stream;
+        if (!stream.loadFromFile(fileName))
+        {
+            return false;
+        }
+
+        // header: magic, version, then the payload's hash (low and high words)
+        int magic = 0, version = 0;
+        unsigned int hashLow = 0, hashHigh = 0;
+        stream.Read(&magic);
+        stream.Read(&version);
+        stream.Read(&hashLow);
+        stream.Read(&hashHigh);
+        if (!stream.isValid() || magic != UnitAnalysisCacheMagic || version != cacheVersion_)
+        {
+            return false;
+        }
+
+        const MemoryDataStream::Hash payloadHash = stream.getHash(stream.GetPosition());
+        if ((unsigned int)payloadHash != hashLow || (unsigned int)(payloadHash >> 32) != hashHigh)
+        {
+#ifdef ALTAI_DEBUG
+            std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
+            os << "\nDiscarding unit analysis cache file with bad checksum: " << fileName;
+#endif
+            return false;
+        }
+
+        // truncated or otherwise corrupt - discard anything partially read and redo the analysis
+        if (!readAnalysis_(&stream) || !stream.isValid() || !stream.AtEnd() || (int)promotionDepths_.size() != gGlobals.getNumPromotionInfos())
+        {
+            clearAnalysis_();
+            return false;
+        }
+
+#ifdef ALTAI_DEBUG
+        std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
+        os << "\nRead unit analysis from cache file: " << fileName;
+#endif
+        return true;
+    }
+
+    void UnitAnalysis::writeCache_(const std::string& fileName) const
+    {
+        MemoryDataStream payload;
+        writeAnalysis_(&payload);
+        const MemoryDataStream::Hash payloadHash = payload.getHash();
+
+        std::vector<byte> payloadBytes(payload.GetEOF());
+        payload.CopyToMem(payloadBytes.empty() ? NULL : &payloadBytes[0]);
+
+        MemoryDataStream stream;
+        stream.Write(UnitAnalysisCacheMagic);
+        stream.Write(cacheVersion_);
+        stream.Write((unsigned int)payloadHash);
+        stream.Write((unsigned int)(payloadHash >> 32));
+        if (!payloadBytes.empty())
+        {
+            stream.Write((int)payloadBytes.size(), &payloadBytes[0]);
+        }
+
+        if (!stream.saveToFile(fileName))
+        {
+#ifdef ALTAI_DEBUG
+            std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
+            os << "\nFailed to write unit analysis cache file: " << fileName;
+#endif
+        }
+    }
+
+    void UnitAnalysis::clearAnalysis_()
+    {
+        promotionDepths_.clear();
+
+        cityAttackPromotions_.clear();
+        cityDefencePromotions_.clear();
+        combatPromotions_.clear();
+        firstStrikePromotions_.clear();
+        movementPromotions_.clear();
+        collateralPromotions_.clear();
+        unitCounterPromotionsMap_.clear();
+
+        cityAttackUnits_.clear();
+        cityDefenceUnits_.clear();
+        combatUnits_.clear();
+        firstStrikeUnits_.clear();
+        fastUnits_.clear();
+        collateralUnits_.clear();
+        unitCounterUnits_.clear();
+
+        attackUnitValues_.clear();
+        defenceUnitValues_.clear();
+        attackUnitCounterValues_.clear();
+        defenceUnitCounterValues_.clear();
+        cityAttackUnitValues_.clear();
+        cityDefenceUnitValues_.clear();
+
+        combatDataMap_.clear();
+    }
+
+    void UnitAnalysis::writeAnalysis_(FDataStreamBase* pStream) const
+    {
+        writeValue(pStream, promotionDepths_);
+
+        writeValue(pStream, cityAttackPromotions_);
+        writeValue(pStream, cityDefencePromotions_);
+        writeValue(pStream, combatPromotions_);
+        writeValue(pStream, firstStrikePromotions_);
+        writeValue(pStream, movementPromotions_);
+        writeValue(pStream, collateralPromotions_);
+        writeValue(pStream, unitCounterPromotionsMap_);
+
+        writeValue(pStream, cityAttackUnits_);
+        writeValue(pStream, cityDefenceUnits_);
+        writeValue(pStream, combatUnits_);
+        writeValue(pStream, firstStrikeUnits_);
+        writeValue(pStream, fastUnits_);
+        writeValue(pStream, collateralUnits_);
+        writeValue(pStream, unitCounterUnits_);
+
+        writeValue(pStream, attackUnitValues_);
+        writeValue(pStream, defenceUnitValues_);
+        writeValue(pStream, attackUnitCounterValues_);
+        writeValue(pStream, defenceUnitCounterValues_);
+        writeValue(pStream, cityAttackUnitValues_);
+        writeValue(pStream, cityDefenceUnitValues_);
+
+        pStream->Write(combatDataMap_.size());
+        for (CombatDataMap::const_iterator ci(combatDataMap_.begin()), ciEnd(combatDataMap_.end()); ci != ciEnd; ++ci)
+        {
+            pStream->Write(ci->first);
+            pStream->Write(ci->second.size());
+            for (UnitCombatDataMap::const_iterator unitIter(ci->second.begin()), unitEndIter(ci->second.end()); unitIter != unitEndIter; ++unitIter)
+            {
+                pStream->Write(unitIter->first);
+                unitIter->second.write(pStream);
+            }
+        }
+    }
+
+    bool UnitAnalysis::readAnalysis_(FDataStreamBase* pStream)
+    {
+        if (!(readValue(pStream, promotionDepths_) &&
+
+            readValue(pStream, cityAttackPromotions_) &&
+            readValue(pStream, cityDefencePromotions_) &&
+            readValue(pStream, combatPromotions_) &&
+            readValue(pStream, firstStrikePromotions_) &&
+            readValue(pStream, movementPromotions_) &&
+            readValue(pStream, collateralPromotions_) &&
+            readValue(pStream, unitCounterPromotionsMap_) &&
+
+            readValue(pStream, cityAttackUnits_) &&
+            readValue(pStream, cityDefenceUnits_) &&
+            readValue(pStream, combatUnits_) &&
+            readValue(pStream, firstStrikeUnits_) &&
+            readValue(pStream, fastUnits_) &&
+            readValue(pStream, collateralUnits_) &&
+            readValue(pStream, unitCounterUnits_) &&
+
+            readValue(pStream, attackUnitValues_) &&
+            readValue(pStream, defenceUnitValues_) &&
+            readValue(pStream, attackUnitCounterValues_) &&
+            readValue(pStream, defenceUnitCounterValues_) &&
+            readValue(pStream, cityAttackUnitValues_) &&
+            readValue(pStream, cityDefenceUnitValues_)))
+        {
+            return false;
+        }
+
+        // each unit's entry is its type and count, each other unit's entry is its type and the four odds
+        const size_t unitEntrySize = sizeof(int) + sizeof(size_t), otherUnitEntrySize = 5 * sizeof(int);
+
+        combatDataMap_.clear();
+        size_t unitCount = 0;
+        pStream->Read(&unitCount);
+        if (unitCount > pStream->GetSizeLeft() / unitEntrySize)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < unitCount; ++i)
+        {
+            int unitType = NO_UNIT;
+            pStream->Read(&unitType);
+            UnitCombatDataMap& unitCombatDataMap = combatDataMap_[(UnitTypes)unitType];
+
+            size_t otherUnitCount = 0;
+            pStream->Read(&otherUnitCount);
+            if (otherUnitCount > pStream->GetSizeLeft() / otherUnitEntrySize)
+            {
+                return false;
+            }
+
+            for (size_t j = 0; j < otherUnitCount; ++j)
+            {
+                int otherUnitType = NO_UNIT;
+                pStream->Read(&otherUnitType);
+                unitCombatDataMap[(UnitTypes)otherUnitType].read(pStream);
+            }
+        }
+        return true;
+    }
+
+    void UnitAnalysis::CombatDataOdds::write(FDataStreamBase* pStream) const
+    {
+        pStream->Write(attackOdds);
+        pStream->Write(defenceOdds);
+        pStream->Write(cityAttackOdds);
+        pStream->Write(cityDefenceOdds);
+    }
+
+    void UnitAnalysis::CombatDataOdds::read(FDataStreamBase* pStream)
+    {
+        pStream->Read(&attackOdds);
+        pStream->Read(&defenceOdds);
+        pStream->Read(&cityAttackOdds);
+        pStream->Read(&cityDefenceOdds);
+    }
+
     void UnitAnalysis::promote(UnitData& unit, const UnitData::CombatDetails& combatDetails, bool isAttacker, int level, const Promotions& freePromotions) const
     {
         RemainingLevelsAndPromotions ourPromotions;
@@ -1122,8 +2052,8 @@ namespace AltAI
         {
             //Promotions combatPromotions = getCombatPromotions(unit1.getUnitClassType, unit1Level);
 
-            attackOdds = getCombatOdds(unit1, unit2);
-            defenceOdds = 1000 - getCombatOdds(unit2, unit1);
+            attackOdds = getCombatOdds_(unit1, unit2);
+            defenceOdds = 1000 - getCombatOdds_(unit2, unit1);
         }
 
         return std::make_pair(attackOdds, defenceOdds);
@@ -1172,7 +2102,7 @@ namespace AltAI
 
                     if (isAttacker)
                     {
-                        ourOdds = getCombatOdds(unit, them, combatDetails);
+                        ourOdds = getCombatOdds_(unit, them, combatDetails);
 #ifdef ALTAI_DEBUG
                         //os << "\n\t\tv. unit: " << otherUnitInfo.getType() << " our attack str = " << us.calculateStrength() 
                         //    << " their defence str = " << them.calculateStrength(us)
@@ -1181,7 +2111,7 @@ namespace AltAI
                     }
                     else
                     {
-                        ourOdds = 1000 - getCombatOdds(them, unit, combatDetails);
+                        ourOdds = 1000 - getCombatOdds_(them, unit, combatDetails);
 #ifdef ALTAI_DEBUG
                         //os << "\n\t\tv. unit: " << otherUnitInfo.getType() << " their attack str = " << them.calculateStrength() 
                         //    << " our defence str = " << us.calculateStrength(them)
@@ -1215,11 +2145,11 @@ namespace AltAI
                 int ourOdds;
                 if (isAttacker)
                 {
-                    ourOdds = getCombatOdds(unit, units[i], combatDetails);
+                    ourOdds = getCombatOdds_(unit, units[i], combatDetails);
                 }
                 else
                 {
-                    ourOdds = 1000 - getCombatOdds(units[i], unit, combatDetails);
+                    ourOdds = 1000 - getCombatOdds_(units[i], unit, combatDetails);
                 }
                 odds.push_back(ourOdds);
             }
@@ -1236,19 +2166,155 @@ namespace AltAI
         return odds;
     }
 
+    std::vector<std::vector<UnitOddsData> > UnitAnalysis::getAttackOddsMatrix(const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders,
+        const UnitData::CombatDetails& combatDetails) const
+    {
+        const CombatOddsMatrixInputs inputs(attackers, defenders, combatDetails);
+        const size_t attackerCount = inputs.attackerCount, defenderCount = inputs.defenderCount;
+
+        // pairings which can't fight keep zero odds, and cached pairings are filled in directly
+        // identical pairings (common with stacks of the same unit type) are only calculated once
+        std::vector<UnitOddsData> odds(attackerCount * defenderCount);
+        std::vector<char> toCalculate(attackerCount * defenderCount, 0);
+        std::map<CombatOddsKey, size_t> missedKeys;
+        std::vector<std::pair<size_t, size_t> > duplicateMisses;
+
+        {
+            CriticalSectionLock lock(combatOddsCacheLock_);
+            for (size_t index = 0, count = attackerCount * defenderCount; index < count; ++index)
+            {
+                if (inputs.canFight[index])
+                {
+                    const CombatOddsKey key(inputs.getKey(index / defenderCount, index % defenderCount));
+                    std::map<CombatOddsKey, UnitOddsData>::const_iterator oddsIter = combatOddsDetailCache_.find(key);
+                    if (oddsIter != combatOddsDetailCache_.end())
+                    {
+                        odds[index] = oddsIter->second;
+                    }
+                    else
+                    {
+                        std::map<CombatOddsKey, size_t>::const_iterator missIter = missedKeys.find(key);
+                        if (missIter != missedKeys.end())
+                        {
+                            duplicateMisses.push_back(std::make_pair(index, missIter->second));
+                        }
+                        else
+                        {
+                            missedKeys.insert(std::make_pair(key, index));
+                            toCalculate[index] = 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!missedKeys.empty())
+        {
+            calculateCombatOddsDetailMatrix(inputs, toCalculate, odds);
+
+#ifdef ALTAI_DEBUG
+            // the matrix calculation should only differ from the scalar one by float rounding
+            for (std::map<CombatOddsKey, size_t>::const_iterator ci(missedKeys.begin()), ciEnd(missedKeys.end()); ci != ciEnd; ++ci)
+            {
+                const UnitOddsData scalarOdds = calculateCombatOddsDetail(CombatOddsInputs(ci->first));
+                if (!oddsDetailMatches(odds[ci->second], scalarOdds, 1.0e-4f))
+                {
+                    std::ostream& os = ErrorLog::getLog(*player_.getCvPlayer())->getStream();
+                    os << "\nCombat odds matrix mismatch for attacker: " << ci->second / defenderCount << ", defender: " << ci->second % defenderCount
+                       << "\n\tmatrix odds: ";
+                    odds[ci->second].debug(os);
+                    os << "\n\tscalar odds: ";
+                    scalarOdds.debug(os);
+                    FAssertMsg(false, "Combat odds matrix differs from scalar calculation");
+                }
+            }
+#endif
+
+            for (size_t i = 0, count = duplicateMisses.size(); i < count; ++i)
+            {
+                odds[duplicateMisses[i].first] = odds[duplicateMisses[i].second];
+            }
+
+            CriticalSectionLock lock(combatOddsCacheLock_);
+            if (combatOddsDetailCache_.size() + missedKeys.size() > maxCombatOddsCacheSize_)
+            {
+                combatOddsDetailCache_.clear();
+            }
+            for (std::map<CombatOddsKey, size_t>::const_iterator ci(missedKeys.begin()), ciEnd(missedKeys.end()); ci != ciEnd; ++ci)
+            {
+                combatOddsDetailCache_[ci->first] = odds[ci->second];
+            }
+        }
+
+        std::vector<std::vector<UnitOddsData> > oddsMatrix(attackerCount);
+        for (size_t i = 0; i < attackerCount; ++i)
+        {
+            oddsMatrix[i].assign(odds.begin() + i * defenderCount, odds.begin() + (i + 1) * defenderCount);
+        }
+        return oddsMatrix;
+    }
+
     UnitOddsData UnitAnalysis::getCombatOddsDetail(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails) const
     {
         return getCombatOddsDetail_(attacker, defender, combatDetails);
     }
 
+    int UnitAnalysis::getCombatOdds_(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails) const
+    {
+        const CombatOddsInputs inputs(attacker, defender, combatDetails);
+        const CombatOddsKey key(inputs.getKey());
+
+        {
+            CriticalSectionLock lock(combatOddsCacheLock_);
+            std::map<CombatOddsKey, int>::const_iterator oddsIter = combatOddsCache_.find(key);
+            if (oddsIter != combatOddsCache_.end())
+            {
+                return oddsIter->second;
+            }
+        }
+
+        const int odds = calculateCombatOdds(inputs);
+
+        CriticalSectionLock lock(combatOddsCacheLock_);
+        if (combatOddsCache_.size() >= maxCombatOddsCacheSize_)
+        {
+            combatOddsCache_.clear();
+        }
+        return combatOddsCache_[key] = odds;
+    }
+
+    UnitOddsData UnitAnalysis::getCombatOddsDetail_(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails) const
+    {
+        const CombatOddsInputs inputs(attacker, defender, combatDetails);
+        const CombatOddsKey key(inputs.getKey());
+
+        {
+            CriticalSectionLock lock(combatOddsCacheLock_);
+            std::map<CombatOddsKey, UnitOddsData>::const_iterator oddsIter = combatOddsDetailCache_.find(key);
+            if (oddsIter != combatOddsDetailCache_.end())
+            {
+                return oddsIter->second;
+            }
+        }
+
+        const UnitOddsData odds = calculateCombatOddsDetail(inputs);
+
+        CriticalSectionLock lock(combatOddsCacheLock_);
+        if (combatOddsDetailCache_.size() >= maxCombatOddsCacheSize_)
+        {
+            combatOddsDetailCache_.clear();
+        }
+        return combatOddsDetailCache_[key] = odds;
+    }
+
     std::vector<int> UnitAnalysis::getCollateralDamage(const UnitData& attacker, const std::vector<UnitData>& defenders, size_t skipIndex, const UnitData::CombatDetails& combatDetails) const
     {
         // actual collateral combat assigns random numbers in range 0 - 10000 to each visible unit in defender stack (except unit being directly attacked)
         // takes up to possible target count units (e.g. 6 for catapults) with highest score
         // if unit is not immune to collateral damage from attacker's unit combat type (usually UNITCOMBAT_SIEGE)
         // collateral damage is calculated and applied to that unit base on relative strengths and any promotions which reduce collateral damage
-        static const int COLLATERAL_COMBAT_DAMAGE = gGlobals.getDefineINT("COLLATERAL_COMBAT_DAMAGE");
-        static const int MAX_HIT_POINTS = gGlobals.getMAX_HIT_POINTS();
+        const int COLLATERAL_COMBAT_DAMAGE = GameDataAnalysis::getCollateralCombatDamage();
+        const int MAX_HIT_POINTS = gGlobals.getMAX_HIT_POINTS();
 
         std::vector<int> damage(defenders.size(), 0);        
         
@@ -2076,8 +3142,8 @@ namespace AltAI
                             defender.applyPromotion(*ci);
                         }
                         
-                        int attackOdds = getCombatOdds(attacker, defender, combatDetails);
-                        int defenceOdds = getCombatOdds(defender, attacker, combatDetails);
+                        int attackOdds = getCombatOdds_(attacker, defender, combatDetails);
+                        int defenceOdds = getCombatOdds_(defender, attacker, combatDetails);
 #ifdef ALTAI_DEBUG
                         //os << "\n\t\tv. unit: " << gGlobals.getUnitInfo(defaultUnit).getType() << " attack str = " << attacker.calculateStrength(UnitData::CityAttack | UnitData::FortifyDefender) 
                         //   << " defence str = " << defender.calculateStrength(attacker, combatDetails)
@@ -2176,7 +3242,7 @@ namespace AltAI
                             attacker.applyPromotion(*ci);
                         }
 
-                        int attackOdds = getCombatOdds(attacker, defender, combatDetails);
+                        int attackOdds = getCombatOdds_(attacker, defender, combatDetails);
 //#ifdef ALTAI_DEBUG
 //                        os << "\n\t\tv. unit: " << gGlobals.getUnitInfo(defaultUnit).getType() << " attack str = " << attacker.calculateStrength(UnitData::CityAttack | UnitData::FortifyDefender) 
 //                           << " defence str = " << defender.calculateStrength(attacker, combatDetails)
@@ -2185,7 +3251,7 @@ namespace AltAI
 //                           << " att fs = " << attacker.firstStrikes << " att fs chances = " << attacker.chanceFirstStrikes
 //                           << " def fs = " << defender.firstStrikes << " def fs chances = " << defender.chanceFirstStrikes;
 //#endif
-                        int defenceOdds = getCombatOdds(defender, attacker, combatDetails);
+                        int defenceOdds = getCombatOdds_(defender, attacker, combatDetails);
 //#ifdef ALTAI_DEBUG
 //                        os << "\n\t\t\t" << " attack str = " << defender.calculateStrength(0) 
 //                           << " defence str = " << attacker.calculateStrength(defender, 0)
@@ -2264,8 +3330,8 @@ namespace AltAI
                             defender.applyPromotion(*ci);
                         }
 
-                        int attackOdds = getCombatOdds(attacker, defender);
-                        int defenceOdds = getCombatOdds(defender, attacker);
+                        int attackOdds = getCombatOdds_(attacker, defender);
+                        int defenceOdds = getCombatOdds_(defender, attacker);
 
 //#ifdef ALTAI_DEBUG
 //                        os << "\n\t\tv. unit: " << gGlobals.getUnitInfo(defaultUnit).getType() << " attack str = " << attacker.calculateStrength(combatDetails) 
@@ -2354,8 +3420,8 @@ namespace AltAI
                             defender.applyPromotion(*ci);
                         }
 
-                        int attackOdds = getCombatOdds(attacker, defender);
-                        int defenceOdds = getCombatOdds(defender, attacker);
+                        int attackOdds = getCombatOdds_(attacker, defender);
+                        int defenceOdds = getCombatOdds_(defender, attacker);
 //#ifdef ALTAI_DEBUG
 //                        /*os << "\n\t\tv. unit: " << gGlobals.getUnitInfo(defaultUnit).getType() << " attack str = " << attacker.calculateStrength(0) 
 //                            << " defence str = " << defender.calculateStrength(attacker, 0)
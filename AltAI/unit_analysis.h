@@ -1,6 +1,7 @@
 #pragma once
 
 #include "./utils.h"
+#include "./worker_pool.h"
 
 namespace AltAI
 {
@@ -18,6 +19,12 @@ namespace AltAI
 
         void debug(std::ostream& os) const;
 
+        // attack odds in the 0 - 1000 form of UnitAnalysis::getOdds() - the chance the attacker wins or takes the defender to its combat limit
+        int getAttackOdds() const
+        {
+            return (int)(1000.0f * (AttackerKillOdds + PullOutOdds) + 0.5f);
+        }
+
         float E_HP_Att;
         float E_HP_Def;
         float E_HP_Att_Withdraw;
@@ -63,6 +70,24 @@ namespace AltAI
             DirectionTypes attackDirection;
         };
 
+        // modifier tables which depend only on the unit's type and promotions - immutable once made, and shared by every UnitData
+        // with the same type and promotions, so copying units into combat graphs and maps copies a pointer rather than the tables
+        struct ModifierProfile
+        {
+            ModifierProfile();
+
+            // indexed by FeatureTypes, TerrainTypes and UnitCombatTypes
+            std::vector<int> featureAttackModifiers, featureDefenceModifiers;
+            std::vector<int> terrainAttackModifiers, terrainDefenceModifiers;
+            std::vector<int> unitCombatModifiers;
+            std::vector<char> featureDoubleMoves, terrainDoubleMoves;
+            std::vector<PromotionTypes> promotions;  // sorted
+        };
+        typedef boost::shared_ptr<const ModifierProfile> ModifierProfilePtr;
+
+        // the shared profile for this unit type (NO_UNIT for all zero tables) and promotions (in any order)
+        static ModifierProfilePtr getModifierProfile(UnitTypes unitType, const std::vector<PromotionTypes>& promotions);
+
         UnitData();
         explicit UnitData(const CvUnit* pUnit);
         explicit UnitData(UnitTypes unitType_, const Promotions& promotions_ = Promotions());
@@ -72,6 +97,11 @@ namespace AltAI
 
         void debugPromotions(std::ostream& os) const;
 
+        const std::vector<PromotionTypes>& getPromotions() const
+        {
+            return pModifierProfile->promotions;
+        }
+
         // calculate our strength as defender
         int calculateStrength(const UnitData& other, const CombatDetails& combatDetails = CombatDetails()) const;
 
@@ -93,15 +123,14 @@ namespace AltAI
         bool immuneToFirstStrikes, isBlitz, isRiver, isAmphib;
         bool isBarbarian, isAnimal;
         int extraCollateralDamage, collateralDamageProtection;
-        std::map<FeatureTypes, int> unitFeatureAttackModifiers, unitFeatureDefenceModifiers;
-        std::map<TerrainTypes, int> unitTerrainAttackModifiers, unitTerrainDefenceModifiers;
-        std::map<UnitCombatTypes, int> unitCombatModifiers;
-        std::vector<char> featureDoubleMoves, terrainDoubleMoves;
         bool hasAttacked;
 
-        std::vector<PromotionTypes> promotions;
-
         int animalModifier, barbModifier;  // level handicap modifiers
+
+        ModifierProfilePtr pModifierProfile;
+
+    private:
+        bool applyPromotion_(PromotionTypes promotionType, const std::vector<PromotionTypes>& promotions);
     };
 
     std::vector<UnitData> makeUnitData(const std::set<IDInfo>& units);
@@ -218,19 +247,47 @@ namespace AltAI
 
         std::vector<int> getOdds(const UnitData& unit, const std::vector<UnitData>& units, const UnitData::CombatDetails& combatDetails, bool isAttacker) const;
 
+        // detailed odds of each attacker (rows) v. each defender - each entry is as getCombatOddsDetail(attackers[i], defenders[j], combatDetails)
+        // pairings which can't fight (as getOdds(attackers[i], defenders, combatDetails, true)) are left with zero odds
+        std::vector<std::vector<UnitOddsData> > getAttackOddsMatrix(const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders,
+            const UnitData::CombatDetails& combatDetails) const;
+
         UnitOddsData getCombatOddsDetail(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails = UnitData::CombatDetails()) const;
 
         std::vector<int> getCollateralDamage(const UnitData& attacker, const std::vector<UnitData>& defenders, size_t skipIndex, const UnitData::CombatDetails& combatDetails) const;
         // todo - flanking damage calc
 
+        // inputs to the odds calculation: hp, max hp, max strength (for these combat details), first strikes, chance first strikes, combat limit,
+        // withdrawal prob and first strike immunity for the attacker and the corresponding values for the defender (which has no combat limit or withdrawal)
+        typedef boost::array<int, 14> CombatOddsKey;
+
     private:
 
         static const int maxPromotionSearchDepth_ = 5;
 
+        // odds are deterministic given their key, so entries never go stale - just limit memory use
+        static const size_t maxCombatOddsCacheSize_ = 20000;
+
+        int getCombatOdds_(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails = UnitData::CombatDetails()) const;
+        UnitOddsData getCombatOddsDetail_(const UnitData& attacker, const UnitData& defender, const UnitData::CombatDetails& combatDetails = UnitData::CombatDetails()) const;
+
+        void analyse_();
         void analysePromotions_();
         void calculatePromotionDepths_();
         void analyseUnits_();
 
+        // optional on-disk cache of the results of analyse_(), enabled by the ALTAI_UNIT_ANALYSIS_CACHE global define
+        // files are keyed by a hash of the xml data the analysis depends on (including the player's civ and traits)
+        // and carry a checksum of their contents, so a damaged file is discarded
+        static const int cacheVersion_ = 2;
+        std::string getCacheFileName_() const;
+        bool readCache_(const std::string& fileName);
+        void writeCache_(const std::string& fileName) const;
+        void clearAnalysis_();
+        void writeAnalysis_(FDataStreamBase* pStream) const;
+        // false if the stream is found to be corrupt
+        bool readAnalysis_(FDataStreamBase* pStream);
+
         template <typename ValueF>
             std::pair<int, RemainingLevelsAndPromotions>
                 calculateBestPromotions_(const PromotionsMap& promotionsMap, int baseValue, const boost::shared_ptr<UnitInfo>& pUnitInfo,
@@ -247,6 +304,9 @@ namespace AltAI
             {
             }
 
+            void write(FDataStreamBase* pStream) const;
+            void read(FDataStreamBase* pStream);
+
             int attackOdds, defenceOdds, cityAttackOdds, cityDefenceOdds;
         };
 
@@ -272,5 +332,10 @@ namespace AltAI
         UnitCombatInfoMap cityAttackUnitValues_, cityDefenceUnitValues_;
 
         std::vector<int> promotionDepths_;
+
+        // guards both caches, as combat graphs can be built on the worker pool - held for lookups and inserts, not calculations
+        mutable CriticalSection combatOddsCacheLock_;
+        mutable std::map<CombatOddsKey, int> combatOddsCache_;
+        mutable std::map<CombatOddsKey, UnitOddsData> combatOddsDetailCache_;
     };
 }
\ No newline at end of file
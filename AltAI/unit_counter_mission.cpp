@@ -371,7 +371,7 @@ namespace AltAI
             {
                 UnitPathData hostileUnitPaths;
                 hostileUnitPaths.calculate(makeUnitData(targetStackIter->second), targetStackIter->first,
-                    ::getCity(pMission->closestCity)->plot(), MOVE_MAX_MOVES | MOVE_IGNORE_DANGER | MOVE_THROUGH_ENEMY, (*targetStackIter->second.begin())->getOwner(), player.getTeamID());
+                    ::getCity(pMission->closestCity)->plot(), (*targetStackIter->second.begin())->getOwner(), player.getTeamID());
                 if (hostileUnitPaths.valid)
                 {
                     remainingTurnsToCounter = std::min<int>(remainingTurnsToCounter, hostileUnitPaths.pathTurns);
@@ -422,12 +422,12 @@ namespace AltAI
                 }
             }
 
-            const std::map<int /* sub area id */, std::set<XYCoords> >& borders = pMapAnalysis->getUnrevealedBorderMap();
-            std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(pUnit_->plot()->getSubArea());
+            const SubAreaPlotSet& borders = pMapAnalysis->getUnrevealedBorderMap();
+            SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(pUnit_->plot()->getSubArea());
 
             int closestBorderDistance = MAX_INT;
             // find (plot) distance closest border plot to current target coords
-            for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
+            for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
                 ci != ciEnd; ++ci)
             {
                 // distance from border plot to ourself
@@ -481,8 +481,8 @@ namespace AltAI
 
             // find closest unrevealed plot in same area as unit to closest reference point
             // todo - handle sea units in port
-            const std::map<int /* sub area id */, std::set<XYCoords> >& borders = pMapAnalysis->getUnrevealedBorderMap();
-            std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
+            const SubAreaPlotSet& borders = pMapAnalysis->getUnrevealedBorderMap();
+            SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
 
             std::vector<XYCoords> goodyHuts = pMapAnalysis->getGoodyHuts(pUnitPlot->getSubArea());
 
@@ -516,7 +516,7 @@ namespace AltAI
             }
             
             // find (plot) distance closest border plot to current target coords
-            for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
+            for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
                 ci != ciEnd; ++ci)
             {   
                 // distance from border plot to target
@@ -540,7 +540,7 @@ namespace AltAI
             }
 
             // now find closest border plot to our unit which is within maxPlotDeviation_ of the closest border plot to target
-            for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
+            for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
                 ci != ciEnd; ++ci)
             {
                 int thisPlotDistance = plotDistance(targetPlot_->getX(), targetPlot_->getY(), ci->iX, ci->iY);
@@ -561,7 +561,7 @@ namespace AltAI
             
             for (PlotSet::const_iterator ci(reachablePlotsData.allReachablePlots.begin()), ciEnd(reachablePlotsData.allReachablePlots.end()); ci != ciEnd; ++ci)
             {
-                bool reachablePlotIsBorderPlot = haveBorders && subAreaBorderIter->second.find((*ci)->getCoords()) != subAreaBorderIter->second.end();
+                bool reachablePlotIsBorderPlot = haveBorders && borders.contains(subAreaBorderIter->first, (*ci)->getCoords());
                 if (reachablePlotIsBorderPlot)
                 {
                     reachableBorderPlots.insert(*ci);
@@ -729,8 +729,8 @@ namespace AltAI
             int minimumRefDistance = MAX_INT, closestBorderDistance = MAX_INT;
             CvPlot* pBestPlot = NULL, *pUnitPlot = pUnit_->plot();
 
-            const std::map<int /* sub area id */, std::set<XYCoords> >& borders = pPlayer->getAnalysis()->getMapAnalysis()->getBorderMap();
-            std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
+            const SubAreaPlotSet& borders = pPlayer->getAnalysis()->getMapAnalysis()->getBorderMap();
+            SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
 
             const bool haveBorders = subAreaBorderIter != borders.end() && !subAreaBorderIter->second.empty();
 
@@ -778,7 +778,7 @@ namespace AltAI
                     }
 
                     int closestDistanceToBorder = MAX_INT;
-                    for (std::set<XYCoords>::const_iterator borderIter(subAreaBorderIter->second.begin()), borderEndIter(subAreaBorderIter->second.end());
+                    for (SubAreaPlotSet::Plots::const_iterator borderIter(subAreaBorderIter->second.begin()), borderEndIter(subAreaBorderIter->second.end());
                         borderIter != borderEndIter; ++borderIter)
                     {
                         int thisDistance = stepDistance(borderIter->iX, borderIter->iY, pPlot->getX(), pPlot->getY());
@@ -886,11 +886,11 @@ namespace AltAI
         const CvPlot* pClosestCityPlot = pMapAnalysis->getClosestCity(pUnitPlot, pUnitPlot->getSubArea(), true);
         ReachablePlotsData reachablePlotsData;
         getReachablePlotsData(reachablePlotsData, *pPlayer, std::vector<const CvUnit*>(1, pUnit), false, pUnit->canFight());
-        PlotSet dangerPlots = pPlayer->getAnalysis()->getMilitaryAnalysis()->getThreatenedPlots();
+        MilitaryAnalysisPtr pMilitaryAnalysis = pPlayer->getAnalysis()->getMilitaryAnalysis();
         // todo - use this to detect going in circles?
         std::set<XYCoords> ourHistory = getUnitHistory(*pPlayer, pUnit->getIDInfo());
 
-        const bool plotDanger = dangerPlots.find(pUnit->plot()) != dangerPlots.end();
+        const bool plotDanger = pMilitaryAnalysis->isPlotThreatened(pUnit->plot());
 
         // todo - upgrade if possible
         if (pUnit->getDamage() > 0)  // doesn't apply to work boats
@@ -907,7 +907,7 @@ namespace AltAI
                     {
                         XYCoords endTurnPlot = unitPathData.getFirstTurnEndCoords();
                         const CvPlot* pEndTurnPlot = gGlobals.getMap().plot(endTurnPlot.iX, endTurnPlot.iY);
-                        if (dangerPlots.find(pEndTurnPlot) == dangerPlots.end())
+                        if (!pMilitaryAnalysis->isPlotThreatened(pEndTurnPlot))
                         {
                             moveToPort = true;
                         }
@@ -932,7 +932,7 @@ namespace AltAI
         if (plotDanger && !pUnit->canFight())
         {
             PlotUnitsMap hostiles = getNearbyHostileStacks(*pPlayer, pUnit->plot(), 2);                
-            const CvPlot* pEscapePlot = getEscapePlot(*pPlayer, pUnit->getGroup(), reachablePlotsData.allReachablePlots, dangerPlots, hostiles);
+            const CvPlot* pEscapePlot = getEscapePlot(*pPlayer, pUnit->getGroup(), reachablePlotsData.allReachablePlots, pMilitaryAnalysis->getThreatenedPlots(), hostiles);
             if (pEscapePlot && !pUnit->atPlot(pEscapePlot))
             {
 #ifdef ALTAI_DEBUG
@@ -944,7 +944,7 @@ namespace AltAI
             }            
         }
 
-        const std::map<int /* sub area id */, std::set<XYCoords> >& borders = pMapAnalysis->getUnrevealedBorderMap();
+        const SubAreaPlotSet& borders = pMapAnalysis->getUnrevealedBorderMap();
         std::vector<int> accessibleSubAreas;
         if (pUnitPlot->isCoastalLand())
         {
@@ -967,7 +967,7 @@ namespace AltAI
         PlotSet reachableBorderPlots;
         for (size_t i = 0, count = accessibleSubAreas.size(); i < count; ++i)
         {
-            std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(accessibleSubAreas[i]);
+            SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(accessibleSubAreas[i]);
             const bool haveBorders = subAreaBorderIter != borders.end() && !subAreaBorderIter->second.empty();
             
             for (PlotSet::const_iterator ci(reachablePlotsData.allReachablePlots.begin()), ciEnd(reachablePlotsData.allReachablePlots.end()); haveBorders && ci != ciEnd; ++ci)
@@ -975,7 +975,7 @@ namespace AltAI
                 PlayerTypes plotOwner = (*ci)->getRevealedOwner(pUnit->getTeam(), false);
                 if (plotOwner == NO_PLAYER || plotOwner == pUnit->getOwner() || CvTeamAI::getTeam(PlayerIDToTeamID(plotOwner)).isOpenBorders(pUnit->getTeam()))
                 {
-                    if (subAreaBorderIter->second.find((*ci)->getCoords()) != subAreaBorderIter->second.end())
+                    if (borders.contains(subAreaBorderIter->first, (*ci)->getCoords()))
                     {
                         reachableBorderPlots.insert(*ci);
                     }
@@ -1032,7 +1032,7 @@ namespace AltAI
 
         for (size_t i = 0, count = accessibleSubAreas.size(); i < count; ++i)
         {
-            std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(accessibleSubAreas[i]);
+            SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(accessibleSubAreas[i]);
             const bool haveBorders = subAreaBorderIter != borders.end() && !subAreaBorderIter->second.empty();
             if (haveBorders)
             {
@@ -1040,7 +1040,7 @@ namespace AltAI
                 PlotSet excludedPlots;
                 for (;;)
                 {
-                    for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
+                    for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end());
                         ci != ciEnd; ++ci)
                     {
                         const CvPlot* pThisPlot = gGlobals.getMap().plot(ci->iX, ci->iY);
@@ -1122,7 +1122,7 @@ namespace AltAI
         CityIter cityIter(*pPlayer->getCvPlayer());
         const CvPlot* pUnitPlot = pUnit->plot();
 
-        const std::map<int /* sub area id */, std::set<XYCoords> >& borders = pPlayer->getAnalysis()->getMapAnalysis()->getUnrevealedBorderMap();
+        const SubAreaPlotSet& borders = pPlayer->getAnalysis()->getMapAnalysis()->getUnrevealedBorderMap();
 
         std::map<int /* sub area */, std::set<XYCoords> > subAreaRefPlotsMap = 
             pPlayer->getAnalysis()->getMilitaryAnalysis()->getLandScoutMissionRefPlots();
@@ -1130,7 +1130,7 @@ namespace AltAI
         int closestBorderDistance = MAX_INT;
 
         // todo - detect unreachable border plots (due to no open borders - only reason a plot in the same sub area would be inaccessible)
-        std::map<int, std::set<XYCoords> >::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
+        SubAreaPlotSet::const_iterator subAreaBorderIter = borders.find(pUnitPlot->getSubArea());
         if (subAreaBorderIter == borders.end())  // no unrevealed borders in this sub area...
         { // ...so look for another sub area
             XYCoords closestOtherAreaBorderCoords;
@@ -1150,7 +1150,7 @@ namespace AltAI
                         continue;
                     }
 
-                    for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end()); ci != ciEnd; ++ci)
+                    for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end()); ci != ciEnd; ++ci)
                     {
                         int thisPlotDistance = plotDistance(pUnitPlot->getX(), pUnitPlot->getY(), ci->iX, ci->iY);
                         if (thisPlotDistance < closestBorderDistance)
@@ -1197,7 +1197,7 @@ namespace AltAI
             if (!referencePlots.empty())
             {
                 size_t refPlotIndex = 0;
-                for (std::set<XYCoords>::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end()); ci != ciEnd; ++ci)
+                for (SubAreaPlotSet::Plots::const_iterator ci(subAreaBorderIter->second.begin()), ciEnd(subAreaBorderIter->second.end()); ci != ciEnd; ++ci)
                 {
                     for (size_t i = 0, count = referencePlots.size(); i < count; ++i)
                     {
@@ -33,7 +33,7 @@ namespace AltAI
 
     void updateRequestData(CityData& data, SpecialistTypes specialistType)
     {
-        data.getSpecialistHelper()->changeFreeSpecialistCount(specialistType, 1);
+        data.getSpecialistHelperForWrite()->changeFreeSpecialistCount(specialistType, 1);
         data.recalcOutputs();
     }
 
@@ -0,0 +1,513 @@
+#include "AltAI.h"
+
+#include "./unit_path_finder.h"
+#include "./movement_cost_field.h"
+#include "./game.h"
+#include "./player.h"
+#include "./player_analysis.h"
+#include "./map_analysis.h"
+
+#include "CvGameCoreUtils.h"
+
+namespace AltAI
+{
+    namespace
+    {
+        int getPathHeuristic(const CvPlot* pPlot, const std::vector<const CvPlot*>& pTargetPlots)
+        {
+            // each step costs at least PATH_STEP_WEIGHT, so the distance to the nearest target never overestimates
+            int minDistance = MAX_INT;
+            for (size_t i = 0, count = pTargetPlots.size(); i < count; ++i)
+            {
+                minDistance = std::min<int>(minDistance, stepDistance(pPlot->getX(), pPlot->getY(), pTargetPlots[i]->getX(), pTargetPlots[i]->getY()));
+            }
+            return minDistance * PATH_STEP_WEIGHT;
+        }
+    }
+
+    UnitPathFinder::UnitProfile::UnitProfile(const UnitData& unitData)
+        : movementData(unitData), unitType(unitData.unitType), maxMoves(unitData.pUnitInfo->getMoves() * gGlobals.getMOVE_DENOMINATOR()),
+          isLand(unitData.pUnitInfo->getDomainType() == DOMAIN_LAND), hasCombat(unitData.baseCombat > 0),
+          isOnlyDefensive(unitData.pUnitInfo->isOnlyDefensive()), isNoDefensiveBonus(unitData.pUnitInfo->isNoDefensiveBonus())
+    {
+    }
+
+    // other fields are derived from the unit type
+    bool UnitPathFinder::UnitProfile::operator < (const UnitProfile& other) const
+    {
+        if (unitType != other.unitType)
+        {
+            return unitType < other.unitType;
+        }
+
+        if (hasCombat != other.hasCombat)
+        {
+            return hasCombat < other.hasCombat;
+        }
+
+        return movementData < other.movementData;
+    }
+
+    bool UnitPathFinder::Key::operator < (const Key& other) const
+    {
+        if (playerType != other.playerType)
+        {
+            return playerType < other.playerType;
+        }
+
+        if (startIndex != other.startIndex)
+        {
+            return startIndex < other.startIndex;
+        }
+
+        if (targetIndex != other.targetIndex)
+        {
+            return targetIndex < other.targetIndex;
+        }
+
+        return profiles < other.profiles;
+    }
+
+    UnitPathFinder::UnitPathFinder()
+    {
+    }
+
+    void UnitPathFinder::clear()
+    {
+        paths_.clear();
+        lruList_.clear();
+        costFieldVersions_.clear();
+    }
+
+    void UnitPathFinder::invalidate(PlayerTypes playerType)
+    {
+        for (LruList::iterator lruIter(lruList_.begin()); lruIter != lruList_.end();)
+        {
+            if (lruIter->playerType == playerType)
+            {
+                paths_.erase(*lruIter);
+                lruList_.erase(lruIter++);
+            }
+            else
+            {
+                ++lruIter;
+            }
+        }
+    }
+
+    void UnitPathFinder::findPath(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot,
+        PlayerTypes playerType, TeamTypes isVisibleToTeam, UnitPathData& path)
+    {
+        std::vector<UnitPathData> paths;
+        findPaths(units, pStartPlot, std::vector<const CvPlot*>(1, pTargetPlot), playerType, isVisibleToTeam, paths);
+        path = paths[0];
+    }
+
+    void UnitPathFinder::findPaths(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const std::vector<const CvPlot*>& targetPlots,
+        PlayerTypes playerType, TeamTypes isVisibleToTeam, std::vector<UnitPathData>& paths)
+    {
+        paths.assign(targetPlots.size(), UnitPathData());
+        if (units.empty() || targetPlots.empty())
+        {
+            return;
+        }
+
+        const CvMap& theMap = gGlobals.getMap();
+        const MovementCostField& costField = gGlobals.getGame().getAltAI()->getPlayer(playerType)->getAnalysis()->getMapAnalysis()->getMovementCostField(
+            CvPlayerAI::getPlayer(playerType).getTeam());
+        checkCostField_(playerType, costField);
+
+        // distinct profiles, in the order of their first unit (which can matter for ties in the step cost)
+        std::vector<UnitProfile> profiles;
+        std::set<UnitProfile> seenProfiles;
+        for (size_t i = 0, count = units.size(); i < count; ++i)
+        {
+            UnitProfile profile(units[i]);
+            if (seenProfiles.insert(profile).second)
+            {
+                profiles.push_back(profile);
+            }
+        }
+
+        Key key;
+        key.profiles = std::vector<UnitProfile>(seenProfiles.begin(), seenProfiles.end());
+        key.playerType = playerType;
+        key.startIndex = theMap.plotNum(pStartPlot->getX(), pStartPlot->getY());
+
+        // copied out of the cache, as adding the searched paths can evict entries
+        std::vector<Path> foundPaths(targetPlots.size());
+        std::vector<int> searchTargetIndices;
+        for (size_t i = 0, count = targetPlots.size(); i < count; ++i)
+        {
+            key.targetIndex = theMap.plotNum(targetPlots[i]->getX(), targetPlots[i]->getY());
+            const Path* pFoundPath = getPath_(key);
+            if (pFoundPath)
+            {
+                foundPaths[i] = *pFoundPath;
+            }
+            else if (std::find(searchTargetIndices.begin(), searchTargetIndices.end(), key.targetIndex) == searchTargetIndices.end())
+            {
+                searchTargetIndices.push_back(key.targetIndex);
+            }
+        }
+
+        if (!searchTargetIndices.empty())
+        {
+            std::vector<Path> searchPaths;
+            search_(profiles, costField, playerType, key.startIndex, searchTargetIndices, searchPaths);
+
+            for (size_t i = 0, count = searchTargetIndices.size(); i < count; ++i)
+            {
+                key.targetIndex = searchTargetIndices[i];
+                addPath_(key, searchPaths[i]);
+
+                for (size_t j = 0, targetCount = targetPlots.size(); j < targetCount; ++j)
+                {
+                    if (theMap.plotNum(targetPlots[j]->getX(), targetPlots[j]->getY()) == searchTargetIndices[i])
+                    {
+                        foundPaths[j] = searchPaths[i];
+                    }
+                }
+            }
+        }
+
+        for (size_t i = 0, count = foundPaths.size(); i < count; ++i)
+        {
+            if (!foundPaths[i].empty())
+            {
+                paths[i].valid = true;
+                paths[i].pathTurns = foundPaths[i].rbegin()->turn;
+                for (size_t j = 0, nodeCount = foundPaths[i].size(); j < nodeCount; ++j)
+                {
+                    const CvPlot* pPlot = theMap.plotByIndex(foundPaths[i][j].plotIndex);
+                    paths[i].nodes.push_back(UnitPathData::Node(foundPaths[i][j].turn, foundPaths[i][j].movesLeft, pPlot->getCoords(), pPlot->isVisible(isVisibleToTeam, false)));
+                }
+            }
+        }
+    }
+
+    const UnitPathFinder::Path* UnitPathFinder::getPath_(const Key& key)
+    {
+        PathMap::iterator pathIter = paths_.find(key);
+        if (pathIter == paths_.end())
+        {
+            return NULL;
+        }
+
+        lruList_.splice(lruList_.begin(), lruList_, pathIter->second.second);
+        return &pathIter->second.first;
+    }
+
+    void UnitPathFinder::addPath_(const Key& key, const Path& path)
+    {
+        PathMap::iterator pathIter = paths_.find(key);
+        if (pathIter != paths_.end())
+        {
+            pathIter->second.first = path;
+            lruList_.splice(lruList_.begin(), lruList_, pathIter->second.second);
+            return;
+        }
+
+        if (paths_.size() >= MaxPaths)
+        {
+            paths_.erase(lruList_.back());
+            lruList_.pop_back();
+        }
+
+        lruList_.push_front(key);
+        paths_.insert(std::make_pair(key, std::make_pair(path, lruList_.begin())));
+    }
+
+    // the field's version changes with plot feature, improvement, route and ownership events, war state changes and new turns
+    void UnitPathFinder::checkCostField_(PlayerTypes playerType, const MovementCostField& costField)
+    {
+        std::map<PlayerTypes, int>::iterator versionIter = costFieldVersions_.find(playerType);
+        if (versionIter == costFieldVersions_.end())
+        {
+            costFieldVersions_.insert(std::make_pair(playerType, costField.getVersion()));
+        }
+        else if (versionIter->second != costField.getVersion())
+        {
+            invalidate(playerType);
+            versionIter->second = costField.getVersion();
+        }
+    }
+
+    // a target's path ends with the attack cost step, but other targets' paths can pass through it without paying that cost,
+    // so each target also has an end node, reached from its neighbours with isPathDest set - the search stops once all end nodes are closed
+    void UnitPathFinder::search_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField, PlayerTypes playerType,
+        int startIndex, const std::vector<int>& targetIndices, std::vector<Path>& paths)
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        const int numPlots = theMap.numPlots();
+
+        if (cost_.size() != static_cast<size_t>(numPlots))
+        {
+            cost_.assign(numPlots, MAX_INT);
+            movesLeft_.assign(numPlots, 0);
+            turns_.assign(numPlots, 0);
+            parent_.assign(numPlots, -1);
+            targetSlot_.assign(numPlots, -1);
+            isClosed_.assign(numPlots, 0);
+            touched_.clear();
+        }
+
+        const size_t targetCount = targetIndices.size();
+        paths.assign(targetCount, Path());
+
+        // end node state, indexed by target slot
+        std::vector<int> endCost(targetCount, MAX_INT), endMovesLeft(targetCount, 0), endTurns(targetCount, 0), endParent(targetCount, -1);
+        std::vector<char> isEndClosed(targetCount, 0);
+
+        const CvPlot* pStartPlot = theMap.plotByIndex(startIndex);
+
+        // assume units have all their moves since these are (possibly) theoretical units
+        int startMoves = MAX_INT;
+        for (size_t i = 0, count = profiles.size(); i < count; ++i)
+        {
+            startMoves = std::min<int>(startMoves, profiles[i].maxMoves);
+        }
+
+        std::vector<const CvPlot*> pTargetPlots;
+        size_t targetsLeft = 0;
+        for (size_t i = 0; i < targetCount; ++i)
+        {
+            const CvPlot* pTargetPlot = theMap.plotByIndex(targetIndices[i]);
+            if (targetIndices[i] == startIndex)
+            {
+                paths[i].push_back(PathNode(startIndex, startMoves, 1));
+            }
+            // as unitDataPathDestValid - target must be in the start plot's sub area
+            else if (pTargetPlot->getSubArea() == pStartPlot->getSubArea())
+            {
+                targetSlot_[targetIndices[i]] = static_cast<int>(i);
+                pTargetPlots.push_back(pTargetPlot);
+                ++targetsLeft;
+            }
+        }
+
+        if (targetsLeft > 0)
+        {
+            cost_[startIndex] = 0;
+            movesLeft_[startIndex] = startMoves;
+            turns_[startIndex] = 1;
+            parent_[startIndex] = -1;
+            touched_.push_back(startIndex);
+
+            // (cost + heuristic, node) - nodes from numPlots on are target end nodes
+            // stale entries are skipped as their node is already closed
+            std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int> >, std::greater<std::pair<int, int> > > openList;
+            openList.push(std::make_pair(getPathHeuristic(pStartPlot, pTargetPlots), startIndex));
+
+            while (!openList.empty())
+            {
+                const int nodeIndex = openList.top().second;
+                openList.pop();
+
+                if (nodeIndex >= numPlots)
+                {
+                    const int slot = nodeIndex - numPlots;
+                    if (!isEndClosed[slot])
+                    {
+                        isEndClosed[slot] = 1;
+                        if (--targetsLeft == 0)
+                        {
+                            break;
+                        }
+                    }
+                    continue;
+                }
+
+                const int plotIndex = nodeIndex;
+                if (isClosed_[plotIndex])
+                {
+                    continue;
+                }
+                isClosed_[plotIndex] = 1;
+
+                const CvPlot* pPlot = theMap.plotByIndex(plotIndex);
+                for (int i = 0; i < NUM_DIRECTION_TYPES; ++i)
+                {
+                    const CvPlot* pLoopPlot = plotDirection(pPlot->getX(), pPlot->getY(), (DirectionTypes)i);
+                    if (!pLoopPlot)
+                    {
+                        continue;
+                    }
+
+                    const int loopPlotIndex = theMap.plotNum(pLoopPlot->getX(), pLoopPlot->getY());
+                    // as stepValid
+                    if (pLoopPlot->isImpassable() || pLoopPlot->getArea() != pPlot->getArea())
+                    {
+                        continue;
+                    }
+
+                    const int slot = targetSlot_[loopPlotIndex];
+                    if (slot >= 0 && !isEndClosed[slot])
+                    {
+                        const int cost = cost_[plotIndex] + getStepCost_(profiles, costField, playerType, plotIndex, loopPlotIndex, (DirectionTypes)i,
+                            movesLeft_[plotIndex], true);
+                        if (cost < endCost[slot])
+                        {
+                            endCost[slot] = cost;
+                            endParent[slot] = plotIndex;
+                            endMovesLeft[slot] = getStepMovesLeft_(profiles, costField, plotIndex, (DirectionTypes)i, movesLeft_[plotIndex]);
+                            endTurns[slot] = turns_[plotIndex] + (movesLeft_[plotIndex] == 0 ? 1 : 0);
+
+                            openList.push(std::make_pair(cost, numPlots + slot));
+                        }
+                    }
+
+                    if (isClosed_[loopPlotIndex])
+                    {
+                        continue;
+                    }
+
+                    const int cost = cost_[plotIndex] + getStepCost_(profiles, costField, playerType, plotIndex, loopPlotIndex, (DirectionTypes)i,
+                        movesLeft_[plotIndex], false);
+                    if (cost < cost_[loopPlotIndex])
+                    {
+                        if (cost_[loopPlotIndex] == MAX_INT)
+                        {
+                            touched_.push_back(loopPlotIndex);
+                        }
+
+                        cost_[loopPlotIndex] = cost;
+                        parent_[loopPlotIndex] = plotIndex;
+                        movesLeft_[loopPlotIndex] = getStepMovesLeft_(profiles, costField, plotIndex, (DirectionTypes)i, movesLeft_[plotIndex]);
+                        turns_[loopPlotIndex] = turns_[plotIndex] + (movesLeft_[plotIndex] == 0 ? 1 : 0);
+
+                        openList.push(std::make_pair(cost + getPathHeuristic(pLoopPlot, pTargetPlots), loopPlotIndex));
+                    }
+                }
+            }
+        }
+
+        for (size_t slot = 0; slot < targetCount; ++slot)
+        {
+            if (isEndClosed[slot])
+            {
+                paths[slot].push_back(PathNode(targetIndices[slot], endMovesLeft[slot], endTurns[slot]));
+                for (int plotIndex = endParent[slot]; plotIndex != -1; plotIndex = parent_[plotIndex])
+                {
+                    paths[slot].push_back(PathNode(plotIndex, movesLeft_[plotIndex], turns_[plotIndex]));
+                }
+                // built from end->start
+                std::reverse(paths[slot].begin(), paths[slot].end());
+            }
+            targetSlot_[targetIndices[slot]] = -1;
+        }
+
+        for (size_t i = 0, count = touched_.size(); i < count; ++i)
+        {
+            const int plotIndex = touched_[i];
+            cost_[plotIndex] = MAX_INT;
+            movesLeft_[plotIndex] = 0;
+            turns_[plotIndex] = 0;
+            parent_[plotIndex] = -1;
+            isClosed_[plotIndex] = 0;
+        }
+        touched_.clear();
+    }
+
+    // as unitDataPathCost - cost for the unit which would be left with the fewest moves
+    int UnitPathFinder::getStepCost_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField, PlayerTypes playerType,
+        int fromIndex, int toIndex, DirectionTypes direction, int fromMovesLeft, bool isPathDest) const
+    {
+        const CvMap& theMap = gGlobals.getMap();
+        const CvPlot* pFromPlot = theMap.plotByIndex(fromIndex);
+        const CvPlot* pToPlot = theMap.plotByIndex(toIndex);
+        const TeamTypes teamType = CvPlayerAI::getPlayer(playerType).getTeam();
+
+        int worstCost = MAX_INT, worstMovesLeft = MAX_INT, worstMax = MAX_INT;
+
+        for (size_t i = 0, count = profiles.size(); i < count; ++i)
+        {
+            const int maxMoves = fromMovesLeft > 0 ? fromMovesLeft : profiles[i].maxMoves;
+            int cost = profiles[i].isLand ? costField.getLandMovementCost(profiles[i].movementData, fromIndex, direction) :
+                costField.getSeaMovementCost(profiles[i].movementData, fromIndex, direction);
+
+            const int movesLeft = std::max<int>(0, maxMoves - cost);
+            if (movesLeft > worstMovesLeft || (movesLeft == worstMovesLeft && maxMoves > worstMax))
+            {
+                continue;
+            }
+
+            if (movesLeft == 0)
+            {
+                cost = PATH_MOVEMENT_WEIGHT * maxMoves;
+
+                if (pToPlot->getTeam() != teamType)
+                {
+                    cost += PATH_TERRITORY_WEIGHT;
+                }
+
+                if (gGlobals.getPATH_DAMAGE_WEIGHT() != 0)
+                {
+                    if (pToPlot->getFeatureType() != NO_FEATURE)
+                    {
+                        cost += (gGlobals.getPATH_DAMAGE_WEIGHT() * std::max<int>(0, gGlobals.getFeatureInfo(pToPlot->getFeatureType()).getTurnDamage())) / gGlobals.getMAX_HIT_POINTS();
+                    }
+
+                    if (pToPlot->getExtraMovePathCost() > 0)
+                    {
+                        cost += PATH_MOVEMENT_WEIGHT * pToPlot->getExtraMovePathCost();
+                    }
+                }
+            }
+            else
+            {
+                cost = PATH_MOVEMENT_WEIGHT * cost;
+            }
+
+            if (profiles[i].hasCombat)
+            {
+                // no end of turn defence term - in unitDataPathCost its operator precedence makes it always zero
+                if (!profiles[i].isOnlyDefensive && isPathDest && pToPlot->getVisibleEnemyDefender(playerType))
+                {
+                    cost += PATH_DEFENSE_WEIGHT * std::max<int>(0, 200 - (profiles[i].isNoDefensiveBonus ? 0 : pFromPlot->defenseModifier(teamType, false)));
+
+                    if (!pFromPlot->isCity())
+                    {
+                        cost += PATH_CITY_WEIGHT;
+                    }
+
+                    if (pFromPlot->isRiverCrossing(direction))
+                    {
+                        cost += PATH_RIVER_WEIGHT * -gGlobals.getRIVER_ATTACK_MODIFIER();
+                        cost += PATH_MOVEMENT_WEIGHT * movesLeft;
+                    }
+                }
+            }
+
+            if (cost < worstCost)
+            {
+                worstCost = cost;
+                worstMovesLeft = movesLeft;
+                worstMax = maxMoves;
+            }
+        }
+
+        worstCost += PATH_STEP_WEIGHT;
+
+        if (pFromPlot->getX() != pToPlot->getX() && pFromPlot->getY() != pToPlot->getY())
+        {
+            worstCost += PATH_STRAIGHT_WEIGHT;
+        }
+
+        return worstCost;
+    }
+
+    // as unitDataPathAdd - moves left for the slowest unit
+    int UnitPathFinder::getStepMovesLeft_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField,
+        int fromIndex, DirectionTypes direction, int fromMovesLeft) const
+    {
+        int movesLeft = MAX_INT;
+        for (size_t i = 0, count = profiles.size(); i < count; ++i)
+        {
+            const int unitMoves = (fromMovesLeft == 0 ? profiles[i].maxMoves : fromMovesLeft) - (profiles[i].isLand ?
+                costField.getLandMovementCost(profiles[i].movementData, fromIndex, direction) : costField.getSeaMovementCost(profiles[i].movementData, fromIndex, direction));
+            movesLeft = std::min<int>(movesLeft, std::max<int>(0, unitMoves));
+        }
+        return movesLeft;
+    }
+}
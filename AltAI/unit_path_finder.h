@@ -0,0 +1,90 @@
+#pragma once
+
+#include "./utils.h"
+#include "./unit_tactics.h"
+
+namespace AltAI
+{
+    class MovementCostField;
+
+    // A* search for paths of a stack of (possibly theoretical) units, replacing FAStar with the unitData path callbacks
+    // step costs and moves left/turns are as those callbacks, with movement costs taken from the player's MovementCostField
+    // paths are kept in an lru cache keyed by the units' movement profiles, player, start and target
+    // a player's paths are dropped when its movement cost field changes (plot events and new turns) or on unit events (invalidate())
+    class UnitPathFinder
+    {
+    public:
+        UnitPathFinder();
+
+        void clear();
+        // drops the player's cached paths
+        void invalidate(PlayerTypes playerType);
+
+        // path is not valid if the target is not reachable
+        void findPath(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot,
+            PlayerTypes playerType, TeamTypes isVisibleToTeam, UnitPathData& path);
+        // paths to each of targetPlots (in the same order) from one search which runs until every reachable target is found
+        // each path is the same as findPath would give for its target alone
+        void findPaths(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const std::vector<const CvPlot*>& targetPlots,
+            PlayerTypes playerType, TeamTypes isVisibleToTeam, std::vector<UnitPathData>& paths);
+
+    private:
+        // the unit attributes the path costs depend on - stacks' units are deduplicated by these
+        struct UnitProfile
+        {
+            explicit UnitProfile(const UnitData& unitData);
+            bool operator < (const UnitProfile& other) const;
+
+            UnitMovementData movementData;
+            UnitTypes unitType;
+            int maxMoves;
+            bool isLand, hasCombat, isOnlyDefensive, isNoDefensiveBonus;
+        };
+
+        struct PathNode
+        {
+            PathNode() : plotIndex(-1), movesLeft(0), turn(0) {}
+            PathNode(int plotIndex_, int movesLeft_, int turn_) : plotIndex(plotIndex_), movesLeft(movesLeft_), turn(turn_) {}
+
+            int plotIndex, movesLeft, turn;
+        };
+
+        // empty if no path
+        typedef std::vector<PathNode> Path;
+
+        struct Key
+        {
+            Key() : playerType(NO_PLAYER), startIndex(-1), targetIndex(-1) {}
+            bool operator < (const Key& other) const;
+
+            std::vector<UnitProfile> profiles;
+            PlayerTypes playerType;
+            int startIndex, targetIndex;
+        };
+
+        typedef std::list<Key> LruList;
+        typedef std::map<Key, std::pair<Path, LruList::iterator> > PathMap;
+
+        const Path* getPath_(const Key& key);
+        void addPath_(const Key& key, const Path& path);
+        void checkCostField_(PlayerTypes playerType, const MovementCostField& costField);
+
+        void search_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField, PlayerTypes playerType,
+            int startIndex, const std::vector<int>& targetIndices, std::vector<Path>& paths);
+        int getStepCost_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField, PlayerTypes playerType,
+            int fromIndex, int toIndex, DirectionTypes direction, int fromMovesLeft, bool isPathDest) const;
+        int getStepMovesLeft_(const std::vector<UnitProfile>& profiles, const MovementCostField& costField,
+            int fromIndex, DirectionTypes direction, int fromMovesLeft) const;
+
+        static const size_t MaxPaths = 512;
+
+        PathMap paths_;
+        LruList lruList_;
+        std::map<PlayerTypes, int> costFieldVersions_;  // version of each player's field its cached paths were found with
+
+        // search state, indexed by plot number and reset between searches using the list of touched plots
+        std::vector<int> cost_, movesLeft_, turns_, parent_, targetSlot_;
+        std::vector<char> isClosed_;
+        std::vector<int> touched_;
+    };
+}
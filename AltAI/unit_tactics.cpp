@@ -10,6 +10,8 @@
 #include "./game.h"
 #include "./player.h"
 #include "./player_analysis.h"
+#include "./map_analysis.h"
+#include "./unit_path_finder.h"
 #include "./gamedata_analysis.h"
 #include "./settler_manager.h"
 #include "./helper_fns.h"
@@ -17,9 +19,12 @@
 #include "./tactic_selection_data.h"
 #include "./civ_helper.h"
 #include "./civ_log.h"
+#include "./error_log.h"
 #include "./unit_log.h"
 #include "./iters.h"
 #include "./save_utils.h"
+#include "./profiler.h"
+#include "./worker_pool.h"
 
 #include "CvDLLEngineIFaceBase.h"
 #include "CvDLLFAStarIFaceBase.h"
@@ -178,7 +183,7 @@ namespace AltAI
 
         bool couldMoveInfoDomainSpecific(const CvUnit* pUnit, const CvPlot* pPlot)
         {
-            static const bool bLAND_UNITS_CAN_ATTACK_WATER_CITIES = gGlobals.getDefineINT("LAND_UNITS_CAN_ATTACK_WATER_CITIES") != 0;
+            const bool bLAND_UNITS_CAN_ATTACK_WATER_CITIES = GameDataAnalysis::getLandUnitsCanAttackWaterCities();
 
             switch (pUnit->getDomainType())
 	        {
@@ -257,12 +262,129 @@ namespace AltAI
                 return second.odds.DefenderKillOdds > first.odds.DefenderKillOdds;
             }
         };
+
+        // dense, map sized scratch arrays for getReachablePlotsData indexed by plot number, reused between calls
+        // only the entries a search touches are reset after it
+        // there is only the one instance, so getReachablePlotsData must only be called from the main thread
+        // (none of the worker pool tasks use it)
+        struct ReachablePlotsScratch
+        {
+            void init(int numPlots, int maxMovesLeft)
+            {
+                if ((int)movesLeft.size() != numPlots)
+                {
+                    movesLeft.assign(numPlots, -1);
+                    isClosed.assign(numPlots, 0);
+                    touched.clear();
+                }
+                if ((int)buckets.size() < maxMovesLeft + 1)
+                {
+                    buckets.resize(maxMovesLeft + 1);
+                }
+            }
+
+            void reset()
+            {
+                for (size_t i = 0, count = touched.size(); i < count; ++i)
+                {
+                    movesLeft[touched[i]] = -1;
+                    isClosed[touched[i]] = 0;
+                }
+                touched.clear();
+            }
+
+            std::vector<int> movesLeft;  // -1 if not reached
+            std::vector<char> isClosed;
+            std::vector<int> touched;
+            std::vector<std::vector<int> > buckets;  // open plots, indexed by their moves left (may hold stale entries)
+        };
+
+        ReachablePlotsScratch reachablePlotsScratch;
+
+        // shared by all players - paths are keyed by player
+        UnitPathFinder unitPathFinder;
+
+        // combat graph nodes whose units match apart from hp differences within the same bucket are merged
+        const int CombatGraphHPBucketSize = 5;
+
+        typedef std::map<std::vector<int>, int> CombatGraphNodeMap;
+        // ordered by descending measure, then by node index
+        typedef std::set<std::pair<int, int> > CombatGraphOpenNodes;
+
+        // every combat reduces this: a win removes a defender, a loss removes an attacker and a withdrawal or retreat uses the attacker's attack and moves
+        // so nodes are expanded only after every node which can lead to them has been
+        int getCombatGraphMeasure(const std::vector<CombatGraph::UnitState>& attackerStates, const std::vector<CombatGraph::UnitState>& defenderStates)
+        {
+            int measure = (int)defenderStates.size();
+            for (size_t i = 0, count = attackerStates.size(); i < count; ++i)
+            {
+                measure += 1 + attackerStates[i].moves + (attackerStates[i].hasAttacked ? 0 : 1);
+            }
+            return measure;
+        }
+
+        std::vector<int> makeCombatGraphKey(const std::vector<CombatGraph::UnitState>& attackerStates, const std::vector<CombatGraph::UnitState>& defenderStates)
+        {
+            std::vector<int> key;
+            key.reserve(4 * attackerStates.size() + 1 + 2 * defenderStates.size());
+            for (size_t i = 0, count = attackerStates.size(); i < count; ++i)
+            {
+                key.push_back((int)attackerStates[i].unitIndex);
+                key.push_back(attackerStates[i].hp / CombatGraphHPBucketSize);
+                key.push_back(attackerStates[i].moves);
+                key.push_back(attackerStates[i].hasAttacked ? 1 : 0);
+            }
+            key.push_back(-1);
+            for (size_t i = 0, count = defenderStates.size(); i < count; ++i)
+            {
+                key.push_back((int)defenderStates[i].unitIndex);
+                key.push_back(defenderStates[i].hp / CombatGraphHPBucketSize);
+            }
+            return key;
+        }
+
+        // returns the index of the node for this combat state - either an existing unexpanded node which is reached from
+        // a different combat ordering, or a new one
+        int addCombatGraphNode(CombatGraph& graph, CombatGraphNodeMap& nodeMap, CombatGraphOpenNodes& openNodes, int parentNode, int parentMeasure, float prob,
+            const std::vector<CombatGraph::UnitState>& attackerStates, const std::vector<CombatGraph::UnitState>& defenderStates)
+        {
+            const int measure = getCombatGraphMeasure(attackerStates, defenderStates);
+            std::vector<int> key = makeCombatGraphKey(attackerStates, defenderStates);
+
+            // only merge into nodes which are expanded after this one (withdrawals which don't change the measure always get their own node)
+            if (measure < parentMeasure)
+            {
+                CombatGraphNodeMap::const_iterator nodeIter = nodeMap.find(key);
+                if (nodeIter != nodeMap.end() && !graph.nodes[nodeIter->second].isExpanded)
+                {
+                    graph.nodes[nodeIter->second].prob += prob;
+                    return nodeIter->second;
+                }
+            }
+
+            CombatGraph::Node node;
+            node.parentNode = parentNode;
+            node.prob = prob;
+            node.firstAttacker = graph.unitStates.size();
+            node.attackerCount = attackerStates.size();
+            graph.unitStates.insert(graph.unitStates.end(), attackerStates.begin(), attackerStates.end());
+            node.firstDefender = graph.unitStates.size();
+            node.defenderCount = defenderStates.size();
+            graph.unitStates.insert(graph.unitStates.end(), defenderStates.begin(), defenderStates.end());
+
+            const int nodeIndex = (int)graph.nodes.size();
+            graph.nodes.push_back(node);
+            nodeMap[key] = nodeIndex;
+            openNodes.insert(std::make_pair(-measure, nodeIndex));
+
+            return nodeIndex;
+        }
     }
 
     int landMovementCost(const UnitMovementData& unit, const CvPlot* pFromPlot, const CvPlot* pToPlot, const CvTeamAI& unitsTeam)
     {            
-        static const int MOVE_DENOMINATOR = gGlobals.getMOVE_DENOMINATOR();
-        static const int HILLS_EXTRA_MOVEMENT = gGlobals.getHILLS_EXTRA_MOVEMENT();
+        const int MOVE_DENOMINATOR = gGlobals.getMOVE_DENOMINATOR();
+        const int HILLS_EXTRA_MOVEMENT = gGlobals.getHILLS_EXTRA_MOVEMENT();
 
         const TeamTypes fromPlotTeam = pFromPlot->getTeam(), toPlotTeam = pToPlot->getTeam();
         const RouteTypes fromRouteType = pFromPlot->getRouteType(), toRouteType = pToPlot->getRouteType();
@@ -329,7 +451,7 @@ namespace AltAI
     // movement cost for ships - optimised on the basis that we don't have routes or hills at sea
     int seaMovementCost(const UnitMovementData& unit, const CvPlot* pFromPlot, const CvPlot* pToPlot, const CvTeamAI& unitsTeam)
     {            
-        static const int MOVE_DENOMINATOR = gGlobals.getMOVE_DENOMINATOR();
+        const int MOVE_DENOMINATOR = gGlobals.getMOVE_DENOMINATOR();
 
         const TeamTypes fromPlotTeam = pFromPlot->getTeam(), toPlotTeam = pToPlot->getTeam();
             
@@ -405,6 +527,16 @@ namespace AltAI
         }
         else
         {
+            // bounded results (pruned as unwinnable) rank after exact ones, and between themselves only by distance
+            if (first.attackOdds.isBounded || second.attackOdds.isBounded)
+            {
+                if (first.attackOdds.isBounded != second.attackOdds.isBounded)
+                {
+                    return second.attackOdds.isBounded;
+                }
+                return first.stepDistanceFromTarget < second.stepDistanceFromTarget;
+            }
+
             if ((int)(1000.0f * first.attackOdds.pWin) == (int)(1000.0f * second.attackOdds.pWin))
             {
                 return first.stepDistanceFromTarget < second.stepDistanceFromTarget;
@@ -425,6 +557,11 @@ namespace AltAI
         {
             if (first.stepDistanceFromTarget == second.stepDistanceFromTarget)
             {
+                // bounded results rank after exact ones, and tie between themselves
+                if (first.defenceOdds.isBounded || second.defenceOdds.isBounded)
+                {
+                    return !first.defenceOdds.isBounded;
+                }
                 return first.defenceOdds.pLoss + first.defenceOdds.pDraw > second.defenceOdds.pLoss + second.defenceOdds.pDraw;
             }
             else
@@ -434,6 +571,15 @@ namespace AltAI
         }
         else  // reverse consideration to consider survival prob over proximity to target
         {
+            if (first.defenceOdds.isBounded || second.defenceOdds.isBounded)
+            {
+                if (first.defenceOdds.isBounded != second.defenceOdds.isBounded)
+                {
+                    return second.defenceOdds.isBounded;
+                }
+                return first.stepDistanceFromTarget < second.stepDistanceFromTarget;
+            }
+
             if ((int)(1000.0f * first.defenceOdds.pLoss) == (int)(1000.0f * second.defenceOdds.pLoss))
             {
                 return first.stepDistanceFromTarget < second.stepDistanceFromTarget;
@@ -469,35 +615,22 @@ namespace AltAI
         }
     }
 
-    void UnitPathData::calculate(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot, const int flags, PlayerTypes playerType, TeamTypes isVisibleToTeam)
+    void UnitPathData::calculate(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot, PlayerTypes playerType, TeamTypes isVisibleToTeam)
     {
-        nodes.clear();
-
-        FAStar* pStepFinder = gDLL->getFAStarIFace()->create();
-        CvMap& theMap = gGlobals.getMap();
-        gDLL->getFAStarIFace()->Initialize(pStepFinder, theMap.getGridWidth(), theMap.getGridHeight(), theMap.isWrapX(), theMap.isWrapY(), 
-            unitDataPathDestValid, stepHeuristic, unitDataPathCost, stepValid, unitDataPathAdd, NULL, NULL);
-
-        XYCoords startCoords = pStartPlot->getCoords();
+        unitPathFinder.findPath(units, pStartPlot, pTargetPlot, playerType, isVisibleToTeam, *this);
+    }
 
-        int stepFinderInfo = MAKEWORD((short)playerType, 0);
-        gDLL->getFAStarIFace()->SetData(pStepFinder, &units);
+    std::vector<UnitPathData> getUnitPaths(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const std::vector<const CvPlot*>& targetPlots,
+        PlayerTypes playerType, TeamTypes isVisibleToTeam)
+    {
+        std::vector<UnitPathData> paths;
+        unitPathFinder.findPaths(units, pStartPlot, targetPlots, playerType, isVisibleToTeam, paths);
+        return paths;
+    }
 
-        valid = gDLL->getFAStarIFace()->GeneratePath(pStepFinder, startCoords.iX, startCoords.iY, pTargetPlot->getX(), pTargetPlot->getY(), false, stepFinderInfo, true);
-        if (valid)
-        {
-            FAStarNode* pNode = gDLL->getFAStarIFace()->GetLastNode(pStepFinder);
-            pathTurns = pNode->m_iData2;
-            while (pNode)
-            {
-                XYCoords stepCoords(pNode->m_iX, pNode->m_iY);
-                const CvPlot* thisStepPlot = gGlobals.getMap().plot(pNode->m_iX, pNode->m_iY);
-                const bool plotIsVisible = thisStepPlot->isVisible(isVisibleToTeam, false);
-                // path plots are in reverse order (end->start)
-                nodes.push_front(Node(pNode->m_iData2, pNode->m_iData1, stepCoords, plotIsVisible));
-                pNode = pNode->m_pParent;
-            }
-        }
+    void invalidateUnitPaths(PlayerTypes playerType)
+    {
+        unitPathFinder.invalidate(playerType);
     }
 
     XYCoords UnitPathData::getLastVisiblePlotWithMP() const
@@ -590,81 +723,44 @@ namespace AltAI
     {
         endStatesData = Data(*this);
 
-        for (std::list<StackCombatDataNodePtr>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
+        for (std::list<int>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
         {
-            float pEndState = 1;
-            const StackCombatDataNode* pCurrentNode = (*ci).get();
-                
-            for (const StackCombatDataNode* pNode = (*ci)->parentNode; pNode; pNode = pNode->parentNode)
-            {
-                pEndState *= pCurrentNode == pNode->winNode.get() ? pNode->data.odds.AttackerKillOdds : // win
-                    (pCurrentNode == pNode->drawNode.get() ? (pNode->data.odds.PullOutOdds + pNode->data.odds.RetreatOdds) : // draw
-                        pNode->data.odds.DefenderKillOdds);  // loss
-                pCurrentNode = pNode;
-            }
+            const Node& node = nodes[*ci];
 
-            const bool noAttackers = (*ci)->attackers.empty(), noDefenders = (*ci)->defenders.empty();
+            const bool noAttackers = node.attackerCount == 0, noDefenders = node.defenderCount == 0;
             if (!noDefenders && !noAttackers)  // draw
             {
-                endStatesData.pDraw += pEndState;
+                endStatesData.pDraw += node.prob;
             }
             else if (noDefenders)  // win
             {
-                endStatesData.pWin += pEndState;
+                endStatesData.pWin += node.prob;
             }
             else // loss
             {
-                endStatesData.pLoss += pEndState;
+                endStatesData.pLoss += node.prob;
             }
 
-            int attackerIndex = 0;
-            for (size_t i = 0, count = (*ci)->attackers.size(); i < count; ++i)
+            for (size_t i = 0; i < node.attackerCount; ++i)
             {
-                while (pRootNode->attackers[attackerIndex].unitId != (*ci)->attackers[i].unitId)
-                {
-                    ++attackerIndex;
-                }
-                endStatesData.attackerUnitOdds[attackerIndex++] += pEndState;
+                endStatesData.attackerUnitOdds[getAttackerState(node, i).unitIndex] += node.prob;
             }
 
-            int defenderIndex = 0;
-            for (size_t i = 0, count = (*ci)->defenders.size(); i < count; ++i)
+            for (size_t i = 0; i < node.defenderCount; ++i)
             {
-                while (pRootNode->defenders[defenderIndex].unitId != (*ci)->defenders[i].unitId)
-                {
-                    ++defenderIndex;
-                }
-                endStatesData.defenderUnitOdds[defenderIndex++] += pEndState;
+                endStatesData.defenderUnitOdds[getDefenderState(node, i).unitIndex] += node.prob;
             }
         }
     }
 
     void CombatGraph::debugEndStates(std::ostream& os) const
     {
-        for (std::list<StackCombatDataNodePtr>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
+        for (std::list<int>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
         {
-            float pEndState = 1;
-            const StackCombatDataNode* pCurrentNode = (*ci).get();
-                
-            for (const StackCombatDataNode* pNode = (*ci)->parentNode; pNode; pNode = pNode->parentNode)
-            {
-                if (pCurrentNode == pNode->winNode.get())
-                {
-                    pEndState *= pNode->data.odds.AttackerKillOdds;
-                }
-                else if (pCurrentNode == pNode->lossNode.get())
-                {
-                    pEndState *= pNode->data.odds.DefenderKillOdds;
-                }
-                else  // withdrawal and retreat (pNode->drawNode)
-                {
-                    pEndState *= (pNode->data.odds.PullOutOdds + pNode->data.odds.RetreatOdds);
-                }
-                pCurrentNode = pNode;
-            }
-            os << "\n\t P(endstate) = " << pEndState;
+            const Node& node = nodes[*ci];
+            os << "\n\t P(endstate) = " << node.prob;
 
-            const bool noAttackers = (*ci)->attackers.empty(), noDefenders = (*ci)->defenders.empty();
+            const bool noAttackers = node.attackerCount == 0, noDefenders = node.defenderCount == 0;
             if (!noDefenders && !noAttackers)  // draw
             {
                 os << " (draw) ";
@@ -678,16 +774,18 @@ namespace AltAI
                 os << " (loss) ";
             }
             os << " attackers:";
-            for (size_t i = 0, count = (*ci)->attackers.size(); i < count; ++i)
+            for (size_t i = 0; i < node.attackerCount; ++i)
             {
-                os << ' ' << (*ci)->attackers[i].pUnitInfo->getType() << " hp=" << (*ci)->attackers[i].hp << " ";
-                (*ci)->attackers[i].debugPromotions(os);
+                const UnitState& unitState = getAttackerState(node, i);
+                os << ' ' << attackers[unitState.unitIndex].pUnitInfo->getType() << " hp=" << unitState.hp << " ";
+                attackers[unitState.unitIndex].debugPromotions(os);
             }
             os << " defenders:";
-            for (size_t i = 0, count = (*ci)->defenders.size(); i < count; ++i)
+            for (size_t i = 0; i < node.defenderCount; ++i)
             {
-                os << ' ' << (*ci)->defenders[i].pUnitInfo->getType() << " hp=" << (*ci)->defenders[i].hp << " ";
-                (*ci)->defenders[i].debugPromotions(os);
+                const UnitState& unitState = getDefenderState(node, i);
+                os << ' ' << defenders[unitState.unitIndex].pUnitInfo->getType() << " hp=" << unitState.hp << " ";
+                defenders[unitState.unitIndex].debugPromotions(os);
             }
         }
     }
@@ -745,15 +843,16 @@ namespace AltAI
 
     size_t CombatGraph::getFirstUnitIndex(bool isAttacker) const
     {
-        return isAttacker ? pRootNode->data.attackerIndex : pRootNode->data.defenderIndex;
+        return isAttacker ? nodes[RootNode].data.attackerIndex : nodes[RootNode].data.defenderIndex;
     }
 
-    std::list<IDInfo> CombatGraph::getUnitOrdering(std::list<StackCombatDataNodePtr>::const_iterator endStateIter) const
+    std::list<IDInfo> CombatGraph::getUnitOrdering(std::list<int>::const_iterator endStateIter) const
     {
         std::list<IDInfo> attackUnits;
-        for (const StackCombatDataNode* pNode = (*endStateIter)->parentNode; pNode; pNode = pNode->parentNode)
+        for (int nodeIndex = nodes[*endStateIter].parentNode; nodeIndex != NoNode; nodeIndex = nodes[nodeIndex].parentNode)
         {
-            attackUnits.push_front(pNode->attackers[pNode->data.attackerIndex].unitId);
+            const Node& node = nodes[nodeIndex];
+            attackUnits.push_front(attackers[getAttackerState(node, node.data.attackerIndex).unitIndex].unitId);
         }
         return attackUnits;
     }
@@ -761,17 +860,23 @@ namespace AltAI
     std::pair<std::list<IDInfo>, std::list<IDInfo> > CombatGraph::getLongestAndShortestAttackOrder() const
     {
         std::pair<std::list<IDInfo>, std::list<IDInfo> > attackUnitIndicesPair;
+        if (nodes.empty())
+        {
+            return attackUnitIndicesPair;
+        }
 
         // pick path with most losses
-        for (StackCombatDataNodePtr pNode = pRootNode; pNode && !pNode->isEndState(); pNode = pNode->getWorstOutcome())
+        for (int nodeIndex = RootNode; nodeIndex != NoNode && !nodes[nodeIndex].isEndState(); nodeIndex = nodes[nodeIndex].getWorstOutcome())
         {
-            attackUnitIndicesPair.first.push_back(pNode->attackers[pNode->data.attackerIndex].unitId);
+            const Node& node = nodes[nodeIndex];
+            attackUnitIndicesPair.first.push_back(attackers[getAttackerState(node, node.data.attackerIndex).unitIndex].unitId);
         }
 
         // pick path with most wins
-        for (StackCombatDataNodePtr pNode = pRootNode; pNode && !pNode->isEndState(); pNode = pNode->getBestOutcome())
+        for (int nodeIndex = RootNode; nodeIndex != NoNode && !nodes[nodeIndex].isEndState(); nodeIndex = nodes[nodeIndex].getBestOutcome())
         {
-            attackUnitIndicesPair.second.push_back(pNode->attackers[pNode->data.attackerIndex].unitId);
+            const Node& node = nodes[nodeIndex];
+            attackUnitIndicesPair.second.push_back(attackers[getAttackerState(node, node.data.attackerIndex).unitIndex].unitId);
         }
 
         return attackUnitIndicesPair;
@@ -779,174 +884,223 @@ namespace AltAI
 
     float CombatGraph::getSurvivalOdds(IDInfo unitId, bool isAttacker) const
     {
+        // todo - check this logic for when we are defenders and if we want to consider survival odds of hostiles as well as ourselves
         float odds = 0;
-        for (std::list<StackCombatDataNodePtr>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
+        for (std::list<int>::const_iterator ci(endStates.begin()), ciEnd(endStates.end()); ci != ciEnd; ++ci)
         {
-            for (size_t i = 0, count = isAttacker ? (*ci)->attackers.size() : (*ci)->defenders.size(); i < count; ++i)
+            const Node& node = nodes[*ci];
+            for (size_t i = 0, count = isAttacker ? node.attackerCount : node.defenderCount; i < count; ++i)
             {
-                if (isAttacker ? (*ci)->attackers[i].unitId == unitId : (*ci)->defenders[i].unitId == unitId)
-                {                        
-                    float pEndState = 1;
-                    const StackCombatDataNode* pCurrentNode = (*ci).get();
-                    for (const StackCombatDataNode* pNode = (*ci)->parentNode; pNode; pNode = pNode->parentNode)
-                    {
-                        // todo - check this logic for when we are defenders and if we want to consider survival odds of hostiles as well as ourselves
-                        pEndState *= pCurrentNode == pNode->winNode.get() ? pNode->data.odds.AttackerKillOdds : // win
-                            (pCurrentNode == pNode->drawNode.get() ? pNode->data.odds.PullOutOdds + pNode->data.odds.RetreatOdds : // draw
-                                pNode->data.odds.DefenderKillOdds);  // loss
-
-                        pCurrentNode = pNode;
-                    }
-                    odds += pEndState;
+                if (isAttacker ? attackers[getAttackerState(node, i).unitIndex].unitId == unitId : defenders[getDefenderState(node, i).unitIndex].unitId == unitId)
+                {
+                    odds += node.prob;
                 }
             }
         }
         return odds;
     }
 
+    void CombatGraph::getNodeUnits(const Node& node, std::vector<UnitData>& nodeAttackers, std::vector<UnitData>& nodeDefenders) const
+    {
+        nodeAttackers.resize(node.attackerCount);
+        for (size_t i = 0; i < node.attackerCount; ++i)
+        {
+            const UnitState& unitState = getAttackerState(node, i);
+            nodeAttackers[i] = attackers[unitState.unitIndex];
+            nodeAttackers[i].hp = unitState.hp;
+            nodeAttackers[i].moves = unitState.moves;
+            nodeAttackers[i].hasAttacked = unitState.hasAttacked;
+        }
+
+        nodeDefenders.resize(node.defenderCount);
+        for (size_t i = 0; i < node.defenderCount; ++i)
+        {
+            const UnitState& unitState = getDefenderState(node, i);
+            nodeDefenders[i] = defenders[unitState.unitIndex];
+            nodeDefenders[i].hp = unitState.hp;
+            nodeDefenders[i].moves = unitState.moves;
+            nodeDefenders[i].hasAttacked = unitState.hasAttacked;
+        }
+    }
+
     CombatGraph getCombatGraph(const Player& player, const UnitData::CombatDetails& combatDetails, 
         const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders, double oddsThreshold)
     {
+        ProfileScope profileScope("getCombatGraph", player.getPlayerID());
+
         boost::shared_ptr<UnitAnalysis> pUnitAnalysis = player.getAnalysis()->getUnitAnalysis();
-        std::list<StackCombatDataNodePtr> openNodes, endNodes;
 
-        StackCombatDataNodePtr pRootNode(new StackCombatDataNode());
-        pRootNode->prob = 1.0f;
-        pRootNode->attackers = attackers;
-        pRootNode->defenders = defenders;
+        CombatGraph combatGraph;
+        combatGraph.attackers = attackers;
+        combatGraph.defenders = defenders;
+
+        CombatGraphNodeMap nodeMap;
+        CombatGraphOpenNodes openNodes;
 
-        openNodes.push_front(pRootNode);
+        {
+            std::vector<CombatGraph::UnitState> attackerStates, defenderStates;
+            for (size_t i = 0, count = attackers.size(); i < count; ++i)
+            {
+                attackerStates.push_back(CombatGraph::UnitState(i, attackers[i]));
+            }
+            for (size_t i = 0, count = defenders.size(); i < count; ++i)
+            {
+                defenderStates.push_back(CombatGraph::UnitState(i, defenders[i]));
+            }
+            addCombatGraphNode(combatGraph, nodeMap, openNodes, CombatGraph::NoNode, MAX_INT, 1.0f, attackerStates, defenderStates);
+        }
+
+        // scratch storage reused for each node expanded
+        std::vector<UnitData> nodeAttackers, nodeDefenders;
+        std::vector<CombatGraph::UnitState> attackerStates, defenderStates, childAttackerStates, childDefenderStates;
 
         while (!openNodes.empty())
         {
-            StackCombatDataNodePtr pCurrentNode = *openNodes.begin();
+            const int currentNode = openNodes.begin()->second, currentMeasure = -openNodes.begin()->first;
+            openNodes.erase(openNodes.begin());
+
+            combatGraph.nodes[currentNode].isExpanded = true;
+            const float currentProb = combatGraph.nodes[currentNode].prob;
+            combatGraph.getNodeUnits(combatGraph.nodes[currentNode], nodeAttackers, nodeDefenders);
+
             // expand node if required
-            if (!pCurrentNode->attackers.empty() && !pCurrentNode->defenders.empty() && stackCanAttack(pCurrentNode->attackers, pCurrentNode->defenders))
+            if (!nodeAttackers.empty() && !nodeDefenders.empty() && stackCanAttack(nodeAttackers, nodeDefenders))
             {
-                pCurrentNode->data = getBestUnitOdds(player, combatDetails, pCurrentNode->attackers, pCurrentNode->defenders, false);
+                StackCombatData data = getBestUnitOdds(player, combatDetails, nodeAttackers, nodeDefenders, false);
 
                 // oddsThreshold limits expansion of very unlikely paths - which significantly reduces the no. of nodes for large stack combinations
                 // better than 99.99% (0.9999) (if oddsThreshold is 0.0001) chance of attacker dying
-                bool ignoreAttackerSurvival = pCurrentNode->prob * pCurrentNode->data.odds.DefenderKillOdds > 1.0 - oddsThreshold || pCurrentNode->prob * pCurrentNode->data.odds.AttackerKillOdds < oddsThreshold;
-                bool onlyRetreat = pCurrentNode->attackers[pCurrentNode->data.attackerIndex].pUnitInfo->getCombatLimit() < 100;
+                bool ignoreAttackerSurvival = currentProb * data.odds.DefenderKillOdds > 1.0 - oddsThreshold || currentProb * data.odds.AttackerKillOdds < oddsThreshold;
+                bool onlyRetreat = nodeAttackers[data.attackerIndex].pUnitInfo->getCombatLimit() < 100;
                 // better than 99.99% chance of defender dying
-                bool ignoreDefenderSurvival = pCurrentNode->prob * pCurrentNode->data.odds.AttackerKillOdds > 1.0 - oddsThreshold || pCurrentNode->prob * pCurrentNode->data.odds.DefenderKillOdds < oddsThreshold ;
+                bool ignoreDefenderSurvival = currentProb * data.odds.AttackerKillOdds > 1.0 - oddsThreshold || currentProb * data.odds.DefenderKillOdds < oddsThreshold ;
                 std::vector<int> unitsCollateralDamage;
-                bool checkCollateral = pCurrentNode->attackers[pCurrentNode->data.attackerIndex].pUnitInfo->getCollateralDamage() > 0;
+                bool checkCollateral = nodeAttackers[data.attackerIndex].pUnitInfo->getCollateralDamage() > 0;
 
                 if (checkCollateral)
                 {
-                    unitsCollateralDamage = pUnitAnalysis->getCollateralDamage(pCurrentNode->attackers[pCurrentNode->data.attackerIndex],
-                        pCurrentNode->defenders, pCurrentNode->data.defenderIndex, combatDetails);
+                    unitsCollateralDamage = pUnitAnalysis->getCollateralDamage(nodeAttackers[data.attackerIndex], nodeDefenders, data.defenderIndex, combatDetails);
                 }
 
+                // withdrawal (for units that have a damage max % limit) and retreat (units with chance to withdraw from combat)
+                // in both cases, neither defender nor attacker is killed
+                const float pullOutOrWithdrawOdds = data.odds.PullOutOdds + data.odds.RetreatOdds;
+                const bool addDrawNode = pullOutOrWithdrawOdds > oddsThreshold && currentProb * pullOutOrWithdrawOdds > oddsThreshold;
+
+                const bool addWinNode = !onlyRetreat && !ignoreAttackerSurvival;
+                if (!onlyRetreat && ignoreAttackerSurvival)
+                {
+                    data.odds.AttackerKillOdds = 0.0;
+                    data.odds.DefenderKillOdds = 1.0;
+                }
+                const bool addLossNode = !ignoreDefenderSurvival;
+                if (ignoreDefenderSurvival)
+                {
+                    data.odds.AttackerKillOdds = 1.0;
+                    data.odds.DefenderKillOdds = 0.0;
+                }
+
+                // child probabilities use the final (pruned) odds stored in the node
+                combatGraph.nodes[currentNode].data = data;
+
+                const CombatGraph::Node& node = combatGraph.nodes[currentNode];
+                attackerStates.assign(combatGraph.unitStates.begin() + node.firstAttacker, combatGraph.unitStates.begin() + node.firstAttacker + node.attackerCount);
+                defenderStates.assign(combatGraph.unitStates.begin() + node.firstDefender, combatGraph.unitStates.begin() + node.firstDefender + node.defenderCount);
+                // node is invalidated by adding further nodes
+
                 // todo - flanking damage
-                if (!onlyRetreat)
+                if (addWinNode)
                 {
-                    if (!ignoreAttackerSurvival)
+                    childAttackerStates = attackerStates;
+                    CombatGraph::UnitState& attackingUnitState = childAttackerStates[data.attackerIndex];
+                    attackingUnitState.hp = std::max<int>(1, (int)data.odds.E_HP_Att);  // prevent div by zero errors from rounding down hp to zero
+                    attackingUnitState.hasAttacked = true;
+                    attackingUnitState.moves = std::max<int>(0, attackingUnitState.moves - 1); // todo calc exact movement cost for attack to plot
+
+                    childDefenderStates.clear();
+                    for (size_t i = 0, count = defenderStates.size(); i < count; ++i)
                     {
-                        StackCombatDataNodePtr pWinNode(new StackCombatDataNode(pCurrentNode.get()));
-                        pWinNode->prob = pWinNode->parentNode->prob * pCurrentNode->data.odds.AttackerKillOdds;
-                        pWinNode->attackers = pCurrentNode->attackers;
-                        UnitData& attackingUnitData = pWinNode->attackers[pCurrentNode->data.attackerIndex];
-                        attackingUnitData.hp = std::max<int>(1, (int)pCurrentNode->data.odds.E_HP_Att);  // prevent div by zero errors from rounding down hp to zero
-                        attackingUnitData.hasAttacked = true;
-                        attackingUnitData.moves = std::max<int>(0, attackingUnitData.moves - 1); // todo calc exact movement cost for attack to plot
-                        for (size_t i = 0, count = pCurrentNode->defenders.size(); i < count; ++i)
+                        if (i != data.defenderIndex)
                         {
-                            if (i != pCurrentNode->data.defenderIndex)
+                            childDefenderStates.push_back(defenderStates[i]);
+                            if (checkCollateral)
                             {
-                                pWinNode->defenders.push_back(pCurrentNode->defenders[i]);
-                                if (checkCollateral)
-                                {
-                                    pWinNode->defenders.rbegin()->hp -= unitsCollateralDamage[i];
-                                }
+                                childDefenderStates.rbegin()->hp -= unitsCollateralDamage[i];
                             }
                         }
-                        pCurrentNode->winNode = pWinNode;
-                        openNodes.push_back(pWinNode);  // attacker wins (or survives?)
-                    }
-                    else
-                    {
-                        pCurrentNode->data.odds.AttackerKillOdds = 0.0;
-                        pCurrentNode->data.odds.DefenderKillOdds = 1.0;
                     }
+
+                    // attacker wins (or survives?)
+                    const int winNode = addCombatGraphNode(combatGraph, nodeMap, openNodes, currentNode, currentMeasure, currentProb * data.odds.AttackerKillOdds,
+                        childAttackerStates, childDefenderStates);
+                    combatGraph.nodes[currentNode].winNode = winNode;
                 }
 
-                if (!ignoreDefenderSurvival)
+                if (addLossNode)
                 {
-                    StackCombatDataNodePtr pLossNode(new StackCombatDataNode(pCurrentNode.get()));
-                    pLossNode->prob = pLossNode->parentNode->prob * pCurrentNode->data.odds.DefenderKillOdds;
-                    pLossNode->defenders = pCurrentNode->defenders;
-                    UnitData& defendingUnitData = pLossNode->defenders[pCurrentNode->data.defenderIndex];
-                    defendingUnitData.hp = std::max<int>(1, (int)pCurrentNode->data.odds.E_HP_Def);
+                    childDefenderStates = defenderStates;
+                    CombatGraph::UnitState& defendingUnitState = childDefenderStates[data.defenderIndex];
+                    defendingUnitState.hp = std::max<int>(1, (int)data.odds.E_HP_Def);
                     if (checkCollateral)  // even if attacker died - still apply any collateral damage to defenders
                     {
-                        for (size_t i = 0, count = pLossNode->defenders.size(); i < count; ++i)
+                        for (size_t i = 0, count = childDefenderStates.size(); i < count; ++i)
                         {
-                            pLossNode->defenders[i].hp -= unitsCollateralDamage[i];
+                            childDefenderStates[i].hp -= unitsCollateralDamage[i];
                         }
                     }
-                    for (size_t i = 0, count = pCurrentNode->attackers.size(); i < count; ++i)
+
+                    childAttackerStates.clear();
+                    for (size_t i = 0, count = attackerStates.size(); i < count; ++i)
                     {
-                        if (i != pCurrentNode->data.attackerIndex)
+                        if (i != data.attackerIndex)
                         {
-                            pLossNode->attackers.push_back(pCurrentNode->attackers[i]);
+                            childAttackerStates.push_back(attackerStates[i]);
                         }
                     }
-                    pCurrentNode->lossNode = pLossNode;
-                    openNodes.push_back(pLossNode);  // defender wins
-                }
-                else
-                {
-                    pCurrentNode->data.odds.AttackerKillOdds = 1.0;
-                    pCurrentNode->data.odds.DefenderKillOdds = 0.0;
+
+                    // defender wins
+                    const int lossNode = addCombatGraphNode(combatGraph, nodeMap, openNodes, currentNode, currentMeasure, currentProb * data.odds.DefenderKillOdds,
+                        childAttackerStates, childDefenderStates);
+                    combatGraph.nodes[currentNode].lossNode = lossNode;
                 }
 
-                // withdrawal (for units that have a damage max % limit) and retreat (units with chance to withdraw from combat)
-                // in both cases, neither defender nor attacker is killed
-                float pullOutOrWithdrawOdds = pCurrentNode->data.odds.PullOutOdds + pCurrentNode->data.odds.RetreatOdds;
-                if (pullOutOrWithdrawOdds > oddsThreshold && pCurrentNode->prob * pullOutOrWithdrawOdds > oddsThreshold)
+                if (addDrawNode)
                 {
-                    StackCombatDataNodePtr pDrawNode(new StackCombatDataNode(pCurrentNode.get()));
-                    pDrawNode->prob = pDrawNode->parentNode->prob * pullOutOrWithdrawOdds;
-                    pDrawNode->attackers = pCurrentNode->attackers;
-                    pDrawNode->defenders = pCurrentNode->defenders;
+                    childAttackerStates = attackerStates;
+                    childDefenderStates = defenderStates;
 
-                    UnitData& attackingUnitData = pDrawNode->attackers[pCurrentNode->data.attackerIndex];
+                    CombatGraph::UnitState& attackingUnitState = childAttackerStates[data.attackerIndex];
                     // average of E_HP_Att_Withdraw and E_HP_Att_Retreat weighted by prob
                     // todo - check the expected HP values for retreat and withdrawal as they seem to be always 0 even when retreat odds are non trivial
                     // values seem to be reversed - for collateral withdrawal E_HP_Att_Retreat 
-                    attackingUnitData.hp = std::max<int>(1, (int)((pCurrentNode->data.odds.PullOutOdds * pCurrentNode->data.odds.E_HP_Att_Retreat + 
-                        pCurrentNode->data.odds.RetreatOdds * pCurrentNode->data.odds.E_HP_Att_Withdraw) / (pCurrentNode->data.odds.PullOutOdds + pCurrentNode->data.odds.RetreatOdds)));
-                    attackingUnitData.hasAttacked = true;
-                    attackingUnitData.moves = std::max<int>(0, attackingUnitData.moves - 1); // todo calc exact movement cost for attack to plot
+                    attackingUnitState.hp = std::max<int>(1, (int)((data.odds.PullOutOdds * data.odds.E_HP_Att_Retreat + 
+                        data.odds.RetreatOdds * data.odds.E_HP_Att_Withdraw) / (data.odds.PullOutOdds + data.odds.RetreatOdds)));
+                    attackingUnitState.hasAttacked = true;
+                    attackingUnitState.moves = std::max<int>(0, attackingUnitState.moves - 1); // todo calc exact movement cost for attack to plot
 
                     if (checkCollateral)  // even if attacker died - still apply any collateral damage to defenders
                     {
-                        for (size_t i = 0, count = pDrawNode->defenders.size(); i < count; ++i)
+                        for (size_t i = 0, count = childDefenderStates.size(); i < count; ++i)
                         {
-                            pDrawNode->defenders[i].hp -= unitsCollateralDamage[i];
+                            childDefenderStates[i].hp -= unitsCollateralDamage[i];
                         }
                     }
 
-                    UnitData& defendingUnitData = pDrawNode->defenders[pCurrentNode->data.defenderIndex];
-                    defendingUnitData.hp = std::max<int>(1, (int)pCurrentNode->data.odds.E_HP_Def_Withdraw);  // + average in expected retreat (hp = max damage limit of attacker?)
-                    
-                    pCurrentNode->drawNode = pDrawNode;
-                    openNodes.push_back(pDrawNode);  // attacker retreats or withdraws
+                    CombatGraph::UnitState& defendingUnitState = childDefenderStates[data.defenderIndex];
+                    defendingUnitState.hp = std::max<int>(1, (int)data.odds.E_HP_Def_Withdraw);  // + average in expected retreat (hp = max damage limit of attacker?)
+
+                    // attacker retreats or withdraws
+                    const int drawNode = addCombatGraphNode(combatGraph, nodeMap, openNodes, currentNode, currentMeasure, currentProb * pullOutOrWithdrawOdds,
+                        childAttackerStates, childDefenderStates);
+                    combatGraph.nodes[currentNode].drawNode = drawNode;
                 }
             }
             else
             {
-                endNodes.push_back(pCurrentNode);
+                combatGraph.endStates.push_back(currentNode);
             }
-            openNodes.erase(openNodes.begin());
         }
 
-        CombatGraph combatGraph;
-        combatGraph.pRootNode = pRootNode;
-        combatGraph.endStates = endNodes;
         return combatGraph;
     };
 
@@ -1026,7 +1180,7 @@ namespace AltAI
     }
 
     UnitMovementData::UnitMovementData(const UnitData& unitData) :
-        featureDoubleMoves(unitData.featureDoubleMoves), terrainDoubleMoves(unitData.terrainDoubleMoves)
+        featureDoubleMoves(unitData.pModifierProfile->featureDoubleMoves), terrainDoubleMoves(unitData.pModifierProfile->terrainDoubleMoves)
     {
         moves = unitData.pUnitInfo->getMoves();
         extraMovesDiscount = 0;  // todo: driven by promotions if we include those with basic UnitData info
@@ -1183,6 +1337,8 @@ namespace AltAI
         std::vector<size_t> defenderIndex(attackUnitsCount);  // index of defending unit each of attacking unit would face
         std::vector<int> attackerOdds(attackUnitsCount);  // odds defending unit has in each of these theoretical battles
         boost::shared_ptr<UnitAnalysis> pUnitAnalysis = player.getAnalysis()->getUnitAnalysis();
+        // attackers which have already attacked get a row of zero odds
+        const std::vector<std::vector<UnitOddsData> > oddsMatrix = pUnitAnalysis->getAttackOddsMatrix(attackers, defenders, combatDetails);
 
         for (size_t i = 0, count = attackUnitsCount; i < count; ++i)
         {
@@ -1192,7 +1348,11 @@ namespace AltAI
                 continue;
             }
 
-            std::vector<int> odds = pUnitAnalysis->getOdds(attackers[i], defenders, combatDetails, true);
+            std::vector<int> odds(defenders.size());
+            for (size_t j = 0, defenderCount = defenders.size(); j < defenderCount; ++j)
+            {
+                odds[j] = oddsMatrix[i][j].getAttackOdds();
+            }
                 
             // find best defender v. attacking unit
             std::vector<int>::const_iterator oddsIter = std::min_element(odds.begin(), odds.end());  // odds are for attacking unit - so find minimum value
@@ -1264,6 +1424,7 @@ namespace AltAI
         std::vector<int> attackerOdds(attackUnitsCount);  // odds defending unit has in each of these theoretical battles
         int bestOddsIndex = -1;
         int bestOdds = -1;
+        const std::vector<std::vector<UnitOddsData> > oddsMatrix = player.getAnalysis()->getUnitAnalysis()->getAttackOddsMatrix(attackers, defenders, combatDetails);
 
         for (size_t i = 0, count = attackUnitsCount; i < count; ++i)
         {
@@ -1272,7 +1433,11 @@ namespace AltAI
                 continue;
             }
 
-            std::vector<int> odds = player.getAnalysis()->getUnitAnalysis()->getOdds(attackers[i], defenders, combatDetails, true);
+            std::vector<int> odds(defenders.size());
+            for (size_t j = 0, defenderCount = defenders.size(); j < defenderCount; ++j)
+            {
+                odds[j] = oddsMatrix[i][j].getAttackOdds();
+            }
                 
             // find best defender v. attacking unit
             std::vector<int>::const_iterator oddsIter = std::min_element(odds.begin(), odds.end());  // odds are for attacking unit - so find minimum value
@@ -1609,13 +1774,13 @@ namespace AltAI
             {
                 if (unitChoiceIter != requiredUnitStack.unitsToBuild[i].begin()) os << " or ";
                 os << unitChoiceIter->pUnitInfo->getType();
-                if (!unitChoiceIter->promotions.empty()) os << " [";
-                for (size_t j = 0, count = unitChoiceIter->promotions.size(); j < count; ++j)
+                if (!unitChoiceIter->getPromotions().empty()) os << " [";
+                for (size_t j = 0, count = unitChoiceIter->getPromotions().size(); j < count; ++j)
                 {
                     if (j > 0) os << " + ";
-                    os << gGlobals.getPromotionInfo(unitChoiceIter->promotions[j]).getType();
+                    os << gGlobals.getPromotionInfo(unitChoiceIter->getPromotions()[j]).getType();
                 }
-                if (!unitChoiceIter->promotions.empty()) os << "]";
+                if (!unitChoiceIter->getPromotions().empty()) os << "]";
             }
             os << "}";
         }
@@ -1625,6 +1790,10 @@ namespace AltAI
 
     void getReachablePlotsData(ReachablePlotsData& reachablePlotsData, const Player& player, const std::vector<const CvUnit*>& unitStack, bool useMaxMoves, bool allowAttack)
     {
+        ProfileScope profileScope("getReachablePlotsData", player.getPlayerID());
+
+        const CvMap& theMap = gGlobals.getMap();
+
         // split units into their stacks
         PlotUnitsMap stackPlotsMap;
         for (size_t i = 0, count = unitStack.size(); i < count; ++i)
@@ -1651,94 +1820,114 @@ namespace AltAI
             }
             FAssert(stackDomain == DOMAIN_LAND || stackDomain == DOMAIN_SEA);
 
-            const CvTeamAI& unitsTeam = CvTeamAI::getTeam(stackPlotIter->second[0]->getTeam());
+            const MovementCostField& movementCosts = player.getAnalysis()->getMapAnalysis()->getMovementCostField(stackPlotIter->second[0]->getTeam());
 
             for (std::map<UnitMovementData, std::vector<const CvUnit*> >::const_iterator mIter(thisStacksGroupingMap.begin()), mEndIter(thisStacksGroupingMap.end());
                 mIter != mEndIter; ++mIter)
             {
-                std::map<const CvPlot*, int, CvPlotOrderF> reachablePlots;
-                PlotSet openList;
-
                 const bool canAttack = mIter->first.canAttack;
                 const int movesLeft = useMaxMoves ? mIter->second[0]->maxMoves() : mIter->second[0]->movesLeft();
+
+                // plots are expanded in order of decreasing moves left (a bucket queue, as moves left only decrease along a path)
+                // so each plot is expanded once, with its final moves left value
+                FAssertMsg(!WorkerPool::isWorkerThread(), "getReachablePlotsData's scratch arrays are main thread only");
+                ReachablePlotsScratch& scratch = reachablePlotsScratch;
+                scratch.init(theMap.numPlots(), movesLeft);
+
+                const int startIndex = theMap.plotNum(stackPlotIter->first->getX(), stackPlotIter->first->getY());
+                scratch.movesLeft[startIndex] = movesLeft;
+                scratch.touched.push_back(startIndex);
                 if (movesLeft > 0)
                 {
-                    openList.insert(stackPlotIter->first);            
+                    scratch.buckets[movesLeft].push_back(startIndex);
                 }
 
-                reachablePlots[stackPlotIter->first] = movesLeft;
-                std::map<const CvUnit*, int, CvUnitIDInfoOrderF>& unitMovements = reachablePlotsData.unitMovementDataMap[stackPlotIter->first];
-                for (size_t unitIndex = 0, unitCount = mIter->second.size(); unitIndex < unitCount; ++unitIndex)
+                for (int bucket = movesLeft; bucket > 0; --bucket)
                 {
-                    unitMovements.insert(std::make_pair(mIter->second[unitIndex], movesLeft));
-                }
+                    // can't hold a reference to the bucket, as pushing onto buckets with the same moves left (zero cost moves) may reallocate it
+                    while (!scratch.buckets[bucket].empty())
+                    {
+                        const int plotIndex = scratch.buckets[bucket].back();
+                        scratch.buckets[bucket].pop_back();
+                        if (scratch.isClosed[plotIndex] || scratch.movesLeft[plotIndex] != bucket)
+                        {
+                            continue;  // already expanded, or since reached with more moves left
+                        }
+                        scratch.isClosed[plotIndex] = 1;
 
-                while (!openList.empty())
-                {
-                    const CvPlot* pPlot = *openList.begin();
-                    NeighbourPlotIter plotIter(pPlot);
+                        const CvPlot* pPlot = theMap.plotByIndex(plotIndex);
+                        NeighbourPlotIter plotIter(pPlot);
 
-                    while (IterPlot pLoopPlot = plotIter())
-                    {
-                        // todo - switch on whether we include plots where we need to attack
-                        // isVisibleEnemyUnit will return true if, for that unit, any unit in the plot is from a team that unit's owner is at war with
-                        if (pLoopPlot.valid() && pLoopPlot->isRevealed(player.getTeamID(), false) &&
-                            pLoopPlot->isValidDomainForLocation(*mIter->second[0]) && (canAttack || !pLoopPlot->isVisibleEnemyUnit(mIter->second[0])))
+                        while (IterPlot pLoopPlot = plotIter())
                         {
-                            if (!couldMoveUnitIntoPlot(mIter->second[0], pLoopPlot, allowAttack, false, useMaxMoves, allowAttack))
+                            // todo - switch on whether we include plots where we need to attack
+                            // isVisibleEnemyUnit will return true if, for that unit, any unit in the plot is from a team that unit's owner is at war with
+                            if (pLoopPlot.valid() && pLoopPlot->isRevealed(player.getTeamID(), false) &&
+                                pLoopPlot->isValidDomainForLocation(*mIter->second[0]) && (canAttack || !pLoopPlot->isVisibleEnemyUnit(mIter->second[0])))
                             {
-                                continue;
-                            }
+                                const int loopPlotIndex = theMap.plotNum(pLoopPlot->getX(), pLoopPlot->getY());
+                                if (scratch.isClosed[loopPlotIndex])
+                                {
+                                    continue;  // already got here as cheaply or cheaper
+                                }
 
-                            // todo - track which units this stack can reach which are its enemies
-                            bool isAttackMove = canAttack && pLoopPlot->isVisibleEnemyUnit(mIter->second[0]);
-                            if (isAttackMove)
-                            {
-                            }
-                        
-                            int cost = stackDomain == DOMAIN_LAND ? landMovementCost(mIter->first, pPlot, pLoopPlot, unitsTeam) : seaMovementCost(mIter->first, pPlot, pLoopPlot, unitsTeam);
-                            int thisMoveMovesLeft = std::max<int>(0, reachablePlots[pPlot] - cost);
-                        
-                            bool updateMovementData = true;
-                            std::map<const CvPlot*, int, CvPlotOrderF>::iterator openPlotsIter = reachablePlots.find(pLoopPlot);
-                            if (openPlotsIter != reachablePlots.end())
-                            {
-                                // already got here as cheaply or cheaper
-                                int currentMoveMovesLeft = openPlotsIter->second;
-                                if (currentMoveMovesLeft >= thisMoveMovesLeft)
+                                if (!couldMoveUnitIntoPlot(mIter->second[0], pLoopPlot, allowAttack, false, useMaxMoves, allowAttack))
                                 {
-                                    updateMovementData = false;
                                     continue;
                                 }
-                                else
+
+                                // todo - track which units this stack can reach which are its enemies
+                                bool isAttackMove = canAttack && pLoopPlot->isVisibleEnemyUnit(mIter->second[0]);
+                        
+                                const DirectionTypes direction = directionXY(pPlot, pLoopPlot);
+                                int cost = stackDomain == DOMAIN_LAND ? movementCosts.getLandMovementCost(mIter->first, plotIndex, direction) : movementCosts.getSeaMovementCost(mIter->first, plotIndex, direction);
+                                int thisMoveMovesLeft = std::max<int>(0, bucket - cost);
+
+                                if (scratch.movesLeft[loopPlotIndex] >= thisMoveMovesLeft)
                                 {
-                                    openPlotsIter->second = thisMoveMovesLeft;
+                                    continue;  // already got here as cheaply or cheaper
                                 }
-                            }
-                            else
-                            {
-                                openPlotsIter = reachablePlots.insert(std::make_pair(pLoopPlot, thisMoveMovesLeft)).first;
-                            }
-
-                            if (updateMovementData)
-                            {
-                                std::map<const CvUnit*, int, CvUnitIDInfoOrderF>& unitMovements = reachablePlotsData.unitMovementDataMap[pLoopPlot];
-                                for (size_t unitIndex = 0, unitCount = mIter->second.size(); unitIndex < unitCount; ++unitIndex)
+                                if (scratch.movesLeft[loopPlotIndex] < 0)
                                 {
-                                    unitMovements[mIter->second[unitIndex]] = openPlotsIter->second;
+                                    scratch.touched.push_back(loopPlotIndex);
                                 }
-                            }
+                                scratch.movesLeft[loopPlotIndex] = thisMoveMovesLeft;
 
-                            // can't move through plot with enemy units (unless we attack and beat the last one)
-                            if (openPlotsIter->second > 0 && !isAttackMove)
-                            {
-                                openList.insert(pLoopPlot);                                
+                                // can't move through plot with enemy units (unless we attack and beat the last one)
+                                if (thisMoveMovesLeft > 0 && !isAttackMove)
+                                {
+                                    scratch.buckets[thisMoveMovesLeft].push_back(loopPlotIndex);
+                                }
                             }
-                            reachablePlotsData.allReachablePlots.insert(pLoopPlot);
                         }
                     }
-                    openList.erase(pPlot);
                 }
+
+                // the start plot has its units' moves, but only counts as reachable for other plots (it is never reached again with more moves)
+                {
+                    std::map<const CvUnit*, int, CvUnitIDInfoOrderF>& unitMovements = reachablePlotsData.unitMovementDataMap[stackPlotIter->first];
+                    for (size_t unitIndex = 0, unitCount = mIter->second.size(); unitIndex < unitCount; ++unitIndex)
+                    {
+                        unitMovements.insert(std::make_pair(mIter->second[unitIndex], movesLeft));
+                    }
+                }
+
+                for (size_t i = 0, count = scratch.touched.size(); i < count; ++i)
+                {
+                    if (scratch.touched[i] == startIndex)
+                    {
+                        continue;
+                    }
+
+                    const CvPlot* pReachablePlot = theMap.plotByIndex(scratch.touched[i]);
+                    std::map<const CvUnit*, int, CvUnitIDInfoOrderF>& unitMovements = reachablePlotsData.unitMovementDataMap[pReachablePlot];
+                    for (size_t unitIndex = 0, unitCount = mIter->second.size(); unitIndex < unitCount; ++unitIndex)
+                    {
+                        unitMovements[mIter->second[unitIndex]] = scratch.movesLeft[scratch.touched[i]];
+                    }
+                    reachablePlotsData.allReachablePlots.insert(pReachablePlot);
+                }
+                scratch.reset();
             }
         }
 
@@ -1783,6 +1972,123 @@ namespace AltAI
         }
     }
 
+    namespace
+    {
+        // cheap bounds on the attackers' chance of beating all the defenders, from the (cached) one on one odds
+        // lower: the best attackers each kill the worst defender for them (the game picks the defender, and damaged defenders only make it easier)
+        // a withdrawal leaves the defender alive, so only kill odds count here
+        // upper: only bounded when each attacker gets one fight and there is no collateral damage, with no more attackers than defenders -
+        // then every defender must be killed in a fight at its current hp, so no better than the best odds against it
+        // otherwise losing attackers can soften the defenders up for later ones, and upper is left at 1
+        std::pair<float, float> getCombatBounds(const Player& player, const UnitData::CombatDetails& combatDetails,
+            const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders)
+        {
+            const std::vector<std::vector<UnitOddsData> > oddsMatrix = player.getAnalysis()->getUnitAnalysis()->getAttackOddsMatrix(attackers, defenders, combatDetails);
+            const size_t attackerCount = attackers.size(), defenderCount = defenders.size();
+
+            // uses the same detailed odds as the combat graph, so the upper bound really does bound the graph's result
+            bool canSoften = attackerCount > defenderCount;
+            std::vector<float> worstOdds(attackerCount, 1.0f), bestOdds(defenderCount, 0.0f);
+            for (size_t i = 0; i < attackerCount; ++i)
+            {
+                canSoften = canSoften || attackers[i].isBlitz || attackers[i].pUnitInfo->getCollateralDamage() > 0;
+                for (size_t j = 0; j < defenderCount; ++j)
+                {
+                    worstOdds[i] = std::min<float>(worstOdds[i], oddsMatrix[i][j].AttackerKillOdds);
+                    // pulling out isn't a win either, but counting it keeps the upper bound loose rather than risk it being too tight
+                    bestOdds[j] = std::max<float>(bestOdds[j], oddsMatrix[i][j].AttackerKillOdds + oddsMatrix[i][j].PullOutOdds);
+                }
+            }
+
+            float lowerBound = 0.0f;
+            if (attackerCount >= defenderCount)
+            {
+                std::sort(worstOdds.begin(), worstOdds.end(), std::greater<float>());
+                lowerBound = 1.0f;
+                for (size_t i = 0; i < defenderCount; ++i)
+                {
+                    lowerBound *= worstOdds[i];
+                }
+            }
+
+            float upperBound = 1.0f;
+            if (!canSoften)
+            {
+                // fewer attackers than defenders can't win at all
+                upperBound = attackerCount < defenderCount ? 0.0f : *std::min_element(bestOdds.begin(), bestOdds.end());
+            }
+
+            return std::make_pair(lowerBound, std::max<float>(lowerBound, upperBound));
+        }
+
+        // only builds the full combat graph if the bounds don't settle which side of the relevant thresholds the result falls
+        // attack: plots we can't win are settled - winnable ones still need the graph for the attack order
+        // defence: plots the hostiles can't win, or are certain to, are settled
+        // settled results keep the units, but take pWin from the bound nearest the threshold, with everything else counted as a loss -
+        // they are flagged as bounded, so move ranking doesn't compare them with exact results
+        CombatGraph::Data getBoundedCombatResults(const Player& player, const UnitData::CombatDetails& combatDetails,
+            const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders, bool isAttack, int& prunedCount)
+        {
+            if (!attackers.empty() && !defenders.empty())
+            {
+                const std::pair<float, float> bounds = getCombatBounds(player, combatDetails, attackers, defenders);
+
+                bool isSettled = false;
+                float pWin = 0.0f;
+                if (bounds.second < (isAttack ? MilitaryAnalysis::attThreshold : MilitaryAnalysis::hostileAttackThreshold))
+                {
+                    isSettled = true;
+                    pWin = bounds.second;
+                }
+                else if (!isAttack && bounds.first > MilitaryAnalysis::defThreshold)
+                {
+                    isSettled = true;
+                    pWin = bounds.first;
+                }
+
+                if (isSettled)
+                {
+                    ++prunedCount;
+#ifdef ALTAI_DEBUG
+                    // withdrawal is where the bounds and the graph's end states are easiest to get out of step, so check against the full graph
+                    bool haveWithdrawal = false;
+                    for (size_t i = 0, count = attackers.size(); i < count && !haveWithdrawal; ++i)
+                    {
+                        haveWithdrawal = attackers[i].withdrawalProb > 0;
+                    }
+                    if (haveWithdrawal)
+                    {
+                        CombatGraph combatGraph = getCombatGraph(player, combatDetails, attackers, defenders);
+                        combatGraph.analyseEndStates();
+                        const float graphWin = combatGraph.endStatesData.pWin, tolerance = 1.0e-3f;
+                        if (graphWin < bounds.first - tolerance || graphWin > bounds.second + tolerance)
+                        {
+                            std::ostream& os = ErrorLog::getLog(*player.getCvPlayer())->getStream();
+                            os << "\nCombat bounds: " << bounds.first << ", " << bounds.second << " don't contain combat graph pWin: " << graphWin
+                               << " for " << attackers.size() << " attackers (with withdrawal) and " << defenders.size() << " defenders";
+                            FAssertMsg(false, "Combat bounds don't contain combat graph result");
+                        }
+                    }
+#endif
+
+                    CombatGraph::Data data;
+                    data.attackers = attackers;
+                    data.defenders = defenders;
+                    data.attackerUnitOdds.resize(attackers.size(), 0.0f);
+                    data.defenderUnitOdds.resize(defenders.size(), 0.0f);
+                    data.pWin = pWin;
+                    data.pLoss = 1.0f - pWin;
+                    data.isBounded = true;
+                    return data;
+                }
+            }
+
+            CombatGraph combatGraph = getCombatGraph(player, combatDetails, attackers, defenders);
+            combatGraph.analyseEndStates();
+            return combatGraph.endStatesData;
+        }
+    }
+
     void GroupCombatData::calculate(const Player& player, const CvSelectionGroup* pGroup)
     {
         std::vector<const CvUnit*> ourUnits;
@@ -1803,6 +2109,9 @@ namespace AltAI
 
     void GroupCombatData::calculate(const Player& player, const std::vector<const CvUnit*>& units, const PlotUnitDataMap& possibleHostiles)
     {
+        ProfileScope profileScope("GroupCombatData::calculate", player.getPlayerID());
+        int evaluatedCount = 0, prunedCount = 0;
+
         attackCombatResultsMap.clear();
         defenceCombatResultsMap.clear();
 
@@ -1904,9 +2213,8 @@ namespace AltAI
                 }
             }
 
-            CombatGraph combatGraph = getCombatGraph(player, combatDetails, enemyUnitData, ourUnitData);
-            combatGraph.analyseEndStates();
-            defenceCombatResultsMap[plotIter->first->getCoords()] = combatGraph.endStatesData;
+            defenceCombatResultsMap[plotIter->first->getCoords()] = getBoundedCombatResults(player, combatDetails, enemyUnitData, ourUnitData, false, prunedCount);
+            ++evaluatedCount;
         }
 
         for (PlotUnitsMap::const_iterator hi(hostilesLocationMap.begin()), hiEnd(hostilesLocationMap.end());
@@ -1950,11 +2258,13 @@ namespace AltAI
                     // we are attacking hostile units at plot: hi->first
                     combatDetails.unitAttackDirectionsMap[ourUnits[i]->getIDInfo()] = directionXY(ourUnits[i]->plot(), hi->first);
                 }
-                CombatGraph combatGraph = getCombatGraph(player, combatDetails, ourUnitData, enemyUnitData);
-                combatGraph.analyseEndStates();
-                attackCombatResultsMap[hi->first->getCoords()] = combatGraph.endStatesData;
+                attackCombatResultsMap[hi->first->getCoords()] = getBoundedCombatResults(player, combatDetails, ourUnitData, enemyUnitData, true, prunedCount);
+                ++evaluatedCount;
             }            
         }
+
+        Profiler::getInstance()->addCount("combatPlots", evaluatedCount);
+        Profiler::getInstance()->addCount("prunedCombatPlots", prunedCount);
     }
 
     void GroupCombatData::debug(std::ostream& os) const
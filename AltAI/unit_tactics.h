@@ -41,34 +41,55 @@ namespace AltAI
     std::list<StackCombatData> getBestUnitOdds(const Player& player, const UnitData::CombatDetails& combatDetails, 
         const std::vector<UnitData>& attackers, const std::vector<UnitData>& defenders, const int oddsThreshold, bool includeCollateral, bool debug);
 
-    struct StackCombatDataNode;
-    typedef boost::shared_ptr<StackCombatDataNode> StackCombatDataNodePtr;
-
-    struct StackCombatDataNode
-    {
-        StackCombatDataNode() : parentNode(NULL), prob(0.0f) {}
-        explicit StackCombatDataNode(const StackCombatDataNode* parentNode_) : parentNode(parentNode_), prob(0.0f) {}
-        StackCombatData data;
-        std::vector<UnitData> attackers, defenders;
-        StackCombatDataNodePtr winNode, lossNode, drawNode;
-        const StackCombatDataNode* parentNode;
-        float prob;
-        StackCombatDataNodePtr getBestOutcome() const { return winNode ? winNode : drawNode ? drawNode : lossNode; }
-        StackCombatDataNodePtr getWorstOutcome() const { return lossNode ? lossNode : drawNode ? drawNode : winNode; }
-        bool isEndState() const { return !(winNode || drawNode || lossNode); }
-    };
-
     struct CombatGraph
     {
-        StackCombatDataNodePtr pRootNode;
-        std::list<StackCombatDataNodePtr> endStates;
+        // combat only changes a unit's hp, moves and whether it has attacked - everything else is
+        // held once per graph in the root attackers/defenders vectors, which unitIndex refers to
+        struct UnitState
+        {
+            UnitState() : unitIndex(0), hp(0), moves(0), hasAttacked(false) {}
+            UnitState(size_t unitIndex_, const UnitData& unitData)
+                : unitIndex(unitIndex_), hp(unitData.hp), moves(unitData.moves), hasAttacked(unitData.hasAttacked) {}
+
+            size_t unitIndex;
+            int hp, moves;
+            bool hasAttacked;
+        };
+
+        enum NodeIndices
+        {
+            NoNode = -1, RootNode = 0
+        };
+
+        // nodes live in the graph's arena and refer to each other and to their units' states by index
+        // identical stack states reached through different combat orderings share one node, so a node can have several parents
+        struct Node
+        {
+            Node() : parentNode(NoNode), winNode(NoNode), lossNode(NoNode), drawNode(NoNode),
+                firstAttacker(0), attackerCount(0), firstDefender(0), defenderCount(0), prob(0.0f), isExpanded(false) {}
+
+            StackCombatData data;  // attacker and defender indices are into this node's unit states
+            int parentNode, winNode, lossNode, drawNode;  // parentNode is the first node to reach this state
+            size_t firstAttacker, attackerCount, firstDefender, defenderCount;
+            float prob;  // total probability of reaching this state
+            bool isExpanded;
+
+            int getBestOutcome() const { return winNode != NoNode ? winNode : drawNode != NoNode ? drawNode : lossNode; }
+            int getWorstOutcome() const { return lossNode != NoNode ? lossNode : drawNode != NoNode ? drawNode : winNode; }
+            bool isEndState() const { return winNode == NoNode && drawNode == NoNode && lossNode == NoNode; }
+        };
+
+        std::vector<UnitData> attackers, defenders;
+        std::vector<Node> nodes;
+        std::vector<UnitState> unitStates;
+        std::list<int> endStates;
 
         struct Data
         {
-            Data() : pWin(0), pLoss(0), pDraw(0) {}
+            Data() : pWin(0), pLoss(0), pDraw(0), isBounded(false) {}
             explicit Data(const CombatGraph& pGraph)
-                : attackers(pGraph.pRootNode->attackers), defenders(pGraph.pRootNode->defenders), attackerUnitOdds(pGraph.pRootNode->attackers.size()), defenderUnitOdds(pGraph.pRootNode->defenders.size()),
-                  longestAndShortestAttackOrder(pGraph.getLongestAndShortestAttackOrder()), pWin(0), pLoss(0), pDraw(0)
+                : attackers(pGraph.attackers), defenders(pGraph.defenders), attackerUnitOdds(pGraph.attackers.size()), defenderUnitOdds(pGraph.defenders.size()),
+                  longestAndShortestAttackOrder(pGraph.getLongestAndShortestAttackOrder()), pWin(0), pLoss(0), pDraw(0), isBounded(false)
             {
             }
 
@@ -81,6 +102,7 @@ namespace AltAI
             std::vector<float> attackerUnitOdds, defenderUnitOdds;
             std::pair<std::list<IDInfo>, std::list<IDInfo> > longestAndShortestAttackOrder;
             float pWin, pLoss, pDraw;
+            bool isBounded;  // odds are only a bound on the real result (not saved - only set for GroupCombatData's pruned plots)
         };
 
         Data endStatesData;
@@ -89,9 +111,14 @@ namespace AltAI
         void debugEndStates(std::ostream& os) const;
         
         size_t getFirstUnitIndex(bool isAttacker) const;
-        std::list<IDInfo> getUnitOrdering(std::list<StackCombatDataNodePtr>::const_iterator endStateIter) const;
+        std::list<IDInfo> getUnitOrdering(std::list<int>::const_iterator endStateIter) const;
         std::pair<std::list<IDInfo>, std::list<IDInfo> > getLongestAndShortestAttackOrder() const;
         float getSurvivalOdds(IDInfo unitId, bool isAttacker) const;
+
+        const UnitState& getAttackerState(const Node& node, size_t index) const { return unitStates[node.firstAttacker + index]; }
+        const UnitState& getDefenderState(const Node& node, size_t index) const { return unitStates[node.firstDefender + index]; }
+        // expand a node's unit states into full unit data (reusing the passed vectors' storage)
+        void getNodeUnits(const Node& node, std::vector<UnitData>& nodeAttackers, std::vector<UnitData>& nodeDefenders) const;
     };
 
     CombatGraph getCombatGraph(const Player& player, const UnitData::CombatDetails& combatDetails, 
@@ -143,7 +170,8 @@ namespace AltAI
         UnitPathData() : pathTurns(-1), valid(false) {}
 
         void calculate(const CvSelectionGroup* pGroup, const CvPlot* pTargetPlot, const int flags, TeamTypes isVisibleToTeam = NO_TEAM);
-        void calculate(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot, const int flags, PlayerTypes playerType, TeamTypes isVisibleToTeam);
+        // path of units with full moves, as seen by playerType (move flags don't apply - the UnitData path costs never used them)
+        void calculate(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const CvPlot* pTargetPlot, PlayerTypes playerType, TeamTypes isVisibleToTeam);
         XYCoords getLastVisiblePlotWithMP() const;
         XYCoords getFirstStepCoords() const;
         XYCoords getFirstTurnEndCoords() const;
@@ -174,6 +202,13 @@ namespace AltAI
         }
     };
 
+    // paths from pStartPlot to each of targetPlots in one search (cached as UnitPathData::calculate for UnitData)
+    std::vector<UnitPathData> getUnitPaths(const std::vector<UnitData>& units, const CvPlot* pStartPlot, const std::vector<const CvPlot*>& targetPlots,
+        PlayerTypes playerType, TeamTypes isVisibleToTeam);
+
+    // drops UnitData paths cached for this player - call when units it can see change
+    void invalidateUnitPaths(PlayerTypes playerType);
+
     struct UnitPathDataComp
     {
         bool operator() (const UnitPathData& pathData1, const UnitPathData& pathData2) const
@@ -87,9 +87,10 @@ namespace AltAI
             UnitTypes unitType = pCityUnitTactics->getUnitType();
             const CvUnitInfo& unitInfo = gGlobals.getUnitInfo(unitType);
 
+            const CityData& cityData = *city.getCityData();
             int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(player.getCvPlayer()->getProductionNeeded(unitType), 
-                city.getCityData()->getModifiersHelper()->getUnitProductionModifier(unitType),
-                city.getCityData()->getModifiersHelper()->getTotalYieldModifier(*city.getCityData())[YIELD_PRODUCTION]);
+                cityData.getModifiersHelper()->getUnitProductionModifier(unitType),
+                cityData.getModifiersHelper()->getTotalYieldModifier(cityData)[YIELD_PRODUCTION]);
 
             //const ProjectionLadder& ladder = pCityUnitTactics->getProjection();
 
@@ -216,8 +217,9 @@ namespace AltAI
         combatDetails.flags = UnitData::CombatDetails::CityAttack;
         combatDetails.plotIsHills = pCity->plot()->isHills();
         combatDetails.plotTerrain = pCity->plot()->getTerrainType();
-        combatDetails.cultureDefence = gGlobals.getCultureLevelInfo(pCityUnitTactics->getCityData()->getCultureHelper()->getCultureLevel()).getCityDefenseModifier();
-        combatDetails.buildingDefence = pCityUnitTactics->getCityData()->getUnitHelper()->getBuildingDefence();
+        const CityData& cityData = *pCityUnitTactics->getCityData();
+        combatDetails.cultureDefence = gGlobals.getCultureLevelInfo(cityData.getCultureHelper()->getCultureLevel()).getCityDefenseModifier();
+        combatDetails.buildingDefence = cityData.getUnitHelper()->getBuildingDefence();
 
         applyCombatTactic(pCityUnitTactics, this, selectionData.thisCityDefenceUnits, pCityUnitTactics->getCity(), combatDetails, false);
     }
@@ -408,9 +410,10 @@ namespace AltAI
         UnitTypes unitType = pCityUnitTactics->getUnitType();
         const CvUnitInfo& unitInfo = gGlobals.getUnitInfo(unitType);
 
+        const CityData& cityData = *city.getCityData();
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(player.getCvPlayer()->getProductionNeeded(unitType), 
-            city.getCityData()->getModifiersHelper()->getUnitProductionModifier(unitType),
-            city.getCityData()->getModifiersHelper()->getTotalYieldModifier(*city.getCityData())[YIELD_PRODUCTION]);
+            cityData.getModifiersHelper()->getUnitProductionModifier(unitType),
+            cityData.getModifiersHelper()->getTotalYieldModifier(cityData)[YIELD_PRODUCTION]);
 
         if (!ladder.units.empty())
         //if (estimatedTurns >= 0)
@@ -544,9 +547,10 @@ namespace AltAI
         Player& player = *gGlobals.getGame().getAltAI()->getPlayer(cityInfo.eOwner);
         City& city = gGlobals.getGame().getAltAI()->getPlayer(cityInfo.eOwner)->getCity(cityInfo.iID);
 
+        const CityData& cityData = *city.getCityData();
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(pPlayer->getCvPlayer()->getProductionNeeded(pCityUnitTactics->getUnitType()), 
-            city.getCityData()->getModifiersHelper()->getUnitProductionModifier(pCityUnitTactics->getUnitType()),
-            city.getCityData()->getModifiersHelper()->getTotalYieldModifier(*city.getCityData())[YIELD_PRODUCTION]);
+            cityData.getModifiersHelper()->getUnitProductionModifier(pCityUnitTactics->getUnitType()),
+            cityData.getModifiersHelper()->getTotalYieldModifier(cityData)[YIELD_PRODUCTION]);
 
 #ifdef ALTAI_DEBUG
         std::ostream& os = CivLog::getLog(*pPlayer->getCvPlayer())->getStream();
@@ -758,9 +762,10 @@ namespace AltAI
         std::ostream& os = CivLog::getLog(*player.getCvPlayer())->getStream();
         os << "\nUnit tactics (scout) for city: " << narrow(pCity->getName());
 #endif
+        const CityData& cityData = *city.getCityData();
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(player.getCvPlayer()->getProductionNeeded(pCityUnitTactics->getUnitType()), 
-                city.getCityData()->getModifiersHelper()->getUnitProductionModifier(pCityUnitTactics->getUnitType()),
-                city.getCityData()->getModifiersHelper()->getTotalYieldModifier(*city.getCityData())[YIELD_PRODUCTION]);
+                cityData.getModifiersHelper()->getUnitProductionModifier(pCityUnitTactics->getUnitType()),
+                cityData.getModifiersHelper()->getTotalYieldModifier(cityData)[YIELD_PRODUCTION]);
 
         const ProjectionLadder& ladder = pCityUnitTactics->getProjection();
 
@@ -838,9 +843,10 @@ namespace AltAI
         UnitTypes unitType = pCityUnitTactics->getUnitType();
         const CvUnitInfo& unitInfo = gGlobals.getUnitInfo(unitType);
 
+        const CityData& cityData = *city.getCityData();
         int estimatedTurns = city.getBaseOutputProjection().getExpectedTurnBuilt(player.getCvPlayer()->getProductionNeeded(unitType), 
-            city.getCityData()->getModifiersHelper()->getUnitProductionModifier(unitType),
-            city.getCityData()->getModifiersHelper()->getTotalYieldModifier(*city.getCityData())[YIELD_PRODUCTION]);
+            cityData.getModifiersHelper()->getUnitProductionModifier(unitType),
+            cityData.getModifiersHelper()->getTotalYieldModifier(cityData)[YIELD_PRODUCTION]);
 
         if (estimatedTurns < player.getAnalysis()->getNumSimTurns())
         {
@@ -1040,7 +1046,7 @@ namespace AltAI
             CityDataPtr pCityData = city.getCityData()->clone();
 
             std::vector<IProjectionEventPtr> events;
-            ProjectionLadder base = getProjectedOutput(player, pBaseCityData, numSimTurns, events, ConstructItem(), __FUNCTION__, false);
+            ProjectionLadder base = getIncrementalProjectedOutput(player, pBaseCityData, numSimTurns, events, __FUNCTION__);
 
             updateRequestData(*pCityData, specType_);
             events.clear();
@@ -0,0 +1,105 @@
+#include "AltAI.h"
+
+#include "./worker_pool.h"
+
+#include <process.h>
+
+namespace AltAI
+{
+    namespace
+    {
+        // non-null on the pool's threads (tls slots start out null on every thread)
+        const DWORD workerTlsIndex = ::TlsAlloc();
+
+        struct TaskQueue
+        {
+            explicit TaskQueue(const std::vector<IWorkerTask*>& tasks_) : tasks(tasks_), nextTask(0) {}
+
+            void runTasks()
+            {
+                for (;;)
+                {
+                    const LONG index = ::InterlockedIncrement(&nextTask) - 1;
+                    if (index >= (LONG)tasks.size())
+                    {
+                        break;
+                    }
+                    tasks[index]->run();
+                }
+            }
+
+            const std::vector<IWorkerTask*>& tasks;
+            volatile LONG nextTask;
+
+        private:
+            TaskQueue& operator = (const TaskQueue&);
+        };
+
+        unsigned __stdcall workerMain(void* pArg)
+        {
+            ::TlsSetValue(workerTlsIndex, pArg);
+            static_cast<TaskQueue*>(pArg)->runTasks();
+            return 0;
+        }
+    }
+
+    boost::shared_ptr<WorkerPool> WorkerPool::instance_;
+
+    boost::shared_ptr<WorkerPool> WorkerPool::getInstance()
+    {
+        if (instance_ == NULL)
+        {
+            instance_ = boost::shared_ptr<WorkerPool>(new WorkerPool());
+        }
+        return instance_;
+    }
+
+    WorkerPool::WorkerPool() : threadCount_(0)
+    {
+#ifndef ALTAI_DEBUG
+        const int requestedThreads = gGlobals.getDefineINT("ALTAI_WORKER_THREADS");
+        if (requestedThreads > 0 && workerTlsIndex != TLS_OUT_OF_INDEXES)
+        {
+            SYSTEM_INFO systemInfo;
+            ::GetSystemInfo(&systemInfo);
+            threadCount_ = std::min<size_t>(requestedThreads, systemInfo.dwNumberOfProcessors > 1 ? systemInfo.dwNumberOfProcessors - 1 : 0);
+            threadCount_ = std::min<size_t>(threadCount_, MAXIMUM_WAIT_OBJECTS);  // limit for the join in run()
+        }
+#endif
+    }
+
+    // threads are started per batch and joined before returning, rather than kept alive, so nothing is left to shut down when the dll is unloaded
+    void WorkerPool::run(const std::vector<IWorkerTask*>& tasks)
+    {
+        TaskQueue queue(tasks);
+
+        const size_t threadCount = tasks.size() > 1 && !isWorkerThread() ? std::min<size_t>(threadCount_, tasks.size() - 1) : 0;
+        std::vector<HANDLE> threads;
+        threads.reserve(threadCount);
+
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            HANDLE hThread = (HANDLE)::_beginthreadex(NULL, 0, &workerMain, &queue, 0, NULL);
+            if (hThread)
+            {
+                threads.push_back(hThread);
+            }
+        }
+
+        queue.runTasks();
+
+        if (!threads.empty())
+        {
+            ::WaitForMultipleObjects((DWORD)threads.size(), &threads[0], TRUE, INFINITE);
+            for (size_t i = 0, count = threads.size(); i < count; ++i)
+            {
+                ::CloseHandle(threads[i]);
+            }
+        }
+    }
+
+    bool WorkerPool::isWorkerThread()
+    {
+        return workerTlsIndex != TLS_OUT_OF_INDEXES && ::TlsGetValue(workerTlsIndex) != NULL;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "./utils.h"
+
+namespace AltAI
+{
+    // a unit of work for WorkerPool - run() should only write to the task's own data, or to shared state guarded by a CriticalSection
+    class IWorkerTask
+    {
+    public:
+        virtual ~IWorkerTask() {}
+        virtual void run() = 0;
+    };
+
+    // runs batches of independent tasks across a bounded number of win32 threads, with the calling thread working through the batch too
+    // tasks are claimed in order from a shared counter, so a thread which finishes early takes the next task rather than idling
+    // extra threads come from the ALTAI_WORKER_THREADS global define (capped at the processor count less one) - zero (the default) runs serially
+    // debug builds always run serially, as the logs are not thread safe
+    class WorkerPool
+    {
+    public:
+        static boost::shared_ptr<WorkerPool> getInstance();
+
+        size_t getThreadCount() const
+        {
+            return threadCount_;
+        }
+
+        // returns once every task has run - batches started from inside a task run serially on that thread
+        void run(const std::vector<IWorkerTask*>& tasks);
+
+        template <typename Task>
+            void runTasks(std::vector<Task>& tasks)
+        {
+            std::vector<IWorkerTask*> pTasks(tasks.size());
+            for (size_t i = 0, count = tasks.size(); i < count; ++i)
+            {
+                pTasks[i] = &tasks[i];
+            }
+            run(pTasks);
+        }
+
+        // true while running a task on one of the pool's threads (for state, e.g. the profiler, which is only updated from the main thread)
+        static bool isWorkerThread();
+
+    private:
+        WorkerPool();
+
+        size_t threadCount_;
+
+        static boost::shared_ptr<WorkerPool> instance_;
+    };
+
+    class CriticalSection
+    {
+    public:
+        CriticalSection()
+        {
+            ::InitializeCriticalSection(&cs_);
+        }
+
+        ~CriticalSection()
+        {
+            ::DeleteCriticalSection(&cs_);
+        }
+
+        void enter()
+        {
+            ::EnterCriticalSection(&cs_);
+        }
+
+        void leave()
+        {
+            ::LeaveCriticalSection(&cs_);
+        }
+
+    private:
+        CriticalSection(const CriticalSection&);
+        CriticalSection& operator = (const CriticalSection&);
+
+        CRITICAL_SECTION cs_;
+    };
+
+    // holds the critical section for its lifetime
+    class CriticalSectionLock
+    {
+    public:
+        explicit CriticalSectionLock(CriticalSection& cs) : cs_(cs)
+        {
+            cs_.enter();
+        }
+
+        ~CriticalSectionLock()
+        {
+            cs_.leave();
+        }
+
+    private:
+        CriticalSectionLock(const CriticalSectionLock&);
+        CriticalSectionLock& operator = (const CriticalSectionLock&);
+
+        CriticalSection& cs_;
+    };
+}
@@ -834,15 +834,16 @@ namespace AltAI
             return pTarget;
         }
 
-        bool tryMission(CvUnitAI* pUnit, const CvCity* pCurrentCity, const std::map<IDInfo, std::vector<PlotBuildData> >& buildsMap, const PlotSet& dangerPlots)
+        bool tryMission(CvUnitAI* pUnit, const CvCity* pCurrentCity, const std::map<IDInfo, std::vector<PlotBuildData> >& buildsMap)
         {
             std::map<IDInfo, std::vector<PlotBuildData> >::const_iterator buildTargetsIter = buildsMap.find(pCurrentCity->getIDInfo());
             if (buildTargetsIter != buildsMap.end() && !buildTargetsIter->second.empty())
             {
+                MilitaryAnalysisPtr pMilitaryAnalysis = player_.getAnalysis()->getMilitaryAnalysis();
                 for (size_t i = 0, targetsCount = buildTargetsIter->second.size(); i < targetsCount; ++i)
                 {
                     const CvPlot* targetPlot = gGlobals.getMap().plot(buildTargetsIter->second[i].coords.iX, buildTargetsIter->second[i].coords.iY);
-                    if (dangerPlots.find(targetPlot) != dangerPlots.end())
+                    if (pMilitaryAnalysis->isPlotThreatened(targetPlot))
                     {
 #ifdef ALTAI_DEBUG
                         std::ostream& os = CivLog::getLog(*player_.getCvPlayer())->getStream();
@@ -868,8 +869,7 @@ namespace AltAI
                         const std::map<int, IDInfo>& areaCityDistances, 
                         const std::map<IDInfo, std::vector<PlotBuildData> >& buildsMap,
                         const std::map<IDInfo, int>& cityWorkerCounts,
-                        RouteTypes routeType,
-                        const PlotSet& dangerPlots)
+                        RouteTypes routeType)
         {
             const CvCity* pNextCity = selectNextCity(pCurrentCity, areaCityDistances, buildsMap, cityWorkerCounts);
 
@@ -893,7 +893,7 @@ namespace AltAI
                 pCurrentCity = pNextCity;
             }
 
-            if (pCurrentCity && tryMission(pUnit, pCurrentCity, buildsMap, dangerPlots))
+            if (pCurrentCity && tryMission(pUnit, pCurrentCity, buildsMap))
             {
                 unitCityTargets_[pUnit->getIDInfo()] = pCurrentCity->getIDInfo();
                 return true;
@@ -1707,8 +1707,6 @@ namespace AltAI
 
                 if (unit.getWorkerMissions().empty())
                 {
-                    PlotSet dangerPlots = player_.getAnalysis()->getMilitaryAnalysis()->getThreatenedPlots();
-
                     RouteTypes routeType = player_.getCvPlayer()->getBestRoute();
 
                     std::map<IDInfo, int> cityWorkerCounts;
@@ -1744,7 +1742,7 @@ namespace AltAI
                     }
 #endif
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, bonusTargetPlots_, cityWorkerCounts, routeType, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, bonusTargetPlots_, cityWorkerCounts, routeType))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected bonus mission, city = " << safeGetCityName(pCurrentCity);
@@ -1752,7 +1750,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, cityBonusTargetPlots_, cityWorkerCounts, routeType, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, cityBonusTargetPlots_, cityWorkerCounts, routeType))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected city bonus mission, city = " << safeGetCityName(pCurrentCity);
@@ -1760,7 +1758,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unconnectedBonusTargetPlots_, cityWorkerCounts, routeType, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unconnectedBonusTargetPlots_, cityWorkerCounts, routeType))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected unconnected bonus mission, city = " << safeGetCityName(pCurrentCity);
@@ -1768,7 +1766,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unbuiltNonBonusImps_, cityWorkerCounts, routeType, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unbuiltNonBonusImps_, cityWorkerCounts, routeType))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected city imp mission, city = " << safeGetCityName(pCurrentCity);
@@ -1776,7 +1774,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, badFeatureImps_, cityWorkerCounts, NO_ROUTE, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, badFeatureImps_, cityWorkerCounts, NO_ROUTE))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected bad feature imp mission, city = " << safeGetCityName(pCurrentCity);
@@ -1784,7 +1782,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unirrigatedIrrigatableBonuses_, cityWorkerCounts, NO_ROUTE, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unirrigatedIrrigatableBonuses_, cityWorkerCounts, NO_ROUTE))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected connect irrigation mission, city = " << safeGetCityName(pCurrentCity);
@@ -1792,7 +1790,7 @@ namespace AltAI
                         return;
                     }
             
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, irrigationChainImps_, cityWorkerCounts, NO_ROUTE, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, irrigationChainImps_, cityWorkerCounts, NO_ROUTE))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected chain irrigation mission, city = " << safeGetCityName(pCurrentCity);
@@ -1800,7 +1798,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unbuiltSelectedImps_, cityWorkerCounts, NO_ROUTE, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unbuiltSelectedImps_, cityWorkerCounts, NO_ROUTE))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected unbuilt, selected imp mission, city = " << safeGetCityName(pCurrentCity);
@@ -1808,7 +1806,7 @@ namespace AltAI
                         return;
                     }
 
-                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unselectedImps_, cityWorkerCounts, NO_ROUTE, dangerPlots))
+                    if (tryMission(pUnit, pCurrentCity, areaCityDistances, unselectedImps_, cityWorkerCounts, NO_ROUTE))
                     {
 #ifdef ALTAI_DEBUG
                         os << " selected unselected imp mission, city = " << safeGetCityName(pCurrentCity);
@@ -4778,6 +4778,20 @@ void CvPlot::setOwner(PlayerTypes eNewValue, bool bCheckUnits, bool bUpdatePlotG
 				verifyUnitValidPlot();
 			}
 
+            // AltAI - whether units can use this plot's route depends on its owner (revealed owner changes are notified separately)
+            if (GC.getGame().getAltAI()->isInit())
+            {
+                AltAI::PlayerIDIter playerIter;
+                PlayerTypes playerType = NO_PLAYER;
+                while ((playerType = playerIter()) != NO_PLAYER)
+                {
+                    if (GET_PLAYER(playerType).isUsingAltAI())
+                    {
+                        GC.getGame().getAltAI()->getPlayer(playerType)->updatePlotMovementCosts(this);
+                    }
+                }
+            }
+
             //// AltAI - done in updateRevealedOwner instead
             //if (GC.getGame().getAltAI()->isInit())
             //{
@@ -5622,6 +5636,20 @@ void CvPlot::setRouteType(RouteTypes eNewValue, bool bUpdatePlotGroups)
 			}
 		}
 
+        // AltAI - route movement costs
+        if (GC.getGame().getAltAI()->isInit())
+        {
+            AltAI::PlayerIDIter playerIter;
+            PlayerTypes playerType = NO_PLAYER;
+            while ((playerType = playerIter()) != NO_PLAYER)
+            {
+                if (GET_PLAYER(playerType).isUsingAltAI())
+                {
+                    GC.getGame().getAltAI()->getPlayer(playerType)->updatePlotMovementCosts(this);
+                }
+            }
+        }
+
 		if (GC.getGameINLINE().isDebugMode())
 		{
 			updateRouteSymbol(true, true);